@@ -112,6 +112,21 @@ DLLEXPORT void simHalt      (simContext sim);
 DLLEXPORT int  simStep      (simContext sim);
 DLLEXPORT int  simRun       (simContext sim);
 
+/* API for saving and restoring the simulated system state */
+
+DLLEXPORT int  simSaveCheckpoint    (simContext sim, const char* path);
+DLLEXPORT int  simRestoreCheckpoint (simContext sim, const char* path);
+
+/* API for forking a simulation into children created with the same arguments
+ * (i.e. simCreateContext()) that share its memory pages copy-on-write, and for
+ * running several simulation contexts in parallel, one host thread each.
+ * Forked contexts share compiled translations only through the persistent
+ * translation archive (i.e. '--fast-cache'), otherwise each context compiles
+ * its hot code itself. A context may only be passed once to simRunContexts. */
+
+DLLEXPORT int  simForkContext (simContext sim, int count, simContext children[]);
+DLLEXPORT int  simRunContexts (int count, simContext sims[]);
+
 /* API for interrogating simulator about external plugin options */
 
 DLLEXPORT int         simPluginOptionIsSet    (simContext sim, const char *opt);
@@ -17,10 +17,13 @@
 #include <string>
 #include <map>
 #include <set>
+#include <vector>
 
 #include "api/types.h"
 #include "sim_types.h"
 
+#include "arch/CacheArch.h"
+
 // -----------------------------------------------------------------------------
 // Forward Declaration
 //
@@ -41,20 +44,33 @@ public:
   bool          cosim;
   bool          init_mem_custom;
   uint32        init_mem_value;
+  bool          mem_sparse;     // back RAM by one sparse reservation of the physical address space
   bool          fast;
   bool          fast_use_default_jit;
   size_t        fast_num_worker_threads;
   bool          fast_enable_debug;
   bool          fast_use_inline_asm;
+  uint32        fast_tier_up_threshold;
+  bool          fast_prelude_pch;   // parse JIT module prelude once per worker as precompiled header
   CompilationMode     fast_trans_mode;
   std::string   fast_cc;
   std::string   fast_mode_cc_opts;
   std::string   fast_tmp_dir;
+  std::string   fast_cache_file;
   bool          keep_files;
   bool          reuse_txlation;
   uint64        sim_period;
+  uint64        sample_period;
+  uint64        sample_warmup;
+  uint64        sample_detail;
+  std::vector<CacheArch> icache_sweep;  // cache geometries simulated in one pass
+  std::vector<CacheArch> dcache_sweep;
   bool          emulate_traps;
   bool          trace_on;
+  bool          trace_binary;
+  std::string   trace_render_file;
+  std::string   checkpoint_save_file;
+  std::string   checkpoint_restore_file;
   bool          verbose;
   bool          quiet;
   bool          exit_on_break;
@@ -92,14 +108,21 @@ public:
   int         rerr_fd;
   
   bool        dump_state;
-  int         halt_simulation;
+  volatile int halt_simulation;   // @see is_halt_simulation()/set_halt_simulation()
 
-  uint32      dcode_cache_size;
+  uint32      dcode_cache_bytes;  // size of each decode cache in bytes
+  bool        dcode_page;         // pre-decode executed pages in bulk
+  uint32      dcode_page_cache_bytes; // size of Dcode pools of each page decode cache in bytes
   uint32      trans_cache_size;
   
   uint32      trace_interval_size;
   uint32      hotspot_threshold;
   
+  // Multi-core simulation settings
+  //
+  uint32      mc_quantum;       // instructions (blocks in JIT mode) per quantum
+  bool        mc_deterministic; // execute cores in core order within a quantum
+  
   bool        track_regs;
 
   bool        has_mmx;
@@ -128,6 +151,25 @@ public:
   bool is_cache_miss_cycle_recording_enabled;
   bool is_opcode_latency_distrib_recording_enabled;
   
+  // Memory model and cycle accurate simulation in translated code. Sampled
+  // simulation only executes translated code while fast-forwarding, hence
+  // translations remain functional even though the models are enabled.
+  //
+  // Halt requests are raised by processors, which may run on their own host
+  // threads (@see System::run_parallel()), and by API callers on other host
+  // threads, hence 'halt_simulation' MUST only be accessed via these methods
+  //
+  bool is_halt_simulation () const { __sync_synchronize(); return halt_simulation != 0; }
+  void set_halt_simulation (bool halt)
+  {
+    __sync_synchronize();
+    halt_simulation = halt;
+    __sync_synchronize();
+  }
+  
+  bool is_jit_memory_sim () const { return memory_sim && !sample_period; }
+  bool is_jit_cycle_sim  () const { return cycle_sim  && !sample_period; }
+  
   // Constructor/Destructor
   //
   SimOptions();
@@ -0,0 +1,65 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2010 The University of Edinburgh
+//                        All Rights Reserved
+// =====================================================================
+//
+// Description: Declaration of a reusable Barrier class.
+//
+// A Barrier blocks each calling thread in wait() until 'count' threads
+// have arrived. Exactly one of the threads released from a barrier
+// episode is told that it is the 'serial' thread, which allows it to
+// perform work that must happen once per episode (e.g. evaluating a
+// termination condition) before the next episode starts.
+//
+// =====================================================================
+
+#ifndef INC_CONCURRENT_BARRIER_H_
+#define INC_CONCURRENT_BARRIER_H_
+
+#include "api/types.h"
+
+#include "concurrent/Mutex.h"
+#include "concurrent/ConditionVariable.h"
+
+namespace arcsim {
+  namespace concurrent {
+
+    // -------------------------------------------------------------------------
+    // Barrier class
+    //
+    class Barrier
+    {
+    public:
+
+      // Initializes a barrier for 'count' participating threads
+      //
+      explicit Barrier(uint32 count);
+
+      ~Barrier();
+
+      // Block until all participating threads have called wait(). Returns
+      // true for exactly one thread per barrier episode (the last thread to
+      // arrive), false for all other threads.
+      //
+      bool wait();
+
+      // Number of participating threads
+      //
+      uint32 get_count() const { return count_; }
+
+    private:
+      Mutex             mtx_;
+      ConditionVariable cond_;
+
+      const uint32      count_;       // number of participating threads
+      uint32            waiting_;     // threads waiting in current episode
+      uint32            generation_;  // incremented whenever an episode completes
+
+      Barrier(const Barrier & b);       // DO NOT COPY
+      void operator=(const Barrier &);  // DO NOT ASSIGN
+    };
+
+  } } // namespace arcsim::concurrent
+
+#endif // INC_CONCURRENT_BARRIER_H_
@@ -55,7 +55,8 @@
 //#define DEBUG_INST_TRACE_EXEC_MODE // enable printing of execution mode during instruction tracing
 
 #define DEFAULT_HASH_CACHE_SIZE   8192 // Hash cache entries
-#define DEFAULT_DCODE_CACHE_SIZE  8192 // Decode cache entries
+#define DEFAULT_DCODE_CACHE_BYTES (2*1024*1024) // Decode cache size in bytes
+#define DEFAULT_DCODE_PAGE_CACHE_BYTES (16*1024*1024) // Page granular decode cache pool size in bytes
 #define DEFAULT_TRANS_CACHE_SIZE  8192 // Translation cache entries
 
 
@@ -72,6 +73,7 @@
 #define DEFAULT_OBJECT_NAME      "target.x"
 #define DEFAULT_OBJECT_FORMAT    OF_ELF
 #define DEFAULT_TRACE_ON         false
+#define DEFAULT_TRACE_BINARY     false
 #define DEFAULT_TRACE_START      0
 #define DEFAULT_VERBOSITY        false
 #define DEFAULT_DEBUG            false
@@ -93,14 +95,33 @@
 
 #define DEFAULT_FAST_ENABLE_DEBUG         false     // debugging of JIT generated code is disabled
 #define DEFAULT_FAST_USE_INLINE_ASM       false     // inline asm emit during JIT compilation is disabled
+#define DEFAULT_FAST_TIER_UP_THRESHOLD    0         // tiered JIT compilation is disabled
+#define DEFAULT_FAST_PRELUDE_PCH          false     // precompiled JIT module prelude is disabled
 #define DEFAULT_FAST_CC                   JIT_CC
 #define DEFAULT_FAST_TMP_DIR              ".arcsim"
+#define DEFAULT_FAST_CACHE_FILE           ""        // persistent translation cache is disabled
 // Threshold at which hotspot frequency should be adapted
 //
 #define DEFAULT_TRANSLATION_QUEUE_SIZE_THRESHOLD 16
 // Number by which current processor local hotspot threshold is multiplied
 //
 #define DEFAULT_HOTSPOT_THRESHOLD_MULTIPLY 10
+// Maximum number of pages and of blocks from other pages included in a region
+// (i.e. '--fast-trans-mode region')
+//
+#define DEFAULT_REGION_MAX_PAGES          4
+#define DEFAULT_REGION_MAX_BLOCKS         64
+
+// Default settings for parallel multi-core simulation
+//
+#define DEFAULT_MC_QUANTUM                10000     // instructions per quantum between core synchronisation
+#define DEFAULT_MC_DETERMINISTIC          false     // cores run concurrently within a quantum
+
+// Default settings for sampled memory/cycle accurate simulation (instructions)
+//
+#define DEFAULT_SAMPLE_PERIOD             0         // sampled simulation is disabled
+#define DEFAULT_SAMPLE_WARMUP             2000      // warm-up instructions per sample
+#define DEFAULT_SAMPLE_DETAIL             1000      // measured instructions per sample
 
 #define DEFAULT_CYCLE_SIM        false
 #define DEFAULT_MEMORY_SIM       false
@@ -111,6 +132,8 @@
 #define DEFAULT_INTERACTIVE      false
 #define DEFAULT_EMULATE_TRAPS    false
 #define DEFAULT_INIT_MEM_CUSTOM  false
+#define DEFAULT_DCODE_PAGE       false
+#define DEFAULT_MEM_SPARSE       false
 #define DEFAULT_HAS_MMX          false
 
 // Default settings for the ISA options
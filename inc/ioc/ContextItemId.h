@@ -47,6 +47,10 @@ namespace arcsim {
       static const char* kInterpInstCount64;
       static const char* kNativeInstCount64;
       static const char* kCycleCount64;
+      static const char* kSmcInvalidationCount64;
+      static const char* kSmcDiscardedTranslationCount64;
+      static const char* kRegionTransferCount64;
+      static const char* kRegionGuardFailCount64;
       // Symbol Table
       //
       static const char* kSymbolTable;
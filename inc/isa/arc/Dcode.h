@@ -129,24 +129,23 @@ namespace arcsim {
         
         // ---------------------------------------------------------------------
         // Member variables
-        // 
-        // 32-bit SIZE: 4b(Kind) + 13b(Info) + 4*8b + 6*sizeof(ptr) + 3*4b + 2b + 3*4b + 17*1b = 116b
-        // 64-bit SIZE: 4b(Kind) + 13b(Info) + 4*8b + 6*sizeof(ptr) + 3*4b + 2b + 3*4b + 17*1b = 140b
         //
-        Kind       kind;               // instruction kind
-        Info       info;               // instruction info structure
-
-        uint8      code;               // load, store, add, sub, bcc, jcc etc
-        uint8      size;               // size of inst + limm if present
-        uint8      link_offset;        // offset to return location
-        uint8      q_field;            // condition field
+        // Members are split into a hot and a cold part. The hot part holds all
+        // fields read by the interpreter for every instruction and comes first
+        // so it shares one 64 byte cache line (i.e. 48b on 32-bit and 64b on
+        // 64-bit hosts) when the Dcode object is cache line aligned (@see
+        // CacheAlignedDcode). Fields only needed for tracing, Actionpoints, EIA
+        // extensions, the JIT, or the cycle accurate and register tracking
+        // modes follow in the cold part, and are only read when these features
+        // are enabled. Keep it this way when adding fields.
+        //
         
+        // HOT -----------------------------------------------------------------
+        //
         uint32     *src1;              // ptr to 1st source
         uint32     *src2;              // ptr to 2nd source
         uint32     *dst1;              // ptr to 1st destination
         uint32     *dst2;              // ptr to 2nd destination
-        ise::eia::EiaInstructionInterface*   eia_inst; // ptr to object that implements instruction        
-        ise::eia::EiaConditionCodeInterface* eia_cond; // ptr to object that implements condition
         
         uint32     limm;               // long immediate data
 
@@ -154,13 +153,14 @@ namespace arcsim {
         //                causes only problems.
         uint32     shimm;              // short immediate data
         uint32     jmp_target;         // target of jump or branch
-        uint16     addr_shift;         // shift by 1, 2 or 3 bits
         
-        uint32     aps_inst_matches;   // actionpoint instruction matches        
-        uint32     xpu_required;       // EIA permissions required in XPU register
-
-        uint32     fetch_addr[3];      // fetch buffer address/es
-        uint8      fetches;            // number of inst fetches required
+        Kind       kind;               // instruction kind
+        
+        uint8      code;               // load, store, add, sub, bcc, jcc etc
+        uint8      size;               // size of inst + limm if present
+        uint8      link_offset;        // offset to return location
+        uint8      q_field;            // condition field
+        uint8      addr_shift;         // shift by 1, 2 or 3 bits
         
         bool       flag_enable;        // F bit from the instruction
         bool       z_wen;              // enables write to Z flag
@@ -174,11 +174,24 @@ namespace arcsim {
         // FIXME(iboehm): remove overloading of dslot for ENTER and LEAVE as it
         //                causes only problems.
         bool       dslot;              // true if inst HAS a delay-slot
-        bool       in_dslot;           // true if inst IS in a delay slot
         bool       taken_branch;       // true if inst is branch and branch is taken
         bool       has_limm;           // true if inst has limm data
         bool       cache_byp;          // true if load/store bypasses cache
         
+        // COLD ----------------------------------------------------------------
+        //
+        uint32     aps_inst_matches;   // actionpoint instruction matches        
+        uint32     xpu_required;       // EIA permissions required in XPU register
+        ise::eia::EiaInstructionInterface*   eia_inst; // ptr to object that implements instruction        
+        ise::eia::EiaConditionCodeInterface* eia_cond; // ptr to object that implements condition
+        
+        Info       info;               // instruction info structure
+        
+        uint32     fetch_addr[3];      // fetch buffer address/es
+        uint8      fetches;            // number of inst fetches required
+        
+        bool       in_dslot;           // true if inst IS in a delay slot
+        
         bool       illegal_operand;
         bool       illegal_inst_format;
         bool       illegal_inst_subcode;
@@ -277,6 +290,31 @@ namespace arcsim {
         //
         DISALLOW_COPY_AND_ASSIGN(Dcode);
       };
+      
+      // -----------------------------------------------------------------------
+      // Dcode padded to a multiple of the cache line size. The size of Dcode
+      // depends on the host word size and on the simulation modes compiled in
+      // (e.g. 128b on 64-bit hosts, 184b with CYCLE_ACC_SIM), so arrays of
+      // Dcode objects would not keep each object on a cache line boundary.
+      // Decode caches allocate arrays of CacheAlignedDcode objects from cache
+      // line aligned memory instead, so the hot part of every object stays
+      // within one cache line.
+      //
+      static const uint32 kDcodeCacheLineBytes = 64;
+      
+      template<uint32 N> struct DcodePadding        { uint8 pad[N]; };
+      template<>         struct DcodePadding<0>     { };
+      
+      struct CacheAlignedDcode
+        : public Dcode,
+          private DcodePadding<(kDcodeCacheLineBytes - sizeof(Dcode) % kDcodeCacheLineBytes)
+                               % kDcodeCacheLineBytes>
+      { };
+      
+      // Compile time check, fails with a negative array size if the padding is wrong
+      //
+      typedef char CacheAlignedDcodeSizeCheck
+        [(sizeof(CacheAlignedDcode) % kDcodeCacheLineBytes == 0) ? 1 : -1];
 
 } } }  // namespace arcsim::isa::arc
 
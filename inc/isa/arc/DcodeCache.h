@@ -14,6 +14,11 @@
 // right shift the PC by 1 before using it to compute an index into the
 // DecodeCache.
 //
+// Tags (i.e. PCs) and LRU state of all sets are kept in a compact array that
+// is separate from the cached Dcode objects, so a lookup only touches the
+// tags of a set and the hot part of the Dcode object it returns (see
+// Dcode.h). The capacity of the cache is given in bytes.
+//
 // =====================================================================
 
 #ifndef INC_ISA_ARC_DCODECACHE_H_
@@ -38,19 +43,25 @@ namespace arcsim {
           kCacheMiss    = 0x2,
         };
 
-        // Entry structure
+        // Entry structure holding the tags of a set, the Dcode objects of way 0
+        // and way 1 of set 'i' are dcode_[2*i] and dcode_[2*i+1]
         struct Entry {
-          uint8                     lru_way_;   // maintain LRU way per Entry
           uint32                    way0_pc_;
-          arcsim::isa::arc::Dcode   way0_inst_;
           uint32                    way1_pc_;
-          arcsim::isa::arc::Dcode   way1_inst_;
+          uint8                     lru_way_;   // maintain LRU way per Entry
         };
 
         DcodeCache();
         ~DcodeCache();
 
-        void construct(uint32 size);
+        // Allocate the largest cache with a power of two number of sets that
+        // fits into 'bytes' bytes
+        void construct(uint32 bytes);
+        
+        // Number of Dcode objects the cache can hold, and the bytes it occupies
+        //
+        uint32 get_capacity() const { return size_ << 1; }
+        uint32 get_bytes()    const { return size_ * kBytesPerSet; }
 
         // -------------------------------------------------------------------------
         // Lookup and return location of Dcode object in cache. Set cache HitType
@@ -60,18 +71,20 @@ namespace arcsim {
         //
         inline arcsim::isa::arc::Dcode* lookup (uint32 pc, HitType*  hit_type)
         { // Least significant bit of PC is always zero so we right shift: (pc >> 1)
-          Entry* const p    = cache_ + ((pc >> 1) & (size_ - 1));
+          const uint32        idx  = (pc >> 1) & (size_ - 1);
+          Entry* const        p    = cache_ + idx;
+          arcsim::isa::arc::CacheAlignedDcode* const ways = dcode_ + (idx << 1);
 
           if (p->way0_pc_ == pc) {                      // hit in WAY 0 ------------
             *hit_type   = kCacheHitWay0;
             p->lru_way_ = kCacheHitWay1;
-            return &(p->way0_inst_);
+            return &(ways[0]);
           }
 
           if (p->way1_pc_ == pc) {                      // hit in WAY 1 ------------
             *hit_type   = kCacheHitWay1;
             p->lru_way_ = kCacheHitWay0;
-            return &(p->way1_inst_);
+            return &(ways[1]);
           }
 
           // CACHE  MISS -----------------------------------------------------------
@@ -81,12 +94,12 @@ namespace arcsim {
           if (p->lru_way_) {
             p->lru_way_ = kCacheHitWay0;
             p->way1_pc_ = pc;        // flag way as valid
-            return &(p->way1_inst_); // return victim
+            return &(ways[1]);       // return victim
           }
           // WAY 0 is least recently used
           p->lru_way_ = kCacheHitWay1;
           p->way0_pc_ = pc;          // flag way as valid
-          return &(p->way0_inst_);   // return victim
+          return &(ways[0]);         // return victim
         }
 
         // ---------------------------------------------------------------------------
@@ -99,6 +112,31 @@ namespace arcsim {
           p->way1_pc_   = kInvalidPcAddress;
         }
 
+        // Purge entries for all PCs within [addr, addr + size). Only the slots
+        // the range maps to are visited, unless the range covers the whole cache.
+        //
+        inline void purge_range (uint32 addr, uint32 size)
+        {
+          const uint32 slots = (size + 1) >> 1;
+          if (slots >= size_) { purge(); return; }
+          for (uint32 i = 0, idx = (addr >> 1); i <= slots; ++i, ++idx) {
+            Entry * const p = cache_ + (idx & (size_ - 1));
+            if ((p->way0_pc_ - addr) < size) { p->way0_pc_ = kInvalidPcAddress; }
+            if ((p->way1_pc_ - addr) < size) { p->way1_pc_ = kInvalidPcAddress; }
+          }
+        }
+
+        // Purge entries for all PCs below 'addr'
+        //
+        inline void purge_below (uint32 addr)
+        {
+          Entry const * const end = cache_end();
+          for (Entry * p = cache_; p < end; ++p) {
+            if (p->way0_pc_ < addr) { p->way0_pc_ = kInvalidPcAddress; }
+            if (p->way1_pc_ < addr) { p->way1_pc_ = kInvalidPcAddress; }
+          }
+        }
+
         inline void purge ()
         {
           Entry const * const end = cache_end();
@@ -110,8 +148,12 @@ namespace arcsim {
         }
 
       private:
-        uint32 size_;        // size of cache
-        Entry* cache_;
+        // Bytes needed per set, i.e. its tags and two Dcode objects
+        static const uint32 kBytesPerSet = sizeof(Entry) + 2 * sizeof(arcsim::isa::arc::CacheAlignedDcode);
+        
+        uint32 size_;        // number of sets
+        Entry* cache_;       // tags of all sets
+        arcsim::isa::arc::CacheAlignedDcode* dcode_;  // Dcode objects of all sets
 
         Entry* cache_end() const { return cache_ + size_; }
 
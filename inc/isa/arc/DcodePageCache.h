@@ -0,0 +1,129 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2011 The University of Edinburgh
+//                        All Rights Reserved
+// =====================================================================
+//
+// Description:
+//
+// Page granular decode cache. Instead of caching individual instructions by
+// PC (see DcodeCache.h), this cache holds a decoded array for each of a
+// small number of recently executed pages. When a page is first executed the
+// processor decodes it in bulk by sweeping linearly from the executed PC to
+// the end of the page (see Processor::predecode_page()), and subsequently
+// instructions are found by indexing into the array of the page with their
+// half-word page offset. Instructions not visited by the sweep (e.g. targets
+// of branches into the middle of LIMM data) are decoded on demand.
+//
+// Pages are mapped directly by virtual page number, a page evicts the page
+// it conflicts with. Each page owns a pool with one Dcode object per slot, so
+// a page can never run out of Dcode objects and evicting a page recycles its
+// pool. The pools are allocated up front, their size is configured with
+// SimOptions::dcode_page_cache_bytes, but only touched as instructions are
+// decoded, so resident memory follows the number of decoded instructions.
+//
+// =====================================================================
+
+#ifndef INC_ISA_ARC_DCODEPAGECACHE_H_
+#define INC_ISA_ARC_DCODEPAGECACHE_H_
+
+#include "api/types.h"
+#include "isa/arc/Dcode.h"
+
+namespace arcsim {
+  namespace isa {
+    namespace arc {
+
+      class DcodePageCache
+      {
+      public:
+        // Decoded page, 'slots' holds one Dcode pointer per half-word of the
+        // page which is 0 if no instruction has been decoded at that offset
+        //
+        struct Page {
+          uint32              page;       // virtual page number
+          Dcode**             slots;
+          CacheAlignedDcode*  pool;       // Dcode objects of this page
+          uint32              pool_used;  // number of Dcode objects in use
+        };
+
+        DcodePageCache();
+        ~DcodePageCache();
+
+        // Allocate cache for pages of 2^'page_bits' bytes holding the largest
+        // power of two number of pages whose pools fit into 'bytes', at least one
+        //
+        void construct(uint32 page_bits, uint32 bytes);
+
+        // ---------------------------------------------------------------------
+        // Lookup page holding 'pc', returns 0 on a miss
+        //
+        inline Page* lookup (uint32 pc)
+        {
+          const uint32 vpage = pc >> page_bits_;
+          Page * const p     = pages_ + (vpage & (size_ - 1));
+          return (p->page == vpage) ? p : 0;
+        }
+
+        // Install empty page for 'pc', evicting the page it conflicts with
+        //
+        Page* insert (uint32 pc);
+
+        // Dcode slot for 'pc' in page 'p'
+        //
+        inline Dcode*& slot (Page* p, uint32 pc)
+        {
+          return p->slots[(pc & page_offset_mask_) >> 1];
+        }
+
+        // Allocate Dcode object from the pool of page 'p'. A Dcode object is
+        // either stored in an empty slot or released right away, hence the pool
+        // holding one object per slot never runs out.
+        //
+        inline Dcode* allocate (Page* p)
+        {
+          return &(p->pool[p->pool_used++]);
+        }
+
+        // Return most recently allocated Dcode object to pool of page 'p'
+        //
+        inline void release (Page* p, Dcode* d)
+        {
+          if (p->pool_used && d == static_cast<Dcode*>(&(p->pool[p->pool_used - 1]))) { --p->pool_used; }
+        }
+
+        // ---------------------------------------------------------------------
+        // Purge methods
+        //
+        void purge ();
+
+        // Purge all pages overlapping [addr, addr + size)
+        //
+        void purge_range (uint32 addr, uint32 size);
+
+        // Purge all pages starting below 'addr'
+        //
+        void purge_below (uint32 addr);
+
+        uint32 get_page_bits() const { return page_bits_; }
+        uint32 get_pages()     const { return size_;      }
+        uint32 get_bytes()     const { return size_ * page_slots_ * sizeof(CacheAlignedDcode); }
+
+      private:
+        uint32              page_bits_;
+        uint32              page_offset_mask_;
+        uint32              page_slots_;   // number of slots per page
+        uint32              size_;         // number of pages
+        Page*               pages_;
+        Dcode**             slots_;        // slots of all pages
+        CacheAlignedDcode*  pool_;         // Dcode objects of all pages
+
+        void clear_page (Page* p);
+
+        DcodePageCache(const DcodePageCache & m);   // DO NOT COPY
+        void operator=(const DcodePageCache &);     // DO NOT ASSIGN
+      };
+
+} } } //  arcsim::isa::arc
+
+#endif /* INC_ISA_ARC_DCODEPAGECACHE_H_ */
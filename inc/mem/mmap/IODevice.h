@@ -20,6 +20,15 @@
 
 #include "mem/MemoryDeviceInterface.h"
 
+#include "sys/cpu/EventQueue.h"
+
+namespace arcsim {
+  namespace util {
+    class CheckpointWriter;
+    class CheckpointReader;
+  }
+}
+
 namespace arcsim {
   namespace mem  {
     namespace mmap {
@@ -34,6 +43,19 @@ namespace arcsim {
         IODevice      (const IODevice & m);  // DO NOT COPY
         void operator=(const IODevice &);    // DO NOT ASSIGN
         
+        // -----------------------------------------------------------------
+        // Timed device events - 'callback' is invoked by the simulation thread
+        // of the processor identified by 'cpu_ctx' once 'delay' cycles (or
+        // instructions if cycle accurate simulation is disabled) have elapsed.
+        // Must only be called from the simulation thread (i.e. from memory
+        // device callbacks or from a previous event callback).
+        //
+        int schedule_event(IocContext cpu_ctx,
+                           arcsim::sys::cpu::EventCallbackInterface* callback,
+                           uint64 delay);
+        int cancel_event  (IocContext cpu_ctx,
+                           arcsim::sys::cpu::EventCallbackInterface* callback);
+        
       public:
         
         IODevice();
@@ -55,6 +77,16 @@ namespace arcsim {
         virtual int dev_start()                                   = 0;
         virtual int dev_stop()                                    = 0;
 
+        // -----------------------------------------------------------------
+        // Checkpointing - devices holding state that is not derived from
+        // their configuration override these methods. Host side resources
+        // (e.g. terminals, windows, audio) are not part of a checkpoint.
+        //
+        virtual void dev_save_checkpoint    (arcsim::util::CheckpointWriter& writer)
+        { /* EMPTY */ }
+        virtual bool dev_restore_checkpoint (arcsim::util::CheckpointReader& reader)
+        { return true; }
+
       };                                                                            
       
 } } } /* namespace arcsim::mem::mmap */
@@ -127,6 +127,12 @@ namespace arcsim {
         int mem_dev_read  (uint32 addr, unsigned char* dest, int size, int agent_id);
         int mem_dev_write (uint32 addr, const unsigned char *data, int size, int agent_id);
 
+        // ---------------------------------------------------------------------
+        // Checkpointing of IRQ vector and ready state
+        //
+        void dev_save_checkpoint    (arcsim::util::CheckpointWriter& writer);
+        bool dev_restore_checkpoint (arcsim::util::CheckpointReader& reader);
+
       };                                          
       
 } } } /* namespace arcsim::mem::mmap */
@@ -23,6 +23,11 @@
 class SystemArch;
 
 namespace arcsim {
+  namespace util {
+    class CheckpointWriter;
+    class CheckpointReader;
+  }
+  
   namespace mem {
     namespace mmap {
 
@@ -50,6 +55,10 @@ namespace arcsim {
         
         bool start_devices();
         bool stop_devices();
+        
+        // Save/restore state of all available devices
+        void save_checkpoint    (arcsim::util::CheckpointWriter& writer);
+        bool restore_checkpoint (arcsim::util::CheckpointReader& reader);
 
       };                                                   
       
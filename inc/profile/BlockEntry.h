@@ -52,6 +52,7 @@ public:
 	uint32 inst_count;          /* number of instructions in the block            */
 	uint32 size_bytes;          /* length of block in bytes of code               */  
 	uint32 interp_count;        /* total number of interpreted executions         */
+	uint32 native_count;        /* number of executions of baseline tier code     */
 
 	const OperatingMode mode;      /* 0 = kernel, 1 = user mode code, in this block  */
 
@@ -16,12 +16,14 @@
 
 #include <map>
 #include <list>
+#include <vector>
 
 #include "api/types.h"
 
 #include "profile/BlockEntry.h"
 
 #include "util/Zone.h"
+#include "util/OpenHashMap.h"
 
 // ---------------------------------------------------------------------
 // FORWARD DECLARATION
@@ -50,20 +52,24 @@ namespace arcsim {
       // Data structures for incremental tracing of dynamic CFG
       //
 
-      // Each BlockProfile contains a map of BlockEntries keyed by addresses
+      // Each BlockProfile contains a map of BlockEntries keyed by physical addresses
       // NOTE: BlockEntry objects are dynamically allocated in processors Zone.
       //
-      std::map<uint32,BlockEntry*>          block_map_;
+      arcsim::util::OpenHashMap<uint32,BlockEntry*>   block_map_;
       
       // number of times page has been touched
       uint32                                interp_count_;
       
-      // Map of basic block nodes: std::map<BlockEntry.virt_addr,BlockEntry*>
-      std::map<uint32,BlockEntry*>          nodes_;
+      // Map of basic block nodes: <BlockEntry.virt_addr,BlockEntry*>
+      arcsim::util::OpenHashMap<uint32,BlockEntry*>   nodes_;
       
-      // Multimap of basic block edges encoding destination blocks for a given
-      // basic block entry address: std::multimap<BlockEntry.virt_addr, BlockEntry*>
-      std::multimap<uint32,BlockEntry*>     edges_;
+      // Map of basic block edges keyed by source and destination block address
+      // (see edge_key()) mapping to the destination BlockEntry.
+      arcsim::util::OpenHashMap<uint64,BlockEntry*>   edges_;
+      
+      static inline uint64 edge_key(uint32 from_addr, uint32 to_addr) {
+        return ((uint64)from_addr << 32) | to_addr;
+      }
       
       // An address that a block can never legally have
       static const uint32                   kInvalidBlockEntryAddress = 1;
@@ -81,6 +87,12 @@ namespace arcsim {
       std::map<sint32,TranslationModule*>   module_map_;
       uint32                                module_count_;
       
+      // Generation of the code on this page, incremented whenever its
+      // translations are invalidated. Regions including blocks of this page
+      // compare it against the generation they were formed with.
+      //
+      uint32                                generation_;
+      
     public:
       // Page Proile frame address
       //
@@ -98,14 +110,14 @@ namespace arcsim {
       inline BlockEntry*
       get_block_entry(uint32 phys_addr, uint32 virt_addr, OperatingMode m, arcsim::util::Zone& zone)
       {
-        if (block_map_.find(phys_addr) != block_map_.end())
-          return block_map_[phys_addr]; // BlockEntry exists, return pointer to it
+        if (BlockEntry** const e = block_map_.find(phys_addr))
+          return *e; // BlockEntry exists, return pointer to it
         
         // Allocation of BlockEntries using C++ placement new with custom Zone allocator
         BlockEntry * entry = new (&zone) BlockEntry(phys_addr, virt_addr, m);
         
         // Insert newly allocated BlockEntry object into block_map_
-        block_map_.insert(std::pair<uint32,BlockEntry*>(phys_addr, entry));    
+        block_map_.insert(phys_addr, entry);
         
         return entry;
       }
@@ -116,9 +128,8 @@ namespace arcsim {
       inline BlockEntry*
       find_block_entry(uint32 addr) const
       {
-        std::map<uint32,BlockEntry*>::const_iterator I = block_map_.find(addr);
-        if (I != block_map_.end())
-          return I->second;
+        if (BlockEntry** const e = block_map_.find(addr))
+          return *e;
         return 0;
       }
       
@@ -143,6 +154,10 @@ namespace arcsim {
         edges_.clear();
       }
       
+      // Record control flow edge leaving this page from the block traced last
+      // for the given interrupt state to 'block' on another page
+      void trace_exit (BlockEntry& block, InterruptState state);
+      
       // Create TranslationModule for this page
       TranslationModule* create_module (SimOptions& sim_opts);
             
@@ -162,6 +177,39 @@ namespace arcsim {
                                         CompilationMode              mode,
                                         TranslationWorkUnit&         work_unit);
       
+      // Create TranslationWorkUnit for a region consisting of the blocks on this
+      // page and the given blocks on other pages (see PhysicalProfile::select_region()),
+      // 'pages' holds the PageProfile of each block in 'off_page_blocks'.
+      bool create_region_work_unit(arcsim::sys::cpu::Processor&     cpu,
+                                   const std::vector<BlockEntry*>&  off_page_blocks,
+                                   const std::vector<PageProfile*>& pages,
+                                   TranslationWorkUnit&             work_unit);
+      
+      // Append destinations of all recorded edges leaving any of the 'from'
+      // blocks (keyed by virtual address) to 'to'
+      void get_successors(const arcsim::util::OpenHashMap<uint32,BlockEntry*>& from,
+                          std::vector<BlockEntry*>&                            to) const;
+      
+      // Traced blocks of the current trace interval, keyed by virtual address
+      const arcsim::util::OpenHashMap<uint32,BlockEntry*>& get_nodes() const { return nodes_; }
+      
+      // Region guard, see PageProfile::generation_
+      //
+      inline uint32        get_generation()     const { return generation_;  }
+      inline const uint32* get_generation_ptr() const { return &generation_; }
+      inline void          invalidate_regions()       { ++generation_;       }
+      
+      // Create TranslationWorkUnit that recompiles a hot baseline TranslationModule
+      // of this page as an optimised TranslationModule.
+      bool create_tier_up_work_unit(arcsim::sys::cpu::Processor& cpu,
+                                    uint32                       threshold,
+                                    TranslationWorkUnit&         work_unit);
+      
+      // Replace baseline TranslationModules by optimised TranslationModules that
+      // finished compilation, and remove optimised TranslationModules that failed
+      // to compile. Returns number of installed modules.
+      int install_optimised_modules();
+      
     private:
       // Create TranslationBlockUnit representing a basic block that is a part of a
       // TranslationWorkUnit.
@@ -170,9 +218,8 @@ namespace arcsim {
                                          TranslationWorkUnit&         work_unit,
                                          TranslationBlockUnit&        block_unit);
       
-      // Retrieve edges from a block entry
-      void get_block_edges(BlockEntry&                 block,
-                           std::list<BlockEntry*>&     dest_blocks) const;
+      // Add all recorded edges to the TranslationBlockUnits of their source blocks
+      void get_block_edges(arcsim::util::OpenHashMap<uint32,TranslationBlockUnit*>& block_units) const;
       
     };
 
@@ -21,6 +21,7 @@
 #define INC_PROFILE_PHYSICALPROFILE_H_
 
 #include <map>
+#include <vector>
 #include <valarray>
 #include <bitset>
 
@@ -29,6 +30,7 @@
 #include "profile/PageProfile.h"
 #include "ioc/ContextItemInterface.h"
 #include "util/Zone.h"
+#include "util/OpenHashMap.h"
 
 namespace arcsim {
   
@@ -67,11 +69,14 @@ namespace arcsim {
       const Type   get_type() const { return arcsim::ioc::ContextItemInterface::kTPhysicalProfile;  };
       
       // ---------------------------------------------------------------------------
-      // Properly construct PhysicalProfile object
+      // Properly construct PhysicalProfile object, control flow edges between
+      // pages are only recorded if 'trace_page_exits' is true (i.e. for mode
+      // 'kCompilationModeRegion')
       //
       void construct (uint32   cache_size,
                       uint32   page_addr_shift,
-                      uint32   page_frame_mask);
+                      uint32   page_frame_mask,
+                      bool     trace_page_exits = false);
       
       // ---------------------------------------------------------------------------
       // Get the PageProfile for the page containing the given physical address.
@@ -88,12 +93,11 @@ namespace arcsim {
           return entry->page_profile_;
         } else {                                   // MISS into PageProfile cache
           PageProfile* profile = 0;
-          std::map<uint32,PageProfile*>::const_iterator I = page_map.find(frame);
-          if (I != page_map.end()) { // PageProfile has already been seen before
-            profile = I->second;
+          if (PageProfile** const p = page_map.find(frame)) { // PageProfile has already been seen before
+            profile = *p;
           } else {                   // PageProfile seen for the first time
             profile = new (&zone) PageProfile (frame);
-            page_map.insert(std::pair<uint32,PageProfile*>(frame, profile));
+            page_map.insert(frame, profile);
           }
           // Update the page cache
           entry->tag_          = frame;
@@ -118,9 +122,8 @@ namespace arcsim {
           return entry->page_profile_;          
         } else {
           // Search for PageProfile in PageProfile map
-          std::map<uint32,PageProfile*>::const_iterator I = page_map.find(frame);        
-          if (I != page_map.end())
-            return I->second;
+          if (PageProfile** const p = page_map.find(frame))
+            return *p;
         }
         return 0; // PageProfile not found
       }
@@ -193,6 +196,10 @@ namespace arcsim {
       //
       int remove_translation (uint32 addr);
       
+      // Remove all translated blocks on the page containing the given address
+      //
+      int remove_page_translations (uint32 addr);
+      
       // Remove absolutely all translations from the simulation
       //
       int remove_translations();
@@ -212,6 +219,48 @@ namespace arcsim {
                            CompilationMode                      mode,
                            uint32                               threshold);
       
+      // ---------------------------------------------------------------------------
+      // Region formation (i.e. kCompilationModeRegion)
+      //
+      
+      // Select blocks on other pages that join the traced blocks of page 'home'
+      // to form a region. Starting from 'home', edges recorded during the last
+      // trace interval are followed to blocks on touched pages, spanning at
+      // most 'max_pages' pages and adding at most 'max_blocks' blocks. 'pages'
+      // receives the PageProfile of each selected block.
+      //
+      void select_region(PageProfile&               home,
+                         uint32                     max_pages,
+                         uint32                     max_blocks,
+                         std::vector<BlockEntry*>&  blocks,
+                         std::vector<PageProfile*>& pages) const;
+      
+      // Region statistics
+      //
+      uint64  get_region_count()            const { return region_count_;       }
+      uint64  get_region_off_page_blocks()  const { return region_block_count_; }
+      uint64  get_region_pages()            const { return region_page_count_;  }
+      
+      // ---------------------------------------------------------------------------
+      // Tiered compilation
+      //
+      
+      // Query how many pages have been profiled
+      //
+      size_t  pages_count() const { return page_map.size(); }
+      
+      // Identify baseline translations that executed at least 'threshold' times
+      // and create TranslationWorkUnits recompiling them as optimised translations
+      //
+      int analyse_tier_up_hotspots(arcsim::sys::cpu::Processor&         cpu,
+                                   std::valarray<TranslationWorkUnit*>& work_units,
+                                   uint32                               threshold);
+      
+      // Replace baseline translations by optimised translations that finished
+      // compilation, returns number of replaced translations
+      //
+      int install_optimised_translations();
+      
       // ---------------------------------------------------------------------------
       // The following methods help to update and query state variables used for
       // tracing block sequences for different interrupt and exception states.
@@ -255,12 +304,22 @@ namespace arcsim {
       PageProfile*                      prev_page_profile_[NUM_INTERRUPT_STATES];
       std::bitset<NUM_INTERRUPT_STATES> trace_sequence_active_;
       
+      // Record control flow edges between pages (see construct())
+      //
+      bool                              trace_page_exits_;
+      
+      // Number of regions formed, off-page blocks they include, and pages they
+      // span in total
+      //
+      uint64                            region_count_;
+      uint64                            region_block_count_;
+      uint64                            region_page_count_;
+      
       // Hash-based cache of recently-accessed physical pages to speed up search
       // for a physical page. Cache lookup is O(1) (i.e. cache hit is O(1)).
-      // Upon a cache miss we consult std::map<page_frame,PageProfile> which
-      // has a worst case search time of O(lg n) (note std::map<> uses balanced
-      // binary tree - Red-Black-Trees - as its backing data-structure) where
-      // n is the number of physical pages.
+      // Upon a cache miss we consult the open-addressing page_map which has an
+      // expected search time of O(1) as well, but may need to probe several
+      // slots.
       //
       static const uint32 kInvalidTag = 0x1;
       struct Entry {
@@ -279,7 +338,7 @@ namespace arcsim {
       // will contain translated code blocks.
       // NOTE: PageProfiles are dynamically allocated in processors Zone.
       //
-      std::map<uint32,PageProfile*>   page_map;
+      arcsim::util::OpenHashMap<uint32,PageProfile*>  page_map;
       
       // Map containg only those PageProfile objects corresponding to
       // physical pages of memory to which an interpretive instruction
@@ -289,7 +348,7 @@ namespace arcsim {
       // corresponding block in page_map. This is to avoid expensive
       // copying of objects.
       //
-      std::map<uint32,PageProfile*>  touched_pages;
+      arcsim::util::OpenHashMap<uint32,PageProfile*>  touched_pages;
       
       // Enclosing context
       //
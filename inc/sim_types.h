@@ -70,6 +70,7 @@ typedef enum {
 typedef enum {
   kCompilationModeBasicBlock   = 0x1,   // Basic block trace mode
   kCompilationModePageControlFlowGraph = 0x2,   // Page trace mode
+  kCompilationModeRegion       = 0x3,   // Region trace mode spanning several pages
 } CompilationMode;
 
 // Format string indices for shared library name mappings
@@ -23,6 +23,13 @@
 
 #include "api/types.h"
 
+namespace arcsim {
+  namespace util {
+    class CheckpointWriter;
+    class CheckpointReader;
+  }
+}
+
 namespace arcsim {
   namespace sys {
     namespace cpu {
@@ -262,6 +269,11 @@ namespace arcsim {
         //
         bool read_aux_register  (uint32 aux_addr, uint32 *data);
         bool write_aux_register (uint32 aux_addr, uint32 aux_data);
+
+        // Save/restore Actionpoint registers and match state
+        //
+        void save_checkpoint    (arcsim::util::CheckpointWriter& writer) const;
+        bool restore_checkpoint (arcsim::util::CheckpointReader& reader);
         
         // Matching methods   --------------------------------------------------
         //
@@ -37,6 +37,11 @@ namespace arcsim {
     class MemoryDeviceInterface;
     class DirectMemoryAccessDeviceInterface;
   }
+  
+  namespace util {
+    class CheckpointWriter;
+    class CheckpointReader;
+  }
     
   namespace sys {
     
@@ -140,6 +145,12 @@ namespace arcsim {
         //
         void create_or_replace_iccm();
         void create_or_replace_dccm();
+        
+        // ------------------------------------------------------------------
+        // Save/restore contents of all instantiated CCMs
+        //
+        void save_checkpoint    (arcsim::util::CheckpointWriter& writer);
+        bool restore_checkpoint (arcsim::util::CheckpointReader& reader);
 
         // ------------------------------------------------------------------
         // Efficiently query CCM availability
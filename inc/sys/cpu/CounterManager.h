@@ -67,6 +67,12 @@ namespace arcsim {
         
         arcsim::util::Counter64& cycle_count;      // Cycle count
         
+        arcsim::util::Counter64& smc_invalidation_count;            // Page invalidations due to code writes
+        arcsim::util::Counter64& smc_discarded_translation_count;   // Translated blocks discarded by them
+        
+        arcsim::util::Counter64& region_transfer_count;     // Transfers to blocks on other pages within regions
+        arcsim::util::Counter64& region_guard_fail_count;   // Such transfers rejected by region guards
+        
       };
 } } } //  arcsim::sys::cpu
 
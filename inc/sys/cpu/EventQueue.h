@@ -0,0 +1,140 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2011 The University of Edinburgh
+//                        All Rights Reserved
+//
+// =====================================================================
+//
+// Description:
+//
+// Per processor queue of timed events. Each event is a deadline in the
+// time base of its processor (i.e. cycles when cycle accurate simulation
+// is enabled, executed instructions otherwise) and a callback that is
+// invoked once that deadline has been reached.
+//
+// The processor keeps the earliest deadline of its queue in
+// 'state.timer_expiry', hence the interpreter and translated code only
+// need a single comparison to find out if any event (ARCompact timers,
+// device deadlines, etc.) is due, and can otherwise run uninterrupted.
+//
+// An EventCallbackInterface instance has at most one pending event,
+// scheduling it again moves its deadline. Events are kept in a binary
+// min-heap, events with equal deadlines are dispatched in the order in
+// which they were scheduled.
+//
+// The queue is NOT thread-safe, it must only be modified from the
+// simulation thread of its processor (i.e. from within memory mapped
+// device callbacks or from within EventCallbackInterface::on_event()).
+//
+// =====================================================================
+
+#ifndef INC_SYS_CPU_EVENTQUEUE_H_
+#define INC_SYS_CPU_EVENTQUEUE_H_
+
+#include <vector>
+
+#include "api/types.h"
+
+namespace arcsim {
+  namespace sys {
+    namespace cpu {
+
+      // -----------------------------------------------------------------------
+      // EventCallbackInterface
+      //
+      class EventCallbackInterface {
+      protected:
+        // Constructor MUST be protected and empty!
+        //
+        EventCallbackInterface()
+        { /* EMPTY */ }
+
+      public:
+        // Destructor MUST be declared AND virtual so all implementations of
+        // this interface can be destroyed correctly.
+        //
+        virtual ~EventCallbackInterface()
+        { /* EMPTY */ }
+
+        // Interface methods ---------------------------------------------------
+        //
+
+        // Method that is executed once the deadline of an event has been
+        // reached, 'now' is the current time of the processor
+        //
+        virtual void on_event(uint64 now) = 0;
+      };
+
+      // -----------------------------------------------------------------------
+      // EventQueue
+      //
+      class EventQueue {
+      public:
+        // Deadline returned if there is no pending event
+        //
+        static const uint64 kNoDeadline = 0xffffffffffffffffULL;
+
+        EventQueue();
+        ~EventQueue();
+
+        // Schedule event for 'callback' at absolute time 'deadline', replacing
+        // any pending event of the same callback
+        //
+        void    schedule(EventCallbackInterface* callback, uint64 deadline);
+
+        // Remove pending event of 'callback', returns true if there was one
+        //
+        bool    cancel(EventCallbackInterface* callback);
+
+        // Remove all pending events
+        //
+        void    clear();
+
+        // Returns true if 'callback' has a pending event
+        //
+        bool    is_scheduled(EventCallbackInterface* callback) const;
+
+        // Invoke callbacks of all events with a deadline at or before 'now' in
+        // deadline order, returns number of invoked callbacks. Events scheduled
+        // by these callbacks for a time at or before 'now' are deferred until
+        // the next call so that a callback can not starve the processor.
+        //
+        uint32  run_due(uint64 now);
+
+        // Earliest pending deadline or kNoDeadline
+        //
+        inline uint64 next_deadline() const
+        {
+          return heap_.empty() ? kNoDeadline : heap_[0].deadline;
+        }
+
+        bool    empty() const { return heap_.empty();  }
+        uint32  size()  const { return heap_.size();   }
+
+      private:
+        struct Event {
+          uint64                  deadline;
+          uint64                  seq;        // tie-breaker for equal deadlines
+          EventCallbackInterface* callback;
+        };
+
+        std::vector<Event>  heap_;
+        uint64              seq_;
+
+        inline bool before(const Event& a, const Event& b) const
+        {
+          return (a.deadline < b.deadline) || (a.deadline == b.deadline && a.seq < b.seq);
+        }
+
+        sint32  find(EventCallbackInterface* callback) const;
+        void    remove_at(uint32 idx);
+        void    sift_up(uint32 idx);
+        void    sift_down(uint32 idx);
+
+        EventQueue(const EventQueue &);       // DO NOT COPY
+        void operator=(const EventQueue &);   // DO NOT ASSIGN
+      };
+
+} } } // arcsim::sys::cpu
+
+#endif  // INC_SYS_CPU_EVENTQUEUE_H_
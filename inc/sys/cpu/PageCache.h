@@ -80,6 +80,11 @@ namespace arcsim {
         //
         uint32 purge(Kind kind, uint32 addr);
         uint32 purge_entry(Kind kind, uint32 const * const entry);
+        
+        // ---------------------------------------------------------------------
+        // Purge all entries caching virtual addresses below 'addr'
+        //
+        uint32 purge_below(Kind kind, uint32 addr);
   
 };
 
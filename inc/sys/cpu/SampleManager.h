@@ -0,0 +1,155 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2011 The University of Edinburgh
+//                        All Rights Reserved
+//
+// =====================================================================
+//
+// Description:
+//
+// Sampled (SMARTS-style) memory hierarchy and pipeline simulation.
+//
+// Instead of routing every instruction through the memory and pipeline
+// models, execution is divided into periods of 'period' instructions. Each
+// period starts with a functional fast-forward phase, followed by a warm-up
+// phase of 'warmup' instructions that updates cache, branch predictor and
+// pipeline state without being measured, and ends with a detailed phase of
+// 'detail' instructions whose cycles and cache misses are recorded as one
+// sample:
+//
+//   |<---------------------------- period ---------------------------->|
+//   +---------------------------------+------------------+-------------+
+//   | FAST-FORWARD (functional, JIT)  | WARM-UP          | DETAIL      |
+//   +---------------------------------+------------------+-------------+
+//
+// The SampleManager only keeps track of phases and samples, the Processor
+// decides how to execute each phase (see Processor::run_sampled()). Sample
+// means are reported together with confidence intervals based on the normal
+// approximation of the sampling distribution.
+//
+// =====================================================================
+
+#ifndef INC_SYS_CPU_SAMPLEMANAGER_H_
+#define INC_SYS_CPU_SAMPLEMANAGER_H_
+
+#include "api/types.h"
+
+namespace arcsim {
+  namespace sys {
+    namespace cpu {
+
+      // -----------------------------------------------------------------------
+      // Running mean and variance of a sampled metric (Welford's method)
+      //
+      class SampleStatistic {
+      public:
+        SampleStatistic()
+        : n_(0), mean_(0.0), m2_(0.0)
+        { /* EMPTY */ }
+
+        void    add(double x);
+        void    clear()              { n_ = 0; mean_ = 0.0; m2_ = 0.0; }
+
+        uint64  get_count()    const { return n_;    }
+        double  get_mean()     const { return mean_; }
+        double  get_variance() const { return (n_ > 1) ? (m2_ / (n_ - 1)) : 0.0; }
+
+        // Half-width of the confidence interval of the mean for the given
+        // standard score 'z' (e.g. 1.96 for a 95% confidence level)
+        //
+        double  get_confidence(double z) const;
+
+      private:
+        uint64  n_;
+        double  mean_;
+        double  m2_;
+      };
+
+      // -----------------------------------------------------------------------
+      // Processor counters captured at the start and end of a detailed phase
+      //
+      struct SampleCounters {
+        uint64  insts;
+        uint64  cycles;
+        uint64  icache_accesses;
+        uint64  icache_misses;
+        uint64  dcache_accesses;
+        uint64  dcache_misses;
+      };
+
+      // -----------------------------------------------------------------------
+      // SampleManager
+      //
+      class SampleManager {
+      public:
+        enum Phase {
+          kPhaseFastForward,
+          kPhaseWarmup,
+          kPhaseDetail
+        };
+
+        SampleManager();
+
+        // Configure sampling, a 'period' of zero disables sampling. Returns
+        // false if the parameters are inconsistent.
+        //
+        bool    configure(uint64 period, uint64 warmup, uint64 detail);
+
+        // Start a new period at instruction count 'now'
+        //
+        void    begin(uint64 now);
+
+        // Advance to the next phase at instruction count 'now', returns the
+        // phase that has been entered
+        //
+        Phase   next_phase(uint64 now);
+
+        // Record a sample from the counters captured when entering and when
+        // leaving a detailed phase
+        //
+        void    add_sample(const SampleCounters& start, const SampleCounters& end);
+
+        // Fast-forward CPI estimate (i.e. mean CPI of all samples so far)
+        //
+        double  get_estimated_cpi() const;
+
+        inline bool   is_enabled()         const { return period_ != 0; }
+        inline bool   is_started()         const { return started_;     }
+        inline bool   is_fast_forwarding() const { return phase_ == kPhaseFastForward; }
+        inline Phase  get_phase()          const { return phase_; }
+
+        // Instruction count at which the current phase ends
+        //
+        inline uint64 get_phase_end()      const { return phase_end_; }
+
+        // Print sample statistics, 'has_cycles' selects whether CPI is reported
+        //
+        void    print_stats(bool has_cycles) const;
+
+      private:
+        uint64  period_;
+        uint64  warmup_;
+        uint64  detail_;
+
+        bool    started_;
+        Phase   phase_;
+        uint64  phase_end_;
+
+        // Instructions executed in each kind of phase
+        //
+        uint64  ff_insts_;
+        uint64  warmup_insts_;
+        uint64  detail_insts_;
+        uint64  phase_start_;
+
+        SampleStatistic cpi_;
+        SampleStatistic icache_miss_rate_;
+        SampleStatistic dcache_miss_rate_;
+
+        SampleManager(const SampleManager &);     // DO NOT COPY
+        void operator=(const SampleManager &);    // DO NOT ASSIGN
+      };
+
+} } } // arcsim::sys::cpu
+
+#endif  // INC_SYS_CPU_SAMPLEMANAGER_H_
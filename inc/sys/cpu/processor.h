@@ -148,6 +148,7 @@
 
 #include <map>
 #include <stack>
+#include <vector>
 #include <sstream>
 
 #include "define.h"
@@ -163,6 +164,7 @@
 #include "arch/CoreArch.h"
 
 #include "isa/arc/DcodeCache.h"
+#include "isa/arc/DcodePageCache.h"
 
 
 #include "sys/cpu/state.h"
@@ -170,6 +172,8 @@
 #include "sys/cpu/CounterManager.h"
 #include "sys/cpu/EiaExtensionManager.h"
 #include "sys/cpu/CcmManager.h"
+#include "sys/cpu/EventQueue.h"
+#include "sys/cpu/SampleManager.h"
 #include "sys/mmu/Mmu.h"
 #include "sys/aps/Actionpoints.h"
 #include "sys/smt/Smart.h"
@@ -183,6 +187,8 @@
 #include "util/Log.h"
 #include "util/Zone.h"
 
+#include "concurrent/Mutex.h"
+
 #include "util/TraceStream.h"
 #include "util/system/Timer.h"
 
@@ -232,6 +238,10 @@ namespace arcsim {
   
   namespace util {
     class CounterTimer;
+    class BinaryTraceWriter;
+    class BinaryTraceReader;
+    class CheckpointWriter;
+    class CheckpointReader;
   }
 }
 
@@ -255,6 +265,7 @@ namespace arcsim {
     namespace cpu {
       
 class Processor : public arcsim::util::system::TimerCallbackInterface,
+                  public arcsim::sys::cpu::EventCallbackInterface,
                   public arcsim::ioc::ContextItemInterface
 {
 public:
@@ -274,6 +285,12 @@ private:
   arcsim::isa::arc::DcodeCache* dcode_cache;                       // pointer to currently active decode cache
   arcsim::isa::arc::DcodeCache  dcode_caches[NUM_OPERATING_MODES]; // decode caches for each operating mode
   
+  // Page granular decode caches for each operating mode, only used with
+  // SimOptions::dcode_page (the dcode_page_cache pointer is 0 otherwise)
+  //
+  arcsim::isa::arc::DcodePageCache* dcode_page_cache;
+  arcsim::isa::arc::DcodePageCache  dcode_page_caches[NUM_OPERATING_MODES];
+  
   arcsim::isa::arc::Dcode*      inst;       // pointer to current decoded instruction
   arcsim::isa::arc::Dcode       inst_dslot; // dcode instance used for decoding 
                                             // following dslot instruction
@@ -293,6 +310,42 @@ private:
   // variable. Upon reaching a safe point we then remove the given translations.
   //
   std::stack<uint32>  invalid_translations_stack;
+  
+  // Flag checked by the run loops to find out if simulation should stop. By
+  // default this points to SimOptions::halt_simulation. During parallel
+  // multi-core simulation each processor gets its own flag so that a halting
+  // core does not cut short the quantum of its siblings. The flag may be
+  // written by other host threads, hence it is volatile and MUST be written
+  // via set_halt_simulation().
+  //
+  volatile int*       halt_simulation_;
+  
+  inline void set_halt_simulation (bool halt) {
+    __sync_synchronize();
+    *halt_simulation_ = halt;
+    __sync_synchronize();
+  }
+  
+  // Processors share memory, but every processor has its own dcode, page and
+  // translation caches. When a processor writes to a page holding code, the
+  // written physical ranges are posted to all other processors, which discard
+  // the code they cached for these ranges once they reach their next safe-point
+  // (@see handle_remote_invalidations()). Processors simulated on other host
+  // threads post requests concurrently, hence they are protected by
+  // 'remote_inval_mtx_'. 'remote_flush_write_' requests that the write page
+  // cache is flushed because another processor started executing one of the
+  // pages it may hold.
+  //
+  arcsim::concurrent::Mutex                   remote_inval_mtx_;
+  std::vector<std::pair<uint32,uint32> >      remote_inval_ranges_;
+  bool                                        remote_flush_write_;
+  
+  // Discard decoded and translated code of this processor for all pages within
+  // a physical memory range. If 'x_cached_only' is set, pages that are not
+  // `cached for execution' are skipped. Returns the number of translated blocks
+  // that have been discarded.
+  //
+  int purge_exec_pages(uint32 phys_addr, uint32 size, bool x_cached_only);
 
   // Free union between single-precision floating-point and uint32.
   // This is used to allow casting between float and uint32
@@ -336,6 +389,21 @@ private:
                                          arcsim::isa::arc::Dcode* &iptr,
                                          uint32                   &efa,
                                          bool                     in_dslot);
+  
+  // Fetch and Decode an instruction using the page granular DcodePageCache,
+  // pre-decoding the page holding 'pc' when it is executed first.
+  //
+  // ATTENTION: THIS METHOD IS NOT THREAD SAFE AND SHOULD ONLY BE CALLED BY THE
+  //            PROCESSORS MAIN SIMULATION LOOP!
+  //
+  uint32 decode_instruction_using_page_cache (uint32                   pc,
+                                              arcsim::isa::arc::Dcode* &iptr,
+                                              uint32                   &efa,
+                                              bool                     in_dslot);
+  
+  // Pre-decode 'page' by a linear sweep from 'pc' to the end of the page
+  //
+  void predecode_page (arcsim::isa::arc::DcodePageCache::Page* page, uint32 pc);
     
 #ifdef CYCLE_ACC_SIM
   // Update pipeline timing model in cycle accurate mode.
@@ -366,13 +434,33 @@ private:
   //
   bool step_single (UpdatePacket*, bool);  // Do one inst, collect deltas
   bool step_single_fast ();                // Do one inst, no visibility or EIA
+  bool step_single_plain ();               // Do one inst, no IPT, APs, or EIA
   bool step_block ();                      // Do one basic block of code
   
+  // JIT compiled and sampled simulation modes, called by run()
+  //
+  bool run_jit     (uint32 num_blocks);
+  bool run_sampled (uint32 num_blocks);
+  
+  // Capture counters used for sampled simulation statistics
+  //
+  void get_sample_counters (SampleCounters& counters);
+  
+  // Returns true if step_single_plain() may be used in place of step_single_fast()
+  //
+  bool is_plain_step_enabled ();
+  
   // ---------------------------------------------------------------------------
   // Dispatch frequently executed traces to JIT compilation worker
   //
   inline int dispatch_hot_traces();
   
+  // ---------------------------------------------------------------------------
+  // Install optimised translations and dispatch hot baseline translations for
+  // recompilation (i.e. tiered JIT compilation)
+  //
+  int tier_up_translations();
+  
   
   // ---------------------------------------------------------------------------
   // This method checks the value in state.pending_actions, and performs the
@@ -491,6 +579,10 @@ public:
   // Tracestream used for dispatching each traced instruction
   //  
   arcsim::util::TraceStream TS; // TS - TraceStream
+  
+  // Binary trace writer replacing IS and TS if binary tracing is enabled
+  //
+  arcsim::util::BinaryTraceWriter* BT; // BT - BinaryTrace
       
   // ---------------------------------------------------------------------------
   // Tracing/Profiling related members
@@ -527,6 +619,17 @@ public:
   sint64                       vcount0, vcount1;
   uint64                       timer_sync_time;
   
+  // Timed events (ARCompact timer expiry, device deadlines), the earliest
+  // deadline is mirrored in 'state.timer_expiry'
+  //
+  EventQueue                   events_;
+  
+  // Sampled simulation phases and statistics, counters captured at the start
+  // of the current detailed phase
+  //
+  SampleManager                sampler_;
+  SampleCounters               sample_start_;
+  
   uint64                       rtc_disabled_ticks;
   uint64                       last_rtc_disable;
   uint64                       last_rtc_clear;
@@ -594,6 +697,13 @@ public:
   void reset ();          // reset this processor
   void system_reset ();   // reset at the system level
 
+  // ---------------------------------------------------------------------------
+  // Save architectural state to, and restore it from a checkpoint
+  // (processor-checkpoint.cpp)
+  //
+  void save_checkpoint    (arcsim::util::CheckpointWriter& writer);
+  bool restore_checkpoint (arcsim::util::CheckpointReader& reader);
+
   // ---------------------------------------------------------------------------
   // Simulation wrapper methods
   //
@@ -651,13 +761,29 @@ public:
   //
   arcsim::isa::arc::Dcode const * const current_interpreted_inst() const { return inst; }
   
+  // ---------------------------------------------------------------------------
+  // Memory model and pipeline are only updated if memory model simulation is
+  // enabled and a sampled simulation is not fast-forwarding
+  //
+  inline bool is_memory_model_active () const {
+    return sim_opts.memory_sim && !sampler_.is_fast_forwarding();
+  }
+  
   // ---------------------------------------------------------------------------
   // Processor run methods
   //
-  bool run         (uint32 num_blocks);    // Simulate for num_blocks basic blocks (JIT)
+  bool run         (uint32 num_blocks);    // Simulate for num_blocks basic blocks (JIT or sampled)
   bool run_notrace (uint32 num_insts);     // Simulate for num_insts (Normal)
   bool run_trace   (uint32 num_insts, UpdatePacket* upkt = NULL);  // Simulate for num_insts (instruction tracing)
 
+  // ---------------------------------------------------------------------------
+  // Redirect halt requests of this processor to 'flag'. Passing NULL restores
+  // the default behaviour where halt requests go to SimOptions::halt_simulation.
+  //
+  void set_halt_flag (volatile int* flag) {
+    halt_simulation_ = (flag != NULL) ? flag : &sim_opts.halt_simulation;
+  }
+  
   // ---------------------------------------------------------------------------
   // Run-time emulators and complex instruction interpretation (processor.cpp)
   //
@@ -747,6 +873,30 @@ public:
   uint32  time_to_expiry();
   uint32  timer_advance_cycles();
 
+  // ---------------------------------------------------------------------------
+  // Event queue methods (processor-timers.cpp)
+  //
+  
+  // Callback method executed when the ARCompact timer event is due
+  //
+  void    on_event(uint64 now);
+  
+  // Current time in the time base of the event queue (i.e. cycles if cycle
+  // accurate simulation is enabled, executed instructions otherwise)
+  //
+  uint64  get_event_time () const;
+  
+  // Schedule 'callback' to be invoked 'delay' time units from now, replacing
+  // any pending event of 'callback'. Cancel pending event of 'callback'.
+  //
+  void    schedule_event (EventCallbackInterface* callback, uint64 delay);
+  void    cancel_event   (EventCallbackInterface* callback);
+  
+  // Invoke callbacks of all due events and update 'state.timer_expiry'
+  //
+  void    dispatch_events ();
+  void    update_event_deadline ();
+
   // Performance counting and display functions (processor.cpp)
   //
   uint64 instructions  () const;
@@ -778,6 +928,29 @@ public:
   
   void trace_lr         (uint32 addr, uint32 data, int success);
   void trace_sr         (uint32 addr, uint32 data, int success);
+  
+  // Render all records of the current chunk of a binary trace in textual
+  // trace format, returns false if the chunk is corrupt
+  //
+  bool trace_render     (arcsim::util::BinaryTraceReader& reader);
+  
+private:
+  // Textual trace formatting shared by live tracing and trace_render()
+  //
+  void trace_fmt_emit        (bool native, bool has_cycles, uint64 cycles);
+  void trace_fmt_commit      (bool is_commit);
+  void trace_fmt_instruction (uint32 pc, uint32 inst, uint32 limm, uint32 flags, uint32 sym_pc);
+  void trace_fmt_write_back  (const char* port, int wa, uint32 wdata);
+  void trace_fmt_exception   (const char* message, const uint32* regs);
+  void trace_fmt_rtie        (uint32 pc, uint32 status32, uint32 bta);
+  void trace_fmt_mul64_inst  (uint32 mlo, uint32 mmid, uint32 mhi);
+  void trace_fmt_loop_back   (uint32 pc);
+  void trace_fmt_loop_count  (uint32 count);
+  void trace_fmt_loop_inst   (int taken, uint32 target, uint32 lp_start, uint32 lp_end, uint32 lp_count);
+  void trace_fmt_load_store  (int fmt, uint32 addr, uint32 data);
+  void trace_fmt_aux         (bool is_write, uint32 addr, uint32 data, int success);
+  
+public:
 
   // ---------------------------------------------------------------------------
   // Functions to support rudimentary debugger (processor.cpp)
@@ -794,9 +967,10 @@ public:
   // Performance-critical methods for manipulating a PendingActions
   //
   
-  // Set a specific pending action
+  // Set a specific pending action. Other processors and host threads may set
+  // pending actions concurrently, hence they are modified atomically.
   inline void set_pending_action(PendingActionKind action) {
-    state.pending_actions |= action;
+    __sync_fetch_and_or(&state.pending_actions, static_cast<uint32>(action));
   }
   
   // Check if any actions are pending
@@ -818,7 +992,7 @@ public:
   inline void
   clear_pending_action(PendingActionKind action) {
     if (action != kPendingAction_NONE) {
-      state.pending_actions &= ~action;
+      __sync_fetch_and_and(&state.pending_actions, ~static_cast<uint32>(action));
     }
   }
   
@@ -864,6 +1038,18 @@ public:
     return system.get_host_page(addr);
   }
   
+  // Retrieve BlockData object for page without allocating system memory,
+  // returns '0' if the page has never been accessed
+  //
+  inline arcsim::sys::mem::BlockData*
+  find_host_page(uint32 addr)
+  {
+    if (ccm_mgr_->in_ccm_mapped_region(addr)) {
+      return ccm_mgr_->get_host_page(addr);
+    }
+    return system.find_host_page(addr);
+  }
+  
   // ---------------------------------------------------------------------------
   // Block wise read and write of memory at processor level. Note that block wise
   // read/write uses physical addresses as the start address of a block.
@@ -880,6 +1066,26 @@ public:
                                   uint8 const * buf,
                                   int           agent_id);
   
+  // Invalidate decoded and translated code for all pages within a physical
+  // memory range that contain executable code, on this and all other
+  // processors. Returns the number of translated blocks of this processor
+  // that have been discarded.
+  //
+  int invalidate_exec_pages(uint32 phys_addr, uint32 size);
+  
+  // Discard decoded and translated code for a physical memory range on all
+  // other processors, or make them flush their write page caches
+  //
+  void broadcast_exec_invalidation(uint32 phys_addr, uint32 size);
+  void broadcast_write_cache_flush();
+  
+  // Requests posted by other processors, they are handled by this processor
+  // at its next safe-point
+  //
+  void post_remote_invalidation(uint32 phys_addr, uint32 size);
+  void post_remote_write_cache_flush();
+  void handle_remote_invalidations();
+  
   
   // ---------------------------------------------------------------------------
   // Returns false if stack checking is enabled and we access an illegal memory area
@@ -1243,19 +1449,62 @@ public:
   inline void purge_dcode_cache () {
     for (uint32 i = 0; i < NUM_OPERATING_MODES; ++i) {
       dcode_caches[i].purge();
+      if (dcode_page_cache) { dcode_page_caches[i].purge(); }
+    }
+  }
+
+  inline void purge_dcode_cache_below (uint32 pc) {
+    for (uint32 i = 0; i < NUM_OPERATING_MODES; ++i) {
+      dcode_caches[i].purge_below(pc);
+      if (dcode_page_cache) { dcode_page_caches[i].purge_below(pc); }
     }
   }
 
   inline void purge_dcode_entry (uint32 pc) {
     for (uint32 i = 0; i < NUM_OPERATING_MODES; ++i) {
       dcode_caches[i].purge_entry(pc);
+      if (dcode_page_cache) { dcode_page_caches[i].purge_range(pc, 2); }
     }
   }
 
+  inline void purge_dcode_range (uint32 pc, uint32 size) {
+    for (uint32 i = 0; i < NUM_OPERATING_MODES; ++i) {
+      dcode_caches[i].purge_range(pc, size);
+      if (dcode_page_cache) { dcode_page_caches[i].purge_range(pc, size); }
+    }
+  }
+
+  inline const TranslationCache& get_translation_cache () const {
+    return trans_cache;
+  }
+
+  // The translation cache epoch is incremented whenever the translation cache
+  // is purged entirely (e.g. when the MMU mapping changes). Region translations
+  // check it before entering blocks on other pages (see kCompilationModeRegion).
+  //
+  inline uint32        get_trans_cache_epoch ()     const { return state.trans_cache_epoch;  }
+
   inline void purge_translation_cache () {
     // only purge translation cache if in fast mode
     if (sim_opts.fast) {
       trans_cache.purge();
+      ++state.trans_cache_epoch;
+    }
+  }
+  
+  // Purge translations for addresses below 'addr', the epoch still changes as
+  // region guards can not tell which addresses their transfers depend on
+  //
+  inline void purge_translation_cache_below (uint32 addr) {
+    if (sim_opts.fast) {
+      trans_cache.purge_below(addr);
+      ++state.trans_cache_epoch;
+    }
+  }
+  
+  inline void purge_translation_cache_range (uint32 addr, uint32 size) {
+    if (sim_opts.fast) {
+      trans_cache.purge_range(addr, size);
     }
   }
   
@@ -1268,6 +1517,12 @@ public:
   {
     return page_cache.purge(page_kind, addr);
   }
+  
+  inline uint32 purge_page_cache_below(arcsim::sys::cpu::PageCache::Kind page_kind,
+                                       uint32                                 addr)
+  {
+    return page_cache.purge_below(page_kind, addr);
+  }
 
 };
 
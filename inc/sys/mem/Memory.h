@@ -18,6 +18,23 @@
 //
 //  It is also possible to perform block wise memory reads and writes. 
 //
+//  BlockData objects are found through a flat two-level page table indexed
+//  by page frame number. Lookups of existing pages do not lock, only the
+//  allocation of new pages is synchronised.
+//
+//  If 'SimOptions::mem_sparse' is set, RAM pages are not allocated from the
+//  block pool but live at their physical address within one sparse host
+//  reservation of the complete 32-bit physical address space. Host memory
+//  is only committed for pages that are touched, and the host address of a
+//  RAM page is 'get_sparse_base() + page_frame'.
+//
+//  Sparse memory additionally keeps a direct access permission byte for each
+//  page frame (@see get_direct_perm()). Translated code may access a page by
+//  host address, bypassing page caches, while its permission allows this.
+//  Only plain RAM pages are ever given permissions, and pages cached for
+//  execution lose their write permission so that writes to them still take
+//  the slow path that detects self-modifying code.
+//
 // =====================================================================
 
 #ifndef INC_MEMORY_MEMORY_H_
@@ -42,6 +59,8 @@ namespace arcsim {
   
   namespace util {
     class CodeBuffer;
+    class CheckpointWriter;
+    class CheckpointReader;
   }
   
   namespace sys  {
@@ -59,19 +78,29 @@ namespace arcsim {
       {
       private:
         // ------------------------------------------------------------------
-        // Map holding all physical pages of memory. Access to this structure
-        // MUST be synchronised for multi-core processor simulation. The good
-        // thing is that this structure is ONLY ever modified in 'get_host_page'
-        // when a page is created for the first time on demand. 
-        //  
-        std::map<uint32,BlockData*>                    mem_blocks_;
+        // Two-level page table holding all physical pages of memory. The page
+        // directory has an entry for every 2^kLogTwoPageTableSize page frames,
+        // page tables are allocated on demand. Entries are ONLY ever set in
+        // 'get_host_page' when a page is created for the first time, which
+        // MUST be synchronised by 'mem_blocks_mtx_' for multi-core processor
+        // simulation. Entries are published after the BlockData object they
+        // point to is complete, hence lookups need no lock.
+        //
+        static const uint32  kLogTwoPageTableSize = 10;
+        
+        BlockData** *                                  page_dir_;
+        uint32                                         page_dir_size_;
         arcsim::concurrent::Mutex                      mem_blocks_mtx_;
 
         // Set of all memory devices that are registered, and array of memory
-        // devices sorted by start address of memory device range
+        // devices sorted by start address of memory device range. Devices are
+        // shared by all processors, hence the array holds proxies that serialise
+        // every call into a device with 'mem_devices_mtx_' so that processors
+        // simulated on their own host threads may access devices concurrently.
         //
         std::set<arcsim::mem::MemoryDeviceInterface*>     mem_devices_set_;
         std::vector<arcsim::mem::MemoryDeviceInterface*>  mem_devices_array_;
+        arcsim::concurrent::Mutex                         mem_devices_mtx_;
 
         // Simulated system and page Architecture Configuration
         //
@@ -86,6 +115,39 @@ namespace arcsim {
         uint32 *             block_pool_ptr_;
         std::stack<uint32*>  block_pool_stack_;
         
+        // Copy-on-write mappings of snapshot files backing restored pages
+        //
+        std::vector<std::pair<void*,size_t> > snapshot_mappings_;
+        
+        // Sparse reservation of the physical address space backing RAM pages
+        // if 'SimOptions::mem_sparse' is set, '0' otherwise
+        //
+        uint8 *              sparse_base_;
+        uint8 *              direct_perm_;   // direct access permissions per page frame
+        
+        // Lookup BlockData of page frame number 'frame_num' without locking,
+        // returns '0' if the page has not been allocated yet
+        //
+        inline BlockData* lookup_page (uint32 frame_num) const
+        {
+          BlockData** const table = page_dir_[frame_num >> kLogTwoPageTableSize];
+          return table ? table[frame_num & ((1U << kLogTwoPageTableSize) - 1)] : 0;
+        }
+        
+        // Insert 'block' into page table, MUST be called with 'mem_blocks_mtx_'
+        // held. Returns previous entry.
+        //
+        BlockData* set_page (uint32 frame_num, BlockData* block);
+        
+        // Retrieve all allocated pages in order of their page frames
+        //
+        void get_pages (std::vector<BlockData*>& pages) const;
+        
+        // Reserve sparse physical address space, returns false if the host
+        // can not reserve it
+        //
+        bool reserve_sparse_memory();
+        
         // This parameter controls how many elements will be allocated in a pool
         // 2^(kLogTwoBlockPoolSize). If a block is '8K' large and kLogTwoBlockPoolSize
         // is set to '5', enough space to hold 2^5 * 8K blocks (i.e. 32 * 8K = 256K)
@@ -93,16 +155,22 @@ namespace arcsim {
         //
         static const uint32  kLogTwoBlockPoolSize = 5;
         
-        // Re-quest new block from block pool. If the pool has been drained it
-        // will be re-filled on demand.
+        // Re-quest new block for 'page_frame' from block pool, or from the
+        // sparse reservation. If the pool has been drained it will be re-filled
+        // on demand.
         //
-        uint32 * new_block();
+        uint32 * new_block(uint32 page_frame);
         
         // Refills block pool when (1) this class is instantiated, and (2) as a
         // side-effect of a call to 'new_block()'. DO NOT CALL THIS METHOD
         // directly without being abosolutely sure that you know what you are doing!
         //
         uint32   refill_block_pool();
+        
+        // Frees all block pool memory and unmaps all snapshot files. MUST only
+        // be called when no page refers to either of them any more.
+        //
+        void     release_block_pool();
                 
       public:
         // -------------------------------------------------------------------
@@ -118,10 +186,52 @@ namespace arcsim {
         //
         BlockData* get_host_page (uint32 phys_byte_addr);
         
+        // Retrieve block of 'memory' for a given physical address without
+        // allocating it, returns '0' if it has never been accessed
+        //
+        inline BlockData* find_host_page (uint32 phys_byte_addr) const
+        {
+          return lookup_page(phys_byte_addr >> page_arch.byte_index_shift);
+        }
+        
         // Retrieve pointer to block of host memory modelling processor memory.
         // Be carefull not to call this on MemoryDevices!
         //
         uint32 * get_host_page_ptr(uint32 addr);
+        
+        // Host address of physical address '0' in the sparse reservation, or
+        // '0' if memory is not sparse. Only valid for RAM pages.
+        //
+        inline uint8 * get_sparse_base() const { return sparse_base_; }
+        
+        // -------------------------------------------------------------------
+        // Direct access permissions of page frames in sparse memory
+        //
+        enum DirectAccess {
+          kDirectRead  = 0x1,
+          kDirectWrite = 0x2
+        };
+        
+        // Permission array indexed by page frame number, '0' if memory is not
+        // sparse
+        //
+        inline uint8 * get_direct_perm() const { return direct_perm_; }
+        
+        // Grant or revoke direct write permission of RAM page 'page_frame'
+        //
+        inline void set_direct_write(uint32 page_frame, bool enable)
+        {
+          if (direct_perm_) {
+            uint8& perm = direct_perm_[page_frame >> page_arch.byte_index_shift];
+            if (perm & kDirectRead) { perm = enable ? (kDirectRead | kDirectWrite) : kDirectRead; }
+          }
+        }
+        
+        // Returns true if code generated for 'arch' may access memory directly,
+        // i.e. memory is sparse and virtual addresses are physical RAM addresses
+        // that are not watched by Actionpoints
+        //
+        bool is_direct_access_enabled(const CoreArch& arch) const;
 
         
         // -------------------------------------------------------------------
@@ -207,6 +317,14 @@ namespace arcsim {
         // Method that resets allocated memory contents to given values (i.e. '0')
         //
         void clear();
+        
+        // -------------------------------------------------------------------
+        // Save RAM pages to checkpoint, and replace all RAM pages by the
+        // copy-on-write mapped pages of a checkpoint. Memory devices are
+        // not affected.
+        //
+        bool save_checkpoint   (arcsim::util::CheckpointWriter& writer);
+        bool restore_checkpoint(arcsim::util::CheckpointReader& reader);
 
       };
 
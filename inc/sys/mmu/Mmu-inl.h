@@ -33,6 +33,11 @@ namespace arcsim {
         return pd1 & pd_fmt_->perm_mask_;
       }
 
+      inline uint32
+      Mmu::soft_tlb_index(uint32 addr) const {
+        return (addr >> pd_fmt_->page_size_log2_) & (kSoftTLB_size - 1);
+      }
+
       inline uint32
       Mmu::get_valid_global_search_key(uint32 vpn) const {
         return vpn | valid_global_;
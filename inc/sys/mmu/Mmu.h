@@ -64,6 +64,13 @@
 
 class MmuArch;
 
+namespace arcsim {
+  namespace util {
+    class CheckpointWriter;
+    class CheckpointReader;
+  }
+}
+
 namespace arcsim {
   namespace sys {
     namespace cpu {
@@ -156,6 +163,10 @@ namespace arcsim {
         bool    translate_rmw   (uint32 addr, bool mode, uint32& phys_addr);
         uint32  translate_exec  (uint32 addr, bool mode, uint32& phys_addr);
 
+        // Save/restore TLB contents and MMU enable/ASID state
+        void    save_checkpoint    (arcsim::util::CheckpointWriter& writer) const;
+        bool    restore_checkpoint (arcsim::util::CheckpointReader& reader);
+
       private:
 
         struct EntryTLB {  // TLB entry structure
@@ -180,6 +191,15 @@ namespace arcsim {
         EntryTLB    uitlb_[kuITLB_size];
         EntryTLB    udtlb_[kuDTLB_size];
 
+        // Host-side software TLB caching JTLB hits for data accesses. It is
+        // direct-mapped by virtual page number and each entry holds a copy of
+        // the matching JTLB entry, whose PD0 includes the ASID (or global bit).
+        // Entries are therefore matched with the same search keys as the JTLB
+        // and survive ASID switches, they only need invalidating when the JTLB
+        // entry they were copied from changes.
+        static const uint32 kSoftTLB_size = 256;
+        EntryTLB    soft_tlb_[kSoftTLB_size];
+
         // JTLB dynamically allocated and indexed as jTLB[SET][WAY]
         EntryTLB**  jtlb_;
         uint32      jtlb_sets_;
@@ -232,6 +252,11 @@ namespace arcsim {
         void    tlb_get_index ();
         void    tlb_probe ();
         void    utlb_clear ();
+
+        // Software TLB maintenance
+        inline uint32 soft_tlb_index(uint32 addr) const;
+        void    soft_tlb_clear ();
+        void    soft_tlb_purge (uint32 pd0);
       };
 
 } } } // arcsim::sys::cpu
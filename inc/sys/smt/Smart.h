@@ -20,6 +20,13 @@
 
 #include "api/types.h"
 
+namespace arcsim {
+  namespace util {
+    class CheckpointWriter;
+    class CheckpointReader;
+  }
+}
+
 namespace arcsim {
   namespace sys {
     namespace cpu {
@@ -130,6 +137,11 @@ namespace arcsim {
         void push_branch    (uint32 br_src, uint32 br_dst);
         void push_exception (uint32 ex_src, uint32 ex_dst);
         
+        // Checkpoint methods   ------------------------------------------------
+        //
+        void save_checkpoint    (arcsim::util::CheckpointWriter& writer) const;
+        bool restore_checkpoint (arcsim::util::CheckpointReader& reader);
+        
         // Inline methods, on fast path   --------------------------------------
         //
         inline bool enabled ()       const  { return is_enabled;           }
@@ -38,6 +38,8 @@
 namespace arcsim {
   namespace util {
     class SymbolTable;
+    class CheckpointWriter;
+    class CheckpointReader;
   }
   
   namespace mem {
@@ -64,6 +66,14 @@ struct UpdatePacket;
 class System
 {
 public:
+  // Simulation modes used to drive processors
+  //
+  enum RunMode {
+    kRunModeFast,     // JIT compiled simulation       (Processor::run)
+    kRunModeNoTrace,  // interpretive simulation        (Processor::run_notrace)
+    kRunModeTrace     // interpretive tracing simulation (Processor::run_trace)
+  };
+  
   // Unique autogenerated system id
   //
   const uint32          id;
@@ -119,6 +129,19 @@ public:
   //
   void reset_to_initial_state(bool purge_translations);
   
+  // Save complete simulated system state to snapshot file 'path', and restore
+  // it from such a file (see util/Checkpoint.h). The target must have been
+  // loaded into a system of identical configuration before restoring.
+  //
+  bool save_checkpoint    (const char* path);
+  bool restore_checkpoint (const char* path);
+  
+  // Copy state of this system into 'count' systems of identical configuration,
+  // all of which share one copy-on-write snapshot of its memory pages. Children
+  // share translations only through the '--fast-cache' archive.
+  //
+  bool fork_state (System* const children[], uint32 count);
+  
   // Start simulation
   //
   bool start_simulation(int argc, char *argv[]);
@@ -138,10 +161,20 @@ public:
   
   bool simulate ();
   bool interact ();
+  
+  // Render binary trace file in textual trace format (see '--trace-render')
+  //
+  bool render_binary_trace (const char* trace_file);
   bool run ();
   bool run_notrace ();
   bool run_trace ();
   
+  // Parallel multi-core simulation where each processor executes on its own
+  // host thread and all processors synchronise after each quantum of
+  // 'sim_opts.mc_quantum' instructions (blocks in JIT mode).
+  //
+  bool run_parallel (RunMode mode);
+  
   bool step ();
   bool step (UpdatePacket*);
   bool trace(UpdatePacket*);
@@ -179,6 +212,11 @@ public:
     return ext_mem->get_host_page (addr);
   }
 
+  inline arcsim::sys::mem::BlockData* find_host_page (uint32 addr) const
+  {
+    return ext_mem->find_host_page (addr);
+  }
+
   inline uint32* get_host_page_location (uint32 addr)
   {
     return ext_mem->get_host_page_ptr (addr);
@@ -216,6 +254,11 @@ private:
   void*                       io_plugin_handle;
   void*                       ise_plugin_handle;
 
+  // Save/restore complete state to/from a checkpoint (system.cpp)
+  //
+  bool save_state    (arcsim::util::CheckpointWriter& writer);
+  bool restore_state (arcsim::util::CheckpointReader& reader);
+
 };
 
 #endif
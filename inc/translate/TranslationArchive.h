@@ -0,0 +1,128 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2010 The University of Edinburgh
+//                        All Rights Reserved
+// =====================================================================
+//
+// Description:
+//
+// TranslationArchive is a persistent, content-addressed store of compiled
+// TranslationModules that survives across simulation runs.
+//
+// Compiled objects (i.e. shared libraries produced by an external compiler or
+// LLVM bitcode produced by Clang) are stored in a single append-only archive
+// file that is memory-mapped for lookups. Each object is keyed by a hash of the
+// instructions and control-flow of its TranslationWorkUnit, the configuration
+// of the processor it was translated for, and all options that affect code
+// generation (@see TranslationWorker::archive_key()). Archived code must not
+// embed host addresses, it reaches counters and caches through the cpuState
+// structure instead, so a key matches independent of module names, load
+// addresses, the order in which hot pages were discovered, or the process
+// that compiled it.
+//
+// Archive layout (all fields in host byte order):
+//
+//   ArchiveHeader | EntryHeader | object bytes | EntryHeader | object ...
+//
+// Several simulator processes may share one archive, appends are serialised
+// using an advisory file lock.
+//
+// =====================================================================
+
+#ifndef INC_TRANSLATE_TRANSLATIONARCHIVE_H_
+#define INC_TRANSLATE_TRANSLATIONARCHIVE_H_
+
+#include <map>
+#include <string>
+
+#include "api/types.h"
+
+#include "concurrent/Mutex.h"
+
+namespace arcsim {
+  namespace internal {
+    namespace translate {
+
+      class TranslationArchive {
+      public:
+
+        TranslationArchive();
+        ~TranslationArchive();
+
+        // Open (or create) archive file and index existing entries
+        //
+        bool open(const std::string& path);
+
+        // Unmap and close archive file
+        //
+        void close();
+
+        bool is_open() const { return fd_ >= 0; }
+
+        // Compute key for a buffer. Keys for several buffers can be combined
+        // by passing in the previous key as 'seed'.
+        //
+        static uint64 compute_key(const char* buf, size_t len, uint64 seed = kKeySeed);
+
+        // Write the object stored for 'key' to file 'path'. Returns true if
+        // the archive contains an object for 'key'.
+        //
+        bool lookup(uint64 key, const std::string& path);
+
+        // Copy the object stored for 'key' to 'object'. Returns true if the
+        // archive contains an object for 'key'.
+        //
+        bool lookup(uint64 key, std::string& object);
+
+        // Add the object stored in file 'path' to the archive
+        //
+        bool insert(uint64 key, const std::string& path);
+
+        // Add the 'size' bytes at 'object' to the archive
+        //
+        bool insert(uint64 key, const char* object, size_t size);
+
+        // ---------------------------------------------------------------------
+        // Statistics
+        //
+        uint64 get_hit_count()    const { return hit_count_;    }
+        uint64 get_miss_count()   const { return miss_count_;   }
+        uint64 get_insert_count() const { return insert_count_; }
+        size_t get_entry_count()  const { return index_.size(); }
+
+      private:
+        TranslationArchive(const TranslationArchive & a); // DO NOT COPY
+        void operator=(const TranslationArchive &);       // DO NOT ASSIGN
+
+        static const uint64 kKeySeed = 0xcbf29ce484222325ULL; // FNV-1a offset basis
+
+        // Location of an object in the archive
+        //
+        struct Location {
+          uint64 offset;
+          uint64 size;
+        };
+
+        // Map archive file up to its current size and index all entries that
+        // have been appended since the last call (possibly by other processes)
+        //
+        bool remap();
+
+        arcsim::concurrent::Mutex     mtx_;
+
+        std::string                   path_;
+        int                           fd_;
+        uint8*                        base_;      // start of mapped archive
+        uint64                        map_size_;  // size of mapped region
+        uint64                        end_;       // end of indexed entries
+
+        std::map<uint64,Location>     index_;
+
+        uint64                        hit_count_;
+        uint64                        miss_count_;
+        uint64                        insert_count_;
+      };
+
+} } } // namespace arcsim::internal::translate
+
+#endif // INC_TRANSLATE_TRANSLATIONARCHIVE_H_
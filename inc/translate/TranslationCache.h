@@ -33,6 +33,13 @@ public:
   //
   static const uint32 kInvalidAddr = 0x1;
   
+  // JIT generated code chains to the next translation by looking up this cache
+  // directly (i.e. without returning to Processor::run()). A chain is broken
+  // whenever the iteration count has none of these bits set, bounding the
+  // number of blocks executed before Processor::run() checks timers again.
+  //
+  static const uint32 kChainIterationMask = 0x3f;
+  
   TranslationCache();
   ~TranslationCache();
   
@@ -63,6 +70,37 @@ public:
     p->code_ = block;
   }
 
+  // ---------------------------------------------------------------------------
+  // Cache layout used by JIT generated code. The cache is never re-allocated
+  // after construct(), and purge() MUST be called whenever a translation is
+  // removed as chained translations rely on it.
+  //
+  const Entry* get_entries()    const { return cache_;    }
+  uint32       get_index_mask() const { return size_ - 1; }
+
+  // Purge entries for all addresses within [addr, addr + size). Only the slots
+  // the range maps to are visited, unless the range covers the whole cache.
+  //
+  void purge_range (uint32 addr, uint32 size)
+  {
+    const uint32 slots = (size + 1) >> 1;
+    if (slots >= size_) { purge(); return; }
+    for (uint32 i = 0, idx = (addr >> 1); i <= slots; ++i, ++idx) {
+      Entry * const p = cache_ + (idx & (size_ - 1));
+      if ((p->addr_ - addr) < size) { p->addr_ = kInvalidAddr; }
+    }
+  }
+
+  // Purge entries for all addresses below 'addr'
+  //
+  void purge_below (uint32 addr)
+  {
+    const Entry * end = cache_end();
+    for (Entry * p = cache_; p < end; ++p) {
+      if (p->addr_ < addr) { p->addr_ = kInvalidAddr; }
+    }
+  }
+
   void purge ()
   { 
     const Entry * end = cache_end();
@@ -27,6 +27,8 @@
 #include "concurrent/ConditionVariable.h"
 
 #include "translate/TranslationWorkUnit.h"
+#include "translate/TranslationWorkQueue.h"
+#include "translate/TranslationArchive.h"
 
 class System;
 class SimOptions;
@@ -69,8 +71,12 @@ namespace arcsim {
         //
         uint32 get_translation_work_queue_size() const
         {
-          return static_cast<uint32>(trans_work_unit_queue.size());
+          return trans_work_unit_queue.size();
         }
+        
+        // Print translation work queue statistics
+        //
+        void print_stats() const;
 
       private:
         TranslationManager(const TranslationManager & m);   // DO NOT COPY
@@ -99,20 +105,28 @@ namespace arcsim {
         size_t                                  worker_thread_count;
         std::valarray<TranslationWorker*>       worker_list;
         
-        // Attributes for synchronised access to shared resources
+        // Attributes used by idle TranslationWorkers to wait for work. Adding
+        // and removing work does NOT require this lock.
         //
         arcsim::concurrent::Mutex             mutx_work_queue;
         arcsim::concurrent::ConditionVariable cond_work_queue; 
         
         // SHARED RESOURCE
         //
-        // Queue structures containing work passed in from the outside via
-        // dispatch_translation_work_units(). This structure is a priority queue using
-        // TranslationWorkUnit hotspot thresholds as a sorting criteria
-        // NOTE: access to this structure MUST be synchronised
+        // Queue structure containing work passed in from the outside via
+        // dispatch_translation_work_units(). This structure is a sharded priority
+        // queue using TranslationWorkUnit recency and hotspot frequency as a
+        // sorting criteria. It synchronises access internally.
+        //
+        TranslationWorkQueue                  trans_work_unit_queue;
+        
+        // SHARED RESOURCE
+        //
+        // Persistent archive of compiled TranslationModules that is re-used across
+        // simulation runs (@see SimOptions::fast_cache_file). It synchronises
+        // access internally.
         //
-        std::priority_queue<TranslationWorkUnit*,std::vector<TranslationWorkUnit*>,
-                            PrioritizeTranslationWorkUnits> trans_work_unit_queue;
+        TranslationArchive                    trans_archive;
         
 
         // ---------------------------------------------------------------------
@@ -15,6 +15,7 @@
 #define _TranslationModule_h_
 
 #include <map>
+#include <list>
 
 #include "api/types.h"
 
@@ -44,6 +45,16 @@ namespace arcsim {
 
 class TranslationWorkUnit;
 
+// -----------------------------------------------------------------------------
+// JIT compilation tiers. Baseline modules are compiled with a cheap optimisation
+// pipeline and count native block executions so hot modules can be recompiled
+// as optimised modules (@see SimOptions::fast_tier_up_threshold).
+//
+typedef enum {
+  kTranslationTierBaseline,
+  kTranslationTierOptimised
+} TranslationTier;
+
 
 // -----------------------------------------------------------------------------
 //
@@ -67,10 +78,12 @@ private:
 
   static const uint8 kDirtyMask      = 0x1;
   static const uint8 kTranslatedMask = 0x2;
+  static const uint8 kFailedMask     = 0x4;
   
   // Module state encodes if an 'in translation' module has been invalidated
   // before it was compiled by setting the first bit to 1. A successfully
-  // translated module is indicated by setting the second bit to 1. Access to this
+  // translated module is indicated by setting the second bit to 1, a module
+  // whose translation failed by setting the third bit to 1. Access to this
   // state variable must be synchronised using using the corresponding lock() and
   // unlock() methods.
   //
@@ -98,6 +111,16 @@ private:
   std::string     name_;       // unique module name  
 	const uint32    key_;        // temporal identity of this module
 	int             ref_count_;  // number of BlockEntries referencing module
+  
+  TranslationTier tier_;       // JIT compilation tier of this module
+  
+  // Tiered compilation book keeping. The baseline_ module is replaced by this
+  // module once its staged native code is installed. Installation and the
+  // tier_up_pending_ flag are only touched by the owning processor.
+  //
+  TranslationModule*  baseline_;
+  bool                tier_up_pending_;
+  std::list<std::pair<arcsim::profile::BlockEntry*,TranslationBlock> > staged_blocks_;
 
 public:
   
@@ -137,6 +160,48 @@ public:
   inline bool is_translated() const { return module_state_ & kTranslatedMask; }
   inline void mark_as_translated()  { module_state_ |= kTranslatedMask;       }
   
+  inline bool is_failed() const     { return module_state_ & kFailedMask; }
+  inline void mark_as_failed()      { module_state_ |= kFailedMask;       }
+  
+  // ---------------------------------------------------------------------------
+  // Tiered compilation
+  //
+  void            set_tier(TranslationTier t) { tier_ = t;    }
+  TranslationTier get_tier()    const         { return tier_; }
+  bool            is_baseline() const         { return tier_ == kTranslationTierBaseline; }
+  
+  // LLVM optimisation level used for this module's tier
+  //
+  int             get_opt_level() const       { return is_baseline() ? 1 : 3; }
+  
+  void               set_baseline(TranslationModule* m) { baseline_ = m;    }
+  TranslationModule* get_baseline() const               { return baseline_; }
+  
+  bool is_tier_up_pending() const    { return tier_up_pending_; }
+  void mark_as_tier_up_pending()     { tier_up_pending_ = true; }
+  void clear_tier_up_pending()       { tier_up_pending_ = false; }
+  
+  // Returns true if a block of this module executed at least 'threshold' times
+  //
+  bool is_hot(uint32 threshold) const;
+  
+  // Reset execution counts of all blocks of this module so that baseline code
+  // requests another tier-up once it executed 'threshold' more times
+  //
+  void reset_exec_counts();
+  
+  // Retrieve all BlockEntries registered with this module
+  //
+  void get_block_entries(std::list<arcsim::profile::BlockEntry*>& blocks) const;
+  
+  // Stage native code that replaces the baseline module, staged code is
+  // registered by install_staged_block_entries() - calls to these methods
+  // MUST be synchronised
+  //
+  void stage_block_entry(arcsim::profile::BlockEntry& block, TranslationBlock native);
+  bool has_staged_block_entries() const { return !staged_blocks_.empty(); }
+  int  install_staged_block_entries();
+  
   
   // ---------------------------------------------------------------------------
   // Accessors for LLVM modules/engines
@@ -158,6 +223,10 @@ public:
   bool           load_shared_library ();
   bool           close_shared_library();
   
+  // Retrieve path of shared library produced by an external JIT compiler
+  //
+  std::string    get_shared_library_path() const;
+  
   // Lookup TranslationBlock (i.e. function pointer) for symbol name in shared library
   //
   TranslationBlock   get_pointer_to_function(const char* symbol);
@@ -0,0 +1,152 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2010 The University of Edinburgh
+//                        All Rights Reserved
+// =====================================================================
+//
+// Description:
+//
+// TranslationWorkQueue is a sharded, work-stealing priority queue holding
+// TranslationWorkUnits that are waiting to be JIT compiled.
+//
+// Each shard is a small priority queue protected by its own Mutex, so
+// concurrent producers (i.e. Processor::dispatch_hot_traces()) and consumers
+// (i.e. TranslationWorkers) rarely contend for the same lock. Producers spread
+// work units over shards in round-robin fashion, and every consumer has a
+// 'home' shard it pops from first before it tries to steal work from other
+// shards. The PrioritizeTranslationWorkUnits recency/frequency policy is
+// maintained within every shard, and therefore approximately across shards.
+//
+// The total number of queued work units is maintained with atomic operations
+// so empty() and size() never need to acquire a lock. It is only changed while
+// the lock of the shard holding the work unit is held, hence it never drops
+// below the number of work units consumers may still remove. Statistics are
+// 64-bit wide and are therefore kept under a separate lock, as 64-bit values
+// can not be read atomically on 32-bit hosts.
+//
+// =====================================================================
+
+#ifndef INC_TRANSLATE_TRANSLATIONWORKQUEUE_H_
+#define INC_TRANSLATE_TRANSLATIONWORKQUEUE_H_
+
+#include <cstddef>
+#include <queue>
+#include <vector>
+
+#include "api/types.h"
+
+#include "concurrent/Mutex.h"
+
+#include "translate/TranslationWorkUnit.h"
+
+namespace arcsim {
+  namespace internal {
+    namespace translate {
+
+      class TranslationWorkQueue {
+      public:
+
+        explicit TranslationWorkQueue(size_t shard_count = 1);
+        ~TranslationWorkQueue();
+
+        // Change the number of shards. This method is NOT thread safe and must
+        // only be called while the queue is empty and no workers are running.
+        //
+        void set_shard_count(size_t shard_count);
+        size_t get_shard_count() const { return shard_list_.size(); }
+
+        // Add 'work_size' TranslationWorkUnits to the queue. Work units are spread
+        // over shards in round-robin fashion.
+        //
+        void push(size_t work_size, TranslationWorkUnit* const * w);
+
+        // Remove highest priority TranslationWorkUnit from the queue. Consumers
+        // should pass a unique 'home' index so they are distributed across shards.
+        // Returns NULL if there is no more work.
+        //
+        TranslationWorkUnit* pop(size_t home);
+
+        // Remove ALL TranslationWorkUnits from the queue
+        //
+        void clear();
+
+        // Lock-free queries of current queue size
+        //
+        bool   empty() const { return size_ == 0; }
+        uint32 size()  const { return size_;      }
+
+        // ---------------------------------------------------------------------
+        // Statistics
+        //
+        struct Stats {
+          uint64 enqueue_count;
+          uint64 dequeue_count;
+          uint64 steal_count;
+          uint64 contention_count;
+          // Accumulated time in microseconds producers spent adding work
+          //
+          uint64 enqueue_micros;
+          // Accumulated and maximum time in microseconds work units spent in
+          // the queue before being picked up by a consumer
+          //
+          uint64 dequeue_micros;
+          uint64 dequeue_max_micros;
+        };
+
+        // Retrieve a consistent copy of all statistics
+        //
+        void get_stats(Stats& stats) const;
+
+      private:
+        TranslationWorkQueue(const TranslationWorkQueue & q); // DO NOT COPY
+        void operator=(const TranslationWorkQueue &);         // DO NOT ASSIGN
+
+        // Queue entry remembering when a work unit was enqueued
+        //
+        struct Entry {
+          TranslationWorkUnit* unit;
+          uint64               enqueue_time;
+        };
+
+        // Apply PrioritizeTranslationWorkUnits policy to queue entries
+        //
+        struct PrioritizeEntries {
+          bool operator()(const Entry& x, const Entry& y) const
+          {
+            PrioritizeTranslationWorkUnits p;
+            return p(x.unit, y.unit);
+          }
+        };
+
+        // Shard holding part of the work
+        //
+        struct Shard {
+          arcsim::concurrent::Mutex                                       mtx;
+          std::priority_queue<Entry,std::vector<Entry>,PrioritizeEntries> queue;
+        };
+
+        // Try to remove work from a given shard, 'block' determines if we wait
+        // for the shard lock or give up if the shard is contended. Returns
+        // false if no work was removed.
+        //
+        bool pop_shard(Shard& shard, bool block, Entry& entry);
+
+        void create_shards(size_t shard_count);
+        void destroy_shards();
+
+        std::vector<Shard*>   shard_list_;
+
+        // Modified atomically
+        //
+        volatile uint32       size_;
+        volatile uint32       next_shard_;
+
+        // Modified and read with 'stats_mtx_' held
+        //
+        mutable arcsim::concurrent::Mutex stats_mtx_;
+        Stats                 stats_;
+      };
+
+} } } // namespace arcsim::internal::translate
+
+#endif // INC_TRANSLATE_TRANSLATIONWORKQUEUE_H_
@@ -70,6 +70,17 @@ public:
   
   arcsim::profile::BlockEntry&              entry_;
   std::list<arcsim::profile::BlockEntry*>   edges_;
+  
+  // Blocks of a region (i.e. kCompilationModeRegion) that lie on another page
+  // than the first block of their TranslationWorkUnit are off-page blocks. They
+  // are only entered from within the translation while the generation of their
+  // page (see PageProfile::get_generation()) still equals 'region_generation_'.
+  // 'region_guard_' points to that generation, it is 0 for all other blocks.
+  //
+  const uint32*                             region_guard_;
+  uint32                                    region_generation_;
+  
+  inline bool is_off_page() const { return region_guard_ != 0; }
 };
 
 class TranslationWorkUnit
@@ -79,6 +90,11 @@ public:
   explicit TranslationWorkUnit(arcsim::sys::cpu::Processor* cpu, uint32 timestamp);
   ~TranslationWorkUnit();  
   
+  // Free all blocks and reset contents so this TranslationWorkUnit can be
+  // populated again
+  //
+  void clear();
+  
   arcsim::sys::cpu::Processor* const cpu; // processor this TranslationWorkUnit belongs to  
   std::map<uint32,uint32>            lp_end_to_lp_start_map; // ZOL LP_END to LP_START mapping
 
@@ -87,6 +103,7 @@ public:
   
   uint32                             exec_freq; // cumulative basic block interpretation frequ.
   uint32                             timestamp; // creation timestamp (i.e. interval num.)   
+  uint32                             region_epoch; // Processor::trans_cache_epoch at creation
   
 };
 
@@ -13,8 +13,10 @@
 #ifndef INC_TRANSLATE_TRANSLATIONWORKER_H_
 #define INC_TRANSLATE_TRANSLATIONWORKER_H_
 
+#include <map>
 #include <queue>
 #include <set>
+#include <string>
 
 #include "arch/Configuration.h"
 
@@ -94,6 +96,29 @@ namespace arcsim {
       //
       void mark_module_for_gc(void* m);
       
+      // Translation latency statistics of the C/Clang code generator. Latencies
+      // cover code generation and compilation but NOT loading of translated
+      // modules.
+      //
+      uint64 get_c_trans_micros()  const { return c_trans_micros_;  }
+      uint64 get_c_trans_insns()   const { return c_trans_insns_;   }
+      uint64 get_c_trans_modules() const { return c_trans_modules_; }
+      
+      // Number of runtime preludes precompiled and time spent doing so, this
+      // time is included in the C/Clang translation latency
+      //
+      uint64 get_prelude_count()   const { return prelude_pch_.size(); }
+      uint64 get_prelude_micros()  const { return prelude_micros_;  }
+      
+      // Number of baseline modules recompiled as optimised modules
+      //
+      uint64 get_tier_up_count()   const { return tier_up_count_;   }
+      
+      // Number of work units not translated because their code exceeded the
+      // maximum size of the code buffer
+      //
+      uint64 get_size_reject_count() const { return size_reject_count_; }
+      
     private:
       TranslationWorker(const TranslationWorker &);   // DO NOT COPY
       void operator=(const TranslationWorker &);      // DO NOT ASSIGN
@@ -121,6 +146,12 @@ namespace arcsim {
       llvm::LLVMContext*              CTX_;  // llvm per thread context
       llvm::Module*                   MOD_;  // llvm per thread main module
       llvm::ExecutionEngine*          ENG_;  // llvm per thread execution engine
+      llvm::ExecutionEngine*          ENG_BASELINE_; // llvm per thread engine for baseline
+                                                     // modules (i.e. fast code generation)
+      
+      // Modules added to ENG_BASELINE_ - only accessed by this worker thread
+      //
+      std::set<void*>                 baseline_modules_;
       
       arcsim::util::CodeBuffer*       code_buf_;    // C-code generation buffer
       TranslationOptManager           opt_manager;  // custom optimisation manager
@@ -133,6 +164,28 @@ namespace arcsim {
       //
       arcsim::concurrent::Mutex         mutx_mod_release_pool_;
       std::set<void*>                   mod_release_pool_;
+      
+      // Translation latency statistics
+      //
+      uint64                            c_trans_micros_;   // time spent in C/Clang path
+      uint64                            c_trans_insns_;    // instructions translated via C/Clang
+      uint64                            c_trans_modules_;  // modules translated via C/Clang
+      uint64                            tier_up_count_;    // optimised replacement modules
+      uint64                            size_reject_count_; // work units exceeding code buffer
+      
+      // Precompiled runtime preludes (@see TranslationWorker::get_prelude_pch()),
+      // maps the key of a prelude source to the path of its header file. The
+      // precompiled header is stored next to it, the path is empty if
+      // precompilation failed.
+      //
+      std::map<uint64, std::string>     prelude_pch_;
+      uint64                            prelude_micros_;   // time spent precompiling preludes
+      
+      // Key of the runtime prelude emitted for each processor, the prelude
+      // captures the processor configuration in persistent translation archive
+      // keys (@see TranslationWorker::archive_key())
+      //
+      std::map<const void*, uint64>     config_key_;
 
       // ------------------------------------------------------------------------
       // Implementation of run() method 
@@ -178,19 +231,57 @@ namespace arcsim {
       //
       bool load_module(const TranslationWorkUnit& w);
       
+      // Execution engine responsible for TranslationModule
+      //
+      llvm::ExecutionEngine* get_engine(const TranslationModule& m) const;
+      
       // ------------------------------------------------------------------------
       
+      // Returns true if the module for TranslationWorkUnit may be stored in the
+      // persistent translation archive (i.e. its code embeds no host addresses)
+      //
+      bool is_archivable(const TranslationWorkUnit& w) const;
+      
+      // Compute persistent translation archive key for TranslationWorkUnit,
+      // this does not require any code to be generated for it
+      //
+      uint64 archive_key(const TranslationWorkUnit& w);
+      
+      // Retrieve module for TranslationWorkUnit from the persistent translation
+      // archive, returns false if the archive holds no module for 'key'
+      //
+      bool load_archived_module(const TranslationWorkUnit& w, uint64 key);
+      
+      // Add compiled module for TranslationWorkUnit to the persistent
+      // translation archive
+      //
+      void archive_module(const TranslationWorkUnit& w, uint64 key);
+      
       // Create C-Module for TranslationWork unit
       // 
       bool translate_work_unit_to_c(const TranslationWorkUnit& w);
       
+      // Emit runtime prelude and C-Module for TranslationWorkUnit into code_buf_.
+      // With the LLVM JIT the prelude is replaced by its precompiled header
+      // 'pch' if there is one, otherwise 'pch' is left empty.
+      //
+      bool emit_module_source(const TranslationWorkUnit& w, std::string& pch);
+      
       // Configuration of passes to be used with LLVM internal JIT
       //
       void configure_optimisation_passes(llvm::PassManager* PM, int optLevel);
       
-      // JIT compile using Clang/LLVM
+      // Retrieve precompiled header for the runtime prelude held in code_buf_,
+      // precompiling it if this worker has not seen that prelude before.
+      // Returns false if the prelude could not be precompiled.
+      //
+      bool get_prelude_pch(std::string& pch);
+      
+      // JIT compile using Clang/LLVM, implicitly including the precompiled
+      // header 'pch' unless it is empty. Sets 'pch_failed' if 'pch' could not
+      // be loaded, it is not used for later modules.
       //
-      bool compile_module_llvm(TranslationModule& m);
+      bool compile_module_llvm(TranslationModule& m, const std::string& pch, bool& pch_failed);
       
       // Compile by piping C source to external compiler using popen(3)
       //
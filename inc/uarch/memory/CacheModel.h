@@ -19,6 +19,10 @@
 
 #include "util/Histogram.h"
 
+#if defined(HAVE_SSE2)
+# include <emmintrin.h>
+#endif
+
 
 // ---------------------------------------------------------------------------
 // Macro definitions
@@ -51,7 +55,12 @@ private:
   uint32                waymask;
   uint32                index_bits;
   
-  uint32**              tags;
+  // Tags are stored set-major, i.e. all ways of a set are adjacent in memory
+  // so that one probe touches a single host cache line and all ways of a set
+  // can be compared at once.
+  //
+  uint32*               tags;
+  uint32                way_stride; // ways rounded up to kTagVectorWidth
   
   uint32                hit_way;
   uint32                hit_set;
@@ -76,6 +85,44 @@ private:
   void   purge_victim   (uint32 victim_addr);
   
   static const uint32   kInvalidProgramCount;
+  
+  // Number of tags compared per SIMD instruction
+  //
+  static const uint32   kTagVectorWidth = 4;
+  
+  inline uint32& tag_at (uint32 way, uint32 set) const
+  {
+    return tags[set * way_stride + way];
+  }
+  
+  // Find way matching 'valid_match' in 'hit_set', sets 'hit_way' to the
+  // matching way or to 'ways' if there is no match
+  //
+  inline bool find_way ()
+  {
+    uint32 const * const row = tags + hit_set * way_stride;
+#if defined(HAVE_SSE2)
+    const __m128i key  = _mm_set1_epi32(valid_match);
+    const __m128i mask = _mm_set1_epi32(tagmask | VALID_BIT);
+    for (uint32 w = 0; w < ways; w += kTagVectorWidth) {
+      const __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + w));
+      const int     m = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(t, mask), key)));
+      if (m) {
+        hit_way = w + __builtin_ctz(m);
+        return true;
+      }
+    }
+#else
+    for (uint32 w = 0; w < ways; ++w) {
+      if ((row[w] & (tagmask | VALID_BIT)) == valid_match) {
+        hit_way = w;
+        return true;
+      }
+    }
+#endif
+    hit_way = ways;
+    return false;
+  }
 
 
 public:
@@ -152,21 +199,25 @@ public:
   {
     hit_set = (addr >> block_bits) & setmask;
     valid_match = (addr & tagmask) | VALID_BIT;
-    for (hit_way = 0; hit_way < ways; ++hit_way)
-      if ((tags[hit_way][hit_set] & (tagmask | VALID_BIT)) == valid_match)
-        return true;
-    return false;
+    return find_way();
   }
   
   inline bool is_dirty_hit (uint32 addr)
   {
     hit_set = (addr >> block_bits) & setmask;
     valid_match = (addr & tagmask) | VALID_BIT;
-    for (hit_way = 0; hit_way < ways; ++hit_way)
-      if ((tags[hit_way][hit_set] & (tagmask | VALID_BIT)) == valid_match)
-        return ((tags[hit_way][hit_set] & DIRTY_BIT) == DIRTY_BIT);
+    if (find_way())
+      return ((tag_at(hit_way,hit_set) & DIRTY_BIT) == DIRTY_BIT);
     return false;
   }
+  
+  // Prefetch tags of the set 'addr' maps to into the host cache, used by
+  // MemoryModel when simulating the accesses of an ENTER_S/LEAVE_S instruction
+  //
+  inline void prefetch_set (uint32 addr) const
+  {
+    __builtin_prefetch(tags + ((addr >> block_bits) & setmask) * way_stride);
+  }
 
   
   inline uint16 read (uint32 addr, uint8 blk_bits, uint32 pc)
@@ -218,7 +269,7 @@ public:
       }
     } else {                /* CACHE HIT */
       ++write_hits;
-      tags[hit_way][hit_set] |= DIRTY_BIT;
+      tag_at(hit_way,hit_set) |= DIRTY_BIT;
       latency = write_lat[blk_bits];
     }
     return latency;
@@ -0,0 +1,113 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2011 The University of Edinburgh
+//                        All Rights Reserved
+//
+// =====================================================================
+//
+// Description:
+//
+// Single pass simulation of many cache geometries for one address stream.
+//
+// Geometries sharing block size and number of sets are simulated together
+// using per-set LRU stacks (Mattson's stack algorithm): the depth at which
+// an address is found in the stack of its set is its LRU stack distance,
+// and an access hits in every cache of that group whose associativity is
+// larger than this distance. One pass therefore yields miss ratios for all
+// associativities (i.e. cache sizes) of a group, the miss-ratio curve.
+//
+// Geometries are tag-only and always use LRU replacement, they observe the
+// address stream but do not contribute to simulated latencies.
+//
+// =====================================================================
+
+#ifndef INC_UARCH_MEMORY_CACHESWEEP_H_
+#define INC_UARCH_MEMORY_CACHESWEEP_H_
+
+#include <vector>
+
+#include "api/types.h"
+
+#include "arch/CacheArch.h"
+
+namespace arcsim {
+  namespace uarch {
+    namespace memory {
+
+      // -----------------------------------------------------------------------
+      // CacheSweep
+      //
+      class CacheSweep {
+      public:
+
+        // Constructor - 'geometries' have been validated by SimOptions (i.e.
+        // sizes, ways and block sizes are powers of two)
+        //
+        CacheSweep(CacheArch::CacheKind kind, const std::vector<CacheArch>& geometries);
+        ~CacheSweep();
+
+        // Simulate access to 'addr' in all geometries
+        //
+        inline void access(uint32 addr)
+        {
+          ++accesses_;
+          for (uint32 i = 0; i < groups_.size(); ++i) { groups_[i]->access(addr); }
+        }
+
+        // Invalidate all geometries, statistics are retained
+        //
+        void invalidate();
+
+        void print_stats() const;
+
+      private:
+        // ---------------------------------------------------------------------
+        // LRU stacks of all sets of geometries with equal block size and number
+        // of sets, 'depth' is the largest associativity of these geometries
+        //
+        struct StackGroup {
+          uint32  block_bits;
+          uint32  set_bits;
+          uint32  set_mask;
+          uint32  depth;
+          uint32* stacks;     // sets * depth tags, most recently used first
+          uint64* hits;       // hits at each stack distance
+
+          StackGroup(uint32 block_bits, uint32 set_bits, uint32 depth);
+          ~StackGroup();
+
+          void    invalidate();
+
+          // Hits of a geometry with associativity 'ways' in this group
+          //
+          uint64  get_hits(uint32 ways) const;
+
+          inline void access(uint32 addr)
+          {
+            const uint32  line  = addr >> block_bits;
+            const uint32  tag   = line >> set_bits;
+            uint32* const stack = stacks + (line & set_mask) * depth;
+
+            uint32 d = 0;
+            while (d < depth && stack[d] != tag) { ++d; }
+            if (d < depth) { ++hits[d];   }   // hit at stack distance 'd'
+            else           { d = depth-1; }   // miss, LRU entry drops out
+
+            for (; d > 0; --d) { stack[d] = stack[d-1]; }
+            stack[0] = tag;
+          }
+        };
+
+        CacheArch::CacheKind      kind_;
+        std::vector<CacheArch>    geometries_;
+        std::vector<uint32>       geometry_group_;  // group of each geometry
+        std::vector<StackGroup*>  groups_;
+        uint64                    accesses_;
+
+        CacheSweep(const CacheSweep & m);           // DO NOT COPY
+        void operator=(const CacheSweep &);         // DO NOT ASSIGN
+      };
+
+} } } // arcsim::uarch::memory
+
+#endif  // INC_UARCH_MEMORY_CACHESWEEP_H_
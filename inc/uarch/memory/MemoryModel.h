@@ -13,8 +13,8 @@
 #ifndef _INC_UARCH_MEMORY_MEMORYMODEL_H_
 #define _INC_UARCH_MEMORY_MEMORYMODEL_H_
 
-#include <queue>
 #include <string>
+#include <vector>
 
 #include "api/types.h"
 
@@ -26,6 +26,7 @@
 #include "uarch/memory/CcmModel.h"
 #include "uarch/memory/MainMemoryModel.h"
 #include "uarch/memory/LatencyCache.h"
+#include "uarch/memory/CacheSweep.h"
 
 
 // -----------------------------------------------------------------------------
@@ -40,6 +41,33 @@ namespace arcsim {
     class CodeBuffer;
 } }
 
+// -----------------------------------------------------------------------------
+// FIFO of addresses accessed by a memory instruction. Unlike std::queue<> the
+// pending addresses are contiguous in memory so that they can be handed to
+// MemoryModel::read_multiple()/write_multiple() in one go. Only ENTER_S and
+// LEAVE_S queue several addresses (i.e. their register saves and restores).
+//
+class MemoryAddressQueue {
+private:
+  std::vector<uint32>   addrs_;
+  uint32                head_;
+  
+public:
+  MemoryAddressQueue() : head_(0)
+  { /* EMPTY */ }
+  
+  inline void   push  (uint32 addr)  { addrs_.push_back(addr);          }
+  inline bool   empty () const       { return head_ == addrs_.size();   }
+  inline uint32 size  () const       { return addrs_.size() - head_;    }
+  inline uint32 front () const       { return addrs_[head_];            }
+  inline void   pop   ()             { if (++head_ == addrs_.size()) { clear(); } }
+  inline void   clear ()             { addrs_.clear(); head_ = 0;       }
+  
+  // Pointer to pending addresses, only valid if queue is not empty
+  //
+  inline uint32 const * data () const { return &addrs_[head_];         }
+};
+
 class MemoryModel {
 private:
   uint16                block_offset;
@@ -63,10 +91,16 @@ public:
   CCMModel*             iccms_c[4];
   CCMModel*             dccm_c;
   
+  // Optional single pass simulation of alternative cache geometries observing
+  // all cached fetches and data accesses (see '--icache-sweep'/'--dcache-sweep')
+  //
+  arcsim::uarch::memory::CacheSweep* icache_sweep;
+  arcsim::uarch::memory::CacheSweep* dcache_sweep;
+  
   // Queue containing all addresses a memory instruction has accessed
   // (e.g. load, store, enter, leave, ex)
   //
-  std::queue<uint32>    addr_queue;
+  MemoryAddressQueue    addr_queue;
   
   // I-cache and D-cache enables
   //
@@ -158,6 +192,8 @@ public:
         return cycles;
     }
     
+    if (icache_sweep && addr <= cached_limit) { icache_sweep->access(addr); }
+    
     // Check ICACHE if present and enabled
     //
     if (icache_enabled) {
@@ -194,6 +230,8 @@ public:
     //
     if (dccm_c && (cycles = dccm_c->read(addr, block_offset)))
       return cycles;
+    
+    if (dcache_sweep && !uncached && addr <= cached_limit) { dcache_sweep->access(addr); }
 
     // If this read is uncached, or outside the cacheable region, or if
     // the dcache is disabled, then return the latency of 4-byte read 
@@ -231,6 +269,8 @@ public:
     //
     if (dccm_c && (cycles = dccm_c->write(addr, block_offset)))
       return cycles;
+    
+    if (dcache_sweep && !uncached && addr <= cached_limit) { dcache_sweep->access(addr); }
 
     // If this write is uncached, or outside the cacheable region, or if
     // the dcache is disabled, then return the latency of 4-byte write 
@@ -258,6 +298,36 @@ public:
 
     return cycles;    
   }
+  
+  // ---------------------------------------------------------------------------
+  // Read/write methods simulating the 'count' accesses of a single ENTER_S or
+  // LEAVE_S instruction in order, returning the accumulated latency. They are
+  // equivalent to calling read()/write() for each address, except that the
+  // data cache sets of all addresses are prefetched into the host cache first.
+  // All other accesses, including those of translated code, are simulated one
+  // at a time as they happen because their latencies feed the pipeline model
+  // in program order.
+  //
+  uint32 read_multiple  (uint32 const * addrs, uint32 count, uint32 pc, bool uncached);
+  uint32 write_multiple (uint32 const * addrs, uint32 count, uint32 pc, bool uncached);
+  
+  // Simulate all accesses recorded in 'addr_queue' and empty it
+  //
+  inline uint32 read_queue (uint32 pc, bool uncached)
+  {
+    if (addr_queue.empty()) { return 0; }
+    const uint32 cycles = read_multiple(addr_queue.data(), addr_queue.size(), pc, uncached);
+    addr_queue.clear();
+    return cycles;
+  }
+  
+  inline uint32 write_queue (uint32 pc, bool uncached)
+  {
+    if (addr_queue.empty()) { return 0; }
+    const uint32 cycles = write_multiple(addr_queue.data(), addr_queue.size(), pc, uncached);
+    addr_queue.clear();
+    return cycles;
+  }
 
 };
 
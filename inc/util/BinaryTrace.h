@@ -0,0 +1,265 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2011 The University of Edinburgh
+//                        All Rights Reserved
+// =====================================================================
+//
+// Description:
+//
+// Compact binary instruction trace. Instead of disassembling and formatting
+// each traced instruction as text, the processor appends small tagged records
+// to a BinaryTraceWriter. Records are staged in fixed size chunks of a lock-free
+// single-producer/single-consumer ring buffer and a background thread writes
+// completed chunks to the trace file, hence the simulation thread never blocks
+// on I/O unless the ring buffer is full.
+//
+// All record fields are LEB128 encoded variable length integers and PCs are
+// stored as signed deltas to the previous instruction, most records are
+// therefore only a few bytes long.
+//
+// A trace file is a sequence of chunks, each of which can be decoded on its
+// own:
+//
+//   +--------+---------+--------+-----------------------------+
+//   | magic  | core id | length | records ...                 |
+//   | uint32 | uint32  | uint32 | (length bytes)              |
+//   +--------+---------+--------+-----------------------------+
+//
+// The BinaryTraceReader decodes a trace file chunk by chunk so that the
+// textual trace format can be rendered offline (see '--trace-render').
+//
+// =====================================================================
+
+#ifndef INC_UTIL_BINARYTRACE_H_
+#define INC_UTIL_BINARYTRACE_H_
+
+#include "api/types.h"
+
+#include "concurrent/Thread.h"
+
+#include <cstdio>
+#include <string>
+
+namespace arcsim {
+  namespace util {
+
+    // -------------------------------------------------------------------------
+    // Binary trace record kinds
+    //
+    struct BinaryTrace
+    {
+      enum RecordKind {
+        kRecInstruction = 1,  // pc, instruction, limm, flags
+        kRecWriteBack,        // register, value
+        kRecCommit,           // committed?
+        kRecEmit,             // end of traced instruction
+        kRecException,        // message, exception and stack checking registers
+        kRecMul64,            // MLO, MMID, MHI
+        kRecLoopBack,         // pc
+        kRecLoopCount,        // LP_COUNT
+        kRecLoopInst,         // taken, target or LP_START, LP_END, LP_COUNT
+        kRecLoad,             // format, address, data
+        kRecStore,            // format, address, data
+        kRecLr,               // address, data, success
+        kRecSr,               // address, data, success
+        kRecRtie,             // pc, STATUS32, BTA
+        kRecString            // length, characters
+      };
+
+      // Chunk header magic ('ABT1')
+      //
+      static const uint32 kChunkMagic       = 0x31544241;
+
+      // Size of chunk header in bytes
+      //
+      static const uint32 kChunkHeaderSize  = 3 * sizeof(uint32);
+
+      // Maximum length of strings embedded in records, longer strings are
+      // truncated
+      //
+      static const uint32 kMaxStringLength  = 1024;
+
+      // Upper bound for the size of any single record
+      //
+      static const uint32 kMaxRecordSize    = kMaxStringLength + 128;
+    };
+
+    // -------------------------------------------------------------------------
+    // BinaryTraceWriter owns the ring buffer and the background writer thread.
+    // All put_*() methods and end_record() must only be called by the single
+    // producer (i.e. the simulation thread of a processor).
+    //
+    class BinaryTraceWriter : public arcsim::concurrent::Thread
+    {
+    public:
+      // Size of one chunk of the ring buffer in bytes
+      //
+      static const uint32 kChunkSize  = 64 * 1024;
+
+      // Number of chunks in ring buffer, must be a power of two
+      //
+      static const uint32 kChunkCount = 16;
+
+      // Constructor - chunks are written to 'fd' using the given core id
+      //
+      explicit BinaryTraceWriter(int fd, uint32 core_id);
+
+      // Destructor - flushes all pending records and stops writer thread
+      //
+      ~BinaryTraceWriter();
+
+      // Start background writer thread
+      //
+      void open();
+
+      // Publish the partially filled chunk and stop background writer thread
+      // once all chunks have been written, reports an incomplete trace
+      //
+      void close();
+
+      // Publish the partially filled chunk so that it is written out
+      //
+      void flush();
+
+      // -----------------------------------------------------------------------
+      // Record encoding
+      //
+      inline void put_u8(uint8 val)
+      {
+        *cur_++ = val;
+      }
+
+      inline void put_varint(uint64 val)
+      {
+        while (val >= 0x80) { *cur_++ = static_cast<uint8>(val | 0x80); val >>= 7; }
+        *cur_++ = static_cast<uint8>(val);
+      }
+
+      // Signed values are 'zig-zag' encoded so that small negative deltas
+      // remain small
+      //
+      inline void put_svarint(sint32 val)
+      {
+        put_varint((static_cast<uint32>(val) << 1) ^ static_cast<uint32>(val >> 31));
+      }
+
+      void put_string(const char* str, uint32 len);
+
+      // Encode PC as delta to previously encoded PC
+      //
+      inline void put_pc(uint32 pc)
+      {
+        put_svarint(static_cast<sint32>(pc - last_pc_));
+        last_pc_ = pc;
+      }
+
+      // Must be called after each record, publishes current chunk if there is
+      // no room left for another record
+      //
+      inline void end_record()
+      {
+        if (static_cast<uint32>(end_ - cur_) < BinaryTrace::kMaxRecordSize) { publish_chunk(); }
+      }
+
+      // Number of chunks written and number of times the producer had to wait
+      // for a free chunk
+      //
+      uint64 get_chunk_count() const { return chunk_count_; }
+      uint64 get_stall_count() const { return stall_count_; }
+
+      // False once a chunk could not be written, all following chunks are
+      // dropped so the trace file ends with the last chunk written in full
+      //
+      bool   is_complete()     const { return !failed_; }
+
+      // Background writer thread
+      //
+      void run();
+
+    private:
+      int           fd_;
+      uint32        core_id_;
+
+      // Ring buffer chunks and number of valid bytes in each chunk
+      //
+      uint8*        chunks_;
+      uint32        chunk_len_[kChunkCount];
+
+      // Ring buffer indices, 'head_' is only written by the producer, 'tail_'
+      // is only written by the writer thread
+      //
+      volatile uint32 head_;
+      volatile uint32 tail_;
+      volatile bool   done_;
+      volatile bool   failed_;
+      bool            running_;
+
+      // Producer position within current chunk
+      //
+      uint8*        cur_;
+      uint8*        end_;
+      uint32        last_pc_;
+
+      uint64        chunk_count_;
+      uint64        stall_count_;
+      uint64        lost_count_;   // chunks not written after a failure
+
+      void    publish_chunk();
+      void    begin_chunk();
+      bool    write_chunk(uint32 idx);
+
+      BinaryTraceWriter(const BinaryTraceWriter &);     // DO NOT COPY
+      void operator=(const BinaryTraceWriter &);        // DO NOT ASSIGN
+    };
+
+    // -------------------------------------------------------------------------
+    // BinaryTraceReader decodes a binary trace file chunk by chunk
+    //
+    class BinaryTraceReader
+    {
+    public:
+      explicit BinaryTraceReader(FILE* fd);
+      ~BinaryTraceReader();
+
+      // Read next chunk, returns false at end of file or if the file is corrupt
+      //
+      bool next_chunk();
+
+      // Core id of current chunk
+      //
+      uint32 get_core_id() const { return core_id_; }
+
+      // True if all records of current chunk have been decoded
+      //
+      bool is_chunk_end() const { return cur_ >= end_; }
+
+      // True if a decoding error occurred (i.e. truncated record)
+      //
+      bool has_error()    const { return error_; }
+
+      // -----------------------------------------------------------------------
+      // Record decoding
+      //
+      uint8   get_u8();
+      uint64  get_varint();
+      sint32  get_svarint();
+      uint32  get_pc();
+      void    get_string(std::string& str);
+
+    private:
+      FILE*   fd_;
+      uint8*  buf_;
+      uint32  buf_size_;
+      uint8*  cur_;
+      uint8*  end_;
+      uint32  core_id_;
+      uint32  last_pc_;
+      bool    error_;
+
+      BinaryTraceReader(const BinaryTraceReader &);     // DO NOT COPY
+      void operator=(const BinaryTraceReader &);        // DO NOT ASSIGN
+    };
+
+} } // arcsim::util
+
+#endif  // INC_UTIL_BINARYTRACE_H_
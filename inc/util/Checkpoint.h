@@ -0,0 +1,160 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2011 The University of Edinburgh
+//                        All Rights Reserved
+// =====================================================================
+//
+// Description:
+//
+// Snapshot files holding the complete state of a simulated system (see
+// System::save_checkpoint() and System::restore_checkpoint()).
+//
+// Components serialise their state into tagged sections of a metadata
+// area that is read back in the same order on restore. Simulated memory
+// pages are stored separately, back to back in a page data area that is
+// aligned to the host page size:
+//
+//   +--------+--------------------------------+---------+----------------+
+//   | header | metadata (tagged sections)     | padding | page data ...  |
+//   +--------+--------------------------------+---------+----------------+
+//
+// On restore the page data area is memory-mapped copy-on-write (i.e.
+// MAP_PRIVATE), hence restoring a checkpoint does not copy any simulated
+// memory and takes the same time regardless of memory size. Pages are
+// only faulted in by the host once they are touched, and the snapshot
+// file itself is never modified.
+//
+// All fields are stored in host byte order, checkpoints can therefore
+// only be restored on the same kind of host by the same simulator build.
+//
+// =====================================================================
+
+#ifndef INC_UTIL_CHECKPOINT_H_
+#define INC_UTIL_CHECKPOINT_H_
+
+#include <string>
+#include <vector>
+
+#include "api/types.h"
+
+namespace arcsim {
+  namespace util {
+
+    // -------------------------------------------------------------------------
+    // Section tags
+    //
+    struct Checkpoint
+    {
+      enum SectionTag {
+        kSectionSystem    = 0x53595354,  // 'SYST'
+        kSectionProcessor = 0x43505520,  // 'CPU '
+        kSectionMemory    = 0x4d454d20,  // 'MEM '
+        kSectionDevices   = 0x44455653   // 'DEVS'
+      };
+
+      // File magic ('ACKP') and version, bump kVersion whenever the layout
+      // of any section changes incompatibly
+      //
+      static const uint32 kMagic   = 0x504b4341;
+      static const uint32 kVersion = 1;
+    };
+
+    // -------------------------------------------------------------------------
+    // CheckpointWriter collects all sections in memory and writes the snapshot
+    // file in one go once commit() is called. Pages registered with
+    // write_page() are only referenced, they must remain valid and unchanged
+    // until commit() returns.
+    //
+    class CheckpointWriter
+    {
+    public:
+      explicit CheckpointWriter(uint32 page_bytes);
+      ~CheckpointWriter();
+
+      void    begin_section(uint32 tag);
+
+      void    write(const void* data, size_t size);
+      void    write_string(const std::string& str);
+
+      template<typename T>
+      inline void write_value(const T& val) { write(&val, sizeof(T)); }
+
+      // Append page of 'page_bytes' bytes to the page data area, returns the
+      // index of the page in that area
+      //
+      uint32  write_page(const void* page);
+
+      // Write snapshot file to 'path', or to the start of the open file 'fd'
+      //
+      bool    commit(const std::string& path);
+      bool    commit(int fd);
+
+    private:
+      const uint32              page_bytes_;
+      std::vector<uint8>        meta_;
+      std::vector<const void*>  pages_;
+
+      CheckpointWriter(const CheckpointWriter &);  // DO NOT COPY
+      void operator=(const CheckpointWriter &);    // DO NOT ASSIGN
+    };
+
+    // -------------------------------------------------------------------------
+    // CheckpointReader reads the metadata area of a snapshot file and maps its
+    // page data area. Read errors are sticky, once a read has failed all
+    // subsequent reads fail as well and has_error() returns true.
+    //
+    class CheckpointReader
+    {
+    public:
+      CheckpointReader();
+      ~CheckpointReader();
+
+      // Open snapshot file, read its metadata and map its page data area. The
+      // file descriptor variant leaves 'fd' open, the mapping remains valid
+      // after it is closed.
+      //
+      bool    open(const std::string& path);
+      bool    open(int fd);
+
+      // Returns false if the next section is not tagged 'tag'
+      //
+      bool    expect_section(uint32 tag);
+
+      bool    read(void* data, size_t size);
+      bool    read_string(std::string& str);
+
+      template<typename T>
+      inline bool read_value(T& val) { return read(&val, sizeof(T)); }
+
+      bool    has_error()      const { return error_;      }
+
+      uint32  get_page_bytes() const { return page_bytes_; }
+      uint32  get_page_count() const { return page_count_; }
+
+      // Copy-on-write mapping of page 'idx' of the page data area
+      //
+      uint8*  get_page(uint32 idx) const;
+
+      // Transfer ownership of the page data mapping to the caller, who must
+      // release it with munmap() once the pages are no longer used. Unless
+      // released, the mapping is removed when the reader is destroyed.
+      //
+      void    release_pages(void** base, size_t* size);
+
+    private:
+      std::vector<uint8>  meta_;
+      size_t              pos_;
+      bool                error_;
+
+      uint32              page_bytes_;
+      uint32              page_count_;
+      uint8*              pages_;
+      size_t              pages_size_;
+
+      CheckpointReader(const CheckpointReader &);  // DO NOT COPY
+      void operator=(const CheckpointReader &);    // DO NOT ASSIGN
+    };
+
+} } // namespace arcsim::util
+
+#endif  // INC_UTIL_CHECKPOINT_H_
@@ -9,6 +9,10 @@
 // and snprintf(buf,...). It provides all the luxury of snprintf(buf,...) and
 // snprintf(buf,...) but is much easier to use and SAFER.
 //
+// The buffer starts out with the given size and grows by doubling whenever an
+// append does not fit, up to a maximum size. Only if that maximum size is
+// exceeded the buffer becomes full.
+//
 // NOTE: This buffer implemenation is NOT thread-safe, so do not try to append
 //       to a CodeBuffer instance from multiple threads!
 //
@@ -29,18 +33,23 @@ namespace arcsim {
       
       // Default buffer size is 512K (i.e. 0x00080000)
       //
-      static const uint32 kBufferSize = 0x00080000;
+      static const uint32 kBufferSize    = 0x00080000;
+      
+      // Default maximum buffer size is 64M (i.e. 0x04000000)
+      //
+      static const uint32 kMaxBufferSize = 0x04000000;
       
-      explicit CodeBuffer(uint32 size = kBufferSize);
+      explicit CodeBuffer(uint32 size = kBufferSize, uint32 max_size = kMaxBufferSize);
       ~CodeBuffer();
       
       // Safely append to code buffer
       //
       CodeBuffer& append (const char * fmt, ...);
 
-      // Retrieve buffer size
+      // Retrieve current and maximum buffer size
       //
       inline uint32 get_size()               const { return size_;  }
+      inline uint32 get_max_size()           const { return max_size_; }
       
       // Retrieve buffer state
       //
@@ -67,13 +76,21 @@ namespace arcsim {
     private:
       // NOTE: Declaration order matters!
       //
-      const uint32 size_;    // size of buffer
-      char * const buf_;     // pointer to beginning of buffer
-      char * const end_;     // pointer to end of buffer
-      char *       pos_;     // current position in buffer
+      uint32       size_;     // size of buffer
+      const uint32 max_size_; // maximum size buffer may grow to
+      char *       buf_;      // pointer to beginning of buffer
+      char *       end_;      // pointer to end of buffer
+      char *       pos_;      // current position in buffer
       
-      State        state_;   // state of buffer
+      State        state_;    // state of buffer
+      
+      // Grow buffer so at least 'bytes' more bytes fit, returns false if that
+      // would exceed the maximum size
+      //
+      bool grow (uint32 bytes);
       
+      CodeBuffer(const CodeBuffer &);          // DO NOT COPY
+      void operator=(const CodeBuffer &);      // DO NOT ASSIGN
     };
     
 } } // arcsim::util
@@ -16,6 +16,15 @@
 // on demand and fully automatic and it integrates very well with our JIT
 // compiler.
 //
+// HistogramEntries are kept in a radix tree of small direct-mapped tables
+// so that an increment is a handful of dependent array loads instead of a
+// std::map look-up. Tables are small and allocated on demand, so an empty
+// Histogram costs a few pointers and its first entry about 1.5KB (2.5KB on
+// 64-bit hosts). Tables are only ever added, never moved or removed, hence
+// look-ups and increments do not acquire a lock and pointers returned by
+// get_value_ptr_at_index() stay valid for the lifetime of the Histogram.
+// The mutex is only taken when a new index is touched for the first time.
+//
 // There is also a HistogramIter iterator that allows for easy iteration
 // over histogram entries in a Histogram:
 //
@@ -43,9 +52,7 @@
 #include "concurrent/Mutex.h"
 
 #include <set>
-#include <map>
 #include <vector>
-#include <stack>
 #include <string>
 
 namespace arcsim {
@@ -141,14 +148,9 @@ namespace arcsim {
       //
       static const int kHistogramMaxNameSize            = 256;
       
-      // Default HistogramEntry allocation size
-      //
-      static const int kHistogramEntryDefaultAllocSize  = 64;
-      
       // Constructor
       //
-      explicit Histogram(const char*  name,
-                         uint32       alloc_size = kHistogramEntryDefaultAllocSize);
+      explicit Histogram(const char*  name);
       
       // Destructor
       //
@@ -181,8 +183,19 @@ namespace arcsim {
       
       // Increment. If index does not exist it will be automatically allocated.
       //
-      void inc(uint32 idx);
-      void inc(uint32 idx, uint32 val);
+      inline void inc(uint32 idx)
+      {
+        HistogramEntry* const entry = lookup_entry(idx);
+        if (entry) { entry->inc();                  } // FAST PATH
+        else       { new_histogram_entry(idx)->inc(); } // SLOW PATH
+      }
+      
+      inline void inc(uint32 idx, uint32 val)
+      {
+        HistogramEntry* const entry = lookup_entry(idx);
+        if (entry) { entry->inc(val);                  } // FAST PATH
+        else       { new_histogram_entry(idx)->inc(val); } // SLOW PATH
+      }
             
       // Reset everything to 0
       //
@@ -197,44 +210,69 @@ namespace arcsim {
       static const uint32 kInitialHistogramId = 0xFFFFFFFF;
       uint8  name_[kHistogramMaxNameSize];
       
-      uint32 alloc_size_;
-      
-      
-      // Set of ALL HistogramEntries for this Histogram
+      // The radix tree is indexed starting with the most significant bits of
+      // a histogram index. The 2 most significant bits select a root slot, the
+      // following four levels of nodes are indexed by 6 bits each. A leaf holds
+      // the HistogramEntries of 64 consecutive indices (e.g. all PCs within a
+      // 64 byte range of code) and a bitmap marking which of them exist.
       //
-      std::set<HistogramEntry*>     hist_entries_;
+      static const uint32 kLeafBits   = 6;
+      static const uint32 kLeafSize   = 1 << kLeafBits;
+      static const uint32 kLeafMask   = kLeafSize - 1;
+      static const uint32 kNodeBits   = 6;
+      static const uint32 kNodeSize   = 1 << kNodeBits;
+      static const uint32 kNodeMask   = kNodeSize - 1;
+      static const uint32 kRootShift  = kLeafBits + 4 * kNodeBits;
+      static const uint32 kRootSize   = 1 << (32 - kRootShift);
       
-      // Map for fast lookup/increment of HistogramEntry values:
-      // key: hist index
-      // val: pointer to hist value
-      //
-      std::map<uint32,uint32*>      hist_map_index_value_;
+      struct HistogramLeaf {
+        HistogramEntry  entry[kLeafSize];
+        uint32          present[kLeafSize / 32];
+        explicit HistogramLeaf(uint32 base_idx);
+      };
+      struct HistogramNode {
+        void*           child[kNodeSize]; // HistogramNodes, or HistogramLeafs on last level
+        HistogramNode();
+      };
       
-      // In order to allow for allocation to happen in chunks we use an allocation
-      // pool that looks like a stack. When adding a new HistogramEntry to the 
-      // hist_entries_ set we pop a pre-allocated element from the hist_alloc_pool_
-      // stack. Should the hist_alloc_pool_ become empty we will allocate another
-      // chunk of HistogramEntries and put them on a stack.
+      // Root of radix tree
       //
-      std::stack<HistogramEntry*>   hist_entries_alloc_pool_;
+      HistogramNode*                hist_root_[kRootSize];
       
-      // Stack of ALL allocated HistogramEntry chunks
+      // List of ALL existing HistogramEntries for this Histogram
       //
-      std::stack<HistogramEntry*>   hist_entries_alloc_chunks_;
+      std::vector<HistogramEntry*>  hist_entries_;
       
       // Mutex that must be acquired before modifying HistogramEntry book keeping
       // structures
       //
       arcsim::concurrent::Mutex     hist_entries_mutex_;
       
-      // Re-fills allocation pool and returns number of instantiated HistogramEntries
+      // Returns pointer to existing HistogramEntry or '0' if there is none
       //
-      uint32 refill_historgram_allocation_pool();
+      inline HistogramEntry* lookup_entry(uint32 idx) const
+      {
+        void* n = hist_root_[idx >> kRootShift];
+        for (uint32 s = kRootShift - kNodeBits; (n != 0) && (s >= kLeafBits); s -= kNodeBits) {
+          n = static_cast<HistogramNode*>(n)->child[(idx >> s) & kNodeMask];
+        }
+        if (n == 0) { return 0; }
+        HistogramLeaf* const l = static_cast<HistogramLeaf*>(n);
+        const uint32         i = idx & kLeafMask;
+        return (l->present[i >> 5] & (1U << (i & 31))) ? &l->entry[i] : 0;
+      }
       
-      // Returns pointer to new HistogramEntry and maintains all lookup
-      // structures
+      // Returns pointer to HistogramEntry for index, creating it and all
+      // necessary tables if it does not exist yet
       //
       HistogramEntry* new_histogram_entry(uint32 idx);
+      
+      // Free radix tree node whose children are indexed starting at bit 'shift'
+      //
+      static void delete_node(HistogramNode* n, uint32 shift);
+      
+      Histogram(const Histogram & m);       // DO NOT COPY
+      void operator=(const Histogram &);    // DO NOT ASSIGN
     };
     
     // -------------------------------------------------------------------------
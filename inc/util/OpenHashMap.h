@@ -0,0 +1,217 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2011 The University of Edinburgh
+//                        All Rights Reserved
+// =====================================================================
+//
+// Description:
+//
+// Open-addressing hash map for integral keys (i.e. simulated addresses)
+// and POD values (i.e. pointers). All slots live in one flat array that
+// is probed linearly, hence a lookup touches one or two cache lines in
+// contrast to the pointer chasing of std::map<>.
+//
+// The key 0x1 is reserved to mark empty slots. This is an address that
+// no page frame or basic block can ever have.
+//
+// There is also an OpenHashMap::Iter iterator that visits all entries in
+// unspecified order:
+//
+// for (arcsim::util::OpenHashMap<uint32,PageProfile*>::Iter I(map);
+//      !I.is_end();
+//      ++I)
+// {
+//   I.value()->clear();
+// }
+//
+// The map must not be modified while it is iterated over.
+//
+// =====================================================================
+
+#ifndef INC_UTIL_OPENHASHMAP_H_
+#define INC_UTIL_OPENHASHMAP_H_
+
+#include "api/types.h"
+
+#include "util/Allocate.h"
+
+namespace arcsim {
+  namespace util {
+
+    template <typename K, typename V>
+    class OpenHashMap
+    {
+    private:
+      struct Slot {
+        K   key;
+        V   value;
+      };
+
+    public:
+      // Key marking an empty slot
+      //
+      static const uint32 kEmptyKey = 0x1;
+
+      // Table capacity upon first insertion, must be a power of two
+      //
+      static const uint32 kInitialCapacity = 16;
+
+      OpenHashMap()
+      : slots_(0), capacity_(0), size_(0), shift_(32)
+      { /* EMPTY */ }
+
+      ~OpenHashMap()
+      {
+        if (slots_) { Malloced::Delete(slots_); slots_ = 0; }
+      }
+
+      uint32  size()  const { return size_;       }
+      bool    empty() const { return size_ == 0;  }
+
+      // -----------------------------------------------------------------------
+      // Return pointer to value stored for key, or '0' if key is not present
+      //
+      inline V* find(K key) const
+      {
+        if (size_ == 0) { return 0; }
+        for (uint32 i = index(key); ; i = (i + 1) & (capacity_ - 1)) {
+          Slot * const s = slots_ + i;
+          if (s->key == key)       { return &s->value; }
+          if (s->key == kEmptyKey) { return 0;         }
+        }
+      }
+
+      // -----------------------------------------------------------------------
+      // Insert key/value pair if key is not present yet. Returns true if the
+      // pair has been inserted and false if the key was already present in
+      // which case the stored value is left untouched.
+      //
+      inline bool insert(K key, const V& value)
+      {
+        if ((size_ + 1) * 2 > capacity_) { grow(); }
+        for (uint32 i = index(key); ; i = (i + 1) & (capacity_ - 1)) {
+          Slot * const s = slots_ + i;
+          if (s->key == key) { return false; }
+          if (s->key == kEmptyKey) {
+            s->key   = key;
+            s->value = value;
+            ++size_;
+            return true;
+          }
+        }
+      }
+
+      // -----------------------------------------------------------------------
+      // Remove key, returns true if key was present. Entries following the
+      // removed one within its probe sequence are shifted back so that no
+      // 'tombstones' are needed.
+      //
+      bool erase(K key)
+      {
+        if (size_ == 0) { return false; }
+        const uint32 mask = capacity_ - 1;
+        uint32 i = index(key);
+        while (slots_[i].key != key) {
+          if (slots_[i].key == kEmptyKey) { return false; }
+          i = (i + 1) & mask;
+        }
+        for (uint32 j = (i + 1) & mask; slots_[j].key != kEmptyKey; j = (j + 1) & mask) {
+          // Move entry at 'j' into hole at 'i' unless its home slot lies
+          // cyclically within (i, j]
+          const uint32 home = index(slots_[j].key);
+          if (((j - home) & mask) >= ((j - i) & mask)) {
+            slots_[i] = slots_[j];
+            i = j;
+          }
+        }
+        slots_[i].key = kEmptyKey;
+        --size_;
+        return true;
+      }
+
+      // -----------------------------------------------------------------------
+      // Remove all entries, the table keeps its capacity
+      //
+      void clear()
+      {
+        if (size_ == 0) { return; }
+        Slot const * const end = slots_ + capacity_;
+        for (Slot * s = slots_; s < end; ++s) { s->key = kEmptyKey; }
+        size_ = 0;
+      }
+
+      // -----------------------------------------------------------------------
+      // Iterator over all entries
+      //
+      class Iter
+      {
+      public:
+        explicit Iter(const OpenHashMap& map)
+        : slot_(map.slots_), end_(map.slots_ + map.capacity_)
+        {
+          while (slot_ < end_ && slot_->key == kEmptyKey) { ++slot_; }
+        }
+
+        bool  is_end() const { return slot_ >= end_;  }
+        K     key()    const { return slot_->key;     }
+        V&    value()  const { return slot_->value;   }
+
+        Iter& operator++()
+        {
+          do { ++slot_; } while (slot_ < end_ && slot_->key == kEmptyKey);
+          return *this;
+        }
+
+      private:
+        Slot*        slot_;
+        Slot const*  end_;
+      };
+
+    private:
+      friend class Iter;
+
+      Slot*   slots_;
+      uint32  capacity_;    // number of slots, always a power of two
+      uint32  size_;        // number of occupied slots
+      uint32  shift_;       // 32 - log2(capacity_)
+
+      // Fibonacci hashing spreads the aligned (i.e. low-zero-bit) addresses
+      // used as keys evenly across the table.
+      //
+      inline uint32 index(K key) const
+      {
+        const uint32 folded = (uint32)key ^ (uint32)((uint64)key >> 32);
+        return (folded * 0x9E3779B9U) >> shift_;
+      }
+
+      void grow()
+      {
+        Slot * const old_slots    = slots_;
+        const uint32 old_capacity = capacity_;
+
+        capacity_ = old_capacity ? (old_capacity << 1) : kInitialCapacity;
+        shift_    = 32;
+        for (uint32 c = capacity_; c > 1; c >>= 1) { --shift_; }
+
+        slots_ = (Slot*)Malloced::New(capacity_ * sizeof(Slot));
+        Slot const * const end = slots_ + capacity_;
+        for (Slot * s = slots_; s < end; ++s) { s->key = kEmptyKey; }
+
+        // Re-insert all entries of the old table
+        //
+        for (Slot const * s = old_slots; s < old_slots + old_capacity; ++s) {
+          if (s->key == kEmptyKey) { continue; }
+          uint32 i = index(s->key);
+          while (slots_[i].key != kEmptyKey) { i = (i + 1) & (capacity_ - 1); }
+          slots_[i] = *s;
+        }
+        if (old_slots) { Malloced::Delete(old_slots); }
+      }
+
+      OpenHashMap(const OpenHashMap & m);       // DO NOT COPY
+      void operator=(const OpenHashMap &);      // DO NOT ASSIGN
+    };
+
+} } // arcsim::util
+
+#endif  // INC_UTIL_OPENHASHMAP_H_
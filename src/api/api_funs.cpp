@@ -17,6 +17,7 @@
 #include <string>
 #include <cstring>
 #include <map>
+#include <vector>
 
 #include "arch/Configuration.h"
 
@@ -31,6 +32,8 @@
 
 #include "util/Counter.h"
 
+#include "concurrent/Thread.h"
+
 
 // -----------------------------------------------------------------------------
 // Temporary macro for casting cpuContext into processor class.
@@ -174,6 +177,65 @@ int simRun (simContext sim)
 	return SYSTEM(sim)->simulate();
 }
 
+int simSaveCheckpoint (simContext sim, const char* path)
+{
+  return SYSTEM(sim)->save_checkpoint(path);
+}
+
+int simRestoreCheckpoint (simContext sim, const char* path)
+{
+  return SYSTEM(sim)->restore_checkpoint(path);
+}
+
+int simForkContext (simContext sim, int count, simContext children[])
+{
+  if (count < 1) return 0;
+  return SYSTEM(sim)->fork_state(reinterpret_cast<System* const*>(children), count);
+}
+
+// Thread running one simulation context until it stops
+//
+class SimulationThread : public arcsim::concurrent::Thread
+{
+public:
+  System& sys;
+  bool    status;
+  
+  explicit SimulationThread(System& _sys) : sys(_sys), status(false) { }
+  
+  void run() { status = sys.simulate(); }
+};
+
+// Contexts run in parallel share no state apart from process-global resources
+// that are already serialised (i.e. LLVM, shared library loading, logging and
+// the translation archive). A context must therefore appear only once.
+//
+int simRunContexts (int count, simContext sims[])
+{
+  for (int i = 0; i < count; ++i) {
+    for (int j = 0; j < i; ++j) {
+      if (sims[i] == sims[j]) {
+        LOG(LOG_ERROR) << "[API] Simulation context passed more than once to simRunContexts().";
+        return 0;
+      }
+    }
+  }
+  
+  std::vector<SimulationThread*> threads;
+  for (int i = 0; i < count; ++i) {
+    threads.push_back(new SimulationThread(*SYSTEM(sims[i])));
+    threads.back()->start();
+  }
+  
+  int status = 1;
+  for (int i = 0; i < count; ++i) {
+    threads[i]->join();
+    if (!threads[i]->status) { status = 0; }
+    delete threads[i];
+  }
+  return status;
+}
+
 void simTrace (simContext sim)
 {
   SYSTEM(sim)->trace(&SYSTEM(sim)->cpu[0]->delta);
@@ -291,7 +353,7 @@ void simVerboseOff (simContext sim)   {
 void simInteractiveOn (simContext sim)
 {
   SYSTEM(sim)->sim_opts.interactive     = true;
-  SYSTEM(sim)->sim_opts.halt_simulation = true;
+  SYSTEM(sim)->sim_opts.set_halt_simulation(true);
 }
 void simInteractiveOff(simContext sim)
 {
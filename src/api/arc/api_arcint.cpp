@@ -1427,6 +1427,7 @@ private:
       if (value) {
         if (key_is(value, "bb"))   arch_conf.sys_arch.sim_opts.fast_trans_mode = kCompilationModeBasicBlock;
         if (key_is(value, "page")) arch_conf.sys_arch.sim_opts.fast_trans_mode = kCompilationModePageControlFlowGraph;
+        if (key_is(value, "region")) arch_conf.sys_arch.sim_opts.fast_trans_mode = kCompilationModeRegion;
       }
     } else if (sim_prop_is(fast-thresh) ) {
       if (value) arch_conf.sys_arch.sim_opts.hotspot_threshold = arcsim_strtoul(value);
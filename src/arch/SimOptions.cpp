@@ -56,9 +56,21 @@ Special simulation modes:\n\
  -M | --emt                   Emulate OS traps (i.e. system calls)\n\
  -R | --trackregs             Register usage tracking simulation\n\
  -S | --sim   <insns>         Simulation period\n\
+ --dcode-cache <bytes>        Size of each decode cache in bytes (default: 2097152)\n\
+ --dcode-page                 Decode pages in bulk when they are first executed and look up decoded\n\
+                              instructions by page offset\n\
+ --dcode-page-cache <bytes>   Size of the decoded instructions held by each page granular decode\n\
+                              cache in bytes (default: 16777216)\n\
+\n\
+Sampled simulation options (effective with '--fast' and '--memory' or '--cycle'):\n\
+ --sample-period <insns>      Simulate one sample every <insns> instructions and fast-forward\n\
+                              functionally in between (default: 0 = disabled)\n\
+ --sample-warmup <insns>      Instructions warming caches and predictors before each sample\n\
+                              (default: 2000)\n\
+ --sample-detail <insns>      Instructions measured in detail per sample (default: 1000)\n\
 \n\
 Fast JIT mode options:\n\
- -m | --fast-trans-mode <mode>Fast translation mode [bb|page] (default: page)\n\
+ -m | --fast-trans-mode <mode>Fast translation mode [bb|page|region] (default: page)\n\
  -Q | --fast-num-threads <n>  Specify number of worker threads used for parallel JIT compilation\n\
  -n | --fast-thresh      <n>  Number of interpretations before a block is deemed to be hot\n\
  -D | --fast-trace-size  <n>  Trace interval size (i.e. # of interpreted blocks for one trace interval)\n\
@@ -69,11 +81,39 @@ Fast JIT mode options:\n\
  -r | --reuse                 Reuse previous fast mode files (effective with '--fast-cc')\n\
  -j | --fast-tmp-dir          Directory for storing intermediate JIT compilation results (effective with '--fast-cc')\n\
  -Y | --fast-use-inline-asm   Emit inline assembly code during JIT compilation (effective with '--fast-cc')\n\
+ --fast-cache <file>          Persistent translation cache archive, re-used across simulation runs\n\
+                              (effective with '--fast-cc')\n\
+ --fast-tier-up <n>           Compile translations with a fast baseline pipeline first and recompile\n\
+                              them fully optimised once a block executed <n> times natively\n\
+                              (default: 0 = disabled, not effective with '--fast-cc')\n\
+ --fast-pch                   Precompile the runtime prelude of translated modules once per JIT\n\
+                              worker instead of parsing it for each module (not effective with\n\
+                              '--fast-cc')\n\
+\n\
+Multi-core simulation options:\n\
+ --mc-quantum <n>             Instructions (blocks in fast mode) each core executes between\n\
+                              synchronisation barriers (default: 10000)\n\
+ --mc-deterministic           Execute cores in core order within each quantum to make runs\n\
+                              with a fixed quantum exactly reproducible\n\
+\n\
+Cache geometry sweep options (implies '--memory'):\n\
+ --icache-sweep <geom,...>    Simulate LRU instruction caches of all given geometries in a single\n\
+                              pass and report their miss ratios and miss-ratio curves\n\
+ --dcache-sweep <geom,...>    Same as '--icache-sweep' for data caches\n\
+                              A geometry is <size>:<ways>:<block size> (e.g. 16K:4:32)\n\
+\n\
+Checkpoint options:\n\
+ --checkpoint-save <file>     Save complete simulated system state to <file> when the simulation\n\
+                              stops (e.g. after '--sim <insns>' instructions or a halt)\n\
+ --checkpoint-restore <file>  Restore simulated system state from <file> after loading the target\n\
+                              (simulator configuration must match the saved system)\n\
 \n\
 Memory configuration options:\n\
 -Z | --mem-init       <value> Initialise each memory block with a custom value\n\
 -G | --mem-block-size <value> Memory block size in bytes (e.g. 512B,1K,2K,4K,8K,16K - default:8K)\n\
                               Note that MMU/CCM configuration may override memory block size setting.\n\
+ --mem-sparse                 Back memory by one sparse reservation of the 4GB physical address space\n\
+                              using transparent huge pages (64-bit hosts only)\n\
 \n\
 Handling of standard input/output/error and trace output:\n\
  -I | --input        <file>   Redirect standard input from file\n\
@@ -163,6 +203,10 @@ Supported memory device options used with '--mem-dev-x':\n\
 \n\
 Tracing and debug related options:\n\
  -t | --trace                 Trace each instruction (with symbol table lookup)\n\
+ --trace-binary               Write compact binary trace records to the trace output\n\
+                              file (see '-U') instead of formatted text\n\
+ --trace-render <file>        Render binary trace file in textual trace format to the\n\
+                              trace output instead of running a simulation\n\
  -P | --profile               Show function-level and HotSpot profiling information\n\
  -X | --dump-state            Output CPU state information\n\
  -d | --debug=<n>             Output debugging information\n\
@@ -188,6 +232,40 @@ Additional Verification Support Options:\n\
 ";
 #endif
 
+// Parse comma separated list of cache geometries '<size>:<ways>:<block size>'
+// where size may be suffixed by 'K' or 'M'. All values must be powers of two.
+//
+static bool
+parse_cache_geometries (const char* str, std::vector<CacheArch>& geometries)
+{
+  while (*str) {
+    char*  end;
+    uint32 size  = strtoul(str, &end, 10);
+    if      (*end == 'K' || *end == 'k') { size <<= 10; ++end; }
+    else if (*end == 'M' || *end == 'm') { size <<= 20; ++end; }
+    if (*end++ != ':') { return false; }
+    uint32 ways  = strtoul(end, &end, 10);
+    if (*end++ != ':') { return false; }
+    uint32 block = strtoul(end, &end, 10);
+    if (*end != ',' && *end != '\0') { return false; }
+    str = (*end == ',') ? end + 1 : end;
+    
+    if (   block < 4 || (block & (block - 1))
+        || ways == 0 || (ways  & (ways  - 1))
+        || size == 0 || (size  & (size  - 1))
+        || size < ways * block) {
+      return false;
+    }
+    CacheArch g;
+    g.is_configured = true;
+    g.size          = size;
+    g.ways          = ways;
+    while ((1U << g.block_bits) < block) { ++g.block_bits; }
+    geometries.push_back(g);
+  }
+  return !geometries.empty();
+}
+
 static void usage (const char *msg)
 {
   FPRINTF(stderr) << ARCSIM_COPYRIGHT << "usage: " << msg << std::endl; 
@@ -198,6 +276,30 @@ static void usage (const char *msg)
 }
 
 
+// Long options without a single character equivalent use values above the
+// range of characters returned by getopt_long().
+//
+enum LongOnlyOption {
+  kOptMulticoreQuantum = 256,
+  kOptMulticoreDeterministic,
+  kOptFastCache,
+  kOptFastTierUp,
+  kOptFastPreludePch,
+  kOptTraceBinary,
+  kOptTraceRender,
+  kOptSamplePeriod,
+  kOptSampleWarmup,
+  kOptSampleDetail,
+  kOptIcacheSweep,
+  kOptDcacheSweep,
+  kOptCheckpointSave,
+  kOptCheckpointRestore,
+  kOptMemSparse,
+  kOptDcodeCache,
+  kOptDcodePage,
+  kOptDcodePageCache
+};
+
 static struct option long_options[] = {
   /* keep the following alphabetically ordered based on short option */
   { "arch",        required_argument, 0, 'a'  },
@@ -247,6 +349,25 @@ static struct option long_options[] = {
   { "fast-use-inline-asm", no_argument,0,'Y'  },
   { "parch",       no_argument,       0, 'z'  },
   { "mem-init",    required_argument, 0, 'Z'  },
+  /* long options without short option equivalent */
+  { "mc-quantum",  required_argument, 0, kOptMulticoreQuantum       },
+  { "mc-deterministic", no_argument,  0, kOptMulticoreDeterministic },
+  { "fast-cache",  required_argument, 0, kOptFastCache              },
+  { "fast-tier-up", required_argument, 0, kOptFastTierUp           },
+  { "fast-pch",    no_argument,       0, kOptFastPreludePch         },
+  { "trace-binary", no_argument,      0, kOptTraceBinary            },
+  { "trace-render", required_argument, 0, kOptTraceRender           },
+  { "sample-period", required_argument, 0, kOptSamplePeriod         },
+  { "sample-warmup", required_argument, 0, kOptSampleWarmup         },
+  { "sample-detail", required_argument, 0, kOptSampleDetail         },
+  { "icache-sweep", required_argument, 0, kOptIcacheSweep           },
+  { "dcache-sweep", required_argument, 0, kOptDcacheSweep           },
+  { "checkpoint-save", required_argument, 0, kOptCheckpointSave     },
+  { "checkpoint-restore", required_argument, 0, kOptCheckpointRestore },
+  { "mem-sparse",  no_argument,       0, kOptMemSparse              },
+  { "dcode-cache", required_argument, 0, kOptDcodeCache             },
+  { "dcode-page",  no_argument,       0, kOptDcodePage              },
+  { "dcode-page-cache", required_argument, 0, kOptDcodePageCache   },
   /* last element in array must be NULL i.e. empty */
   {NULL}
 };
@@ -319,9 +440,16 @@ const char* isa_tokens[] = {
 
 SimOptions::SimOptions()
 : sim_period(0),
+  sample_period(DEFAULT_SAMPLE_PERIOD),
+  sample_warmup(DEFAULT_SAMPLE_WARMUP),
+  sample_detail(DEFAULT_SAMPLE_DETAIL),
   obj_format(DEFAULT_OBJECT_FORMAT),
   big_endian(false),
   trace_on(DEFAULT_TRACE_ON),
+  trace_binary(DEFAULT_TRACE_BINARY),
+  trace_render_file(""),
+  checkpoint_save_file(""),
+  checkpoint_restore_file(""),
   sys_arch_file(DEFAULT_SYS_ARCH_FILE),
   isa_file(DEFAULT_ISA_FILE),
   print_sys_arch(DEFAULT_PRINT_SYS_ARCH),
@@ -335,10 +463,13 @@ SimOptions::SimOptions()
   fast_num_worker_threads(DEFAULT_FAST_NUM_WORKER_THREADS),
   fast_enable_debug(DEFAULT_FAST_ENABLE_DEBUG),
   fast_use_inline_asm(DEFAULT_FAST_USE_INLINE_ASM),
+  fast_tier_up_threshold(DEFAULT_FAST_TIER_UP_THRESHOLD),
+  fast_prelude_pch(DEFAULT_FAST_PRELUDE_PCH),
   fast_trans_mode(DEFAULT_FAST_TRANS_MODE),
   fast_cc(DEFAULT_FAST_CC),
   fast_mode_cc_opts(DEFAULT_FAST_MODE_CC_OPTS),
   fast_tmp_dir(DEFAULT_FAST_TMP_DIR),
+  fast_cache_file(DEFAULT_FAST_CACHE_FILE),
   cycle_sim(DEFAULT_CYCLE_SIM),
   memory_sim(DEFAULT_MEMORY_SIM),
   keep_files(DEFAULT_KEEP_FILES),
@@ -349,6 +480,7 @@ SimOptions::SimOptions()
   emulate_traps(DEFAULT_EMULATE_TRAPS),
   init_mem_custom(DEFAULT_INIT_MEM_CUSTOM),
   init_mem_value(0),
+  mem_sparse(DEFAULT_MEM_SPARSE),
   page_size_log2(DEFAULT_LOG2_PAGE_SIZE),
   obj_name(DEFAULT_OBJECT_NAME),
   app_args(0),
@@ -365,10 +497,14 @@ SimOptions::SimOptions()
   std_error_file(""),
   rerr_fd(-1),
   halt_simulation(0),
-  dcode_cache_size(DEFAULT_DCODE_CACHE_SIZE),
+  dcode_cache_bytes(DEFAULT_DCODE_CACHE_BYTES),
+  dcode_page(DEFAULT_DCODE_PAGE),
+  dcode_page_cache_bytes(DEFAULT_DCODE_PAGE_CACHE_BYTES),
   trans_cache_size(DEFAULT_TRANS_CACHE_SIZE),
   trace_interval_size(DEFAULT_TRACE_INTERVAL_SIZE),
   hotspot_threshold(DEFAULT_HOTSPOT_THRESHOLD),
+  mc_quantum(DEFAULT_MC_QUANTUM),
+  mc_deterministic(DEFAULT_MC_DETERMINISTIC),
   print_sim_cfg(DEFAULT_PRINT_SIM_CFG),
   has_mmx(DEFAULT_HAS_MMX),
   is_eia_enabled(false),
@@ -435,6 +571,23 @@ SimOptions::get_sim_opts(Configuration* _arch_conf, int argc, char *argv[])
       case 't':
         trace_on = true;
         break;
+        
+      case kOptTraceBinary:
+        trace_binary = true;
+        break;
+        
+      case kOptTraceRender:
+        trace_render_file = optarg;
+        LOG(LOG_INFO) << "Rendering binary trace file '" << trace_render_file << "'";
+        break;
+        
+      case kOptCheckpointSave:
+        checkpoint_save_file = optarg;
+        break;
+        
+      case kOptCheckpointRestore:
+        checkpoint_restore_file = optarg;
+        break;
                 
       case 'k':
         keep_files = true;
@@ -518,6 +671,7 @@ SimOptions::get_sim_opts(Configuration* _arch_conf, int argc, char *argv[])
       case 'm': {
         if (!strcmp(optarg, "bb"))  fast_trans_mode = kCompilationModeBasicBlock;
         if (!strcmp(optarg, "page"))fast_trans_mode = kCompilationModePageControlFlowGraph;
+        if (!strcmp(optarg, "region"))fast_trans_mode = kCompilationModeRegion;
         LOG(LOG_INFO) << "JIT translation mode: '" << fast_trans_mode << "'";
         break;
       }
@@ -587,6 +741,90 @@ SimOptions::get_sim_opts(Configuration* _arch_conf, int argc, char *argv[])
         fast_use_inline_asm = true;
         break;
       }
+        // Persistent translation cache
+        //
+      case kOptFastCache: {
+        fast_cache_file = optarg;
+        LOG(LOG_INFO) << "Persistent translation cache: '" << fast_cache_file << "'";
+        break;
+      }
+        // Tiered JIT compilation
+        //
+      case kOptFastTierUp: {
+        int threshold = atoi(optarg);
+        if (threshold >= 0) {
+          fast_tier_up_threshold = (uint32)threshold;
+        } else {
+          LOG(LOG_ERROR) << "Tier-up threshold must be >= 0.";
+          exit(EXIT_FAILURE);
+        }
+        LOG(LOG_INFO) << "Tier-up threshold: '" << fast_tier_up_threshold << "'";
+        break;
+      }
+        // Precompiled JIT module prelude
+        //
+      case kOptFastPreludePch: {
+        fast_prelude_pch = true;
+        break;
+      }
+       
+        
+      // -----------------------------------------------------------------------
+      // Multi-core simulation options
+      //
+        
+      case kOptMulticoreQuantum: {
+        int quantum = atoi(optarg);
+        if (quantum > 0) {
+          mc_quantum = (uint32)quantum;
+        } else {
+          LOG(LOG_ERROR) << "Multi-core simulation quantum must be > 0.";
+          exit(EXIT_FAILURE);
+        }
+        LOG(LOG_INFO) << "Multi-core simulation quantum: '" << mc_quantum << "'";
+        break;
+      }
+      case kOptMulticoreDeterministic: {
+        mc_deterministic = true;
+        break;
+      }
+       
+        
+      // -----------------------------------------------------------------------
+      // Sampled simulation options
+      //
+        
+      case kOptSamplePeriod: {
+        sample_period = atoll(optarg);
+        LOG(LOG_INFO) << "Sample period: '" << sample_period << "'";
+        break;
+      }
+      case kOptSampleWarmup: {
+        sample_warmup = atoll(optarg);
+        break;
+      }
+      case kOptSampleDetail: {
+        sample_detail = atoll(optarg);
+        break;
+      }
+       
+        
+      // -----------------------------------------------------------------------
+      // Cache geometry sweeps
+      //
+        
+      case kOptIcacheSweep:
+      case kOptDcacheSweep: {
+        std::vector<CacheArch>& geometries = (c == kOptIcacheSweep) ? icache_sweep : dcache_sweep;
+        geometries.clear();
+        if (!parse_cache_geometries(optarg, geometries)) {
+          LOG(LOG_ERROR) << "Illegal cache geometry list '" << optarg
+                         << "', expected <size>:<ways>:<block size>[,...].";
+          exit(EXIT_FAILURE);
+        }
+        memory_sim = true;
+        break;
+      }
        
         
       // -----------------------------------------------------------------------
@@ -740,6 +978,36 @@ SimOptions::get_sim_opts(Configuration* _arch_conf, int argc, char *argv[])
         init_mem_value  = (uint32)atoi(optarg);
         break;
         
+      case kOptMemSparse:
+        mem_sparse = true;
+        break;
+        
+      case kOptDcodeCache: {
+        int bytes = atoi(optarg);
+        if (bytes > 0) {
+          dcode_cache_bytes = (uint32)bytes;
+        } else {
+          LOG(LOG_ERROR) << "Decode cache size must be > 0.";
+          exit(EXIT_FAILURE);
+        }
+        break;
+      }
+        
+      case kOptDcodePage:
+        dcode_page = true;
+        break;
+        
+      case kOptDcodePageCache: {
+        int bytes = atoi(optarg);
+        if (bytes > 0) {
+          dcode_page_cache_bytes = (uint32)bytes;
+        } else {
+          LOG(LOG_ERROR) << "Page granular decode cache size must be > 0.";
+          exit(EXIT_FAILURE);
+        }
+        break;
+      }
+        
       case 'M':
         emulate_traps = true;
         // Historically under emulate_traps mode, memory pages that are not
@@ -1072,6 +1340,25 @@ SimOptions::get_sim_opts(Configuration* _arch_conf, int argc, char *argv[])
   
   app_args = optind;
 
+  // Binary trace records can not be written to stdout
+  //
+  if (trace_on && trace_binary && !redir_inst_trace_output) {
+    LOG(LOG_ERROR) << "Binary tracing requires a trace output file (i.e. '-U <file>').";
+    exit(EXIT_FAILURE);
+  }
+  
+  // Sampled simulation fast-forwards in JIT mode and samples the memory model
+  //
+  if (sample_period) {
+    if (!fast || !memory_sim) {
+      LOG(LOG_ERROR) << "Sampled simulation requires '--fast' and '--memory' or '--cycle'.";
+      exit(EXIT_FAILURE);
+    }
+    if (sample_detail == 0 || sample_warmup + sample_detail > sample_period) {
+      LOG(LOG_ERROR) << "Sample period must be >= warm-up + detail instructions, and detail must be > 0.";
+      exit(EXIT_FAILURE);
+    }
+  }
   
   // Output ISA specific options
   //
@@ -0,0 +1,62 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2010 The University of Edinburgh
+//                        All Rights Reserved
+// =====================================================================
+//
+// Description: Definition of a reusable Barrier class.
+//
+// =====================================================================
+
+#include "Assertion.h"
+
+#include "concurrent/Barrier.h"
+#include "concurrent/ScopedLock.h"
+
+namespace arcsim {
+  namespace concurrent {
+
+      // Construct a Barrier
+      //
+      Barrier::Barrier(uint32 count)
+      : count_(count),
+        waiting_(0),
+        generation_(0)
+      {
+        ASSERT(count_ > 0 && "Barrier requires at least one participant!");
+      }
+
+      // Destruct Barrier
+      //
+      Barrier::~Barrier()
+      {
+        ASSERT(waiting_ == 0 && "Barrier destroyed while threads are waiting!");
+      }
+
+      // Wait for all participating threads. The generation counter protects
+      // against spurious wake-ups and allows the barrier to be re-used for
+      // consecutive episodes without re-initialisation.
+      //
+      bool
+      Barrier::wait()
+      {
+        ScopedLock lock(mtx_);
+
+        const uint32 generation = generation_;
+
+        if (++waiting_ == count_) {
+          // Last thread to arrive releases all other threads
+          //
+          waiting_ = 0;
+          ++generation_;
+          cond_.broadcast();
+          return true;
+        }
+
+        while (generation == generation_) {
+          cond_.wait(mtx_);
+        }
+        return false;
+      }
+
+} } // arcsim::concurrent
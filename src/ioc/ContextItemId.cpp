@@ -47,6 +47,10 @@ namespace arcsim {
     const char* ContextItemId::kInterpInstCount64     = "counter64.interpreted-instructions";
     const char* ContextItemId::kNativeInstCount64     = "counter64.native-instructions";
     const char* ContextItemId::kCycleCount64          = "counter64.cycles";
+    const char* ContextItemId::kSmcInvalidationCount64          = "counter64.smc-invalidations";
+    const char* ContextItemId::kSmcDiscardedTranslationCount64  = "counter64.smc-discarded-translations";
+    const char* ContextItemId::kRegionTransferCount64           = "counter64.region-transfers";
+    const char* ContextItemId::kRegionGuardFailCount64          = "counter64.region-guard-failures";
 
     // SymbolTable
     //
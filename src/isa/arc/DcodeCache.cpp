@@ -16,19 +16,26 @@ namespace arcsim {
     namespace arc {
 
       DcodeCache::DcodeCache()
-      : size_(0), cache_(0)
+      : size_(0), cache_(0), dcode_(0)
       { /* EMPTY */ }
 
       DcodeCache::~DcodeCache()
       {
         if (cache_) arcsim::util::Malloced::Delete(cache_);
+        if (dcode_) arcsim::util::Malloced::DeleteAligned(dcode_);
       }
 
-      void DcodeCache::construct (uint32 size)
+      void DcodeCache::construct (uint32 bytes)
       {
-        ASSERT(IS_POWER_OF_TWO(size) && "DcodeCache capacity not power of two!");
-        size_  = (size >> 1); // an Entry holds two ways hence we divide size by two
+        ASSERT(cache_ == 0 && "DcodeCache constructed twice!");
+        // Largest power of two number of sets fitting into 'bytes', at least one
+        size_ = 1;
+        while ((size_ << 1) * kBytesPerSet <= bytes) { size_ <<= 1; }
+        
         cache_ = (Entry*)arcsim::util::Malloced::New(size_ * sizeof(Entry));
+        // Dcode objects start on a cache line boundary so the hot part of each
+        // one shares a single cache line (@see Dcode)
+        dcode_ = (arcsim::isa::arc::CacheAlignedDcode*)arcsim::util::Malloced::NewAligned((size_ << 1) * sizeof(arcsim::isa::arc::CacheAlignedDcode));
         purge(); // clear out dcode cache
       }
       
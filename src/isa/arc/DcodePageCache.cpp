@@ -0,0 +1,107 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2011 The University of Edinburgh
+//                        All Rights Reserved
+// =====================================================================
+
+#include <cstring>
+
+#include "isa/arc/DcodePageCache.h"
+
+#include "Assertion.h"
+
+#include "util/Allocate.h"
+
+namespace arcsim {
+  namespace isa {
+    namespace arc {
+
+      // Virtual page number that never matches, pages are at least 512 bytes
+      //
+      static const uint32 kInvalidPage = 0xFFFFFFFF;
+
+      DcodePageCache::DcodePageCache()
+      : page_bits_(0), page_offset_mask_(0), page_slots_(0), size_(0),
+        pages_(0), slots_(0), pool_(0)
+      { /* EMPTY */ }
+
+      DcodePageCache::~DcodePageCache()
+      {
+        if (pages_) arcsim::util::Malloced::Delete(pages_);
+        if (slots_) arcsim::util::Malloced::Delete(slots_);
+        if (pool_)  arcsim::util::Malloced::DeleteAligned(pool_);
+      }
+
+      void
+      DcodePageCache::construct (uint32 page_bits, uint32 bytes)
+      {
+        ASSERT(pages_ == 0 && "DcodePageCache constructed twice!");
+        page_bits_        = page_bits;
+        page_offset_mask_ = (1U << page_bits) - 1;
+        page_slots_       = (1U << page_bits) >> 1;
+        // Largest power of two number of pages whose pools fit into 'bytes', at least one
+        const uint64 page_bytes = (uint64)page_slots_ * sizeof(CacheAlignedDcode);
+        size_ = 1;
+        while ((size_ << 1) * page_bytes <= bytes) { size_ <<= 1; }
+
+        pages_ = (Page*)  arcsim::util::Malloced::New(size_ * sizeof(Page));
+        slots_ = (Dcode**)arcsim::util::Malloced::New(size_ * page_slots_ * sizeof(Dcode*));
+        pool_  = (CacheAlignedDcode*)arcsim::util::Malloced::NewAligned(size_ * page_slots_ * sizeof(CacheAlignedDcode));
+        for (uint32 i = 0; i < size_; ++i) {
+          pages_[i].slots = slots_ + i * page_slots_;
+          pages_[i].pool  = pool_  + i * page_slots_;
+        }
+        purge(); // clear out cache
+      }
+
+      DcodePageCache::Page*
+      DcodePageCache::insert (uint32 pc)
+      {
+        const uint32 vpage = pc >> page_bits_;
+        Page * const p     = pages_ + (vpage & (size_ - 1));
+        if (p->page != vpage) {
+          clear_page(p);
+          p->page = vpage;
+        }
+        return p;
+      }
+
+      void
+      DcodePageCache::clear_page (Page* p)
+      {
+        p->page      = kInvalidPage;
+        p->pool_used = 0;
+        std::memset(p->slots, 0, page_slots_ * sizeof(Dcode*));
+      }
+
+      void
+      DcodePageCache::purge ()
+      {
+        for (uint32 i = 0; i < size_; ++i) { clear_page(pages_ + i); }
+      }
+
+      void
+      DcodePageCache::purge_range (uint32 addr, uint32 size)
+      {
+        // An instruction may start up to 8 bytes (i.e. instruction and LIMM)
+        // before the range and still overlap it
+        //
+        const uint32 first = (addr > 8 ? addr - 8 : 0) >> page_bits_;
+        const uint32 last  = (addr + (size ? size - 1 : 0)) >> page_bits_;
+        if (last - first >= size_) { purge(); return; }
+        for (uint32 vpage = first; vpage <= last; ++vpage) {
+          Page * const p = pages_ + (vpage & (size_ - 1));
+          if (p->page == vpage) { clear_page(p); }
+        }
+      }
+
+      void
+      DcodePageCache::purge_below (uint32 addr)
+      {
+        for (uint32 i = 0; i < size_; ++i) {
+          Page * const p = pages_ + i;
+          if (p->page != kInvalidPage && (p->page << page_bits_) < addr) { clear_page(p); }
+        }
+      }
+
+} } } //  arcsim::isa::arc
@@ -11,6 +11,27 @@
 
 #include "mem/mmap/IODevice.h"
 
+#include "ioc/Context.h"
+#include "ioc/ContextItemId.h"
+
+#include "sys/cpu/processor.h"
+
+#include "util/Log.h"
+
+// Retrieve processor instance from processor context, or 0 if 'cpu_ctx' is
+// not a processor context
+//
+static arcsim::sys::cpu::Processor*
+get_processor(IocContext cpu_ctx)
+{
+  arcsim::ioc::Context* const ctx = reinterpret_cast<arcsim::ioc::Context*>(cpu_ctx);
+  if (ctx == 0 || ctx->get_level() != arcsim::ioc::Context::kLProcessor) {
+    LOG(LOG_ERROR) << "[IODevice] passed IocContext is not a processor context.";
+    return 0;
+  }
+  return static_cast<arcsim::sys::cpu::Processor*>(ctx->get_item(arcsim::ioc::ContextItemId::kProcessor));
+}
+
 namespace arcsim {
   namespace mem {
     namespace mmap {
@@ -20,6 +41,27 @@ namespace arcsim {
         sys_ctx_(0),
         base_addr_(0) 
       { /* EMPTY */ }
+
+      int
+      IODevice::schedule_event(IocContext cpu_ctx,
+                               arcsim::sys::cpu::EventCallbackInterface* callback,
+                               uint64 delay)
+      {
+        arcsim::sys::cpu::Processor* const cpu = get_processor(cpu_ctx);
+        if (cpu == 0) { return IO_API_ERROR; }
+        cpu->schedule_event(callback, delay);
+        return IO_API_OK;
+      }
+      
+      int
+      IODevice::cancel_event(IocContext cpu_ctx,
+                             arcsim::sys::cpu::EventCallbackInterface* callback)
+      {
+        arcsim::sys::cpu::Processor* const cpu = get_processor(cpu_ctx);
+        if (cpu == 0) { return IO_API_ERROR; }
+        cpu->cancel_event(callback);
+        return IO_API_OK;
+      }
       
 
 } } } /* namespace arcsim::mem::mmap */
@@ -26,6 +26,8 @@
 #include "mem/mmap/IODevice.h"
 #include "mem/mmap/IODeviceIrq.h"
 
+#include "util/Checkpoint.h"
+
 #define CPU_ID_OPTION   "-cpuid"
 #define CPU_NUM_OPTION  "-cpunum"
 
@@ -226,6 +228,28 @@ namespace arcsim {
       {
         return mem_dev_write(addr, data, size);
       }
+      
+      // -----------------------------------------------------------------------
+      // Checkpointing - the RTC follows the host clock and is not saved
+      //
+      void
+      IODeviceIrq::dev_save_checkpoint (arcsim::util::CheckpointWriter& writer)
+      {
+        vector_mutex.acquire();
+        writer.write_value(vector);
+        writer.write_value(state);
+        vector_mutex.release();
+      }
+      
+      bool
+      IODeviceIrq::dev_restore_checkpoint (arcsim::util::CheckpointReader& reader)
+      {
+        vector_mutex.acquire();
+        reader.read_value(vector);
+        reader.read_value(state);
+        vector_mutex.release();
+        return !reader.has_error();
+      }
 
       
       void
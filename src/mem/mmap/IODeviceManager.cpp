@@ -22,6 +22,7 @@
 
 #include "api/api_funs.h"
 
+#include "util/Checkpoint.h"
 #include "util/Log.h"
 
 #ifdef ENABLE_IO_DEVICES
@@ -191,6 +192,55 @@ namespace arcsim {
       }
       
       
+      // -----------------------------------------------------------------------
+      // Checkpointing - only configured devices are saved, the same devices
+      // must be configured in the same order when restoring
+      //
+      void
+      IODeviceManager::save_checkpoint(arcsim::util::CheckpointWriter& writer)
+      {
+        writer.begin_section(arcsim::util::Checkpoint::kSectionDevices);
+        writer.write_value(static_cast<uint32>(devices_ready.size()));
+        for (std::vector<IODevice*>::iterator
+             I = devices_ready.begin(),
+             E = devices_ready.end();
+             I != E; ++I)
+        {
+          writer.write_string((*I)->id());
+          (*I)->dev_save_checkpoint(writer);
+        }
+      }
+      
+      bool
+      IODeviceManager::restore_checkpoint(arcsim::util::CheckpointReader& reader)
+      {
+        uint32 count = 0;
+        if (!reader.expect_section(arcsim::util::Checkpoint::kSectionDevices)
+            || !reader.read_value(count)) {
+          return false;
+        }
+        if (count != devices_ready.size()) {
+          LOG(LOG_ERROR) << "[IO-DEVMGR] Checkpoint holds '" << count
+                         << "' devices but '" << devices_ready.size() << "' are configured.";
+          return false;
+        }
+        for (std::vector<IODevice*>::iterator
+             I = devices_ready.begin(),
+             E = devices_ready.end();
+             I != E; ++I)
+        {
+          std::string id;
+          if (!reader.read_string(id) || id != (*I)->id()) {
+            LOG(LOG_ERROR) << "[IO-DEVMGR] Checkpoint device '" << id
+                           << "' does not match configured device '" << (*I)->id() << "'.";
+            return false;
+          }
+          LOG(LOG_DEBUG3) << "[IO-DEVMGR] Restoring device: " << id;
+          if (!(*I)->dev_restore_checkpoint(reader)) { return false; }
+        }
+        return true;
+      }
+      
       bool
       IODeviceManager::destroy_devices()
       {
@@ -36,6 +36,7 @@
 #include "concurrent/ScopedLock.h"
 
 #include "util/Allocate.h"
+#include "util/Checkpoint.h"
 #include "util/OutputStream.h"
 #include "util/Log.h"
 
@@ -344,6 +345,26 @@ namespace arcsim {
         return mem_dev_write(addr, data, size);
       }
       
+      // -----------------------------------------------------------------------
+      // Checkpointing
+      //
+      void
+      IODeviceUart::dev_save_checkpoint (arcsim::util::CheckpointWriter& writer)
+      {
+        arcsim::concurrent::ScopedLock lock(buf_mutex);
+        writer.write(reg, sizeof(reg));
+        writer.write_value(buf);
+      }
+      
+      bool
+      IODeviceUart::dev_restore_checkpoint (arcsim::util::CheckpointReader& reader)
+      {
+        arcsim::concurrent::ScopedLock lock(buf_mutex);
+        reader.read(reg, sizeof(reg));
+        reader.read_value(buf);
+        return !reader.has_error();
+      }
+      
       // -----------------------------------------------------------------------
       // Read the next character in the receive buffer, moving the
       // buffer on to the next character if something was there.
@@ -28,6 +28,7 @@ namespace arcsim {
       inst_count(0),
       size_bytes(0),
       interp_count(0),
+      native_count(0),
       native_(0),
       module_(0),
       tstate_(kNotTranslated)
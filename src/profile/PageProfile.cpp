@@ -13,6 +13,8 @@
 
 #include <iomanip>
 #include <cstring>
+#include <vector>
+#include <algorithm>
 
 #include "Assertion.h"
 
@@ -33,12 +35,21 @@
 namespace arcsim {
   namespace profile {
 
+  // Order BlockEntries by their virtual address
+  //
+  static bool
+  is_lower_virt_addr(const BlockEntry* a, const BlockEntry* b)
+  {
+    return a->virt_addr < b->virt_addr;
+  }
+
   // -----------------------------------------------------------------------------
   // Constructor/Destructor
   //
   PageProfile::PageProfile (uint32 addr)
     : page_address(addr),
       module_count_(0),
+      generation_(0),
       interp_count_(0)
   {
     for (uint32 i = 0; i < NUM_INTERRUPT_STATES; ++i) {
@@ -80,19 +91,9 @@ namespace arcsim {
     bool
     PageProfile::is_block_entry_present(uint32 addr) const
     {
-      for (std::map<uint32,BlockEntry*>::const_iterator
-           I = block_map_.upper_bound(addr),
-           E = block_map_.begin();
-           I != E; /* left blank on purpose */ )
+      for (arcsim::util::OpenHashMap<uint32,BlockEntry*>::Iter I(block_map_); !I.is_end(); ++I)
       {
-        --I; // Pay attention! We need to decrement the iterator right at the
-        // start to ensure we include begin()! Why?
-        
-        // See http://bytes.com/topic/c/answers/790809-stl-map-reverse-iterator-lower_bound
-        // Andrew Koenig: "Rule of thumb: decrement before you use the iterator; increment after you
-        // use it."
-        
-        const BlockEntry& b = *I->second;
+        const BlockEntry& b = *I.value();
         if ((addr >= b.phys_addr) && (addr < (b.phys_addr + b.size_bytes)))
           return true;
       }
@@ -106,19 +107,9 @@ namespace arcsim {
     bool
     PageProfile::is_block_entry_translation_present(uint32 addr) const
     {
-      for (std::map<uint32,BlockEntry*>::const_iterator
-           I = block_map_.upper_bound(addr),
-           E = block_map_.begin();
-           I != E; /* left blank on purpose */ )
+      for (arcsim::util::OpenHashMap<uint32,BlockEntry*>::Iter I(block_map_); !I.is_end(); ++I)
       {
-        --I; // Pay attention! We need to decrement the iterator right at the
-        // start to ensure we include begin()! Why?
-        
-        // See http://bytes.com/topic/c/answers/790809-stl-map-reverse-iterator-lower_bound
-        // Andrew Koenig: "Rule of thumb: decrement before you use the iterator; increment after you
-        // use it."
-        
-        const BlockEntry& b = *I->second;
+        const BlockEntry& b = *I.value();
         if (!b.is_not_translated()
             && (addr >= b.phys_addr) && (addr < (b.phys_addr + b.size_bytes)))
           return true;
@@ -141,8 +132,7 @@ PageProfile::trace_block (BlockEntry&     block,
   // ---------------------------------------------------------------------------
   // NODES - check if this block entry has been registered as a node
   //
-	if (nodes_.find(block.virt_addr) == nodes_.end())
-    nodes_[block.virt_addr] = &block;
+	nodes_.insert(block.virt_addr, &block);
 
   // ---------------------------------------------------------------------------
   // EDGES - add an edge if this block belongs to an active trace sequence
@@ -153,30 +143,9 @@ PageProfile::trace_block (BlockEntry&     block,
     //
     ASSERT(prev_block_[irq_state] != kInvalidBlockEntryAddress);
 
-    bool   matching_edge  = false;
-    
-    std::pair<std::multimap<uint32,BlockEntry*>::const_iterator,
-              std::multimap<uint32,BlockEntry*>::const_iterator> from_edges;
-    
-    // Find all Edges from previous node
-    //
-    from_edges = edges_.equal_range(prev_block_[irq_state]);
-    
-		// Linear search for edges that match destination node
-    //
-		for (std::multimap<uint32,BlockEntry*>::const_iterator
-         I = from_edges.first, E = from_edges.second; I != E; ++I)
-    {
-			if (I->second->virt_addr == block.virt_addr) {
-        matching_edge = true;
-        break;
-      }
-		}
-    // If no edge with matching destination was found, we need to insert it
+    // Insert edge from previous node unless it has been recorded already
     //
-    if (!matching_edge) {
-      edges_.insert(std::pair<uint32,BlockEntry*>(prev_block_[irq_state], &block));	
-    }
+    edges_.insert(edge_key(prev_block_[irq_state], block.virt_addr), &block);
 	}
   // Remember this block as the last one added for this interrupt state, so we
   // know where to draw the edge from, for the next block in this trace sequence
@@ -184,6 +153,18 @@ PageProfile::trace_block (BlockEntry&     block,
   prev_block_[irq_state] = block.virt_addr;
 }
 
+// -----------------------------------------------------------------------------
+// Record edge from the last block of the active trace sequence on this page to
+// a block on another page. Only used for mode 'kCompilationModeRegion'.
+//
+void
+PageProfile::trace_exit (BlockEntry& block, InterruptState irq_state)
+{
+  if (prev_block_[irq_state] != kInvalidBlockEntryAddress) {
+    edges_.insert(edge_key(prev_block_[irq_state], block.virt_addr), &block);
+  }
+}
+
 // -----------------------------------------------------------------------------
 // Depending on the translation mode the semantics of 'hotspot' change. The
 // following are rather ad-hoc implementations
@@ -194,9 +175,9 @@ PageProfile::has_hotspots(CompilationMode mode, uint32 threshold) const
   if (nodes_.empty()) // No blocks were touched - page is cold
       return false;
 
-  // ---- kCompilationModePageControlFlowGraph mode
+  // ---- kCompilationModePageControlFlowGraph and kCompilationModeRegion mode
   //
-  if (mode == kCompilationModePageControlFlowGraph)
+  if (mode == kCompilationModePageControlFlowGraph || mode == kCompilationModeRegion)
     return (interp_count_ >= threshold);
   
   // ---- For all other compilation modes
@@ -204,9 +185,8 @@ PageProfile::has_hotspots(CompilationMode mode, uint32 threshold) const
 
   // Trace is hot if there is one basic block that has been executed often enough
   //      
-  for (std::map<uint32,BlockEntry*>::const_iterator I = nodes_.begin(), E = nodes_.end();
-       I != E; ++I) {
-    if (I->second->interp_count >= threshold)
+  for (arcsim::util::OpenHashMap<uint32,BlockEntry*>::Iter I(nodes_); !I.is_end(); ++I) {
+    if (I.value()->interp_count >= threshold)
       return true;
   }
   
@@ -226,20 +206,26 @@ PageProfile::create_translation_work_unit(arcsim::sys::cpu::Processor& cpu,
   // add lp_end_to_lp_start_map to work_unit
   work_unit.lp_end_to_lp_start_map = cpu.lp_end_to_lp_start_map;
   
+  // Blocks are translated in ascending address order
+  //
+  std::vector<BlockEntry*> blocks;
+  blocks.reserve(nodes_.size());
+  for (arcsim::util::OpenHashMap<uint32,BlockEntry*>::Iter I(nodes_); !I.is_end(); ++I) {
+    blocks.push_back(I.value());
+  }
+  std::sort(blocks.begin(), blocks.end(), is_lower_virt_addr);
+  
+  arcsim::util::OpenHashMap<uint32,TranslationBlockUnit*> block_units;
   
-  for (std::map<uint32,BlockEntry*>::const_iterator I = nodes_.begin(), E = nodes_.end();
+  for (std::vector<BlockEntry*>::const_iterator I = blocks.begin(), E = blocks.end();
        success && (I != E); ++I)
   {
-    BlockEntry* block = I->second;
+    BlockEntry* block = *I;
     
     // HEAP allocate TranslationBlockUnit
     TranslationBlockUnit* block_unit = new TranslationBlockUnit(block);
     work_unit.blocks.push_back(block_unit);
-    
-    // Compute CFG edges from this block if mode is 'kCompilationModePageControlFlowGraph'
-    //
-    if (mode == kCompilationModePageControlFlowGraph)
-      get_block_edges(*block, block_unit->edges_);
+    block_units.insert(block->virt_addr, block_unit);
     
     // create block of instructions for translation
     success = create_translation_block_unit(cpu, *block, work_unit, *block_unit);
@@ -248,26 +234,251 @@ PageProfile::create_translation_work_unit(arcsim::sys::cpu::Processor& cpu,
     work_unit.exec_freq += block->interp_count;
   }
   
+  // Compute CFG edges between blocks if mode is 'kCompilationModePageControlFlowGraph'
+  //
+  if (success && mode == kCompilationModePageControlFlowGraph)
+    get_block_edges(block_units);
+  
   return success;
 }
 
-// Finds all outgoing edges from a given block
+// -----------------------------------------------------------------------------
+// Generate region work unit. Off-page blocks are guarded by the generation of
+// their page at this point in time, and by the translation cache epoch of the
+// processor as their virtual address only maps to the traced physical address
+// until the MMU mapping changes.
 //
-void
-PageProfile::get_block_edges(BlockEntry&              block,
-                             std::list<BlockEntry*>&  dest_blocks) const
-{ // Compute start and end range for all edges from a given block
+bool
+PageProfile::create_region_work_unit(arcsim::sys::cpu::Processor&     cpu,
+                                     const std::vector<BlockEntry*>&  off_page_blocks,
+                                     const std::vector<PageProfile*>& pages,
+                                     TranslationWorkUnit&             work_unit)
+{
+  ASSERT(off_page_blocks.size() == pages.size());
+  
+  bool success = create_translation_work_unit(cpu, kCompilationModeRegion, work_unit);
+  
+  arcsim::util::OpenHashMap<uint32,TranslationBlockUnit*> block_units;
+  for (std::list<TranslationBlockUnit*>::const_iterator I = work_unit.blocks.begin(), E = work_unit.blocks.end();
+       I != E; ++I) {
+    block_units.insert((*I)->entry_.virt_addr, *I);
+  }
+  
+  for (uint32 i = 0; success && i < off_page_blocks.size(); ++i)
+  {
+    BlockEntry* block = off_page_blocks[i];
+    
+    // HEAP allocate TranslationBlockUnit
+    TranslationBlockUnit* block_unit = new TranslationBlockUnit(block);
+    block_unit->region_guard_      = pages[i]->get_generation_ptr();
+    block_unit->region_generation_ = pages[i]->get_generation();
+    work_unit.blocks.push_back(block_unit);
+    block_units.insert(block->virt_addr, block_unit);
+    
+    // create block of instructions for translation
+    success = create_translation_block_unit(cpu, *block, work_unit, *block_unit);
+  }
+  
+  // Compute CFG edges between blocks from the edges recorded on each page
   //
-  std::pair<std::multimap<uint32,BlockEntry*>::const_iterator,
-            std::multimap<uint32,BlockEntry*>::const_iterator> from_edges = edges_.equal_range(block.virt_addr);
+  if (success) {
+    get_block_edges(block_units);
+    for (uint32 i = 0; i < pages.size(); ++i) {
+      if (std::find(pages.begin(), pages.begin() + i, pages[i]) == pages.begin() + i)
+        pages[i]->get_block_edges(block_units);
+    }
+  }
+  
+  work_unit.region_epoch = cpu.get_trans_cache_epoch();
+  return success;
+}
+
+// -----------------------------------------------------------------------------
+// Append destinations of edges leaving the given blocks
+//
+void
+PageProfile::get_successors(const arcsim::util::OpenHashMap<uint32,BlockEntry*>& from,
+                            std::vector<BlockEntry*>&                            to) const
+{
+  for (arcsim::util::OpenHashMap<uint64,BlockEntry*>::Iter I(edges_); !I.is_end(); ++I)
+  {
+    BlockEntry** const b = from.find((uint32)(I.key() >> 32));
+    // source block must be the one on this page
+    if (b && find_block_entry((*b)->phys_addr) == *b)
+      to.push_back(I.value());
+  }
+}
 
-  // Add all edges leading away from a block
+// -----------------------------------------------------------------------------
+// Recompile the first hot baseline module on this page. Edges of the original
+// trace are not retained once a module is translated, hence every block of the
+// module is treated as a potential target of indirect control transfers.
+//
+bool
+PageProfile::create_tier_up_work_unit(arcsim::sys::cpu::Processor& cpu,
+                                      uint32                       threshold,
+                                      TranslationWorkUnit&         work_unit)
+{
+  TranslationModule*      baseline = 0;
+  std::list<BlockEntry*>  entries;
+  
+  for (std::map<sint32,TranslationModule*>::const_iterator I = module_map_.begin(), E = module_map_.end();
+       !baseline && I != E; ++I)
+  {
+    TranslationModule* const m = I->second;
+    if (!m->is_baseline() || m->is_tier_up_pending())
+      continue;
+    
+    m->lock();
+    if (m->is_translated() && m->is_hot(threshold)) {
+      m->get_block_entries(entries);
+      baseline = m;
+    }
+    m->unlock();
+  }
+  
+  if (!baseline || entries.empty())
+    return false;
+  
+  work_unit.lp_end_to_lp_start_map = cpu.lp_end_to_lp_start_map;
+  
+  bool success = true;
+  for (std::list<BlockEntry*>::const_iterator I = entries.begin(), E = entries.end();
+       success && (I != E); ++I)
+  {
+    TranslationBlockUnit* block_unit = new TranslationBlockUnit(*I);
+    work_unit.blocks.push_back(block_unit);
+    block_unit->edges_ = entries;
+    success = create_translation_block_unit(cpu, **I, work_unit, *block_unit);
+    work_unit.exec_freq += (*I)->native_count;
+  }
+  if (success)
+    work_unit.module = create_module(cpu.sim_opts);
+  
+  // Baseline code only requests a tier-up when its execution count reaches the
+  // threshold, hence re-arm it so that recompilation is attempted again later
+  if (work_unit.module == 0) {
+    baseline->lock();
+    baseline->reset_exec_counts();
+    baseline->unlock();
+    return false;
+  }
+  
+  work_unit.module->set_baseline(baseline);
+  baseline->mark_as_tier_up_pending();
+  
+  LOG(LOG_DEBUG) << "[PageProfile] recompiling hot baseline module '" << baseline->get_id()
+                 << "' as '" << work_unit.module->get_id() << "'.";
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// Install optimised modules. This method must only be called by the processor
+// owning this page while it is not executing native code, as baseline code is
+// freed.
+//
+int
+PageProfile::install_optimised_modules()
+{
+  int                           num_installed = 0;
+  std::list<TranslationModule*> failed_modules;
+  
+  for (std::map<sint32,TranslationModule*>::iterator I = module_map_.begin();
+       I != module_map_.end(); ++I)
+  {
+    TranslationModule* const m        = I->second;
+    TranslationModule* const baseline = m->get_baseline();
+    
+    if (baseline == 0)
+      continue;
+    
+    // -----------------------------------------------------------------------
+    // BEGIN SYNCHRONISATION on module
+    //
+    m->lock();
+    const bool ready  = m->is_translated();
+    const bool failed = m->is_failed();
+    if (ready) {
+      // Release BlockEntries from baseline module and hand them to optimised module
+      //
+      baseline->lock();
+      baseline->erase_block_entries();
+      baseline->unlock();
+      
+      m->install_staged_block_entries();
+      m->set_baseline(0);
+    }
+    m->unlock();
+    //
+    // END SYNCHRONISATION on module
+    // -----------------------------------------------------------------------
+    
+    if (failed) {
+      // Failed optimised modules are dropped below, their baseline modules are
+      // re-armed and recompiled once they executed 'threshold' more times
+      //
+      baseline->lock();
+      baseline->reset_exec_counts();
+      baseline->unlock();
+      baseline->clear_tier_up_pending();
+      m->set_baseline(0);
+      failed_modules.push_back(m);
+      continue;
+    }
+    
+    if (ready) {
+      // Remove and GC replaced baseline module
+      //
+      for (std::map<sint32,TranslationModule*>::iterator B = module_map_.begin();
+           B != module_map_.end(); ++B)
+      {
+        if (B->second == baseline) {
+          module_map_.erase(B);
+          break;
+        }
+      }
+      LOG(LOG_DEBUG) << "[PageProfile] replaced baseline module '" << baseline->get_id()
+                     << "' by '" << m->get_id() << "' on page 0x" << HEX(page_address);
+      delete baseline;
+      ++num_installed;
+    }
+  }
+  
+  // Remove and GC failed optimised modules
   //
-  for (std::multimap<uint32,BlockEntry*>::const_iterator I  = from_edges.first;
-       I != from_edges.second; ++I)
+  for (std::list<TranslationModule*>::const_iterator F = failed_modules.begin();
+       F != failed_modules.end(); ++F)
+  {
+    for (std::map<sint32,TranslationModule*>::iterator I = module_map_.begin();
+         I != module_map_.end(); ++I)
+    {
+      if (I->second == *F) {
+        module_map_.erase(I);
+        break;
+      }
+    }
+    LOG(LOG_DEBUG) << "[PageProfile] dropped failed optimised module '" << (*F)->get_id()
+                   << "' on page 0x" << HEX(page_address);
+    delete *F;
+  }
+  return num_installed;
+}
+
+// Adds all outgoing edges to the TranslationBlockUnits of their source blocks,
+// provided their destination blocks are part of the same TranslationWorkUnit
+//
+void
+PageProfile::get_block_edges(arcsim::util::OpenHashMap<uint32,TranslationBlockUnit*>& block_units) const
+{
+  for (arcsim::util::OpenHashMap<uint64,BlockEntry*>::Iter I(edges_); !I.is_end(); ++I)
   {
-    dest_blocks.push_back(I->second);
-  } 
+    const uint32 from_addr = (uint32)(I.key() >> 32);
+    TranslationBlockUnit** const u = block_units.find(from_addr);
+    TranslationBlockUnit** const v = block_units.find(I.value()->virt_addr);
+    if (u && v && &(*v)->entry_ == I.value() && find_block_entry((*u)->entry_.phys_addr) == &(*u)->entry_) {
+      (*u)->edges_.push_back(I.value());
+    }
+  }
 }
 
 
@@ -44,7 +44,11 @@ namespace arcsim {
       page_addr_shift_(0),
       page_frame_mask_(0),
       cache_size_(0),
-      cache_(0)
+      cache_(0),
+      trace_page_exits_(false),
+      region_count_(0),
+      region_block_count_(0),
+      region_page_count_(0)
     {
       uint32 i;
       for (i = 0; i < kPhysicalProfileMaxNameSize - 1 && name[i]; ++i)
@@ -64,11 +68,13 @@ namespace arcsim {
   void
   PhysicalProfile::construct (uint32                       cache_size,
                               uint32                       page_addr_shift,
-                              uint32                       page_frame_mask)
+                              uint32                       page_frame_mask,
+                              bool                         trace_page_exits)
   {
     cache_size_       = cache_size;
     page_addr_shift_  = page_addr_shift;
     page_frame_mask_  = page_frame_mask;
+    trace_page_exits_ = trace_page_exits;
     
     ASSERT(IS_POWER_OF_TWO(cache_size) && "PageProfileCache: Initial Capacity not power of two!");
     
@@ -119,28 +125,49 @@ PhysicalProfile::analyse_hotspots(arcsim::sys::cpu::Processor&         cpu,
 {
   int   work_size = 0;
   
-  for (std::map<uint32,PageProfile*>::iterator
-        I = touched_pages.begin(),
-        E = touched_pages.end();
-       I != E; ++I)
+  for (arcsim::util::OpenHashMap<uint32,PageProfile*>::Iter I(touched_pages);
+       !I.is_end(); ++I)
   {
-    PageProfile * const pp = I->second;
+    PageProfile * const pp = I.value();
     
     if (pp->has_hotspots(mode, threshold)) {
       TranslationWorkUnit* t = new TranslationWorkUnit(&cpu, cpu.trace_interval);
       
       // populate TranslationWorkUnit with translations
-      if (pp->create_translation_work_unit(cpu, mode, *t)) {
+      bool success;
+      if (mode == kCompilationModeRegion) {
+        std::vector<BlockEntry*>  blocks;
+        std::vector<PageProfile*> pages;
+        select_region(*pp, DEFAULT_REGION_MAX_PAGES, DEFAULT_REGION_MAX_BLOCKS, blocks, pages);
+        success = pp->create_region_work_unit(cpu, blocks, pages, *t);
+        if (success && !blocks.empty()) {
+          ++region_count_;
+          region_block_count_ += blocks.size();
+          std::sort(pages.begin(), pages.end());
+          region_page_count_  += std::unique(pages.begin(), pages.end()) - pages.begin() + 1;
+        }
+      } else {
+        success = pp->create_translation_work_unit(cpu, mode, *t);
+      }
+      
+      if (success) {
         
         // Create TranslationModule for TranslationWorkUnit
         t->module = pp->create_module(cpu.sim_opts);
         
+        // With tiered compilation new modules start out as baseline modules
+        if (t->module != 0 && cpu.sim_opts.fast_tier_up_threshold && cpu.sim_opts.fast_use_default_jit)
+          t->module->set_tier(kTranslationTierBaseline);
+        
         if (t->module != 0) {               // SUCCESS
-          // Mark all blocks in module as 'in translation' and re-set interpretation count
+          // Mark all blocks in module as 'in translation' and re-set interpretation count,
+          // off-page blocks of a region remain with the page they belong to
           for (std::list<TranslationBlockUnit*>::const_iterator
                I = t->blocks.begin(), E = t->blocks.end(); I != E; ++I) {
+            if ((*I)->is_off_page()) continue;
             (*I)->entry_.mark_as_in_translation();
             (*I)->entry_.interp_count = 0;
+            (*I)->entry_.native_count = 0;
           }
           work_units[work_size++] = t; // store TranslationWorkUnit pointer
         }
@@ -155,6 +182,105 @@ PhysicalProfile::analyse_hotspots(arcsim::sys::cpu::Processor&         cpu,
   return work_size;
 }
 
+// Select region starting at page 'home'
+//
+void
+PhysicalProfile::select_region(PageProfile&               home,
+                               uint32                     max_pages,
+                               uint32                     max_blocks,
+                               std::vector<BlockEntry*>&  blocks,
+                               std::vector<PageProfile*>& pages) const
+{
+  // All blocks of the region keyed by virtual address, and distinct pages
+  //
+  arcsim::util::OpenHashMap<uint32,BlockEntry*> region;
+  std::vector<PageProfile*>                     region_pages(1, &home);
+  
+  for (arcsim::util::OpenHashMap<uint32,BlockEntry*>::Iter I(home.get_nodes()); !I.is_end(); ++I) {
+    region.insert(I.key(), I.value());
+  }
+  
+  // Visit pages in the order they join the region, each page contributes the
+  // successors of all region blocks located on it. Sweep until no more blocks
+  // join, as blocks may join pages that have been visited already.
+  //
+  bool changed = true;
+  while (changed && blocks.size() < max_blocks) {
+    changed = false;
+    for (uint32 i = 0; i < region_pages.size() && blocks.size() < max_blocks; ++i)
+    {
+      std::vector<BlockEntry*> succ;
+      region_pages[i]->get_successors(region, succ);
+      
+      for (std::vector<BlockEntry*>::const_iterator S = succ.begin(), E = succ.end();
+           S != E && blocks.size() < max_blocks; ++S)
+      {
+        BlockEntry* const b = *S;
+        
+        // Skip blocks already in region and blocks whose virtual address is
+        // taken by another block of the region
+        if (region.find(b->virt_addr)) continue;
+        
+        // Only pages traced during this interval qualify, as writes to them
+        // since have removed their traces
+        PageProfile** const p = touched_pages.find(b->phys_addr & page_frame_mask_);
+        if (p == 0) continue;
+        
+        if (std::find(region_pages.begin(), region_pages.end(), *p) == region_pages.end()) {
+          if (region_pages.size() >= max_pages) continue;
+          region_pages.push_back(*p);
+        }
+        region.insert(b->virt_addr, b);
+        blocks.push_back(b);
+        pages.push_back(*p);
+        changed = true;
+      }
+    }
+  }
+}
+
+// Analyse all baseline translations for tier-up candidates
+//
+int
+PhysicalProfile::analyse_tier_up_hotspots(arcsim::sys::cpu::Processor&         cpu,
+                                          std::valarray<TranslationWorkUnit*>& work_units,
+                                          uint32                               threshold)
+{
+  int                  work_size = 0;
+  TranslationWorkUnit* t         = 0;
+  
+  // Most pages hold no hot baseline module, so a TranslationWorkUnit is only
+  // allocated once the previous one has been handed out
+  for (arcsim::util::OpenHashMap<uint32,PageProfile*>::Iter I(page_map);
+       !I.is_end() && work_size < (int)work_units.size(); ++I)
+  {
+    if (t == 0)
+      t = new TranslationWorkUnit(&cpu, cpu.trace_interval);
+    
+    if (I.value()->create_tier_up_work_unit(cpu, threshold, *t)) {
+      work_units[work_size++] = t; // store TranslationWorkUnit pointer
+      t = 0;
+    } else {
+      t->clear();
+    }
+  }
+  delete t;
+  return work_size;
+}
+
+// Install optimised translations on all pages
+//
+int
+PhysicalProfile::install_optimised_translations()
+{
+  int installed = 0;
+  for (arcsim::util::OpenHashMap<uint32,PageProfile*>::Iter I(page_map); !I.is_end(); ++I)
+  {
+    installed += I.value()->install_optimised_modules();
+  }
+  return installed;
+}
+
 // ---------------------------------------------------------------------------
 // Remove/Query Translations
 //
@@ -177,6 +303,8 @@ int
 PhysicalProfile::remove_translation (uint32 addr)
 {  
   if (PageProfile* p = find_page_profile(addr)) {
+    // Regions including blocks of this page must no longer enter them
+    p->invalidate_regions();
     if (p->is_block_entry_translation_present(addr)) {
       return p->remove_translations();
     }
@@ -184,6 +312,18 @@ PhysicalProfile::remove_translation (uint32 addr)
   return 0;
 }
 
+// Remove all translated blocks on the page containing the given address
+//
+int
+PhysicalProfile::remove_page_translations (uint32 addr)
+{
+  if (PageProfile* p = find_page_profile(addr)) {
+    p->invalidate_regions();
+    return p->remove_translations();
+  }
+  return 0;
+}
+
 // Remove ALL translations from the simulation
 //
 int
@@ -191,10 +331,9 @@ PhysicalProfile::remove_translations ()
 {
   LOG(LOG_DEBUG) << "[PhysicalProfile] removing ALL translations.";
   int removed = 0;
-	for (std::map<uint32,PageProfile*>::const_iterator
-        I = page_map.begin(), E = page_map.end(); I != E; ++I)
+	for (arcsim::util::OpenHashMap<uint32,PageProfile*>::Iter I(page_map); !I.is_end(); ++I)
   {  
-    removed += I->second->remove_translations();
+    removed += I.value()->remove_translations();
 	}
 	return removed;
 }
@@ -215,20 +354,18 @@ PhysicalProfile::trace_block(BlockEntry&     block, InterruptState  irq_state)
   //
   PageProfile* p = 0;
   
-  std::map<uint32,PageProfile*>::const_iterator I = touched_pages.find(page_frame);
-  
-  if (I != touched_pages.end()) {
+  if (PageProfile** const t = touched_pages.find(page_frame)) {
     // PageProfile has already been touched, return pointer to it
-    p = I->second;
+    p = *t;
   } else {
     // PageProfile has not been touched yet, hence we need to go look for it
-		std::map<uint32,PageProfile*>::const_iterator page_map_I = page_map.find (page_frame);
+		PageProfile** const page_map_p = page_map.find (page_frame);
 		
 		// the following should ALWAYS succeed
-		if (page_map_I != page_map.end()) { 
+		if (page_map_p != 0) { 
       // Create new entry touched_pages map
-      touched_pages.insert(std::pair<uint32,PageProfile*>(page_frame, page_map_I->second));      
-      p = page_map_I->second;
+      touched_pages.insert(page_frame, *page_map_p);
+      p = *page_map_p;
 		}
   }
   
@@ -238,8 +375,12 @@ PhysicalProfile::trace_block(BlockEntry&     block, InterruptState  irq_state)
   // need to start a new trace sequence for this page by reseting the currently
   // active trace sequence
   //
-  if (!is_equal_previous_page_profile(irq_state, p))
+  if (!is_equal_previous_page_profile(irq_state, p)) {
+    // Record edge leaving the previous page so regions can follow it
+    if (trace_page_exits_ && is_trace_sequence_active(irq_state) && prev_page_profile_[irq_state])
+      prev_page_profile_[irq_state]->trace_exit(block, irq_state);
     reset_active_trace_sequence(irq_state);
+  }
   
   // Add block to PageProfile trace
   p->trace_block (block, irq_state, is_trace_sequence_active(irq_state));
@@ -257,7 +398,7 @@ PhysicalProfile::is_trace_present (uint32 addr) const
 {
   const uint32 page_frame = addr & page_frame_mask_;
   
-  if (touched_pages.find(page_frame) != touched_pages.end())
+  if (touched_pages.find(page_frame) != 0)
     return true;
   
   return false;
@@ -269,11 +410,9 @@ PhysicalProfile::remove_trace (uint32 addr)
 {
 	const uint32 page_frame = addr & page_frame_mask_;
 
-  std::map<uint32,PageProfile*>::iterator I = touched_pages.find(page_frame);
-  
-  if (I != touched_pages.end()) {
-    I->second->clear();     // clear collected traces for page
-    touched_pages.erase(I); // remove page from map
+  if (PageProfile** const p = touched_pages.find(page_frame)) {
+    (*p)->clear();                  // clear collected traces for page
+    touched_pages.erase(page_frame); // remove page from map
     
     // Removing one page interrupts the current trace sequence
     // FIXME: here we interrupt ALL trace sequences.
@@ -288,10 +427,10 @@ PhysicalProfile::remove_trace (uint32 addr)
 void
 PhysicalProfile::remove_traces()
 {
-  while (!touched_pages.empty()) {
-    touched_pages.begin()->second->clear(); // clear trace nodes within page
-    touched_pages.erase(touched_pages.begin());
+  for (arcsim::util::OpenHashMap<uint32,PageProfile*>::Iter I(touched_pages); !I.is_end(); ++I) {
+    I.value()->clear(); // clear trace nodes within page
   }
+  touched_pages.clear();
   // removing all traced blocks effectively interrupts ALL trace sequences
   reset_all_active_trace_sequences();
 }
@@ -79,6 +79,8 @@
 #include "sys/cpu/processor.h"
 #include "sys/cpu/aux-registers.h"
 
+#include "util/Checkpoint.h"
+
 #include "util/Log.h"
 
 namespace arcsim {
@@ -195,6 +197,42 @@ namespace arcsim {
         is_enabled = (num_aps > 0);
       }
 
+      // -----------------------------------------------------------------------
+      // Checkpointing - the number and feature level of Actionpoints are part
+      // of the configuration, the partial decoding is recomputed on restore.
+      //
+      void
+      Actionpoints::save_checkpoint(arcsim::util::CheckpointWriter& writer) const
+      {
+        writer.write(ap_regs, sizeof(ap_regs));
+        writer.write(mvalues, sizeof(mvalues));
+        writer.write(mcopies, sizeof(mcopies));
+        writer.write(pvalues, sizeof(pvalues));
+        writer.write_value(inst_matches);
+        writer.write_value(matching_address);
+        writer.write_value(matching_data);
+        writer.write_value(aps_hits);
+        writer.write_value(aps_matches);
+        writer.write_value(aps_action);
+      }
+      
+      bool
+      Actionpoints::restore_checkpoint(arcsim::util::CheckpointReader& reader)
+      {
+        reader.read(ap_regs, sizeof(ap_regs));
+        reader.read(mvalues, sizeof(mvalues));
+        reader.read(mcopies, sizeof(mcopies));
+        reader.read(pvalues, sizeof(pvalues));
+        reader.read_value(inst_matches);
+        reader.read_value(matching_address);
+        reader.read_value(matching_data);
+        reader.read_value(aps_hits);
+        reader.read_value(aps_matches);
+        reader.read_value(aps_action);
+        classify_actionpoints();
+        return !reader.has_error();
+      }
+
       // -----------------------------------------------------------------------
       // Determine the set of Actionpoints that can be individually operated,
       // or which may be the lead Actionpoint in a pair or quad grouping.
@@ -26,6 +26,7 @@
 #include "mem/dma/DMACloselyCoupledMemoryDevice.h"
 #include "mem/ccm/CCMemoryDevice.h"
 
+#include "util/Checkpoint.h"
 #include "util/Log.h"
 
 namespace arcsim {
@@ -86,6 +87,82 @@ namespace arcsim {
       }
 
       
+      // ------------------------------------------------------------------
+      // Checkpointing helpers. A CCM is either a MemoryDevice that is accessed
+      // word by word, or a DMA device whose backing store is contiguous.
+      //
+      static void
+      save_ccm(arcsim::util::CheckpointWriter&                  writer,
+               arcsim::mem::MemoryDeviceInterface*              dev,
+               arcsim::mem::DirectMemoryAccessDeviceInterface*  dma,
+               uint32                                           start,
+               uint32                                           size)
+      {
+        if (!dev && !dma) { size = 0; }
+        writer.write_value(size);
+        if (dma) {
+          uint8* p = 0;
+          dma->dma_dev_location(start, &p);
+          writer.write(p, size);
+        } else if (dev) {
+          for (uint32 off = 0; off < size; off += sizeof(uint32)) {
+            uint32 data = 0;
+            dev->mem_dev_read(start + off, reinterpret_cast<unsigned char*>(&data), sizeof(data));
+            writer.write_value(data);
+          }
+        }
+      }
+      
+      static bool
+      restore_ccm(arcsim::util::CheckpointReader&                  reader,
+                  arcsim::mem::MemoryDeviceInterface*              dev,
+                  arcsim::mem::DirectMemoryAccessDeviceInterface*  dma,
+                  uint32                                           start,
+                  uint32                                           size)
+      {
+        uint32 saved_size = 0;
+        if (!dev && !dma) { size = 0; }
+        if (!reader.read_value(saved_size) || saved_size != size) {
+          LOG(LOG_ERROR) << "[CCM] Checkpoint CCM size does not match configuration.";
+          return false;
+        }
+        if (dma) {
+          uint8* p = 0;
+          dma->dma_dev_location(start, &p);
+          reader.read(p, size);
+        } else if (dev) {
+          for (uint32 off = 0; off < size; off += sizeof(uint32)) {
+            uint32 data = 0;
+            reader.read_value(data);
+            dev->mem_dev_write(start + off, reinterpret_cast<const unsigned char*>(&data), sizeof(data));
+          }
+        }
+        return !reader.has_error();
+      }
+      
+      void
+      CcmManager::save_checkpoint(arcsim::util::CheckpointWriter& writer)
+      {
+        save_ccm(writer, i_ccm_dev_, i_ccm_dma_, core_arch_.iccm.start_addr, core_arch_.iccm.size);
+        save_ccm(writer, d_ccm_dev_, d_ccm_dma_, core_arch_.dccm.start_addr, core_arch_.dccm.size);
+        for (int i = 0; i < IsaOptions::kMultipleIccmCount; ++i) {
+          save_ccm(writer, i_ccms_dev_[i], i_ccms_dma_[i],
+                   core_arch_.iccms[i].start_addr, core_arch_.iccms[i].size);
+        }
+      }
+      
+      bool
+      CcmManager::restore_checkpoint(arcsim::util::CheckpointReader& reader)
+      {
+        bool success = restore_ccm(reader, i_ccm_dev_, i_ccm_dma_, core_arch_.iccm.start_addr, core_arch_.iccm.size)
+                    && restore_ccm(reader, d_ccm_dev_, d_ccm_dma_, core_arch_.dccm.start_addr, core_arch_.dccm.size);
+        for (int i = 0; success && i < IsaOptions::kMultipleIccmCount; ++i) {
+          success = restore_ccm(reader, i_ccms_dev_[i], i_ccms_dma_[i],
+                                core_arch_.iccms[i].start_addr, core_arch_.iccms[i].size);
+        }
+        return success;
+      }
+      
       // ------------------------------------------------------------------
       // Configure CCM Manager based on CoreArch configuration
       //
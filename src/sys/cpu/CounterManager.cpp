@@ -64,7 +64,11 @@ namespace arcsim {
       basic_block_entry_count (NEW_COUNTER64(ctx, ContextItemId::kBasicBlockExecCount64)),
       interp_inst_count (NEW_COUNTER64(ctx, ContextItemId::kInterpInstCount64)),
       native_inst_count (NEW_COUNTER64(ctx, ContextItemId::kNativeInstCount64)),
-      cycle_count       (NEW_COUNTER64(ctx, ContextItemId::kCycleCount64))
+      cycle_count       (NEW_COUNTER64(ctx, ContextItemId::kCycleCount64)),
+      smc_invalidation_count          (NEW_COUNTER64(ctx, ContextItemId::kSmcInvalidationCount64)),
+      smc_discarded_translation_count (NEW_COUNTER64(ctx, ContextItemId::kSmcDiscardedTranslationCount64)),
+      region_transfer_count           (NEW_COUNTER64(ctx, ContextItemId::kRegionTransferCount64)),
+      region_guard_fail_count         (NEW_COUNTER64(ctx, ContextItemId::kRegionGuardFailCount64))
       { /* EMPTY */ }
 
       void
@@ -87,6 +91,10 @@ namespace arcsim {
         interp_inst_count.clear();
         native_inst_count.clear();
         cycle_count.clear();
+        smc_invalidation_count.clear();
+        smc_discarded_translation_count.clear();
+        region_transfer_count.clear();
+        region_guard_fail_count.clear();
       }
       
 } } } //  arcsim::sys::cpu
@@ -0,0 +1,133 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2011 The University of Edinburgh
+//                        All Rights Reserved
+//
+// =====================================================================
+//
+// Description:
+//
+// Per processor queue of timed events.
+//
+// =====================================================================
+
+#include "sys/cpu/EventQueue.h"
+
+namespace arcsim {
+  namespace sys {
+    namespace cpu {
+
+      EventQueue::EventQueue()
+      : seq_(0)
+      { /* EMPTY */ }
+
+      EventQueue::~EventQueue()
+      { /* EMPTY */ }
+
+      void
+      EventQueue::schedule(EventCallbackInterface* callback, uint64 deadline)
+      {
+        const sint32 idx = find(callback);
+        if (idx >= 0) { remove_at(idx); }
+
+        Event e;
+        e.deadline = deadline;
+        e.seq      = seq_++;
+        e.callback = callback;
+        heap_.push_back(e);
+        sift_up(heap_.size() - 1);
+      }
+
+      bool
+      EventQueue::cancel(EventCallbackInterface* callback)
+      {
+        const sint32 idx = find(callback);
+        if (idx < 0) { return false; }
+        remove_at(idx);
+        return true;
+      }
+
+      void
+      EventQueue::clear()
+      {
+        heap_.clear();
+      }
+
+      bool
+      EventQueue::is_scheduled(EventCallbackInterface* callback) const
+      {
+        return find(callback) >= 0;
+      }
+
+      uint32
+      EventQueue::run_due(uint64 now)
+      {
+        // Events scheduled from within callbacks get a sequence number at or
+        // above 'last_seq' and are left for the next call
+        //
+        const uint64 last_seq = seq_;
+        uint32       count    = 0;
+
+        while (!heap_.empty() && heap_[0].deadline <= now && heap_[0].seq < last_seq) {
+          EventCallbackInterface* const callback = heap_[0].callback;
+          remove_at(0);   // remove first, the callback may re-schedule itself
+          callback->on_event(now);
+          ++count;
+        }
+        return count;
+      }
+
+      // Pending events are few (i.e. timers and a handful of devices), hence a
+      // linear search is cheaper than maintaining a separate index
+      //
+      sint32
+      EventQueue::find(EventCallbackInterface* callback) const
+      {
+        for (uint32 i = 0; i < heap_.size(); ++i) {
+          if (heap_[i].callback == callback) { return i; }
+        }
+        return -1;
+      }
+
+      void
+      EventQueue::remove_at(uint32 idx)
+      {
+        const uint32 last = heap_.size() - 1;
+        if (idx != last) {
+          heap_[idx] = heap_[last];
+          heap_.pop_back();
+          sift_down(idx);
+          sift_up(idx);
+        } else {
+          heap_.pop_back();
+        }
+      }
+
+      void
+      EventQueue::sift_up(uint32 idx)
+      {
+        while (idx > 0) {
+          const uint32 parent = (idx - 1) / 2;
+          if (!before(heap_[idx], heap_[parent])) { break; }
+          const Event tmp = heap_[idx]; heap_[idx] = heap_[parent]; heap_[parent] = tmp;
+          idx = parent;
+        }
+      }
+
+      void
+      EventQueue::sift_down(uint32 idx)
+      {
+        const uint32 size = heap_.size();
+        for (;;) {
+          const uint32 left  = 2 * idx + 1;
+          const uint32 right = left + 1;
+          uint32       min   = idx;
+          if (left  < size && before(heap_[left],  heap_[min])) { min = left;  }
+          if (right < size && before(heap_[right], heap_[min])) { min = right; }
+          if (min == idx) { break; }
+          const Event tmp = heap_[idx]; heap_[idx] = heap_[min]; heap_[min] = tmp;
+          idx = min;
+        }
+      }
+
+} } } // arcsim::sys::cpu
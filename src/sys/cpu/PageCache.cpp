@@ -246,5 +246,39 @@ namespace arcsim {
         return removed;
       }
 
+      // -----------------------------------------------------------------------------
+      // Purge entries below 'addr'. The virtual page address of an entry is its
+      // tag (without memory type bits) followed by its index.
+      //
+      static uint32
+      purge_entries_below(EntryPageCache_ * const cache, const PageArch* page_arch, uint32 addr)
+      {
+        const uint32 tag_mask = (1UL << page_arch->page_tag_bits) - 1;
+        uint32       removed  = 0;
+        for (uint32 idx = 0; idx < page_arch->page_cache_size; ++idx) {
+          EntryPageCache_ * const p = cache + idx;
+          if (p->addr_ == kInvalidTag) { continue; }
+          const uint32 page = ((p->addr_ & tag_mask) << page_arch->byte_tag_shift)
+                            | (idx << page_arch->byte_index_shift);
+          if (page < addr) {
+            p->addr_ = kInvalidTag;
+            p->block_= kInvalidPage;
+            ++removed;
+          }
+        }
+        return removed;
+      }
+      
+      uint32
+      PageCache::purge_below(Kind kind, uint32 addr)
+      {
+        if (addr == 0) { return 0; }
+        
+        uint32 removed = 0;
+        if (kind == READ  || kind == ALL) { removed += purge_entries_below(state_->cache_page_read_,  page_arch_, addr); }
+        if (kind == WRITE || kind == ALL) { removed += purge_entries_below(state_->cache_page_write_, page_arch_, addr); }
+        if (kind == EXEC  || kind == ALL) { removed += purge_entries_below(state_->cache_page_exec_,  page_arch_, addr); }
+        return removed;
+      }
       
 } } } //  arcsim::sys::cpu
@@ -0,0 +1,175 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2011 The University of Edinburgh
+//                        All Rights Reserved
+//
+// =====================================================================
+//
+// Description:
+//
+// Sampled (SMARTS-style) memory hierarchy and pipeline simulation.
+//
+// =====================================================================
+
+#include <cmath>
+#include <cstdio>
+
+#include "sys/cpu/SampleManager.h"
+
+namespace arcsim {
+  namespace sys {
+    namespace cpu {
+
+      // Standard score for a 95% confidence level
+      //
+      static const double kConfidenceZ95 = 1.96;
+
+      // -----------------------------------------------------------------------
+      // SampleStatistic
+      //
+      void
+      SampleStatistic::add(double x)
+      {
+        ++n_;
+        const double delta = x - mean_;
+        mean_ += delta / n_;
+        m2_   += delta * (x - mean_);
+      }
+
+      double
+      SampleStatistic::get_confidence(double z) const
+      {
+        return (n_ > 1) ? (z * std::sqrt(get_variance() / n_)) : 0.0;
+      }
+
+      // -----------------------------------------------------------------------
+      // SampleManager
+      //
+      SampleManager::SampleManager()
+      : period_(0),
+        warmup_(0),
+        detail_(0),
+        started_(false),
+        phase_(kPhaseDetail),   // every instruction is detailed until begin()
+        phase_end_(0),
+        ff_insts_(0),
+        warmup_insts_(0),
+        detail_insts_(0),
+        phase_start_(0)
+      { /* EMPTY */ }
+
+      bool
+      SampleManager::configure(uint64 period, uint64 warmup, uint64 detail)
+      {
+        if (period && (detail == 0 || warmup + detail > period)) { return false; }
+        period_ = period;
+        warmup_ = warmup;
+        detail_ = detail;
+        return true;
+      }
+
+      void
+      SampleManager::begin(uint64 now)
+      {
+        started_     = true;
+        phase_       = kPhaseFastForward;
+        phase_start_ = now;
+        phase_end_   = now + (period_ - warmup_ - detail_);
+      }
+
+      SampleManager::Phase
+      SampleManager::next_phase(uint64 now)
+      {
+        const uint64 elapsed = now - phase_start_;
+        switch (phase_) {
+          case kPhaseFastForward: {
+            ff_insts_   += elapsed;
+            phase_       = kPhaseWarmup;
+            phase_end_   = now + warmup_;
+            break;
+          }
+          case kPhaseWarmup: {
+            warmup_insts_ += elapsed;
+            phase_         = kPhaseDetail;
+            phase_end_     = now + detail_;
+            break;
+          }
+          case kPhaseDetail: {
+            detail_insts_ += elapsed;
+            // Overshooting fast-forward phases (i.e. JIT blocks do not end
+            // exactly at phase boundaries) are not made up for, hence the
+            // period is measured from the start of each fast-forward phase
+            phase_         = kPhaseFastForward;
+            phase_end_     = now + (period_ - warmup_ - detail_);
+            break;
+          }
+        }
+        phase_start_ = now;
+        return phase_;
+      }
+
+      void
+      SampleManager::add_sample(const SampleCounters& start, const SampleCounters& end)
+      {
+        const uint64 insts = end.insts - start.insts;
+        if (insts == 0) { return; }
+
+        cpi_.add(static_cast<double>(end.cycles - start.cycles) / insts);
+
+        const uint64 iacc = end.icache_accesses - start.icache_accesses;
+        if (iacc) {
+          icache_miss_rate_.add(static_cast<double>(end.icache_misses - start.icache_misses) / iacc);
+        }
+        const uint64 dacc = end.dcache_accesses - start.dcache_accesses;
+        if (dacc) {
+          dcache_miss_rate_.add(static_cast<double>(end.dcache_misses - start.dcache_misses) / dacc);
+        }
+      }
+
+      double
+      SampleManager::get_estimated_cpi() const
+      {
+        return (cpi_.get_count()) ? cpi_.get_mean() : 1.0;
+      }
+
+      void
+      SampleManager::print_stats(bool has_cycles) const
+      {
+        if (!is_enabled()) { return; }
+
+        const uint64 total = ff_insts_ + warmup_insts_ + detail_insts_;
+
+        fprintf (stderr, "Sampled Simulation Statistics\n");
+        fprintf (stderr, "-----------------------------------------------------------\n");
+        fprintf (stderr, " Period/Warm-up/Detail: %llu/%llu/%llu [Instructions]\n",
+                 period_, warmup_, detail_);
+        fprintf (stderr, " Samples:               %12llu\n", cpi_.get_count());
+        fprintf (stderr, " Fast-forward:          %12llu%10.2f\n", ff_insts_,
+                 (total) ? (100.0 * ff_insts_ / total) : 0.0);
+        fprintf (stderr, " Warm-up:               %12llu%10.2f\n", warmup_insts_,
+                 (total) ? (100.0 * warmup_insts_ / total) : 0.0);
+        fprintf (stderr, " Detail:                %12llu%10.2f\n", detail_insts_,
+                 (total) ? (100.0 * detail_insts_ / total) : 0.0);
+        fprintf (stderr, "-----------------------------------------------------------\n");
+        fprintf (stderr, "                          Mean     +/- 95%% CI   Rel. error\n");
+        if (has_cycles) {
+          fprintf (stderr, " CPI:                 %10.4f  %10.4f  %9.2f%%\n",
+                   cpi_.get_mean(), cpi_.get_confidence(kConfidenceZ95),
+                   (cpi_.get_mean() > 0) ? (100.0 * cpi_.get_confidence(kConfidenceZ95) / cpi_.get_mean()) : 0.0);
+        }
+        if (icache_miss_rate_.get_count()) {
+          fprintf (stderr, " I-cache miss rate:   %10.4f  %10.4f  %9.2f%%\n",
+                   icache_miss_rate_.get_mean(), icache_miss_rate_.get_confidence(kConfidenceZ95),
+                   (icache_miss_rate_.get_mean() > 0)
+                   ? (100.0 * icache_miss_rate_.get_confidence(kConfidenceZ95) / icache_miss_rate_.get_mean()) : 0.0);
+        }
+        if (dcache_miss_rate_.get_count()) {
+          fprintf (stderr, " D-cache miss rate:   %10.4f  %10.4f  %9.2f%%\n",
+                   dcache_miss_rate_.get_mean(), dcache_miss_rate_.get_confidence(kConfidenceZ95),
+                   (dcache_miss_rate_.get_mean() > 0)
+                   ? (100.0 * dcache_miss_rate_.get_confidence(kConfidenceZ95) / dcache_miss_rate_.get_mean()) : 0.0);
+        }
+        fprintf (stderr, "-----------------------------------------------------------\n\n");
+      }
+
+} } } // arcsim::sys::cpu
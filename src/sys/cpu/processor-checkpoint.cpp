@@ -0,0 +1,208 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2011 The University of Edinburgh
+//                        All Rights Reserved
+//
+// =====================================================================
+//
+// Description:
+//
+// This file implements saving and restoring the architectural state of a
+// processor to and from a checkpoint (see util/Checkpoint.h).
+//
+// Only architectural state is saved. Host pointers held in the cpuState
+// structure are preserved on restore, and all derived state (i.e. decode
+// caches, translations, page caches, and microarchitectural cache and
+// pipeline state) is discarded and rebuilt on demand.
+//
+// =====================================================================
+
+#include <vector>
+
+#include "sys/cpu/processor.h"
+
+#include "util/Checkpoint.h"
+#include "util/Counter.h"
+#include "util/Log.h"
+
+namespace arcsim {
+  namespace sys {
+    namespace cpu {
+
+      // -----------------------------------------------------------------------
+      // Save architectural state of this processor
+      //
+      void
+      Processor::save_checkpoint (arcsim::util::CheckpointWriter& writer)
+      {
+        using arcsim::util::Checkpoint;
+
+        writer.begin_section(Checkpoint::kSectionProcessor);
+        writer.write_value(static_cast<sint32>(core_id));
+        writer.write_value(state);
+
+        // Interrupt stack, from bottom to top
+        //
+        std::stack<InterruptState> irqs(interrupt_stack);
+        std::vector<uint32>        entries;
+        while (!irqs.empty()) { entries.push_back(irqs.top()); irqs.pop(); }
+        writer.write_value(static_cast<uint32>(entries.size()));
+        for (std::vector<uint32>::reverse_iterator I = entries.rbegin(), E = entries.rend();
+             I != E; ++I) {
+          writer.write_value(*I);
+        }
+
+        // Timers
+        //
+        writer.write_value(running0);
+        writer.write_value(running1);
+        writer.write_value(vcount0);
+        writer.write_value(vcount1);
+        writer.write_value(count_increment);
+        writer.write_value(timer_sync_time);
+        writer.write_value(rtc_disabled_ticks);
+        writer.write_value(last_rtc_disable);
+        writer.write_value(last_rtc_clear);
+
+        // Counters driving the time base of timers and events
+        //
+        writer.write_value(cnt_ctx.interp_inst_count.get_value());
+        writer.write_value(cnt_ctx.native_inst_count.get_value());
+        writer.write_value(cnt_ctx.cycle_count.get_value());
+
+        mmu.save_checkpoint(writer);
+        aps.save_checkpoint(writer);
+        smt.save_checkpoint(writer);
+        ccm_mgr_->save_checkpoint(writer);
+      }
+
+      // -----------------------------------------------------------------------
+      // Restore architectural state of this processor
+      //
+      bool
+      Processor::restore_checkpoint (arcsim::util::CheckpointReader& reader)
+      {
+        using arcsim::util::Checkpoint;
+
+        sint32   id = 0;
+        cpuState saved;
+        if (   !reader.expect_section(Checkpoint::kSectionProcessor)
+            || !reader.read_value(id)
+            || id != core_id
+            || !reader.read_value(saved)) {
+          LOG(LOG_ERROR) << "[CPU" << core_id << "] Checkpoint does not match processor.";
+          return false;
+        }
+
+        uint32 irq_count = 0;
+        std::vector<uint32> entries;
+        if (reader.read_value(irq_count)) {
+          entries.resize(irq_count);
+          for (uint32 i = 0; i < irq_count; ++i) { reader.read_value(entries[i]); }
+        }
+
+        bool   r0 = false, r1 = false;
+        sint64 vc0 = 0, vc1 = 0;
+        uint32 inc = 0;
+        uint64 sync_time = 0, rtc_ticks = 0, rtc_disable = 0, rtc_clear = 0;
+        uint64 interp_count = 0, native_count = 0, cycles = 0;
+        reader.read_value(r0);
+        reader.read_value(r1);
+        reader.read_value(vc0);
+        reader.read_value(vc1);
+        reader.read_value(inc);
+        reader.read_value(sync_time);
+        reader.read_value(rtc_ticks);
+        reader.read_value(rtc_disable);
+        reader.read_value(rtc_clear);
+        reader.read_value(interp_count);
+        reader.read_value(native_count);
+        reader.read_value(cycles);
+
+        if (   reader.has_error()
+            || !mmu.restore_checkpoint(reader)
+            || !aps.restore_checkpoint(reader)
+            || !smt.restore_checkpoint(reader)
+            || !ccm_mgr_->restore_checkpoint(reader)) {
+          LOG(LOG_ERROR) << "[CPU" << core_id << "] Failed to restore processor from checkpoint.";
+          return false;
+        }
+
+        // Host pointers in the saved state refer to the process that wrote the
+        // checkpoint, keep the ones of this processor
+        //
+        saved.cpu_ctx           = state.cpu_ctx;
+        saved.cache_page_read_  = state.cache_page_read_;
+        saved.cache_page_write_ = state.cache_page_write_;
+        saved.cache_page_exec_  = state.cache_page_exec_;
+        saved.mem_direct_base   = state.mem_direct_base;
+        saved.mem_direct_perm   = state.mem_direct_perm;
+        saved.native_inst_count       = state.native_inst_count;
+        saved.interp_inst_count       = state.interp_inst_count;
+        saved.dslot_inst_count        = state.dslot_inst_count;
+        saved.region_transfer_count   = state.region_transfer_count;
+        saved.region_guard_fail_count = state.region_guard_fail_count;
+        saved.trans_cache_entries     = state.trans_cache_entries;
+        saved.trans_cache_mask        = state.trans_cache_mask;
+        saved.trans_cache_epoch       = state.trans_cache_epoch;
+        saved.trans_chain_active      = state.trans_chain_active;
+        for (uint32 i = 0; i < GPR_BASE_REGS; ++i) { saved.xregs[i] = state.xregs[i]; }
+        state = saved;
+
+        while (!interrupt_stack.empty()) { interrupt_stack.pop(); }
+        for (uint32 i = 0; i < entries.size(); ++i) {
+          interrupt_stack.push(static_cast<InterruptState>(entries[i]));
+        }
+        if (interrupt_stack.empty()) { interrupt_stack.push(INTERRUPT_NONE); }
+
+        running0           = r0;
+        running1           = r1;
+        vcount0            = vc0;
+        vcount1            = vc1;
+        count_increment    = inc;
+        timer_sync_time    = sync_time;
+        rtc_disabled_ticks = rtc_ticks;
+        last_rtc_disable   = rtc_disable;
+        last_rtc_clear     = rtc_clear;
+
+        cnt_ctx.interp_inst_count.set_value(interp_count);
+        cnt_ctx.native_inst_count.set_value(native_count);
+        cnt_ctx.cycle_count.set_value(cycles);
+
+        // Reset derived execution state
+        //
+        dcode_cache = &(dcode_caches[MAP_OPERATING_MODE(state.U)]);
+        if (dcode_page_cache) { dcode_page_cache = &(dcode_page_caches[MAP_OPERATING_MODE(state.U)]); }
+        lp_end_to_lp_start_map.clear();
+        lp_end_to_lp_start_map[0] = 0x1;
+
+        end_of_block             = false;
+        prev_had_dslot           = false;
+        state.iterations         = 0;
+        trace_interval           = 0;
+        trace_interp_block_count = 0;
+
+        // Discard everything decoded or translated from previous memory contents
+        //
+        phys_profile_.remove_translations();
+        page_cache.flush(arcsim::sys::cpu::PageCache::ALL);
+        purge_translation_cache();
+        purge_dcode_cache();
+        if (mem_model) { mem_model->clear(); }
+
+        // Re-arm timer event relative to the restored time base
+        //
+        events_.cancel(this);
+        state.timer_expiry = EventQueue::kNoDeadline;
+        if (inst_timer_enabled) {
+          time_to_expiry();
+        } else {
+          update_event_deadline();
+        }
+
+        LOG(LOG_DEBUG) << "[CPU" << core_id << "] Restored from checkpoint at PC 0x"
+                       << std::hex << state.pc << std::dec << ".";
+        return true;
+      }
+
+} } } //  arcsim::sys::cpu
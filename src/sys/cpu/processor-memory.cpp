@@ -26,6 +26,9 @@
 #include "mem/MemoryDeviceInterface.h"
 
 #include "util/Log.h"
+#include "util/Counter.h"
+
+#include "concurrent/ScopedLock.h"
 
 // shortcut macro for logging memory exceptions and errors
 #define LOG_MEM_ERROR(_addr_,_type_)                              \
@@ -33,6 +36,8 @@
                  << std::hex << std::setfill('0') << std::setw(8) \
                  << _addr_ << _type_
 
+#define HEX(_addr_) std::hex << std::setw(8) << std::setfill('0') << _addr_
+
 namespace arcsim {
   namespace sys {
     namespace cpu {
@@ -231,6 +236,10 @@ namespace arcsim {
           if (block->is_w_cached()) {
             block->set_w_cached(false); // reset w_cached flag
             
+            // Other processors may hold this page in their write page caches
+            // as well, and would not notice that it is now cached for execution
+            broadcast_write_cache_flush();
+            
             // Remove page from writeable cache
             if (block->type_tag == kMemoryTypeTagDev){
               page_cache.purge_entry (arcsim::sys::cpu::PageCache::WRITE,
@@ -242,8 +251,10 @@ namespace arcsim {
           }
           // Mark this pages as `cached for execution', so as to trigger
           // flushing of dcode cache if this page is subsequently written.
+          // Translated code must not write to it directly any more.
           //
           block->set_x_cached(true);
+          if (block->is_mem_ram()) { system.ext_mem->set_direct_write(block->page_frame, false); }
           
           // Perform the memory read operation. This is performed right here 
           // if the page is regular RAM, or by the nominated read function
@@ -391,9 +402,14 @@ namespace arcsim {
                 // Flush executable page cache
                 //
                 page_cache.flush(arcsim::sys::cpu::PageCache::EXEC);
+                // Other processors may execute this page as well. They are told
+                // before x_cached is reset, as later writes no longer notice it.
+                //
+                broadcast_exec_invalidation(host_page->page_frame, core_arch.page_arch.page_bytes);
                 // Reset x_cached flag
                 //
                 host_page->set_x_cached(false);
+                if (host_page->is_mem_ram()) { system.ext_mem->set_direct_write(host_page->page_frame, true); }
                 
                 if (phys_profile_.is_translation_present(phys_addr)) {
                   remove_translation(phys_addr);
@@ -585,9 +601,14 @@ namespace arcsim {
                 LOG(LOG_DEBUG) << "[CPU-MEMORY.WRITE] REMOVED TRACES FOR PAGE."; 
               }            
             }
+            // Other processors may execute this page as well. They are told
+            // before x_cached is reset, as later writes no longer notice it.
+            //
+            broadcast_exec_invalidation(block->page_frame, core_arch.page_arch.page_bytes);
             // Reset x_cached flag
             //
             block->set_x_cached(false);
+            if (block->is_mem_ram()) { system.ext_mem->set_direct_write(block->page_frame, true); }
           }
           // Mark this page as `cached for writing', if permitted
           //
@@ -760,6 +781,8 @@ namespace arcsim {
       {
         const uint32                   block_bytes  = core_arch.page_arch.page_bytes;
         const uint32                   offset       = phys_addr % block_bytes;
+        const uint32                   write_addr   = phys_addr;
+        const uint32                   write_size   = size;
         arcsim::sys::mem::BlockData*   block        = get_host_page(phys_addr);
         bool                           success      = true;
         bool                           touched_exec = false;
@@ -827,19 +850,10 @@ namespace arcsim {
           }
         }
         // If we have touched a block that contains executable code we need to
-        // clear the dcode and page caches. If the JIT compiler is enabled we
-        // do the safe thing and flush all translations, the translation cache,
-        // and remove all gathered traces.
+        // invalidate decoded code, translations, and traces for the written pages.
         //
         if (touched_exec) {
-          purge_dcode_cache();
-          purge_page_cache(arcsim::sys::cpu::PageCache::EXEC);
-          
-          if (sim_opts.fast) { /* If we JIT was enabled we also remove native code and traces */
-            purge_translation_cache();
-            phys_profile_.remove_translations();
-            phys_profile_.remove_traces();
-          }
+          invalidate_exec_pages(write_addr, write_size);
         }
         return success;
       }
@@ -929,6 +943,8 @@ namespace arcsim {
       {
         const uint32                   block_bytes  = core_arch.page_arch.page_bytes;
         const uint32                   offset       = phys_addr % block_bytes;
+        const uint32                   write_addr   = phys_addr;
+        const uint32                   write_size   = size;
         arcsim::sys::mem::BlockData*   block        = get_host_page(phys_addr);
         bool                           success      = true;
         bool                           touched_exec = false;
@@ -1001,21 +1017,151 @@ namespace arcsim {
           }
         }
         // If we have touched a block that contains executable code we need to
-        // clear the dcode and page caches. If the JIT compiler is enabled we
-        // do the safe thing and flush all translations, the translation cache,
-        // and remove all gathered traces.
+        // invalidate decoded code, translations, and traces for the written pages.
         //
         if (touched_exec) {
+          invalidate_exec_pages(write_addr, write_size);
+        }
+        return success;
+      }
+
+      // -------------------------------------------------------------------
+      // Invalidate decoded code, translations, and traces for all pages within
+      // the given physical memory range that are `cached for execution' by
+      // this processor, and ask all other processors to do the same. All other
+      // pages keep their translations.
+      //
+      int
+      Processor::invalidate_exec_pages(uint32 phys_addr, uint32 size)
+      {
+        broadcast_exec_invalidation(phys_addr, size);
+        return purge_exec_pages(phys_addr, size, true);
+      }
+      
+      // -------------------------------------------------------------------
+      // Without an MMU simulated virtual addresses equal physical addresses,
+      // hence the virtually indexed dcode, page, and translation caches are
+      // purged for the given pages only. Otherwise we cannot tell which of
+      // their entries map to the given pages and they are flushed entirely.
+      //
+      // An instruction (including its LIMM) of up to 8 bytes that starts on
+      // the preceding page may spill into the range, so the range is widened
+      // by 8 bytes downwards (@see DcodePageCache::purge_range()).
+      //
+      int
+      Processor::purge_exec_pages(uint32 phys_addr, uint32 size, bool x_cached_only)
+      {
+        const uint32 block_bytes = core_arch.page_arch.page_bytes;
+        const uint32 frame_mask  = ~core_arch.page_arch.page_byte_offset_mask;
+        const bool   is_virt_eq_phys = !core_arch.mmu_arch.is_configured;
+        int          removed     = 0;
+        
+        if (size == 0) { return removed; }
+        
+        const uint32 first_page = ((phys_addr > 8) ? phys_addr - 8 : 0) & frame_mask;
+        
+        if (!is_virt_eq_phys) {
           purge_dcode_cache();
           purge_page_cache(arcsim::sys::cpu::PageCache::EXEC);
-          
-          if (sim_opts.fast) { /* If we JIT was enabled we also remove native code and traces */
-            purge_translation_cache();
-            phys_profile_.remove_translations();
-            phys_profile_.remove_traces();
+          purge_translation_cache();
+        }
+        
+        const uint32 last_page = (phys_addr + size - 1) & frame_mask;
+        for (uint32 page = first_page; ; page += block_bytes)
+        {
+          // Pages that have never been accessed hold no code, and must not be
+          // allocated as a side-effect of the invalidation
+          //
+          bool purge = !x_cached_only;
+          if (!purge) {
+            arcsim::sys::mem::BlockData* const block = find_host_page(page);
+            purge = block && block->is_x_cached();
+          }
+          if (purge) {
+            if (is_virt_eq_phys) {
+              purge_dcode_range(page, block_bytes);
+              purge_page_cache_entry(arcsim::sys::cpu::PageCache::EXEC, page);
+              purge_translation_cache_range(page, block_bytes);
+            }
+            if (sim_opts.fast) { /* If the JIT is enabled we also remove native code and traces */
+              removed += phys_profile_.remove_page_translations(page);
+              phys_profile_.remove_trace(page);
+            }
           }
+          if (page == last_page) { break; }
+        }
+        
+        cnt_ctx.smc_invalidation_count.inc();
+        cnt_ctx.smc_discarded_translation_count.inc(removed);
+        LOG(LOG_DEBUG) << "[CPU-MEMORY.BLOCK] INVALIDATED PAGES 0x" << HEX(first_page)
+                       << " - 0x" << HEX(last_page) << ", REMOVED " << std::dec << removed << " TRANSLATIONS.";
+        return removed;
+      }
+      
+      // -------------------------------------------------------------------
+      // Code invalidation across processors. CCMs are private to each
+      // processor, so writes to them are never broadcast.
+      //
+      void
+      Processor::broadcast_exec_invalidation(uint32 phys_addr, uint32 size)
+      {
+        if (system.total_cores < 2 || size == 0 || ccm_mgr_->in_ccm_mapped_region(phys_addr)) {
+          return;
+        }
+        for (uint32 i = 0; i < system.total_cores; ++i) {
+          if (system.cpu[i] != this) { system.cpu[i]->post_remote_invalidation(phys_addr, size); }
+        }
+      }
+      
+      void
+      Processor::broadcast_write_cache_flush()
+      {
+        for (uint32 i = 0; i < system.total_cores; ++i) {
+          if (system.cpu[i] != this) { system.cpu[i]->post_remote_write_cache_flush(); }
+        }
+      }
+      
+      void
+      Processor::post_remote_invalidation(uint32 phys_addr, uint32 size)
+      {
+        arcsim::concurrent::ScopedLock lock(remote_inval_mtx_);
+        remote_inval_ranges_.push_back(std::make_pair(phys_addr, size));
+        set_pending_action(kPendingAction_REMOTE_INVALIDATION);
+      }
+      
+      void
+      Processor::post_remote_write_cache_flush()
+      {
+        arcsim::concurrent::ScopedLock lock(remote_inval_mtx_);
+        remote_flush_write_ = true;
+        set_pending_action(kPendingAction_REMOTE_INVALIDATION);
+      }
+      
+      // -------------------------------------------------------------------
+      // Handle requests posted by other processors. This MUST only be called
+      // by the thread simulating this processor while it is not executing
+      // native code. Pages written by another processor may already have
+      // lost their x_cached flag, hence all posted pages are purged.
+      //
+      void
+      Processor::handle_remote_invalidations()
+      {
+        std::vector<std::pair<uint32,uint32> > ranges;
+        bool                                   flush_write;
+        {
+          arcsim::concurrent::ScopedLock lock(remote_inval_mtx_);
+          clear_pending_action(kPendingAction_REMOTE_INVALIDATION);
+          ranges.swap(remote_inval_ranges_);
+          flush_write         = remote_flush_write_;
+          remote_flush_write_ = false;
+        }
+        
+        if (flush_write) {
+          purge_page_cache(arcsim::sys::cpu::PageCache::WRITE);
+        }
+        for (uint32 i = 0; i < ranges.size(); ++i) {
+          purge_exec_pages(ranges[i].first, ranges[i].second, false);
         }
-        return success;
       }
 
 } } } //  arcsim::sys::cpu
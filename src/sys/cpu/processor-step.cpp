@@ -53,7 +53,7 @@
 // Recorded addresses accessed by memory operations in memory model address queue
 //
 #define MEMORY_ACCESS(_addr) \
-  do { if (sim_opts.memory_sim) mem_model->addr_queue.push(_addr); } while(0)
+  do { if (is_memory_model_active()) mem_model->addr_queue.push(_addr); } while(0)
 
 
 #ifdef STEP
@@ -62,6 +62,20 @@
   #define IF_STEP_TRACE_INSTR(...)
 #endif
 
+// Threaded dispatch - with GCC each opcode handler of the interpreter switch
+// also carries a label so the pre-decoded opcode can be dispatched through a
+// table of label addresses (i.e. computed goto), skipping the range check
+// and indirection of the switch jump table.
+//
+#if defined (__GNUC__)
+  #define USE_THREADED_DISPATCH
+  #define OP_LABEL(op)  op_label_##op:
+#else
+  #define OP_LABEL(op)
+#endif
+
+#define OP_CASE(op)     case OpCode::op: OP_LABEL(op)
+
 
 #endif // SRC_INTERNAL_SYSTEM_CPU_PROCESSOR_STEP_CPP
 
@@ -82,13 +96,20 @@
 // possible, and hence without the capability to trace execution of
 // each instruction.
 //
+// Processor::step_single_plain () is a specialisation of step_single_fast ()
+// that omits all IPT, Actionpoint, and EIA extension checks. It must only be
+// used when none of these are configured or active (see is_plain_step_enabled()).
+//
 bool
 #ifdef STEP
 Processor::step_single (UpdatePacket *delta, bool check)
 #endif
-#ifdef STEP_FAST
+#if defined(STEP_FAST) && !defined(STEP_PLAIN)
 Processor::step_single_fast ()
 #endif
+#ifdef STEP_PLAIN
+Processor::step_single_plain ()
+#endif
 {
   uint32  efa                  = 0;
   uint32  ecause               = 0;
@@ -116,6 +137,7 @@ Processor::step_single_fast ()
     return !state.H;
   }
   
+#ifndef STEP_PLAIN
   // ---------------------------------------------------------------------------
   // HandleBeginInstructionExecutionIPT check
   //
@@ -127,9 +149,11 @@ Processor::step_single_fast ()
   // ---------------------------------------------------------------------------
   // In case Actionpoints might be enabled, copy the pre-decoded breakpoint
   // Actionpoint set that triggers on this instruction. These may be combined
-  // with other Actionpoints to trigger a compound condition later on.
+  // with other Actionpoints to trigger a compound condition later on. The set
+  // lives in the cold part of the Dcode object, so it is only read if there are
+  // any instruction Actionpoints.
   //
-  aps.init_aps_matches(inst->aps_inst_matches);
+  aps.init_aps_matches(aps.has_inst_aps() ? inst->aps_inst_matches : 0);
   
   // ---------------------------------------------------------------------------
   // EIA extensions
@@ -151,6 +175,7 @@ Processor::step_single_fast ()
       }
     }
   }
+#endif /* !STEP_PLAIN */
 
 #ifdef STEP
   // Skip former parts of instruction trace, including disassembly, for cosim
@@ -257,9 +282,17 @@ Processor::step_single_fast ()
   //
   //
   using namespace arcsim::isa::arc;
+#ifdef USE_THREADED_DISPATCH
+  static void * const op_dispatch[OpCode::opcode_count] = {
+#define DEF_OP_DISPATCH(name,ignore) &&op_label_##name,
+    BUILTIN_OPCODE_LIST(DEF_OP_DISPATCH)
+#undef DEF_OP_DISPATCH
+  };
+  goto *op_dispatch[inst->code];
+#endif
   switch (inst->code)
   {
-    case OpCode::BCC:
+    OP_CASE(BCC)
       {
         START_ILLEGAL_IN_DSLOT
           end_of_block   = !inst->dslot;
@@ -292,7 +325,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::BR:
+    OP_CASE(BR)
       {
         START_ILLEGAL_IN_DSLOT
           end_of_block   = !inst->dslot;
@@ -322,7 +355,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::BRCC:
+    OP_CASE(BRCC)
       {
         START_ILLEGAL_IN_DSLOT
           end_of_block   = !inst->dslot;
@@ -359,7 +392,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::BBIT0:
+    OP_CASE(BBIT0)
       {
         START_ILLEGAL_IN_DSLOT
           end_of_block = !inst->dslot;
@@ -379,7 +412,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::BBIT1:
+    OP_CASE(BBIT1)
       {
         START_ILLEGAL_IN_DSLOT
           end_of_block = !inst->dslot;
@@ -399,7 +432,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::JCC_SRC1:
+    OP_CASE(JCC_SRC1)
       {
         START_ILLEGAL_IN_DSLOT
           end_of_block   = !inst->dslot;
@@ -430,7 +463,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::JCC_SRC2:
+    OP_CASE(JCC_SRC2)
       {
         START_ILLEGAL_IN_DSLOT
           end_of_block = !inst->dslot;
@@ -464,7 +497,7 @@ Processor::step_single_fast ()
 
       // Return from IRQ1
       //
-    case OpCode::J_F_ILINK1:
+    OP_CASE(J_F_ILINK1)
       {
         START_ILLEGAL_IN_DSLOT
           end_of_block = true;
@@ -481,7 +514,7 @@ Processor::step_single_fast ()
 
       // Return from IRQ2
       //
-    case OpCode::J_F_ILINK2:
+    OP_CASE(J_F_ILINK2)
       {
         START_ILLEGAL_IN_DSLOT
           end_of_block = true;        
@@ -496,7 +529,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::LPCC:
+    OP_CASE(LPCC)
       {
         START_ILLEGAL_IN_DSLOT
           end_of_block = true;
@@ -527,7 +560,7 @@ Processor::step_single_fast ()
     // only, and has been superceded by the OpCode::LW_* codes which are specialized
     // for each possible path through the OpCode::LD_WORD semantics.
     //
-    case OpCode::LD_WORD:
+    OP_CASE(LD_WORD)
       {
         uint32 ea = *(inst->src1) + (*(inst->src2) << inst->addr_shift);
         uint32 ma = inst->pre_addr ? *(inst->src1) : ea;
@@ -553,7 +586,7 @@ Processor::step_single_fast ()
 
     // Load word, no address shift, no address update
     //
-    case OpCode::LW:
+    OP_CASE(LW)
       {
         uint32 ma = *(inst->src1) + *(inst->src2);
         uint32 rd = 0;
@@ -576,7 +609,7 @@ Processor::step_single_fast ()
     // Load word, no address shift, no address update, use pre-adder EA
     // (probably not needed, but provided for completeness)
     //
-    case OpCode::LW_PRE:
+    OP_CASE(LW_PRE)
       {
         uint32 ma = *(inst->src1);
         uint32 rd = 0;
@@ -598,7 +631,7 @@ Processor::step_single_fast ()
 
     // Load word, 2-bit address shift, no address update
     //
-    case OpCode::LW_SH2:
+    OP_CASE(LW_SH2)
       {
         uint32 ma = *(inst->src1) + (*(inst->src2) << 2);
         uint32 rd = 0;
@@ -621,7 +654,7 @@ Processor::step_single_fast ()
     // Load word, 2-bit address shift, no address update, pre-adder address
     // (probably not needed, but provided for completeness)
     //
-    case OpCode::LW_PRE_SH2:
+    OP_CASE(LW_PRE_SH2)
       {
         uint32 ma = *(inst->src1);
         //uint32 ea = ma + (*(inst->src2) << 2);
@@ -644,7 +677,7 @@ Processor::step_single_fast ()
 
     // Load word, no address shift, address register update
     //
-    case OpCode::LW_A:
+    OP_CASE(LW_A)
       {
         uint32 ma = *(inst->src1) + *(inst->src2);
         uint32 rd = 0;
@@ -670,7 +703,7 @@ Processor::step_single_fast ()
     // Load word, no address shift, address register update,
     // use pre-adder value as address
     //
-    case OpCode::LW_PRE_A:
+    OP_CASE(LW_PRE_A)
       {
         uint32 ma = *(inst->src1);
         uint32 ea = ma + *(inst->src2);
@@ -698,7 +731,7 @@ Processor::step_single_fast ()
     // Load word, 2-bit address shift, address register update
     // (probably not needed, but provided for completeness)
     //
-    case OpCode::LW_SH2_A:
+    OP_CASE(LW_SH2_A)
       {
         uint32 ma = *(inst->src1) + (*(inst->src2) << 2);
         uint32 rd = 0;
@@ -725,7 +758,7 @@ Processor::step_single_fast ()
     // use pre-adder value as address. Probably not needed, but
     // provided for completeness.
     //
-    case OpCode::LW_PRE_SH2_A:
+    OP_CASE(LW_PRE_SH2_A)
       {
         uint32 ma = *(inst->src1);
         uint32 ea = ma + (*(inst->src2) << 2);
@@ -750,7 +783,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::LD_HALF_S:
+    OP_CASE(LD_HALF_S)
       {
         uint32 ea = *(inst->src1) + (*(inst->src2) << inst->addr_shift);
         uint32 ma = inst->pre_addr ? *(inst->src1) : ea;
@@ -774,7 +807,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::LD_BYTE_S:
+    OP_CASE(LD_BYTE_S)
       {
         uint32 ea = *(inst->src1) + (*(inst->src2) << inst->addr_shift);
         uint32 ma = inst->pre_addr ? *(inst->src1) : ea;
@@ -798,7 +831,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::LD_HALF_U:
+    OP_CASE(LD_HALF_U)
       {
         uint32 ea = *(inst->src1) + (*(inst->src2) << inst->addr_shift);
         uint32 ma = inst->pre_addr ? *(inst->src1) : ea;
@@ -822,7 +855,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::LD_BYTE_U:
+    OP_CASE(LD_BYTE_U)
       {
         uint32 ea = *(inst->src1) + (*(inst->src2) << inst->addr_shift);
         uint32 ma = inst->pre_addr ? *(inst->src1) : ea;
@@ -850,7 +883,7 @@ Processor::step_single_fast ()
     // as it can be a conditional instruction. Otherwise, it behaves
     // just like a OpCode::LD_WORD
     //
-    case OpCode::LDI:
+    OP_CASE(LDI)
       {
         IF_CC(inst,state)
         {
@@ -880,7 +913,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ST_WORD:
+    OP_CASE(ST_WORD)
       {
         uint32 ea = *(inst->src1) + ((inst->shimm) << inst->addr_shift);
         uint32 ma = inst->pre_addr ? *(inst->src1) : ea;
@@ -896,9 +929,9 @@ Processor::step_single_fast ()
           uint32 rd = 0;
           if (sim_opts.trace_on) {
             char  buf[BUFSIZ];
-            int   len = snprintf(buf, sizeof(buf),
-                                 ": check sw [%08x] <= %08x", ma, *(inst->src2));
-            IS.write(buf, len);
+            snprintf(buf, sizeof(buf),
+                     ": check sw [%08x] <= %08x", ma, *(inst->src2));
+            trace_string(buf);
           }
 
           // Read back data written by translated basic block
@@ -909,10 +942,10 @@ Processor::step_single_fast ()
           {
             if (sim_opts.trace_on) {
               char  buf[BUFSIZ];
-              int   len = snprintf(buf, sizeof(buf),
-                                   " ERROR: read %08x, wdata = %08x",
-                                   rd, *(inst->src2));
-              IS.write(buf, len);
+              snprintf(buf, sizeof(buf),
+                       " ERROR: read %08x, wdata = %08x",
+                       rd, *(inst->src2));
+              trace_string(buf);
             } else {
               LOG(LOG_ERROR)
                 << "*** Error @ " << std::hex << std::setw(8) << std::setfill('0')
@@ -959,7 +992,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ST_HALF:
+    OP_CASE(ST_HALF)
       {
         uint32 ea = *(inst->src1) + ((inst->shimm) << inst->addr_shift);
         uint32 ma = inst->pre_addr ? *(inst->src1) : ea;
@@ -977,10 +1010,10 @@ Processor::step_single_fast ()
           {
             if (sim_opts.trace_on) {
               char  buf[BUFSIZ];
-              int   len = snprintf(buf, sizeof(buf),
-                                   " ERROR: mem=%04x, ref=%04x",
-                                   rd, *(inst->src2));
-              IS.write(buf, len);
+              snprintf(buf, sizeof(buf),
+                       " ERROR: mem=%04x, ref=%04x",
+                       rd, *(inst->src2));
+              trace_string(buf);
             } else {
               LOG(LOG_ERROR)
                 << "*** Error @ " << std::hex << std::setw(8) << std::setfill('0')
@@ -1026,7 +1059,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ST_BYTE:
+    OP_CASE(ST_BYTE)
       {
         uint32 ea = *(inst->src1) + ((inst->shimm) << inst->addr_shift);
         uint32 ma = inst->pre_addr ? *(inst->src1) : ea;
@@ -1044,10 +1077,10 @@ Processor::step_single_fast ()
           {
             if (sim_opts.trace_on) {
               char  buf[BUFSIZ];
-              int   len = snprintf(buf, sizeof(buf),
-                                   " ERROR: mem=%02x, ref=%02x",
-                                   rd, *(inst->src2));
-              IS.write(buf, len);
+              snprintf(buf, sizeof(buf),
+                       " ERROR: mem=%02x, ref=%02x",
+                       rd, *(inst->src2));
+              trace_string(buf);
             } else {
               LOG(LOG_ERROR)
                 << "*** Error @ " << std::hex << std::setw(8) << std::setfill('0')
@@ -1093,7 +1126,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::LR:
+    OP_CASE(LR)
       {
         uint32 c = *(inst->src2);
         uint32 b;
@@ -1108,7 +1141,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SR:
+    OP_CASE(SR)
       {
 
         uint32 b = *(inst->src1);
@@ -1134,7 +1167,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::AEX:
+    OP_CASE(AEX)
       {
         
         uint32 b = *(inst->src1);
@@ -1160,7 +1193,7 @@ Processor::step_single_fast ()
         break;
     }
     
-    case OpCode::SETI:
+    OP_CASE(SETI)
     {
       LOG(LOG_DEBUG3) << "SETI " << HEX(*(inst->src2));
 
@@ -1179,7 +1212,7 @@ Processor::step_single_fast ()
       break;
     }
     
-    case OpCode::CLRI:
+    OP_CASE(CLRI)
     {
       if(inst->info.rf_renb0)
       {
@@ -1189,7 +1222,7 @@ Processor::step_single_fast ()
       break;
     }
 
-    case OpCode::TST:
+    OP_CASE(TST)
       {
         IF_CC(inst,state)
         {
@@ -1200,7 +1233,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::BTST:
+    OP_CASE(BTST)
       {
         IF_CC(inst,state)
         {
@@ -1211,7 +1244,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::CMP:
+    OP_CASE(CMP)
       {
         IF_CC(inst,state)
         {
@@ -1232,7 +1265,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::RCMP:
+    OP_CASE(RCMP)
       {
         IF_CC(inst,state)
         {
@@ -1257,16 +1290,16 @@ Processor::step_single_fast ()
      * which execute unconditionally and do not set flags.
      * These functions dominate execution time, so are coded ultra-efficiently.
      */
-    case OpCode::MOV: *(inst->dst1) = *(inst->src2);               break;
-    case OpCode::ADD: *(inst->dst1) = *(inst->src1) + *(inst->src2); break;
-    case OpCode::SUB: *(inst->dst1) = *(inst->src1) - *(inst->src2); break;
-    case OpCode::AND: *(inst->dst1) = *(inst->src1) & *(inst->src2); break;
-    case OpCode::OR:  *(inst->dst1) = *(inst->src1) | *(inst->src2); break;
+    OP_CASE(MOV) *(inst->dst1) = *(inst->src2);               break;
+    OP_CASE(ADD) *(inst->dst1) = *(inst->src1) + *(inst->src2); break;
+    OP_CASE(SUB) *(inst->dst1) = *(inst->src1) - *(inst->src2); break;
+    OP_CASE(AND) *(inst->dst1) = *(inst->src1) & *(inst->src2); break;
+    OP_CASE(OR)  *(inst->dst1) = *(inst->src1) | *(inst->src2); break;
 
     /* Versions of mov, add, sub, and, or that either set flags,
      * or execute conditionally, or both.
      */
-    case OpCode::MOV_F:
+    OP_CASE(MOV_F)
       {
         IF_CC(inst,state)
         {
@@ -1281,7 +1314,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ADD_F:
+    OP_CASE(ADD_F)
       {
         IF_CC(inst,state)
         {
@@ -1315,7 +1348,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SUB_F:
+    OP_CASE(SUB_F)
       {
         IF_CC(inst,state)
         {
@@ -1349,7 +1382,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::AND_F:
+    OP_CASE(AND_F)
       {
         IF_CC(inst,state)
         {
@@ -1379,7 +1412,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::BCLR:
+    OP_CASE(BCLR)
       {
         IF_CC(inst,state)
         {
@@ -1404,7 +1437,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::BSET:
+    OP_CASE(BSET)
       {
         IF_CC(inst,state)
         {
@@ -1429,7 +1462,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::OR_F:
+    OP_CASE(OR_F)
       {
         IF_CC(inst,state)
         {
@@ -1458,7 +1491,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::RSUB:
+    OP_CASE(RSUB)
       {
         IF_CC(inst,state)
         {
@@ -1487,7 +1520,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ADC:
+    OP_CASE(ADC)
       {
         IF_CC(inst,state)
         {
@@ -1525,7 +1558,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SBC:
+    OP_CASE(SBC)
       {
         IF_CC(inst,state)
         {
@@ -1563,7 +1596,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::XOR:
+    OP_CASE(XOR)
       {
         IF_CC(inst,state)
         {
@@ -1588,7 +1621,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::BIC:
+    OP_CASE(BIC)
       {
         IF_CC(inst,state)
         {
@@ -1613,7 +1646,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::MAX: // Bug fixed, Nov-07 (fixed setting of C bit)
+    OP_CASE(MAX) // Bug fixed, Nov-07 (fixed setting of C bit)
       {
         IF_CC(inst,state)
         {
@@ -1650,7 +1683,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::MIN: // Bug fixed, Nov-07 (fixed setting of C bit)
+    OP_CASE(MIN) // Bug fixed, Nov-07 (fixed setting of C bit)
       {
         IF_CC(inst,state)
         {
@@ -1685,7 +1718,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::BXOR: // Bug fixed, Nov-07 (ANDed 0x1f mask to src2)
+    OP_CASE(BXOR) // Bug fixed, Nov-07 (ANDed 0x1f mask to src2)
       {
         IF_CC(inst,state)
         {
@@ -1710,7 +1743,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::BMSK: // Bug fixed, Nov-07 (modified mask generation)
+    OP_CASE(BMSK) // Bug fixed, Nov-07 (modified mask generation)
       {
         IF_CC(inst,state)
         {
@@ -1737,7 +1770,7 @@ Processor::step_single_fast ()
         break;
       }
 
-     case OpCode::BMSKN: // ARCv2 only
+     OP_CASE(BMSKN) // ARCv2 only
       {
         IF_CC(inst,state)
         {
@@ -1764,7 +1797,7 @@ Processor::step_single_fast ()
         break;
       }
 
-   case OpCode::ADD1:
+   OP_CASE(ADD1)
       {
         IF_CC(inst,state)
         {
@@ -1793,7 +1826,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ADD2:
+    OP_CASE(ADD2)
       {
         IF_CC(inst,state)
         {
@@ -1822,7 +1855,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ADD3:
+    OP_CASE(ADD3)
       {
         IF_CC(inst,state)
         {
@@ -1851,7 +1884,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SUB1:
+    OP_CASE(SUB1)
       {
         IF_CC(inst,state)
         {
@@ -1880,7 +1913,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SUB2:
+    OP_CASE(SUB2)
       {
         IF_CC(inst,state)
         {
@@ -1909,7 +1942,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SUB3:
+    OP_CASE(SUB3)
       {
         IF_CC(inst,state)
         {
@@ -1938,7 +1971,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::MPY: // Bug fixed, Nov 07 (adjusted state.V update logic)
+    OP_CASE(MPY) // Bug fixed, Nov 07 (adjusted state.V update logic)
       {
         IF_CC(inst,state)
         {
@@ -1958,7 +1991,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::MPYH: // Bug fixed, Nov 07 (corrected casting of state.N expression)
+    OP_CASE(MPYH) // Bug fixed, Nov 07 (corrected casting of state.N expression)
       {
         IF_CC(inst,state)
         {
@@ -1975,7 +2008,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::MPYHU: // Bug fixed, Nov 07 (used dst1 in state.Z calculation)
+    OP_CASE(MPYHU) // Bug fixed, Nov 07 (used dst1 in state.Z calculation)
       {
         IF_CC(inst,state)
         {
@@ -1992,7 +2025,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::MPYU: // Bug fixed, Nov 07 (used dst1 in state.Z calculation)
+    OP_CASE(MPYU) // Bug fixed, Nov 07 (used dst1 in state.Z calculation)
       {
         IF_CC(inst,state)
         {
@@ -2012,7 +2045,7 @@ Processor::step_single_fast ()
     // -------------------------------------------------------------------------
     // OpCode::MUL64: only available on ARC 600 processor
     //
-    case OpCode::MUL64:
+    OP_CASE(MUL64)
       {
         IF_CC(inst,state)
         { 
@@ -2028,7 +2061,7 @@ Processor::step_single_fast ()
     // -------------------------------------------------------------------------
     // OpCode::MULU64: only available on ARC 600 processor
     //
-    case OpCode::MULU64:
+    OP_CASE(MULU64)
       {
         IF_CC(inst,state)
         {
@@ -2044,7 +2077,7 @@ Processor::step_single_fast ()
     // -------------------------------------------------------------------------
     // OpCode::MPYW: only available on ARC 600 and ARCv2
     //
-    case OpCode::MPYW:
+    OP_CASE(MPYW)
       {
         IF_CC(inst,state)
         {
@@ -2063,7 +2096,7 @@ Processor::step_single_fast ()
     // -------------------------------------------------------------------------
     // OpCode::MPYWU: only available on ARC 600 and ARCv2
     //
-    case OpCode::MPYWU:
+    OP_CASE(MPYWU)
       {
         IF_CC(inst,state)
         {
@@ -2080,7 +2113,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SETEQ:
+    OP_CASE(SETEQ)
       {
         IF_CC(inst,state)
         {
@@ -2105,7 +2138,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SETNE:
+    OP_CASE(SETNE)
       {
         IF_CC(inst,state)
         {
@@ -2130,7 +2163,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SETLT:
+    OP_CASE(SETLT)
       {
         IF_CC(inst,state)
         {
@@ -2155,7 +2188,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SETGE:
+    OP_CASE(SETGE)
       {
         IF_CC(inst,state)
         {
@@ -2180,7 +2213,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SETLO:
+    OP_CASE(SETLO)
       {
         IF_CC(inst,state)
         {
@@ -2205,7 +2238,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SETHS:
+    OP_CASE(SETHS)
       {
         IF_CC(inst,state)
         {
@@ -2230,7 +2263,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SETLE:
+    OP_CASE(SETLE)
       {
         IF_CC(inst,state)
         {
@@ -2255,7 +2288,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SETGT:
+    OP_CASE(SETGT)
       {
         IF_CC(inst,state)
         {
@@ -2280,7 +2313,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ASL: // Bug fixed, Nov 07 (added update of state.V)
+    OP_CASE(ASL) // Bug fixed, Nov 07 (added update of state.V)
       {
         IF_CC(inst,state)
         {
@@ -2307,7 +2340,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ASR:
+    OP_CASE(ASR)
       {
         IF_CC(inst,state)
         {
@@ -2332,7 +2365,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::LSR:
+    OP_CASE(LSR)
       {
         IF_CC(inst,state)
         {
@@ -2357,7 +2390,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ROR: // Bug fixed, Nov 07 (corrected update to state.Z and state.N)
+    OP_CASE(ROR) // Bug fixed, Nov 07 (corrected update to state.Z and state.N)
       {
         IF_CC(inst,state)
         {
@@ -2380,7 +2413,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ROL: // ARCv2 basecase
+    OP_CASE(ROL) // ARCv2 basecase
       {
         IF_CC(inst,state)
         {
@@ -2408,7 +2441,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::RRC: // Bug fixed, Nov 07 (corrected update to state.Z and state.N)
+    OP_CASE(RRC) // Bug fixed, Nov 07 (corrected update to state.Z and state.N)
       {
         IF_CC(inst,state)
         {
@@ -2438,7 +2471,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::RLC: // Note, different behaviour between ARC700 and ARC600.
+    OP_CASE(RLC) // Note, different behaviour between ARC700 and ARC600.
       {       // '600 sets overflow if flag_enable, '700 does not set overflow
               // Bug fix, Nov 07 (corrected Z and N bit update logic)
         IF_CC(inst,state)
@@ -2470,7 +2503,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SEXBYTE:
+    OP_CASE(SEXBYTE)
       {
         *(inst->dst1) = (char)(*(inst->src2));
         if (inst->flag_enable)
@@ -2481,7 +2514,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SEXWORD:
+    OP_CASE(SEXWORD)
       {
         *(inst->dst1) = (short)(*(inst->src2));
         if (inst->flag_enable)
@@ -2492,7 +2525,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::EXTBYTE:
+    OP_CASE(EXTBYTE)
       {
         *(inst->dst1) = (unsigned char)(*(inst->src2));
         if (inst->flag_enable)
@@ -2503,7 +2536,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::EXTWORD:
+    OP_CASE(EXTWORD)
       {
         *(inst->dst1) = (unsigned short)(*(inst->src2));
         if (inst->flag_enable)
@@ -2514,7 +2547,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ABS: // Bug fix, Nov 07 (update to state.V added)
+    OP_CASE(ABS) // Bug fix, Nov 07 (update to state.V added)
       {
         sint32 b = *(inst->src2);
         *(inst->dst1) = (b < 0) ? -b : b;
@@ -2527,7 +2560,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::NOT:
+    OP_CASE(NOT)
       {
         sint32 b = ~*(inst->src2);
         *(inst->dst1) = (uint32)b;
@@ -2542,7 +2575,7 @@ Processor::step_single_fast ()
       // ----------------------------------------------------------------------
       // EX: atomic exchange operation 
       //
-    case OpCode::EX: // Bug fix, Nov 07 (only update dst1 if write succeeds)
+    OP_CASE(EX) // Bug fix, Nov 07 (only update dst1 if write succeeds)
     {
       const uint32  ma = *(inst->src2);       // target address of EX memory operand
       const uint32  sd = *(inst->dst1);       // sd is required for tracing
@@ -2576,7 +2609,7 @@ Processor::step_single_fast ()
       // ----------------------------------------------------------------------
       // LLOCK: Load locked
       //
-    case OpCode::LLOCK:
+    OP_CASE(LLOCK)
     {
       const uint32  ma = *(inst->src2);
       uint32        rd = 0;
@@ -2607,7 +2640,7 @@ Processor::step_single_fast ()
       // ----------------------------------------------------------------------
       // SCOND: Store conditional
       //
-    case OpCode::SCOND:
+    OP_CASE(SCOND)
     {
       commit = state.lock_phys_addr & 1; // extract lock flag indicating whether we commit
 
@@ -2630,7 +2663,7 @@ Processor::step_single_fast ()
       break;
     }
       
-    case OpCode::ASLM: // Bug fix, Nov 07 (to deal with x86 SAL instruction)
+    OP_CASE(ASLM) // Bug fix, Nov 07 (to deal with x86 SAL instruction)
       {
         IF_CC(inst,state)
         {
@@ -2675,7 +2708,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::LSRM: // Bug fix, Nov 07 (to deal with x86 SAL instruction)
+    OP_CASE(LSRM) // Bug fix, Nov 07 (to deal with x86 SAL instruction)
       {
         IF_CC(inst,state)
         {
@@ -2719,7 +2752,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ASRM: // Bug fix, Nov 07 (to deal with x86 SAL instruction)
+    OP_CASE(ASRM) // Bug fix, Nov 07 (to deal with x86 SAL instruction)
       {
         IF_CC(inst,state)
         {
@@ -2762,7 +2795,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::RORM: // Bug fix, Nov 07 (adjusted state.Z and state.N update)
+    OP_CASE(RORM) // Bug fix, Nov 07 (adjusted state.Z and state.N update)
       {
         IF_CC(inst,state)
         {
@@ -2795,7 +2828,7 @@ Processor::step_single_fast ()
 
     /* Extended arithmetic instructions start here */
 
-    case OpCode::ABSS: // Bug fix, Nov 07 (instruction not conditional)
+    OP_CASE(ABSS) // Bug fix, Nov 07 (instruction not conditional)
       {
         sint32 b = *(inst->src2);
         bool sat = ((uint32)b == 0x80000000);
@@ -2816,7 +2849,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ABSSW: // Bug fix, Nov 07 (instruction not conditional, changed logic too)
+    OP_CASE(ABSSW) // Bug fix, Nov 07 (instruction not conditional, changed logic too)
       {
         sint32 b = (sint32)(*(inst->src2) & 0x0000ffff);
         bool sat = (b == 0x00008000);
@@ -2840,7 +2873,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ADDS: // Bug fixes, Nov 07 (cast for src1 and dst1)
+    OP_CASE(ADDS) // Bug fixes, Nov 07 (cast for src1 and dst1)
       {       //  1. cast for src1 in '>' comparison
               //  2. cast for dst1 in state.N expression
               //  3. no update to state.C (apparently)
@@ -2875,7 +2908,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SUBS: // Bug fix, Nov 07
+    OP_CASE(SUBS) // Bug fix, Nov 07
       {       //  1. cast src1 before comparison
               //  2. comparison should be >= rather than >
               //  3. no update to state.C
@@ -2917,8 +2950,8 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ADDSDW: // ADDSDW and SUBSDW are handled together, as their
-    case OpCode::SUBSDW: // semantics are almost identical. They differ only
+    OP_CASE(ADDSDW) // ADDSDW and SUBSDW are handled together, as their
+    OP_CASE(SUBSDW) // semantics are almost identical. They differ only
       {             // in the operator performed (add versus subtract).
         IF_CC(inst,state)
         {
@@ -3048,7 +3081,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ASLS: // Bug fix, major changes for ASLS
+    OP_CASE(ASLS) // Bug fix, major changes for ASLS
       {
         IF_CC(inst,state)
         {
@@ -3108,7 +3141,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ASRS: // Bug fix, major changes for ASLS
+    OP_CASE(ASRS) // Bug fix, major changes for ASLS
       {
         IF_CC(inst,state)
         {
@@ -3167,7 +3200,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::DIVAW: // Bug fix, Nov 07
+    OP_CASE(DIVAW) // Bug fix, Nov 07
       {
         IF_CC(inst,state)
         {
@@ -3191,13 +3224,13 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::NEG: // Bug fix, Nov 07 (added this instruction for ARC 700)
+    OP_CASE(NEG) // Bug fix, Nov 07 (added this instruction for ARC 700)
       {
         *(inst->dst1) = - (sint32)*(inst->src2);
         break;
       }
 
-    case OpCode::NEGS: // Bug fix, Nov 07 (not a conditional instruction)
+    OP_CASE(NEGS) // Bug fix, Nov 07 (not a conditional instruction)
       {
         bool sat;
 
@@ -3222,7 +3255,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::NEGSW: // Bug fix, Nov 07 (not a conditional instruction)
+    OP_CASE(NEGSW) // Bug fix, Nov 07 (not a conditional instruction)
       {        // also fixed error in first if-condition
         bool sat;
         short src16 = *(inst->src2) & 0x0000ffff;
@@ -3248,7 +3281,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::NORM: // Bug fix, Nov 07 (not a conditional instruction)
+    OP_CASE(NORM) // Bug fix, Nov 07 (not a conditional instruction)
       {       // also need to retest 'a' after bsrl insn
         sint32 a = *(inst->src2);
         bool z = (a == 0);
@@ -3273,7 +3306,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::NORMW: // Bug fix, Nov 07 (not a conditional instruction)
+    OP_CASE(NORMW) // Bug fix, Nov 07 (not a conditional instruction)
       {        // also need to retest 'a' after bsrl insn
         sint32 a = ((sint32)*(inst->src2)) << 16;
         bool z = (a == 0);
@@ -3297,7 +3330,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::FFS: // ARCv2 only
+    OP_CASE(FFS) // ARCv2 only
       {
         sint32 a = *(inst->src2);
         sint32 d = 31;
@@ -3316,7 +3349,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::FLS: // ARCv2 only
+    OP_CASE(FLS) // ARCv2 only
       {
         sint32 a = *(inst->src2);
         sint32 d = 0;
@@ -3335,7 +3368,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::RND16: // Bug fix, Nov 07 (not a conditional instruction)
+    OP_CASE(RND16) // Bug fix, Nov 07 (not a conditional instruction)
       {
         sint32 a = *(inst->src2);
         bool sat;
@@ -3360,7 +3393,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SAT16: // Bug fix, Nov 07 (not a conditional instruction)
+    OP_CASE(SAT16) // Bug fix, Nov 07 (not a conditional instruction)
       {
         sint32 a   = *(inst->src2);
         bool   sat = false;
@@ -3390,7 +3423,7 @@ Processor::step_single_fast ()
 
     /* Extended arithmetic instructions finish here. */
 
-    case OpCode::SWAP: // Bug fix, Nov 07 (not a conditional instruction)
+    OP_CASE(SWAP) // Bug fix, Nov 07 (not a conditional instruction)
       {
         uint32 a = (uint32)*(inst->src2);
         *(inst->dst1) = (a >> 16) | (a << 16);
@@ -3403,7 +3436,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SWAPE: // ARCv2 only
+    OP_CASE(SWAPE) // ARCv2 only
       {
         uint32 a = (uint32)*(inst->src2);
         a = ((a & 0x00FF00FFU) << 8) | ((a & 0xFF00FF00U) >> 8);
@@ -3417,7 +3450,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::LSL16: // ARCv2 only
+    OP_CASE(LSL16) // ARCv2 only
       {
         uint32 a = (uint32)*(inst->src2);
         *(inst->dst1) = (a << 16);
@@ -3430,7 +3463,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::LSR16: // ARCv2 only
+    OP_CASE(LSR16) // ARCv2 only
       {
         uint32 a = (uint32)*(inst->src2);
         *(inst->dst1) = (a >> 16);
@@ -3443,7 +3476,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ASR16: // ARCv2 only
+    OP_CASE(ASR16) // ARCv2 only
       {
         sint32 a = (sint32)*(inst->src2);
         *(inst->dst1) = (uint32)(a >> 16);
@@ -3456,7 +3489,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ASR8: // ARCv2 only
+    OP_CASE(ASR8) // ARCv2 only
       {
         sint32 a = (sint32)*(inst->src2);
         *(inst->dst1) = (uint32)(a >> 8);
@@ -3469,7 +3502,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::LSR8: // ARCv2 only
+    OP_CASE(LSR8) // ARCv2 only
       {
         uint32 a = (uint32)*(inst->src2);
         *(inst->dst1) = (a >> 8);
@@ -3482,7 +3515,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::LSL8: // ARCv2 only
+    OP_CASE(LSL8) // ARCv2 only
       {
         uint32 a = (uint32)*(inst->src2);
         *(inst->dst1) = (a << 8);
@@ -3495,7 +3528,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ROL8: // ARCv2 only
+    OP_CASE(ROL8) // ARCv2 only
       {
         uint32 a = (uint32)*(inst->src2);
         *(inst->dst1) = (a << 8) | (a >> 24);
@@ -3508,7 +3541,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::ROR8: // ARCv2 only
+    OP_CASE(ROR8) // ARCv2 only
       {
         uint32 a = (uint32)*(inst->src2);
         *(inst->dst1) = (a >> 8) | (a << 24);
@@ -3521,7 +3554,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::DIV:  // ARCv2 only
+    OP_CASE(DIV)  // ARCv2 only
       {
         IF_CC(inst,state)
         {
@@ -3568,7 +3601,7 @@ Processor::step_single_fast ()
         break;
       }      
 
-    case OpCode::DIVU:  // ARCv2 only
+    OP_CASE(DIVU)  // ARCv2 only
       {
         IF_CC(inst,state)
         {
@@ -3603,7 +3636,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::REM:  // ARCv2 only
+    OP_CASE(REM)  // ARCv2 only
       {
         IF_CC(inst,state)
         {
@@ -3651,7 +3684,7 @@ Processor::step_single_fast ()
       }
       
 
-    case OpCode::REMU:  // ARCv2 only
+    OP_CASE(REMU)  // ARCv2 only
       {
         IF_CC(inst,state)
         {
@@ -3685,7 +3718,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::JLI_S:  // ARCv2 only
+    OP_CASE(JLI_S)  // ARCv2 only
       {
         START_ILLEGAL_IN_DSLOT
           end_of_block = true;
@@ -3704,7 +3737,7 @@ Processor::step_single_fast ()
         break;
       }      
 
-    case OpCode::EI_S:  // ARCv2 only
+    OP_CASE(EI_S)  // ARCv2 only
       {
         START_ILLEGAL_IN_DSLOT
           end_of_block = true;
@@ -3724,7 +3757,7 @@ Processor::step_single_fast ()
         break;
       }      
 
-    case OpCode::BI:    // ARCv2 only
+    OP_CASE(BI)    // ARCv2 only
       {
         START_ILLEGAL_IN_DSLOT
           end_of_block = true;
@@ -3738,7 +3771,7 @@ Processor::step_single_fast ()
         break;
       }
     
-    case OpCode::BIH:   // ARCv2 only
+    OP_CASE(BIH)   // ARCv2 only
       {
         START_ILLEGAL_IN_DSLOT
           end_of_block = true;
@@ -3754,7 +3787,7 @@ Processor::step_single_fast ()
     
     /* ARCv2 instructions finish here. */
 
-    case OpCode::FLAG: // Bug fix, Nov 07 (this insn is conditional)
+    OP_CASE(FLAG) // Bug fix, Nov 07 (this insn is conditional)
       {            // flag_enable => kflag instruction for A6K
         IF_CC(inst,state)
         {
@@ -3764,7 +3797,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::SLEEP:
+    OP_CASE(SLEEP)
       {
         end_of_block = true;
         sleep_inst (*(inst->src2));
@@ -3772,7 +3805,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::BREAK:
+    OP_CASE(BREAK)
       {
         end_of_block = true;
         LOG(LOG_DEBUG4) << "OpCode::BREAK executing";
@@ -3837,7 +3870,7 @@ Processor::step_single_fast ()
         break;
 #endif
       }
-    case OpCode::AP_BREAK:
+    OP_CASE(AP_BREAK)
       {
         // An Actionpoints breakpoint has been triggered, and this may lead
         // to either an exception or a break, depending on the Action setting
@@ -3972,7 +4005,7 @@ Processor::step_single_fast ()
     // -------------------------------------------------------------------------
     // Software interrupts and trap instructions
     //
-    case OpCode::SWI:
+    OP_CASE(SWI)
     {
       phys_profile_.reset_active_trace_sequence(interrupt_stack.top());
       end_of_block = true;
@@ -4016,7 +4049,7 @@ Processor::step_single_fast ()
       break;
     }
 
-    case OpCode::TRAP0:
+    OP_CASE(TRAP0)
       {
 
         // The TRAP and TRAP_S instructions set the local ecause and efa
@@ -4037,7 +4070,7 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::RTIE:
+    OP_CASE(RTIE)
       {
         START_ILLEGAL_IN_DSLOT
           phys_profile_.reset_active_trace_sequence(interrupt_stack.top());
@@ -4052,12 +4085,12 @@ Processor::step_single_fast ()
 
     // -------------------------------------------------------------------------
       
-    case OpCode::SYNC:
+    OP_CASE(SYNC)
       break;
 
-    case OpCode::FMUL:
-    case OpCode::FADD:
-    case OpCode::FSUB:
+    OP_CASE(FMUL)
+    OP_CASE(FADD)
+    OP_CASE(FSUB)
       {
         IF_CC(inst,state) {
           spfp_emulation(inst->code,inst->dst1,*(inst->src1),*(inst->src2),inst->flag_enable);
@@ -4065,37 +4098,37 @@ Processor::step_single_fast ()
         break;
       }
 
-    case OpCode::DMULH11:
-    case OpCode::DMULH12:
-    case OpCode::DMULH21:
-    case OpCode::DMULH22:
-    case OpCode::DADDH11:
-    case OpCode::DADDH12:
-    case OpCode::DADDH21:
-    case OpCode::DADDH22:
-    case OpCode::DSUBH11:
-    case OpCode::DSUBH12:
-    case OpCode::DSUBH21:
-    case OpCode::DSUBH22:
-    case OpCode::DRSUBH11:
-    case OpCode::DRSUBH12:
-    case OpCode::DRSUBH21:
-    case OpCode::DRSUBH22: {
+    OP_CASE(DMULH11)
+    OP_CASE(DMULH12)
+    OP_CASE(DMULH21)
+    OP_CASE(DMULH22)
+    OP_CASE(DADDH11)
+    OP_CASE(DADDH12)
+    OP_CASE(DADDH21)
+    OP_CASE(DADDH22)
+    OP_CASE(DSUBH11)
+    OP_CASE(DSUBH12)
+    OP_CASE(DSUBH21)
+    OP_CASE(DSUBH22)
+    OP_CASE(DRSUBH11)
+    OP_CASE(DRSUBH12)
+    OP_CASE(DRSUBH21)
+    OP_CASE(DRSUBH22) {
       IF_CC(inst,state) {
         dpfp_emulation(inst->code,inst->dst1,*(inst->src1),*(inst->src2),inst->flag_enable);
       }
       break;
     }
 
-    case OpCode::DEXCL1:
-    case OpCode::DEXCL2: {
+    OP_CASE(DEXCL1)
+    OP_CASE(DEXCL2) {
       IF_CC(inst,state) { // register D1|D2 exchange
         dexcl_emulation(inst->code, inst->dst1, *(inst->src1), *(inst->src2));
       }
       break;
     }
 
-    case OpCode::NOP:
+    OP_CASE(NOP)
       break;
       
       // -----------------------------------------------------------------------
@@ -4104,7 +4137,7 @@ Processor::step_single_fast ()
       //   link    - 1 => save BLINK,  0 => don't save BLINK
       //   dslot   - 1 => save FP,     0 => don't save FP
       //
-    case OpCode::ENTER: {
+    OP_CASE(ENTER) {
       START_ILLEGAL_IN_DSLOT
         
         uint32       rd, ra, rn;
@@ -4262,7 +4295,7 @@ Processor::step_single_fast ()
       //   dslot         - 1 => restore FP,    0 => don't restore FP
       //   info.isReturn - 1 => jump to blink after restoring context
       //
-    case OpCode::LEAVE: {
+    OP_CASE(LEAVE) {
       START_ILLEGAL_IN_DSLOT
         
         uint32  rd, ra, rn;
@@ -4439,7 +4472,7 @@ Processor::step_single_fast ()
     // -------------------------------------------------------------------------
     // EIA Extension Instructions
     //
-    case OpCode::EIA_ZOP: {
+    OP_CASE(EIA_ZOP) {
       // Setup arguments
       // 
       ise::eia::EiaBflags bflags_in = {state.Z,  state.N,  state.C,  state.V };
@@ -4451,7 +4484,7 @@ Processor::step_single_fast ()
       
       break;
     }
-    case OpCode::EIA_ZOP_F: {
+    OP_CASE(EIA_ZOP_F) {
       // Setup arguments
       //
       ise::eia::EiaBflags bflags = {state.Z,  state.N,  state.C,  state.V };
@@ -4475,7 +4508,7 @@ Processor::step_single_fast ()
       }
       break;
     }
-    case OpCode::EIA_SOP: {
+    OP_CASE(EIA_SOP) {
       // Setup arguments
       // 
       ise::eia::EiaBflags bflags_in = {state.Z,  state.N,  state.C,  state.V };
@@ -4487,7 +4520,7 @@ Processor::step_single_fast ()
       
       break;
     }
-    case OpCode::EIA_SOP_F: {
+    OP_CASE(EIA_SOP_F) {
       // Setup arguments
       // 
       ise::eia::EiaBflags bflags = {state.Z,  state.N,  state.C,  state.V };
@@ -4511,7 +4544,7 @@ Processor::step_single_fast ()
       }
       break;
     }
-    case OpCode::EIA_DOP: {
+    OP_CASE(EIA_DOP) {
       // Setup arguments
       // 
       ise::eia::EiaBflags bflags_in = {state.Z,  state.N,  state.C,  state.V };
@@ -4523,7 +4556,7 @@ Processor::step_single_fast ()
       
       break;
     }
-    case OpCode::EIA_DOP_F: {
+    OP_CASE(EIA_DOP_F) {
       // Setup arguments
       // 
       ise::eia::EiaBflags bflags = {state.Z,  state.N,  state.C,  state.V };
@@ -4549,7 +4582,13 @@ Processor::step_single_fast ()
       break;
     }
 
-    case OpCode::EXCEPTION:
+    OP_CASE(EXCEPTION)
+    // Opcodes without an interpreter implementation raise an exception
+    OP_LABEL(MULDW)   OP_LABEL(MULUDW)  OP_LABEL(MULRDW)  OP_LABEL(MACDW)
+    OP_LABEL(MACUDW)  OP_LABEL(MACRDW)  OP_LABEL(MSUBDW)  OP_LABEL(CMACRDW)
+    OP_LABEL(MULULW)  OP_LABEL(MULLW)   OP_LABEL(MULFLW)  OP_LABEL(MACLW)
+    OP_LABEL(MACFLW)  OP_LABEL(MACHULW) OP_LABEL(MACHLW)  OP_LABEL(MACHFLW)
+    OP_LABEL(MULHLW)  OP_LABEL(MULHFLW) OP_LABEL(SIMD)    OP_LABEL(PASTA)
     default: {
 
 #ifdef DEBUG_EXCEPTIONS
@@ -4582,7 +4621,7 @@ Processor::step_single_fast ()
           // simulation.
           //
           enter_exception (0, state.pc, state.pc);
-          sim_opts.halt_simulation = 1;
+          set_halt_simulation(true);
         }
         break;
       }
@@ -4604,7 +4643,7 @@ Processor::step_single_fast ()
   // ---------------------------------------------------------------------------
   // Update memory models when memory model simulation is enabled
   //
-  if (sim_opts.memory_sim) {
+  if (is_memory_model_active()) {
     ASSERT(mem_model && "Memory model NOT instantiated but memory simulation enabled!");
 
     // -------------------------------------------------------------------------
@@ -4724,19 +4763,9 @@ Processor::step_single_fast ()
         case arcsim::isa::arc::Dcode::kMemEnterLeave: {
           MEM_ASSIGN(inst, 0);
           if (inst->code == OpCode::ENTER) {  // ENTER instruction
-            while (!mem_model->addr_queue.empty()) {
-              MEM_ADD(inst, mem_model->write (mem_model->addr_queue.front(),
-                                                     state.pc,
-                                                     false));
-              mem_model->addr_queue.pop();                
-            }
+            MEM_ADD(inst, mem_model->write_queue(state.pc, false));
           } else {                        // LEAVE instruction
-            while (!mem_model->addr_queue.empty()) {
-              MEM_ADD(inst, mem_model->read (mem_model->addr_queue.front(),
-                                                    state.pc,
-                                                    false));
-              mem_model->addr_queue.pop();
-            }
+            MEM_ADD(inst, mem_model->read_queue (state.pc, false));
           }
           break;
         }
@@ -4924,6 +4953,7 @@ Processor::step_single_fast ()
 
   IF_STEP_TRACE_INSTR(this, trace_commit(commit)); // trace instruction commit
   
+#ifndef STEP_PLAIN
   // ---------------------------------------------------------------------------
   // AboutToExecuteInstructionIPT and HandleBeginBasicBlockInstructionIPT check
   //
@@ -4947,6 +4977,7 @@ Processor::step_single_fast ()
       ipt_mgr.notify_begin_basic_block_instruction_execution_ipt_handlers(state.pc);
     }
   }
+#endif /* !STEP_PLAIN */
   
   // TBD - check the DEBUG.IS bit and self-halt the processor if
   // single-stepping is enabled.
@@ -182,6 +182,11 @@ namespace arcsim {
         vcount0  = vcount1  = 0;
         count_increment = 0;
         timer_sync_time = 0;
+        
+        // Drop a pending timer event from before a reset
+        //
+        events_.cancel(this);
+        update_event_deadline();
 
         // Get the user option for using host timers or instruction-count
         // approximation to cpu clock cycles. If host timer is enabled,
@@ -235,6 +240,8 @@ namespace arcsim {
 
         if (use_host_timer)
           timer->start();
+        else if (inst_timer_enabled)
+          time_to_expiry(); // schedule timer event
       }
 
       // -----------------------------------------------------------------------
@@ -271,10 +278,7 @@ namespace arcsim {
         timer_sync(); // bring COUNT0 and COUNT1 up to date with the current time
         
         if (inst_timer_enabled) { // for instruction timer mode timer_sync() checks for time expiry
-          if (!sim_opts.cycle_sim) { // instruction count mode
-            state.iterations = 1; // invalidate pre-computed iterations
-          }
-          time_to_expiry(); // compute state.timer_expiry
+          time_to_expiry(); // re-schedule timer event and update state.timer_expiry
           return;
         }
         
@@ -326,10 +330,7 @@ namespace arcsim {
         timer_sync(); // bring COUNT0 and COUNT1 up to date with the current time
         
         if (inst_timer_enabled) { // for instruction timer mode timer_sync() checks for time expiry
-          if (!sim_opts.cycle_sim) { // instruction count mode
-            state.iterations = 1; // invalidate pre-computed iterations
-          }
-          time_to_expiry(); // compute state.timer_expiry
+          time_to_expiry(); // re-schedule timer event and update state.timer_expiry
           return;
         }
         
@@ -363,10 +364,7 @@ namespace arcsim {
         timer_sync(); // bring COUNT0 and COUNT1 up to date with the current time
         
         if (inst_timer_enabled) { // for instruction timer mode timer_sync() checks for time expiry
-          if (!sim_opts.cycle_sim) { // instruction count mode
-            state.iterations = 1; // invalidate pre-computed iterations
-          }
-          time_to_expiry(); // compute state.timer_expiry
+          time_to_expiry(); // re-schedule timer event and update state.timer_expiry
           return;
         }
         
@@ -389,8 +387,10 @@ namespace arcsim {
       void
       Processor::timer_sync ()
       {
-        if (IS_T0_AND_T1_DISABLED()) // do nothing if TIMERS are disabled
+        if (IS_T0_AND_T1_DISABLED()) { // only dispatch events if TIMERS are disabled
+          dispatch_events();
           return;
+        }
         
         LOG(LOG_DEBUG3) << "[TIMER] SYNC: COUNT0 was " << state.auxs[AUX_COUNT0]
                         << ", COUNT1 was "  << state.auxs[AUX_COUNT1];
@@ -419,6 +419,10 @@ namespace arcsim {
         
         LOG(LOG_DEBUG3) << "[TIMER] SYNC: new COUNT0 = " << state.auxs[AUX_COUNT0]
                         << ", new COUNT1 =  "  << state.auxs[AUX_COUNT1];
+        
+        // Timers are up to date, now run any other due events
+        //
+        dispatch_events();
       }
 
       // -----------------------------------------------------------------------
@@ -446,10 +450,9 @@ namespace arcsim {
 
       // -----------------------------------------------------------------------
       // This is called in order to determine how many cycles can be simulated
-      // up to the point where the next timer will expire. If cycle-accurate
-      // simulation is built into the simulator and is enabled, then the
-      // state.timer_expiry variable will be set to the current cycle count
-      // plus the time to expiry.
+      // up to the point where the next timer will expire. The timer event is
+      // (re-)scheduled for the current time plus the time to expiry, and
+      // state.timer_expiry is updated to the earliest pending event.
       //
       // If COUNTi == LIMITi, then 2^32 cycles will elapse before the counter
       // wraps around and expires. Otherwise, it will be LIMITi - COUNTi.
@@ -459,12 +462,7 @@ namespace arcsim {
       {
         ASSERT(inst_timer_enabled);  // ONLY ENTER IF inst_timer_enabled
         
-        // compute 'current' time/cycles
-#if defined(CYCLE_ACC_SIM)
-        const uint64 now  = (sim_opts.cycle_sim) ? cnt_ctx.cycle_count.get_value() : instructions();
-#else
-        const uint64 now  = instructions();
-#endif
+        const uint64 now    = get_event_time();
 
         const uint32 limit0 = state.auxs[AUX_LIMIT0];
         const uint32 count0 = state.auxs[AUX_COUNT0];
@@ -476,9 +474,10 @@ namespace arcsim {
         const uint32 e1 = (limit1 == count1) ? 0xffffffffUL : (limit1 - count1);
         // determine which timer expires next
         const uint32 et = ((e1 < e0) & (state.auxs[AUX_CONTROL1] & 1UL)) ? e1 : e0;
-        // compute NEW expiry time        
-        state.timer_expiry = now + et;
-        LOG(LOG_DEBUG4) << "[TIMER] EXPIRY TIME = " << state.timer_expiry
+        // schedule timer event at NEW expiry time
+        events_.schedule(this, now + et);
+        update_event_deadline();
+        LOG(LOG_DEBUG4) << "[TIMER] EXPIRY TIME = " << (now + et)
                         << " NOW = " << now << " DELTA = " << et;
         return et;
       }
@@ -522,6 +521,85 @@ namespace arcsim {
         return inc;
       }
 
+      // -----------------------------------------------------------------------
+      // Current time in the time base used by the event queue.
+      //
+      uint64
+      Processor::get_event_time () const
+      {
+#if defined(CYCLE_ACC_SIM)
+        return (sim_opts.cycle_sim) ? cnt_ctx.cycle_count.get_value() : instructions();
+#else
+        return instructions();
+#endif
+      }
+
+      // -----------------------------------------------------------------------
+      // Callback for the ARCompact timer event. Timers are normally brought up
+      // to date by timer_sync() before events are dispatched, hence the timer
+      // event only needs re-arming if no timer has actually expired (e.g. the
+      // deadline was computed before COUNT or LIMIT registers changed).
+      //
+      void
+      Processor::on_event (uint64 now)
+      {
+        LOG(LOG_DEBUG4) << "[EVENT] TIMER EVENT AT " << now;
+        
+        if (!inst_timer_enabled)
+          return;
+        
+        timer_advance_cycles();
+        detect_timer_expiry();
+        if (!events_.is_scheduled(this))
+          time_to_expiry();
+      }
+
+      // -----------------------------------------------------------------------
+      // Schedule/cancel events on behalf of other components (i.e. IODevices).
+      //
+      void
+      Processor::schedule_event (EventCallbackInterface* callback, uint64 delay)
+      {
+        events_.schedule(callback, get_event_time() + delay);
+        update_event_deadline();
+      }
+      
+      void
+      Processor::cancel_event (EventCallbackInterface* callback)
+      {
+        if (events_.cancel(callback))
+          update_event_deadline();
+      }
+      
+      // -----------------------------------------------------------------------
+      // Invoke all due events. This is called by timer_sync(), which in turn is
+      // called whenever the current time has reached state.timer_expiry.
+      //
+      void
+      Processor::dispatch_events ()
+      {
+        const uint64 now = get_event_time();
+        if (events_.next_deadline() <= now)
+          events_.run_due(now);
+        update_event_deadline();
+      }
+      
+      // -----------------------------------------------------------------------
+      // Mirror earliest event deadline in state.timer_expiry, which is checked
+      // by the run loops, translated code and pipeline models. If the deadline
+      // moved closer in instruction count mode the pre-computed iterations of
+      // the current slice are invalidated so the new deadline is not overrun.
+      //
+      void
+      Processor::update_event_deadline ()
+      {
+        const uint64 deadline = events_.next_deadline();
+        if (!sim_opts.cycle_sim && deadline < state.timer_expiry) {
+          state.iterations = 1; // invalidate pre-computed iterations
+        }
+        state.timer_expiry = deadline;
+      }
+
 // A6KV2.1 RTC
       
       uint32 Processor::get_timer0_irq_num()
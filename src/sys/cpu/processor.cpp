@@ -26,6 +26,7 @@
 #include "sys/cpu/EiaExtensionManager.h"
 
 #include "sys/mmu/Mmu.h"
+#include "sys/mem/BlockData.h"
 
 #include "isa/arc/DcodeConst.h"
 #include "isa/arc/Opcode.h"
@@ -42,6 +43,8 @@
 #include "uarch/bpu/BranchPredictorInterface.h"
 #include "uarch/bpu/BranchPredictorFactory.h"
 
+#include "uarch/memory/MemoryModel.h"
+#include "uarch/memory/CacheModel.h"
 #include "uarch/memory/WayMemorisation.h"
 #include "uarch/memory/WayMemorisationFactory.h"
 
@@ -59,6 +62,7 @@
 #include "util/CounterTimer.h"
 #include "util/Histogram.h"
 #include "util/MultiHistogram.h"
+#include "util/BinaryTrace.h"
 
 #include "ioc/Context.h"
 
@@ -107,6 +111,8 @@ Processor::Processor (System&                   sys,
     bpu(BranchPredictorFactory::create_branch_predictor(core_arch.bpu)),
     iway_pred(WayMemorisationFactory::create_way_memo(core_arch.iwpu, CacheArch::kInstCache)),
     dway_pred(WayMemorisationFactory::create_way_memo(core_arch.dwpu, CacheArch::kDataCache)),
+    BT(0),
+    dcode_page_cache(0),
     sim_started(false),
     local_hotspot_threshold(sys_arch.sim_opts.hotspot_threshold),
     pipeline(ProcessorPipelineFactory::create_pipeline(core_arch.pipeline_variant)),
@@ -135,6 +141,9 @@ Processor::Processor (System&                   sys,
     vcount0(0),
     vcount1(0),
     timer_sync_time(0),
+    // Halt requests go straight to SimOptions unless redirected by System
+    halt_simulation_(&sys.sys_conf.sys_arch.sim_opts.halt_simulation),
+    remote_flush_write_(false),
     last_rtc_clear(0),
     last_rtc_disable(0)
 {  
@@ -151,7 +160,17 @@ Processor::Processor (System&                   sys,
   //
   TS.set_buffer_size(100000);
   
-  if (sim_opts.redir_inst_trace_output) {
+  // Sampling parameters have been validated by SimOptions
+  //
+  sampler_.configure(sim_opts.sample_period, sim_opts.sample_warmup, sim_opts.sample_detail);
+  
+  if (sim_opts.trace_on && sim_opts.trace_binary) {
+    // Binary trace records are written to the trace output file by a
+    // background thread
+    //
+    BT = new arcsim::util::BinaryTraceWriter(sim_opts.rinst_trace_fd, core_id);
+    BT->open();
+  } else if (sim_opts.redir_inst_trace_output) {
     // Associates stream with existing file descriptor
     //
     TS.set_out_fd(fdopen(sim_opts.rinst_trace_fd, "w"));
@@ -177,7 +196,8 @@ Processor::Processor (System&                   sys,
   //
   phys_profile_.construct(256,                                   // page lookup cache size
                           core_arch.page_arch.byte_index_shift,
-                          core_arch.page_arch.page_byte_frame_mask);
+                          core_arch.page_arch.page_byte_frame_mask,
+                          sim_opts.fast_trans_mode == kCompilationModeRegion);
 
   // Initialise PageCache
   //
@@ -216,15 +236,35 @@ Processor::Processor (System&                   sys,
   // Initialise translation cache
   //
   trans_cache.construct(sim_opts.trans_cache_size);
+  state.trans_cache_entries = (const char*)trans_cache.get_entries();
+  state.trans_cache_mask    = trans_cache.get_index_mask();
+  state.trans_cache_epoch   = 0;
+  state.trans_chain_active  = 0;
   
   // Initialise decode caches
   //
   for (uint32 i = 0; i < NUM_OPERATING_MODES; ++i) {
-    dcode_caches[i].construct(sim_opts.dcode_cache_size);
+    dcode_caches[i].construct(sim_opts.dcode_cache_bytes);
   }
+  LOG(LOG_DEBUG) << "[CPU" << core_id << "] Decode caches hold "
+                 << dcode_caches[0].get_capacity() << " instructions in "
+                 << dcode_caches[0].get_bytes() << " bytes each.";
   // Currently active decode cache is kernel cache
   //
   dcode_cache = &(dcode_caches[KERNEL_MODE]);  
+  
+  // Initialise page granular decode caches
+  //
+  if (sim_opts.dcode_page) {
+    for (uint32 i = 0; i < NUM_OPERATING_MODES; ++i) {
+      dcode_page_caches[i].construct(core_arch.page_arch.byte_index_shift,
+                                     sim_opts.dcode_page_cache_bytes);
+    }
+    LOG(LOG_DEBUG) << "[CPU" << core_id << "] Page decode caches hold "
+                   << dcode_page_caches[0].get_pages() << " pages in "
+                   << dcode_page_caches[0].get_bytes() << " bytes each.";
+    dcode_page_cache = &(dcode_page_caches[KERNEL_MODE]);
+  }
 }
 
 Processor::~Processor ()
@@ -236,6 +276,7 @@ Processor::~Processor ()
   if (iway_pred){ delete iway_pred; iway_pred= 0; }
   if (dway_pred){ delete dway_pred; dway_pred= 0; }
   if (ccm_mgr_) { delete ccm_mgr_;                }
+  if (BT)       { delete BT;        BT       = 0; } // writes pending records
   
   // Destroy dynamically allocated PageCache data 
   page_cache.destroy();
@@ -327,6 +368,14 @@ Processor::reset_to_initial_state (bool purge_translations)
 #include "processor-step.cpp"
 #undef STEP_FAST
 
+// Include Processor::step_single_plain method
+//
+#define STEP_FAST
+#define STEP_PLAIN
+#include "processor-step.cpp"
+#undef STEP_PLAIN
+#undef STEP_FAST
+
 // -----------------------------------------------------------------------------
 // Processor state/register etc. initialisation
 //
@@ -366,6 +415,16 @@ Processor::init_cpu_state () {
   state.pc           = 0;
   state.next_pc      = 0;
   state.iterations   = 0;
+  
+  // Counters and caches used by translated code
+  //
+  state.native_inst_count       = cnt_ctx.native_inst_count.get_ptr();
+  state.interp_inst_count       = cnt_ctx.interp_inst_count.get_ptr();
+  state.dslot_inst_count        = cnt_ctx.dslot_inst_count.get_ptr();
+  state.region_transfer_count   = cnt_ctx.region_transfer_count.get_ptr();
+  state.region_guard_fail_count = cnt_ctx.region_guard_fail_count.get_ptr();
+  state.trans_cache_entries     = (const char*)trans_cache.get_entries();
+  state.trans_cache_mask        = trans_cache.get_index_mask();
 
   // Initialise ibuff_addr to be invalid
   //
@@ -396,6 +455,16 @@ Processor::init_cpu_state () {
   for (int i = 0; i < GPR_BASE_REGS; ++i) {
      state.xregs[i] = &(state.gprs[i]);
   }
+  
+  // Direct RAM access from translated code (see Memory::get_direct_perm())
+  //
+  if (system.ext_mem->is_direct_access_enabled(core_arch)) {
+    state.mem_direct_base = system.ext_mem->get_sparse_base();
+    state.mem_direct_perm = system.ext_mem->get_direct_perm();
+  } else {
+    state.mem_direct_base = 0;
+    state.mem_direct_perm = 0;
+  }
 }
 
 void
@@ -489,6 +558,10 @@ void Processor::simulation_end()
 void Processor::simulation_stopped()
 {
   stop_timers ();
+  
+  // Hand partially filled binary trace chunk to writer thread
+  //
+  if (BT) { BT->flush(); }
 }
 
 void Processor::timing_checkpoint ()
@@ -537,6 +610,29 @@ double Processor::cycle_sim_ipc () const
   return (cycl_count > 0 ) ? (inst_count/cycl_count) : 0;
 }
 
+// Counters sampled at the start and end of each detailed sampling phase
+//
+void
+Processor::get_sample_counters (SampleCounters& c)
+{
+  c.insts           = instructions();
+  c.cycles          = cnt_ctx.cycle_count.get_value();
+  c.icache_accesses = c.icache_misses = 0;
+  c.dcache_accesses = c.dcache_misses = 0;
+  
+  CacheModel* const icache = mem_model->icache_c;
+  CacheModel* const dcache = mem_model->dcache_c;
+  
+  if (icache && icache != dcache) { // unified caches are reported as data cache
+    c.icache_misses   = icache->get_read_misses();
+    c.icache_accesses = icache->get_read_hits() + c.icache_misses;
+  }
+  if (dcache) {
+    c.dcache_misses   = dcache->get_read_misses() + dcache->get_write_misses();
+    c.dcache_accesses = dcache->get_read_hits()   + dcache->get_write_hits() + c.dcache_misses;
+  }
+}
+
 
 // -----------------------------------------------------------------------------
 // Instruction decode logic
@@ -574,6 +670,10 @@ Processor::decode_instruction_using_cache (uint32                     pc,
   uint32                                ecause   = 0;
   arcsim::isa::arc::DcodeCache::HitType hit_type = arcsim::isa::arc::DcodeCache::kCacheMiss;
   
+  if (dcode_page_cache) {
+    return decode_instruction_using_page_cache(pc, dptr, efa, in_dslot);
+  }
+  
   // lookup which Dcode object we can use in decode cache and mark it as valid
   dptr = dcode_cache->lookup(pc, &hit_type);
   if (hit_type == arcsim::isa::arc::DcodeCache::kCacheMiss) {
@@ -588,6 +688,74 @@ Processor::decode_instruction_using_cache (uint32                     pc,
   return ecause;
 }
 
+// Fetch and Decode an instruction using the DcodePageCache:
+//  1. Lookup the decoded page holding the PC, on a miss install the page and
+//     pre-decode it in bulk
+//  2. If the pre-decode sweep did not reach the PC (e.g. it is the target of a
+//     branch into what the sweep took for LIMM data), or stopped early, the
+//     instruction is decoded on demand into a Dcode object from the page pool
+//
+uint32
+Processor::decode_instruction_using_page_cache (uint32                     pc,
+                                                arcsim::isa::arc::Dcode* & dptr,
+                                                uint32&                    efa,
+                                                bool                       in_dslot)
+{
+  arcsim::isa::arc::DcodePageCache::Page* page = dcode_page_cache->lookup(pc);
+  if (page == 0) {
+    page = dcode_page_cache->insert(pc);
+    predecode_page(page, pc);
+  }
+  
+  if ((dptr = dcode_page_cache->slot(page, pc))) {
+    return 0;
+  }
+  
+  // Decode on demand
+  dptr = dcode_page_cache->allocate(page);
+  
+  const uint32 ecause = fetch_and_decode(pc, *dptr, state, efa, in_dslot, true);
+  if (ecause) { // instr decode failed
+    dcode_page_cache->release(page, dptr);
+  } else {
+    dcode_page_cache->slot(page, pc) = dptr;
+  }
+  return ecause;
+}
+
+// Pre-decode page by a linear sweep from 'pc' to the end of the page. Fetches
+// have no side effects, the sweep simply stops at the first instruction that
+// can not be fetched. Only RAM pages are swept, reading a memory device mapped
+// page may have side effects on the device and raise memory error interrupts,
+// so instructions on those pages are decoded on demand.
+//
+void
+Processor::predecode_page (arcsim::isa::arc::DcodePageCache::Page* page, uint32 pc)
+{
+  const uint32 page_bits = dcode_page_cache->get_page_bits();
+  uint32       efa       = 0;
+  uint32       phys_addr;
+  
+  if (mmu.lookup_exec(pc & state.pc_mask, state.U, phys_addr)) { return; }
+  
+  arcsim::sys::mem::BlockData * const block = find_host_page(phys_addr);
+  if (block == 0 || !block->is_mem_ram()) { return; }
+  
+  for (uint32 addr = pc; (addr >> page_bits) == (pc >> page_bits); ) {
+    arcsim::isa::arc::Dcode*& slot = dcode_page_cache->slot(page, addr);
+    if (slot == 0) {
+      arcsim::isa::arc::Dcode* const d = dcode_page_cache->allocate(page);
+      if (fetch_and_decode(addr, *d, state, efa, false, false)) {
+        dcode_page_cache->release(page, d);
+        break;
+      }
+      slot = d;
+    }
+    if (slot->size == 0) { break; }
+    addr += slot->size;
+  }
+}
+
 // Fetch and decode an instruction
 //
 uint32
@@ -821,6 +989,7 @@ Processor::set_operating_mode (OperatingMode mode)
 {
   // Choose appropriate decode cache depending on operating mode
   dcode_cache = &(dcode_caches[mode]);
+  if (dcode_page_cache) { dcode_page_cache = &(dcode_page_caches[mode]); }
   if(sys_arch.isa_opts.stack_checking){
     //always check because we may have just changed the SC bit by returning form interrupt
     if(sys_arch.isa_opts.is_isa_a6kv2() && state.U != mode)
@@ -1087,8 +1256,8 @@ Processor::restart_from_halted ()
 
   // Clear the Status.H bit
   //
-  state.H                  = false;
-  sim_opts.halt_simulation = false;
+  state.H           = false;
+  set_halt_simulation(false);
 
   // Clear the Debug.BH and Debug.SH bits
   //
@@ -1100,8 +1269,8 @@ Processor::restart_from_halted ()
 void
 Processor::halt_cpu (bool set_self_halt)
 {  
-  state.H                  = true;
-  sim_opts.halt_simulation = true;
+  state.H           = true;
+  set_halt_simulation(true);
   
   // SH (i.e. self halt bit) indicates that the ARCompact based processor has
   // halted itself with the FLAG instruction.
@@ -1178,8 +1347,8 @@ Processor::break_inst ()
 {
   uint32 aux_debug;
   
-  state.H                           = sim_opts.exit_on_break;
-  sim_opts.halt_simulation          = sim_opts.exit_on_break;
+  state.H           = sim_opts.exit_on_break;
+  set_halt_simulation(sim_opts.exit_on_break);
   
   read_aux_register (AUX_DEBUG, &aux_debug, false);
   aux_debug |= 0x20000000; // set the DEBUG.SH bit
@@ -1187,7 +1356,7 @@ Processor::break_inst ()
   
   LOG(LOG_DEBUG4) << "[BRK] at " << HEX(state.pc)
                   << ", state.H = "         << (int)(state.H)
-                  << ", halt_simulation = " << (int)(sim_opts.halt_simulation);
+                  << ", halt_simulation = " << (int)(*halt_simulation_);
 }
 
 void
@@ -1203,7 +1372,7 @@ Processor::sleep_inst (uint32 int_enables)
 #ifdef VERIFICATION_OPTIONS
   if (!sys_arch.isa_opts.ignore_brk_sleep) {
 #endif
-    sim_opts.halt_simulation = sim_opts.exit_on_sleep;
+    set_halt_simulation(sim_opts.exit_on_sleep);
     read_aux_register (AUX_DEBUG, &aux_debug, false);
     aux_debug |= (1 << 23); // set the DEBUG.ZZ bit
     write_aux_register (AUX_DEBUG, aux_debug, false);
@@ -1322,6 +1491,21 @@ Processor::handle_pending_actions ()
     requires_action          = true;
     clear_pending_action(kPendingAction_IPT);
   }
+  
+  // ---------------------------------------------------------------------------
+  // 7. Tiered JIT compilation - baseline code became hot
+  //
+  if (pending_actions & kPendingAction_TIER_UP) {
+    clear_pending_action(kPendingAction_TIER_UP);
+    if (sim_opts.fast) { tier_up_translations(); }
+  }
+  
+  // ---------------------------------------------------------------------------
+  // 8. Another processor wrote to code that this processor may have cached
+  //
+  if (pending_actions & kPendingAction_REMOTE_INVALIDATION) {
+    handle_remote_invalidations();
+  }
 
   return requires_action;
 }
@@ -1332,6 +1516,18 @@ Processor::handle_pending_actions ()
 // stepping, single stepping with tracing etc.)
 //
 
+// step_single_plain() omits the per-instruction IPT, Actionpoint and EIA
+// checks of step_single_fast(), hence it may only be used if none of these
+// features are active.
+//
+bool
+Processor::is_plain_step_enabled ()
+{
+  return !ipt_mgr.is_enabled()
+      && !aps.enabled()
+      && !eia_mgr.any_eia_extensions_defined;
+}
+
 // Interpretive simulation mode without instruction tracing --------------------
 //
 bool
@@ -1339,52 +1535,75 @@ Processor::run_notrace (uint32 iterations)
 {
   bool stepOK = true;
   
+  // Decide once whether the specialised step_single_plain() can be used. This
+  // is re-evaluated whenever pending actions have been handled as they might
+  // have inserted IPTs.
+  bool plain_step = is_plain_step_enabled();
+  
+  // Code written by other processors since we last ran must not be executed
+  if (is_pending_action(kPendingAction_REMOTE_INVALIDATION))
+    handle_remote_invalidations();
+  
   exec_time.start(); // record simulation start time
 
   state.iterations = iterations; // initialise iteration count
 
-  if (inst_timer_enabled && !sim_opts.cycle_sim) { // INSTRUCTION TIMER MODE ---
+  if (!sim_opts.cycle_sim && (inst_timer_enabled || !events_.empty())) { // EVENT TIMING MODE
     uint32 iter_remaining = state.iterations;
-    uint64 prev_sync_time = timer_sync_time; // snapshot of current timer_sync_time
     
-    do { // } while (stepOK && !sim_opts.halt_simulation && iter_remaining);
-      // compute iterations and set 'state.timer_expiry'
-      state.iterations = arcsim::util::min(time_to_expiry(), iter_remaining);
+    do { // } while (stepOK && !*halt_simulation_ && iter_remaining);
+      // The next event deadline is only looked at once per slice, instructions
+      // up to that deadline are executed without consulting any timer state.
+      // Events scheduled for an earlier time while the slice is running cut it
+      // short by resetting 'state.iterations' (see update_event_deadline()).
+      const uint64 slice_start = instructions();
+      const uint64 slice       = (state.timer_expiry > slice_start)
+                                 ? (state.timer_expiry - slice_start) : 0;
+      state.iterations = static_cast<uint32>(arcsim::util::min<uint64>(slice, iter_remaining));
       
-      do { // } while (stepOK && !sim_opts.halt_simulation && state.iterations);
-        stepOK = step_single_fast(); // perform single step
+      while (stepOK && !*halt_simulation_ && state.iterations) {
+        stepOK = plain_step ? step_single_plain() : step_single_fast();
                 
-        if (has_pending_actions() && handle_pending_actions())
-          sim_opts.halt_simulation = 1; // flag that we need to stop when we get here
+        if (has_pending_actions()) {
+          if (handle_pending_actions())
+            set_halt_simulation(true); // flag that we need to stop when we get here
+          plain_step = is_plain_step_enabled();
+        }
 
         --state.iterations; // decrement executed iteration count
-      } while (stepOK && !sim_opts.halt_simulation && state.iterations);
-      
-      timer_sync(); // sync timers and possibly trigger timer interrupt
+      }
       
       // compute remaining iterations
-      ASSERT(timer_sync_time >= prev_sync_time);
-      const uint32 iter_elapsed = timer_sync_time - prev_sync_time;
+      const uint64 iter_elapsed = instructions() - slice_start;
       if (iter_remaining > iter_elapsed) { iter_remaining -= iter_elapsed; }
       else                               { iter_remaining  = 0;            }
-      prev_sync_time = timer_sync_time; // snapshot of current timer_sync_time
       
-      // check to see if advancement of timer resulted in an interrupt
-      if (has_pending_actions() && handle_pending_actions())
-        sim_opts.halt_simulation = 1; // flag that we need to stop when we get here
+      // sync timers and run due events, possibly triggering interrupts
+      if (instructions() >= state.timer_expiry)
+        timer_sync();
+      
+      // check to see if any event resulted in an interrupt
+      if (has_pending_actions()) {
+        if (handle_pending_actions())
+          set_halt_simulation(true); // flag that we need to stop when we get here
+        plain_step = is_plain_step_enabled();
+      }
 
-    } while (stepOK && !sim_opts.halt_simulation && iter_remaining);
+    } while (stepOK && !*halt_simulation_ && iter_remaining);
     
   } else {                                        // CYCLE/HOST TIMER MODE -----
-    do { // } while (stepOK && !sim_opts.halt_simulation && state.iterations);
-      stepOK = step_single_fast(); // perform single step
+    do { // } while (stepOK && !*halt_simulation_ && state.iterations);
+      stepOK = plain_step ? step_single_plain() : step_single_fast();
       
-      if (has_pending_actions() && handle_pending_actions()) {
-        // FIXME: do we need to call timer_advance_cycles() here?
-        sim_opts.halt_simulation = 1; // flag that we need to stop when we get here
+      if (has_pending_actions()) {
+        if (handle_pending_actions()) {
+          // FIXME: do we need to call timer_advance_cycles() here?
+          set_halt_simulation(true); // flag that we need to stop when we get here
+        }
+        plain_step = is_plain_step_enabled();
       }
       --state.iterations; // decrement executed iteration count
-    } while (stepOK && !sim_opts.halt_simulation && state.iterations);    
+    } while (stepOK && !*halt_simulation_ && state.iterations);    
   }
   
   exec_time.stop(); // record and update simulation end time
@@ -1402,54 +1621,60 @@ Processor::run_trace (uint32 iterations, UpdatePacket* upkt)
   if (upkt == NULL) // no UpdatePacket specified, use dummy
     upkt = &dummy;
 
+  // Code written by other processors since we last ran must not be executed
+  if (is_pending_action(kPendingAction_REMOTE_INVALIDATION))
+    handle_remote_invalidations();
+
   state.iterations = iterations; // initialise iteration count
   exec_time.start(); // record simulation start time
 
-  if (inst_timer_enabled && !sim_opts.cycle_sim) { // INSTRUCTION TIMER MODE ---
+  if (!sim_opts.cycle_sim && (inst_timer_enabled || !events_.empty())) { // EVENT TIMING MODE
     uint32 iter_remaining = state.iterations;
-    uint64 prev_sync_time = timer_sync_time; // snapshot of current timer_sync_time
     
-    do { // } while (stepOK && !sim_opts.halt_simulation && iter_remaining);
-      // compute iterations and set 'state.timer_expiry'
-      state.iterations = arcsim::util::min(time_to_expiry(), iter_remaining);
+    do { // } while (stepOK && !*halt_simulation_ && iter_remaining);
+      // run up to the next event deadline (see run_notrace())
+      const uint64 slice_start = instructions();
+      const uint64 slice       = (state.timer_expiry > slice_start)
+                                 ? (state.timer_expiry - slice_start) : 0;
+      state.iterations = static_cast<uint32>(arcsim::util::min<uint64>(slice, iter_remaining));
       
-      do { // } while (stepOK && !sim_opts.halt_simulation && state.iterations);
+      while (stepOK && !*halt_simulation_ && state.iterations) {
         stepOK = step_single(upkt, false); // perform single step
         TRACE_INST(this, trace_emit()); // trace instruction
         
         if (has_pending_actions() && handle_pending_actions())
-          sim_opts.halt_simulation = 1; // flag that we need to stop when we get here
+          set_halt_simulation(true); // flag that we need to stop when we get here
 
         --state.iterations; // decrement executed iteration count
-      } while (stepOK && !sim_opts.halt_simulation && state.iterations);
-      
-      timer_sync(); // sync timers and possibly trigger timer interrupt
+      }
       
       // compute remaining iterations
-      ASSERT(timer_sync_time >= prev_sync_time);
-      const uint32 iter_elapsed = timer_sync_time - prev_sync_time;
+      const uint64 iter_elapsed = instructions() - slice_start;
       if (iter_remaining > iter_elapsed) { iter_remaining -= iter_elapsed; }
       else                               { iter_remaining  = 0;            }
-      prev_sync_time = timer_sync_time; // snapshot of current timer_sync_time
       
-      // check to see if advancement of timer resulted in an interrupt
+      // sync timers and run due events, possibly triggering interrupts
+      if (instructions() >= state.timer_expiry)
+        timer_sync();
+      
+      // check to see if any event resulted in an interrupt
       if (has_pending_actions() && handle_pending_actions())
-        sim_opts.halt_simulation = 1; // flag that we need to stop when we get here
+        set_halt_simulation(true); // flag that we need to stop when we get here
       
-    } while (stepOK && !sim_opts.halt_simulation && iter_remaining);
+    } while (stepOK && !*halt_simulation_ && iter_remaining);
       
   } else {                                        // CYCLE/HOST TIMER MODE -----
     
-    do { // } while (stepOK && !sim_opts.halt_simulation && state.iterations);
+    do { // } while (stepOK && !*halt_simulation_ && state.iterations);
       stepOK = step_single(upkt, false); // perform single step
       TRACE_INST(this, trace_emit());
       
       if (has_pending_actions() && handle_pending_actions()) {
         // FIXME: do we need to call timer_advance_cycles() here?
-        sim_opts.halt_simulation = 1; // flag that we need to stop when we get here
+        set_halt_simulation(true); // flag that we need to stop when we get here
       }
       --state.iterations; // decrement executed iteration count
-    } while(stepOK && !sim_opts.halt_simulation && state.iterations);
+    } while(stepOK && !*halt_simulation_ && state.iterations);
     
   }
   
@@ -1457,23 +1682,35 @@ Processor::run_trace (uint32 iterations, UpdatePacket* upkt)
   return stepOK;
 }
 
+// JIT compiled or sampled simulation mode -------------------------------------
+//
+bool
+Processor::run (uint32 iterations)
+{
+  return sampler_.is_enabled() ? run_sampled(iterations) : run_jit(iterations);
+}
+
 // JIT compiled simulation mode ------------------------------------------------
 //
 // For correct termination on a Halt condition, any basic block that sets state.H
 // must not be translated.
 //
 bool
-Processor::run (uint32 iterations)
+Processor::run_jit (uint32 iterations)
 {
   ASSERT(sim_opts.cosim == false);
 
   bool              stepOK       = true;
   TranslationBlock  native_block = 0;
   
+  // Code written by other processors since we last ran must not be executed
+  if (is_pending_action(kPendingAction_REMOTE_INVALIDATION))
+    handle_remote_invalidations();
+  
   state.iterations = iterations; // initialise iteration count
   exec_time.start(); // record simulation start time
 
-  do { // } while (stepOK && !sim_opts.halt_simulation && state.iterations);
+  do { // } while (stepOK && !*halt_simulation_ && state.iterations);
     // -------------------------------------------------------------------------
     // 1. Execute native translation if lookup in translation cache is successful,
     //    otherwise we need to record traced basic block.
@@ -1509,19 +1746,98 @@ Processor::run (uint32 iterations)
     // 2. After execution/tracing we need to check for any pending actions or
     //    timer expiry.
     //
-    if (inst_timer_enabled && !sim_opts.cycle_sim) {
-      if (instructions() >= state.timer_expiry)
-        timer_sync(); // sync timers and possibly trigger timer interrupt
+    if (!sim_opts.cycle_sim && instructions() >= state.timer_expiry) {
+      timer_sync(); // sync timers, run due events and possibly trigger interrupts
     }
     if (has_pending_actions() && handle_pending_actions())
-      sim_opts.halt_simulation = 1; // flag that we need to stop when we get here
+      set_halt_simulation(true); // flag that we need to stop when we get here
 
-  } while (stepOK && !sim_opts.halt_simulation && state.iterations);
+  } while (stepOK && !*halt_simulation_ && state.iterations);
   
   exec_time.stop(); // record and update simulation end time
   return stepOK;
 }
 
+// Sampled simulation mode -----------------------------------------------------
+//
+// Fast-forward phases execute translated code that does not update the memory
+// model, warm-up and detail phases are interpreted with the memory model and
+// pipeline enabled (see SampleManager). 'iterations' bounds the number of blocks
+// executed while fast-forwarding and the number of interpreted instructions.
+//
+bool
+Processor::run_sampled (uint32 iterations)
+{
+  // Blocks executed per instruction left in a fast-forward phase. Blocks hold
+  // several instructions, hence slices shrink as the phase end is approached.
+  //
+  static const uint64 kSampleBlockSize = 4;
+  
+  bool   stepOK = true;
+  uint32 budget = iterations;
+  
+  if (!sampler_.is_started()) { sampler_.begin(instructions()); }
+  
+  while (stepOK && !*halt_simulation_ && budget) {
+    const uint64 now = instructions();
+    
+    // -------------------------------------------------------------------------
+    // 1. Move on to next phase once the current one is complete, recording a
+    //    sample at the end of each detailed phase
+    //
+    if (now >= sampler_.get_phase_end()) {
+      if (sampler_.get_phase() == SampleManager::kPhaseDetail) {
+        SampleCounters sample_end;
+        get_sample_counters(sample_end);
+        sampler_.add_sample(sample_start_, sample_end);
+      }
+      if (sampler_.next_phase(now) == SampleManager::kPhaseDetail) {
+        get_sample_counters(sample_start_);
+      }
+      continue;
+    }
+    
+    const uint64 remaining = sampler_.get_phase_end() - now;
+    
+    if (sampler_.is_fast_forwarding()) {
+      // -----------------------------------------------------------------------
+      // 2. FAST-FORWARD - functional JIT simulation
+      //
+      const uint32 blocks = static_cast<uint32>(
+        arcsim::util::max<uint64>(1, arcsim::util::min<uint64>(budget, remaining / kSampleBlockSize)));
+      
+      stepOK  = run_jit(blocks);
+      budget -= arcsim::util::min<uint32>(budget, arcsim::util::max<uint32>(1, blocks - state.iterations));
+      
+#ifdef CYCLE_ACC_SIM
+      // The pipeline does not advance time while fast-forwarding, hence cycles
+      // are estimated from the CPI measured so far and timers are serviced at
+      // the end of each slice
+      //
+      if (sim_opts.cycle_sim) {
+        const uint64 insts = instructions() - now;
+        cnt_ctx.cycle_count.set_value(cnt_ctx.cycle_count.get_value()
+                                      + static_cast<uint64>(insts * sampler_.get_estimated_cpi()));
+        if (cnt_ctx.cycle_count.get_value() >= state.timer_expiry) {
+          timer_sync();
+        }
+        if (has_pending_actions() && handle_pending_actions())
+          set_halt_simulation(true); // flag that we need to stop when we get here
+      }
+#endif
+    } else {
+      // -----------------------------------------------------------------------
+      // 3. WARM-UP/DETAIL - interpretive simulation updating the memory model
+      //
+      const uint32 insts = static_cast<uint32>(arcsim::util::min<uint64>(budget, remaining));
+      
+      stepOK  = (sim_opts.trace_on) ? run_trace(insts) : run_notrace(insts);
+      budget -= insts;
+    }
+  }
+  return stepOK;
+}
+
 // This method is called if a translation cache miss occurs. If a translation
 // cache miss occurs we try to find the block in our PhysicalProfile. If a
 // translation already exists for that block we execute the translation,
@@ -1599,22 +1915,26 @@ Processor::step_block ()
       
       // FIXME: avoid creation of new BlockEntries for IPT pending actions
       if (has_pending_actions() && handle_pending_actions())
-        sim_opts.halt_simulation = 1; // flag that we need to stop when we get here
+        set_halt_simulation(true); // flag that we need to stop when we get here
 
-    } while (!end_of_block && stepOK && !sim_opts.halt_simulation);
+    } while (!end_of_block && stepOK && !*halt_simulation_);
   } else {                                      // TRACE MODE OFF
+    bool plain_step = is_plain_step_enabled();
     do {
-      stepOK = step_single_fast();
+      stepOK = plain_step ? step_single_plain() : step_single_fast();
       
       // exceptions (e.g. (I|D)TLB miss) change control flow, hence we 'break'
       if (state.raise_exception) 
         break;
       
       // FIXME: avoid creation of new BlockEntries for IPT pending actions
-      if (has_pending_actions() && handle_pending_actions())
-        sim_opts.halt_simulation = 1; // flag that we need to stop when we get here
+      if (has_pending_actions()) {
+        if (handle_pending_actions())
+          set_halt_simulation(true); // flag that we need to stop when we get here
+        plain_step = is_plain_step_enabled();
+      }
 
-    } while (!end_of_block && stepOK && !sim_opts.halt_simulation);
+    } while (!end_of_block && stepOK && !*halt_simulation_);
   }
   
   // Trace block if it is not translated or in translation
@@ -1672,6 +1992,11 @@ Processor::dispatch_hot_traces()
   if (sim_opts.debug)
     timing_restart();
     
+  // Install optimised translations finished by translation workers, and drop
+  // those that failed to compile
+  if (sim_opts.fast_tier_up_threshold && phys_profile_.install_optimised_translations())
+    purge_translation_cache();
+  
   // Remove traces collected during this interval
   phys_profile_.remove_traces();
   // Reset all active trace sequences, we start from scratch for next interval
@@ -1682,6 +2007,29 @@ Processor::dispatch_hot_traces()
   return work_size;
 }
 
+// ---------------------------------------------------------------------------
+// Tiered JIT compilation. Installing optimised translations frees baseline code,
+// so this method must not be called while executing native code.
+//
+int
+Processor::tier_up_translations()
+{
+  ASSERT(cur_exec_mode != kExecModeNative);
+  
+  // Install optimised translations that finished compilation
+  if (phys_profile_.install_optimised_translations() > 0)
+    purge_translation_cache();
+  
+  // Recompile baseline translations that became hot
+  std::valarray<TranslationWorkUnit*>  work_units(phys_profile_.pages_count());
+  int work_size = phys_profile_.analyse_tier_up_hotspots(*this,
+                                                         work_units,
+                                                         sim_opts.fast_tier_up_threshold);
+  if (work_size > 0)
+    system.trans_mgr.dispatch_translation_work_units(work_size, work_units);
+  
+  return work_size;
+}
       
 // -----------------------------------------------------------------------------
 // Simple debugging support
@@ -1969,10 +2317,55 @@ Processor::dexcl_emulation(uint32 op, uint32 *dst, uint32 src1, uint32 src2)
 // -----------------------------------------------------------------------------
 // Tracing related code
 //
+// Each trace_*() method either appends a compact record to the binary trace
+// (BT) or formats its textual representation into IS right away. The textual
+// formatting is done by the trace_fmt_*() methods, which are also used by
+// trace_render() to turn binary trace records into the very same text.
+//
+
+// Flags encoded with each traced instruction
+//
+static const uint32 kTraceFlagL       = 0x001;
+static const uint32 kTraceFlagU       = 0x002;
+static const uint32 kTraceFlagES      = 0x004;
+static const uint32 kTraceFlagD       = 0x008;
+static const uint32 kTraceFlagZ       = 0x010;
+static const uint32 kTraceFlagN       = 0x020;
+static const uint32 kTraceFlagC       = 0x040;
+static const uint32 kTraceFlagV       = 0x080;
+static const uint32 kTraceFlagMacSat  = 0x100; // MACMODE 's' (0x200)
+static const uint32 kTraceFlagMacSatS = 0x200; // MACMODE 'S' (0x010)
+static const uint32 kTraceFlagSC      = 0x400;
+static const uint32 kTraceFlagSymPc   = 0x800; // symbol lookup PC differs from PC
+
+// Flags encoded with each emitted instruction
+//
+static const uint8  kTraceEmitNative  = 0x1;
+static const uint8  kTraceEmitCycles  = 0x2;
+
+// Registers shown when an exception is traced
+//
+enum TraceExceptionReg {
+  kTraceExcECR = 0, kTraceExcERET,      kTraceExcERSTATUS,  kTraceExcBTA,
+  kTraceExcEFA,     kTraceExcPC,        kTraceExcSTATUS32,
+  // Only if stack checking is enabled
+  kTraceExcKStackBase, kTraceExcKStackTop, kTraceExcUStackBase, kTraceExcUStackTop,
+  kTraceExcSP,      kTraceExcUserSP,
+  kTraceExcRegCount
+};
+static const uint32 kTraceExcRegCountNoSC = kTraceExcKStackBase;
+
+#define SHOW_SC   1 /* 1 => show SC flag in instruction trace */
 
 void
 Processor::trace_string (const char* str)
 {
+  if (BT) {
+    BT->put_u8(arcsim::util::BinaryTrace::kRecString);
+    BT->put_string(str, strlen(str));
+    BT->end_record();
+    return;
+  }
   IS.write(str, strlen(str));
 }
 
@@ -1980,26 +2373,48 @@ Processor::trace_string (const char* str)
 //
 void
 Processor::trace_emit()
+{
+  bool   has_cycles = false;
+  uint64 cycles     = 0;
+#ifdef CYCLE_ACC_SIM
+  // print commit time of instruction first for cycle accurate mode
+  if (sim_opts.cycle_sim) {
+    has_cycles = true;
+    cycles     = cnt_ctx.cycle_count.get_value();
+  }
+#endif
+  
+  if (BT) {
+    BT->put_u8(arcsim::util::BinaryTrace::kRecEmit);
+    BT->put_u8(  ((cur_exec_mode == kExecModeNative) ? kTraceEmitNative : 0)
+               | (has_cycles ? kTraceEmitCycles : 0));
+    if (has_cycles) { BT->put_varint(cycles); }
+    BT->end_record();
+    return;
+  }
+  trace_fmt_emit(cur_exec_mode == kExecModeNative, has_cycles, cycles);
+}
+
+void
+Processor::trace_fmt_emit(bool native, bool has_cycles, uint64 cycles)
 {
 #ifdef DEBUG_INST_TRACE_EXEC_MODE
   // indicate if instruction was executed in native or interpretive mode
   static const char kInterpretiveExecToken[] = "[I]";
   static const char kNativeExecToken[]       = "[N]";
   
-  if (cur_exec_mode == kExecModeNative)
+  if (native)
     TS.write(kNativeExecToken,       sizeof(kNativeExecToken)-1);
   else
     TS.write(kInterpretiveExecToken, sizeof(kInterpretiveExecToken)-1);
 #endif
   
-#ifdef CYCLE_ACC_SIM
   // print commit time of instruction first for cycle accurate mode
-  if (sim_opts.cycle_sim) {
+  if (has_cycles) {
     std::stringstream S;
-    S << std::left << std::setw(11) << cnt_ctx.cycle_count.get_value();
+    S << std::left << std::setw(11) << cycles;
     TS.write(S);
   }
-#endif
   
   // Inject IS (InstructionTrace) into TS (TraceStream)
   //
@@ -2018,6 +2433,36 @@ Processor::trace_emit()
 //
 void
 Processor::trace_instruction (uint32 trace_pc, uint32 instr, uint32 limm)
+{
+  uint32 flags = (state.L  ? kTraceFlagL  : 0)
+               | (state.U  ? kTraceFlagU  : 0)
+               | (state.ES ? kTraceFlagES : 0)
+               | (state.D  ? kTraceFlagD  : 0)
+               | (state.Z  ? kTraceFlagZ  : 0)
+               | (state.N  ? kTraceFlagN  : 0)
+               | (state.C  ? kTraceFlagC  : 0)
+               | (state.V  ? kTraceFlagV  : 0)
+               | ((state.auxs[AUX_MACMODE] & 0x200) ? kTraceFlagMacSat  : 0)
+               | ((state.auxs[AUX_MACMODE] & 0x010) ? kTraceFlagMacSatS : 0)
+               | (state.SC ? kTraceFlagSC : 0)
+               | ((state.pc != trace_pc) ? kTraceFlagSymPc : 0);
+  
+  if (BT) {
+    BT->put_u8(arcsim::util::BinaryTrace::kRecInstruction);
+    BT->put_pc(trace_pc);
+    BT->put_varint(instr);
+    BT->put_varint(limm);
+    BT->put_varint(flags);
+    if (flags & kTraceFlagSymPc) { BT->put_varint(state.pc); }
+    BT->end_record();
+    return;
+  }
+  trace_fmt_instruction(trace_pc, instr, limm, flags, state.pc);
+}
+
+void
+Processor::trace_fmt_instruction (uint32 trace_pc, uint32 instr, uint32 limm,
+                                  uint32 flags,    uint32 sym_pc)
 {
   // Disassemble instruction
   arcsim::isa::arc::Disasm dis (sys_arch.isa_opts, eia_mgr, instr, limm);
@@ -2025,7 +2470,7 @@ Processor::trace_instruction (uint32 trace_pc, uint32 instr, uint32 limm)
   static const uint32 kSymDisplayLength = 14;
   
   std::string fun_name;
-  bool has_sym = system.get_symbol(state.pc, fun_name);
+  bool has_sym = system.get_symbol(sym_pc, fun_name);
   IS << std::setw(kSymDisplayLength) << std::setfill(' ') << std::left
      << ((has_sym) ? fun_name.substr(0, kSymDisplayLength) : " ") // function name
      << std::right;
@@ -2050,28 +2495,27 @@ Processor::trace_instruction (uint32 trace_pc, uint32 instr, uint32 limm)
   // Output flags
   //
   
-#define SHOW_SC   1 /* 1 => show SC flag in instruction trace */
 #if SHOW_SC
      if(sys_arch.isa_opts.stack_checking)
-       IS<< ( (state.SC!=0)? " SC " : "    ");
+       IS<< ( (flags & kTraceFlagSC) ? " SC " : "    ");
 #endif
 
   
-  IS << (state.L ? 'L' : ' ')
-     << (state.U ? 'U' : 'K')
-     << (state.ES? 'E' : ' ')
-     << (state.D ? 'D' : ' ')
-     << (state.Z ? 'Z' : ' ')
-     << (state.N ? 'N' : ' ')
-     << (state.C ? 'C' : ' ')
-     << (state.V ? 'V' : ' ')
+  IS << ((flags & kTraceFlagL)  ? 'L' : ' ')
+     << ((flags & kTraceFlagU)  ? 'U' : 'K')
+     << ((flags & kTraceFlagES) ? 'E' : ' ')
+     << ((flags & kTraceFlagD)  ? 'D' : ' ')
+     << ((flags & kTraceFlagZ)  ? 'Z' : ' ')
+     << ((flags & kTraceFlagN)  ? 'N' : ' ')
+     << ((flags & kTraceFlagC)  ? 'C' : ' ')
+     << ((flags & kTraceFlagV)  ? 'V' : ' ')
 #define SHOW_E1E2   0 /* 1 => show E2/E1 flags in instruction trace */
 #if SHOW_E1E2
      << ( (state.E2)  ? (state.E1 ? "Eb" : "E2") : (state.E1 ? "E1" : "  ") )
 #endif
 #undef SHOW_E1E2
-     << ( (state.auxs[AUX_MACMODE]&0x200) ? 's' : ' ')
-     << ( (state.auxs[AUX_MACMODE]&0x010) ? 'S' : ' ');
+     << ( (flags & kTraceFlagMacSat)  ? 's' : ' ')
+     << ( (flags & kTraceFlagMacSatS) ? 'S' : ' ');
 
   // Add disassembly of instruction to IS
   //
@@ -2084,14 +2528,42 @@ void
 Processor::trace_write_back (int wa0, bool wenb0, uint32 *wdata0,
                              int wa1, bool wenb1, uint32 *wdata1)
 {
+  if (BT) {
+    if (wenb0 || wenb1) {
+      BT->put_u8(arcsim::util::BinaryTrace::kRecWriteBack);
+      BT->put_u8((wenb0 ? 0x1 : 0) | (wenb1 ? 0x2 : 0));
+      if (wenb0) { BT->put_varint(wa0); BT->put_varint(*wdata0); }
+      if (wenb1) { BT->put_varint(wa1); BT->put_varint(*wdata1); }
+      BT->end_record();
+    }
+    return;
+  }
   if (wenb0)
-    IS << " : (w0) r" << std::dec << wa0 << " <= 0x" << HEX(*wdata0);
+    trace_fmt_write_back("w0", wa0, *wdata0);
   if (wenb1)
-    IS << " : (w1) r" << std::dec << wa1 << " <= 0x" << HEX(*wdata1);
+    trace_fmt_write_back("w1", wa1, *wdata1);
+}
+
+void
+Processor::trace_fmt_write_back (const char* port, int wa, uint32 wdata)
+{
+  IS << " : (" << port << ") r" << std::dec << wa << " <= 0x" << HEX(wdata);
 }
 
 void
 Processor::trace_commit (bool is_commit)
+{
+  if (BT) {
+    BT->put_u8(arcsim::util::BinaryTrace::kRecCommit);
+    BT->put_u8(is_commit);
+    BT->end_record();
+    return;
+  }
+  trace_fmt_commit(is_commit);
+}
+
+void
+Processor::trace_fmt_commit (bool is_commit)
 {
   static const char kCommitToken[]   = " *\n";
   static const char kNoCommitToken[] = "\n";  
@@ -2104,6 +2576,36 @@ Processor::trace_commit (bool is_commit)
       
 void
 Processor::trace_exception (const char* message)
+{
+  uint32 regs[kTraceExcRegCount];
+  regs[kTraceExcECR]       = state.auxs[AUX_ECR];
+  regs[kTraceExcERET]      = state.auxs[AUX_ERET];
+  regs[kTraceExcERSTATUS]  = state.auxs[AUX_ERSTATUS];
+  regs[kTraceExcBTA]       = state.auxs[AUX_BTA];
+  regs[kTraceExcEFA]       = state.auxs[AUX_EFA];
+  regs[kTraceExcPC]        = state.pc;
+  regs[kTraceExcSTATUS32]  = BUILD_STATUS32(state);
+  regs[kTraceExcKStackBase]= (state.U) ? state.shadow_stack_base : state.stack_base;
+  regs[kTraceExcKStackTop] = (state.U) ? state.shadow_stack_top  : state.stack_top;
+  regs[kTraceExcUStackBase]= (state.U) ? state.stack_base : state.shadow_stack_base;
+  regs[kTraceExcUStackTop] = (state.U) ? state.stack_top  : state.shadow_stack_top;
+  regs[kTraceExcSP]        = state.gprs[SP_REG];
+  regs[kTraceExcUserSP]    = state.auxs[AUX_USER_SP];
+  
+  if (BT) {
+    const uint32 count = (sys_arch.isa_opts.stack_checking) ? kTraceExcRegCount
+                                                            : kTraceExcRegCountNoSC;
+    BT->put_u8(arcsim::util::BinaryTrace::kRecException);
+    BT->put_string((message != 0) ? message : " ", (message != 0) ? strlen(message) : 1);
+    for (uint32 i = 0; i < count; ++i) { BT->put_varint(regs[i]); }
+    BT->end_record();
+    return;
+  }
+  trace_fmt_exception(message, regs);
+}
+
+void
+Processor::trace_fmt_exception (const char* message, const uint32* regs)
 {
 #ifdef VERIFICATION_OPTIONS
   // for verification we expect the exception message on the same line as the instruction
@@ -2112,99 +2614,169 @@ Processor::trace_exception (const char* message)
   static const char kExceptionMessage[] = "\n EXCEPTION RAISED: ";
 #endif
   
-  uint32 aux_status32  = BUILD_STATUS32(state);
-
   IS << kExceptionMessage
      << ( (message != 0) ? message : " " )
-     << "\n\tECR      <= 0x"  << HEX(state.auxs[AUX_ECR])
-     << "\n\tERET     <= 0x"  << HEX(state.auxs[AUX_ERET])
-     << "\n\tERSTATUS <= 0x"  << HEX(state.auxs[AUX_ERSTATUS])
-     << "\n\tBTA      <= 0x"  << HEX(state.auxs[AUX_BTA])
-     << "\n\tEFA      <= 0x"  << HEX(state.auxs[AUX_EFA])
-     << "\n\tPC       <= 0x"  << HEX(state.pc)
-     << "\n\tSTATUS32 <= 0x"  << HEX(aux_status32);
+     << "\n\tECR      <= 0x"  << HEX(regs[kTraceExcECR])
+     << "\n\tERET     <= 0x"  << HEX(regs[kTraceExcERET])
+     << "\n\tERSTATUS <= 0x"  << HEX(regs[kTraceExcERSTATUS])
+     << "\n\tBTA      <= 0x"  << HEX(regs[kTraceExcBTA])
+     << "\n\tEFA      <= 0x"  << HEX(regs[kTraceExcEFA])
+     << "\n\tPC       <= 0x"  << HEX(regs[kTraceExcPC])
+     << "\n\tSTATUS32 <= 0x"  << HEX(regs[kTraceExcSTATUS32]);
 #if SHOW_SC
   if(sys_arch.isa_opts.stack_checking){
-    IS << "\n\tKStackBase= 0x"  << HEX(((state.U)?state.shadow_stack_base : state.stack_base))
-       << "\n\tKStackTop = 0x"  << HEX(((state.U)?state.shadow_stack_top : state.stack_top))
-       << "\n\tUStackBase= 0x"  << HEX(((state.U)?state.stack_base : state.shadow_stack_base))
-       << "\n\tUStackTop = 0x"  << HEX(((state.U)?state.stack_top : state.shadow_stack_top))
-       << "\n\tSP        = 0x"  << HEX((state.gprs[SP_REG]));
+    IS << "\n\tKStackBase= 0x"  << HEX(regs[kTraceExcKStackBase])
+       << "\n\tKStackTop = 0x"  << HEX(regs[kTraceExcKStackTop])
+       << "\n\tUStackBase= 0x"  << HEX(regs[kTraceExcUStackBase])
+       << "\n\tUStackTop = 0x"  << HEX(regs[kTraceExcUStackTop])
+       << "\n\tSP        = 0x"  << HEX(regs[kTraceExcSP]);
        if(sys_arch.isa_opts.new_interrupts)
-         IS << "\n\tUserSP    = 0x" << HEX(state.auxs[AUX_USER_SP]);
+         IS << "\n\tUserSP    = 0x" << HEX(regs[kTraceExcUserSP]);
   } 
 #endif
   IS << std::endl;
 }
 #undef SHOW_SC
+
 void
 Processor::trace_mul64_inst()
+{
+  if (BT) {
+    BT->put_u8(arcsim::util::BinaryTrace::kRecMul64);
+    BT->put_varint(state.gprs[MLO_REG]);
+    BT->put_varint(state.gprs[MMID_REG]);
+    BT->put_varint(state.gprs[MHI_REG]);
+    BT->end_record();
+    return;
+  }
+  trace_fmt_mul64_inst(state.gprs[MLO_REG], state.gprs[MMID_REG], state.gprs[MHI_REG]);
+}
+
+void
+Processor::trace_fmt_mul64_inst(uint32 mlo, uint32 mmid, uint32 mhi)
 {
   IS << ": (MLO) r"  << std::dec << MLO_REG
-     << " <= 0x"     << HEX(state.gprs[MLO_REG])
+     << " <= 0x"     << HEX(mlo)
      << ", (MMID) r" << std::dec << MMID_REG 
-     << " <= 0x"      << HEX(state.gprs[MMID_REG])
+     << " <= 0x"      << HEX(mmid)
      << ", (MHI) r"  << std::dec << MHI_REG 
-     << " <= 0x"     << HEX(state.gprs[MHI_REG]);
+     << " <= 0x"     << HEX(mhi);
 }
       
 void
 Processor::trace_loop_back ()
 {
-  IS << ": LP -> 0x" << HEX(state.pc);
+  if (BT) {
+    BT->put_u8(arcsim::util::BinaryTrace::kRecLoopBack);
+    BT->put_varint(state.pc);
+    BT->end_record();
+    return;
+  }
+  trace_fmt_loop_back(state.pc);
+}
+
+void
+Processor::trace_fmt_loop_back (uint32 pc)
+{
+  IS << ": LP -> 0x" << HEX(pc);
 }
 
 void
 Processor::trace_loop_count ()
 {
-  IS << ": LP_COUNT <= " << state.gprs[LP_COUNT];
+  if (BT) {
+    BT->put_u8(arcsim::util::BinaryTrace::kRecLoopCount);
+    BT->put_varint(state.gprs[LP_COUNT]);
+    BT->end_record();
+    return;
+  }
+  trace_fmt_loop_count(state.gprs[LP_COUNT]);
+}
+
+void
+Processor::trace_fmt_loop_count (uint32 count)
+{
+  IS << ": LP_COUNT <= " << count;
 }
 
 void
 Processor::trace_loop_inst (int taken, uint32 target)
+{
+  if (BT) {
+    BT->put_u8(arcsim::util::BinaryTrace::kRecLoopInst);
+    BT->put_u8(taken != 0);
+    if (taken) {
+      BT->put_varint(target);
+    } else {
+      BT->put_varint(state.auxs[AUX_LP_START]);
+      BT->put_varint(state.auxs[AUX_LP_END]);
+      BT->put_varint(state.gprs[LP_COUNT]);
+    }
+    BT->end_record();
+    return;
+  }
+  trace_fmt_loop_inst(taken, target, state.auxs[AUX_LP_START],
+                      state.auxs[AUX_LP_END], state.gprs[LP_COUNT]);
+}
+
+void
+Processor::trace_fmt_loop_inst (int taken, uint32 target,
+                                uint32 lp_start, uint32 lp_end, uint32 lp_count)
 {
   if (taken) {
     IS << ": jumped over loop to " << HEX(target);
   } else {
-    IS << ": LP_START <= " << HEX(state.auxs[AUX_LP_START])
-       << ", LP_END <= "   << HEX(state.auxs[AUX_LP_END])
-       << ", LP_COUNT = "  << std::dec << state.gprs[LP_COUNT];
+    IS << ": LP_START <= " << HEX(lp_start)
+       << ", LP_END <= "   << HEX(lp_end)
+       << ", LP_COUNT = "  << std::dec << lp_count;
   }
 }
       
 void
 Processor::trace_load (int fmt, uint32 addr, uint32 data)
 {
-  char  buf[BUFSIZ];
-  int   len;
-
   addr = addr & state.addr_mask;
   
-  switch (fmt) {
-    case T_FORMAT_LW:  len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint32)data); break;
-    case T_FORMAT_LH:  len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint16)data); break;
-    case T_FORMAT_LB:  len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint8)data);  break;
-    case T_FORMAT_LWX: len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint32)data); break;
-    case T_FORMAT_LHX: len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint16)data); break;
-    case T_FORMAT_LBX: len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint8)data);  break;
-    default: {
-      UNIMPLEMENTED1("ERROR: Wrong trace format used for trace_load()");
-      len = 0;
-      break;
-    }
+  if (BT) {
+    BT->put_u8(arcsim::util::BinaryTrace::kRecLoad);
+    BT->put_u8(fmt);
+    BT->put_varint(addr);
+    BT->put_varint(data);
+    BT->end_record();
+    return;
   }
-  IS.write(buf, len);
+  trace_fmt_load_store(fmt, addr, data);
 }
 
 void
 Processor::trace_store (int fmt, uint32 addr, uint32 data)
+{
+  addr = addr & state.addr_mask;
+
+  if (BT) {
+    BT->put_u8(arcsim::util::BinaryTrace::kRecStore);
+    BT->put_u8(fmt);
+    BT->put_varint(addr);
+    BT->put_varint(data);
+    BT->end_record();
+    return;
+  }
+  trace_fmt_load_store(fmt, addr, data);
+}
+
+void
+Processor::trace_fmt_load_store (int fmt, uint32 addr, uint32 data)
 {
   char  buf[BUFSIZ];
   int   len;
 
-  addr = addr & state.addr_mask;
-
   switch (fmt) {
+    case T_FORMAT_LW:  len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint32)data); break;
+    case T_FORMAT_LH:  len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint16)data); break;
+    case T_FORMAT_LB:  len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint8)data);  break;
+    case T_FORMAT_LWX: len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint32)data); break;
+    case T_FORMAT_LHX: len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint16)data); break;
+    case T_FORMAT_LBX: len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint8)data);  break;
     case T_FORMAT_SW:  len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint32)data); break;
     case T_FORMAT_SH:  len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint16)data); break;
     case T_FORMAT_SB:  len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint8)data);  break;
@@ -2212,9 +2784,9 @@ Processor::trace_store (int fmt, uint32 addr, uint32 data)
     case T_FORMAT_SHX: len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint16)data); break;
     case T_FORMAT_SBX: len = snprintf (buf, sizeof(buf), kTraceFormatStr[fmt], addr, (uint8)data);  break;
     default: {
-      UNIMPLEMENTED1("ERROR: Wrong trace format used for trace_store()");
+      UNIMPLEMENTED1("ERROR: Wrong trace format used for trace_load()/trace_store()");
       len = 0;
-      break; 
+      break;
     }
   }
   IS.write(buf, len);
@@ -2223,31 +2795,168 @@ Processor::trace_store (int fmt, uint32 addr, uint32 data)
 void
 Processor::trace_lr (uint32 addr, uint32 data, int success)
 {
-  if (success) {
-    IS << ": aux[0x" << std::hex << std::setw(2) << std::setfill('0') << addr
-       << "] => "    << std::hex << std::setw(2) << std::setfill('0') << data;
-  } else {
-    IS << ": failed aux read, ";
+  if (BT) {
+    BT->put_u8(arcsim::util::BinaryTrace::kRecLr);
+    BT->put_varint(addr);
+    BT->put_varint(data);
+    BT->put_u8(success != 0);
+    BT->end_record();
+    return;
   }
+  trace_fmt_aux(false, addr, data, success);
 }
 
 void
 Processor::trace_sr (uint32 addr, uint32 data, int success)
+{
+  if (BT) {
+    BT->put_u8(arcsim::util::BinaryTrace::kRecSr);
+    BT->put_varint(addr);
+    BT->put_varint(data);
+    BT->put_u8(success != 0);
+    BT->end_record();
+    return;
+  }
+  trace_fmt_aux(true, addr, data, success);
+}
+
+void
+Processor::trace_fmt_aux (bool is_write, uint32 addr, uint32 data, int success)
 {
   if (success) {
     IS << ": aux[0x" << std::hex << std::setw(2) << std::setfill('0') << addr
        << "] => "    << std::hex << std::setw(2) << std::setfill('0') << data;
-  } else {
+  } else if (is_write) {
     IS << ": failed aux write, ";
+  } else {
+    IS << ": failed aux read, ";
   }
 }
 
 void
 Processor::trace_rtie ()
 {
-  IS << ": PC <= 0x"       << HEX(state.next_pc)
-     << ", STATUS32 <= 0x" << HEX(state.auxs[AUX_STATUS32])
-     << ", BTA <= 0x"      << HEX(state.auxs[AUX_BTA]);
+  if (BT) {
+    BT->put_u8(arcsim::util::BinaryTrace::kRecRtie);
+    BT->put_varint(state.next_pc);
+    BT->put_varint(state.auxs[AUX_STATUS32]);
+    BT->put_varint(state.auxs[AUX_BTA]);
+    BT->end_record();
+    return;
+  }
+  trace_fmt_rtie(state.next_pc, state.auxs[AUX_STATUS32], state.auxs[AUX_BTA]);
+}
+
+void
+Processor::trace_fmt_rtie (uint32 pc, uint32 status32, uint32 bta)
+{
+  IS << ": PC <= 0x"       << HEX(pc)
+     << ", STATUS32 <= 0x" << HEX(status32)
+     << ", BTA <= 0x"      << HEX(bta);
+}
+
+// Render binary trace records of the current chunk using the textual trace
+// format. Sequence of records is exactly the same as the sequence of trace_*()
+// method calls that produced them.
+//
+bool
+Processor::trace_render (arcsim::util::BinaryTraceReader& R)
+{
+  using arcsim::util::BinaryTrace;
+  
+  std::string str;
+  
+  while (!R.is_chunk_end() && !R.has_error()) {
+    const uint8 kind = R.get_u8();
+    switch (kind) {
+      case BinaryTrace::kRecInstruction: {
+        const uint32 pc    = R.get_pc();
+        const uint32 instr = R.get_varint();
+        const uint32 limm  = R.get_varint();
+        const uint32 flags = R.get_varint();
+        const uint32 sym_pc= (flags & kTraceFlagSymPc) ? R.get_varint() : pc;
+        trace_fmt_instruction(pc, instr, limm, flags, sym_pc);
+        break;
+      }
+      case BinaryTrace::kRecWriteBack: {
+        const uint8 enb = R.get_u8();
+        if (enb & 0x1) { const int wa = R.get_varint(); trace_fmt_write_back("w0", wa, R.get_varint()); }
+        if (enb & 0x2) { const int wa = R.get_varint(); trace_fmt_write_back("w1", wa, R.get_varint()); }
+        break;
+      }
+      case BinaryTrace::kRecCommit: {
+        trace_fmt_commit(R.get_u8() != 0);
+        break;
+      }
+      case BinaryTrace::kRecEmit: {
+        const uint8  flags  = R.get_u8();
+        const uint64 cycles = (flags & kTraceEmitCycles) ? R.get_varint() : 0;
+        trace_fmt_emit(flags & kTraceEmitNative, flags & kTraceEmitCycles, cycles);
+        break;
+      }
+      case BinaryTrace::kRecException: {
+        uint32 regs[kTraceExcRegCount] = { 0 };
+        const uint32 count = (sys_arch.isa_opts.stack_checking) ? kTraceExcRegCount
+                                                                : kTraceExcRegCountNoSC;
+        R.get_string(str);
+        for (uint32 i = 0; i < count; ++i) { regs[i] = R.get_varint(); }
+        trace_fmt_exception(str.c_str(), regs);
+        break;
+      }
+      case BinaryTrace::kRecMul64: {
+        const uint32 mlo  = R.get_varint();
+        const uint32 mmid = R.get_varint();
+        trace_fmt_mul64_inst(mlo, mmid, R.get_varint());
+        break;
+      }
+      case BinaryTrace::kRecLoopBack: {
+        trace_fmt_loop_back(R.get_varint());
+        break;
+      }
+      case BinaryTrace::kRecLoopCount: {
+        trace_fmt_loop_count(R.get_varint());
+        break;
+      }
+      case BinaryTrace::kRecLoopInst: {
+        if (R.get_u8()) {
+          trace_fmt_loop_inst(1, R.get_varint(), 0, 0, 0);
+        } else {
+          const uint32 lp_start = R.get_varint();
+          const uint32 lp_end   = R.get_varint();
+          trace_fmt_loop_inst(0, 0, lp_start, lp_end, R.get_varint());
+        }
+        break;
+      }
+      case BinaryTrace::kRecLoad:
+      case BinaryTrace::kRecStore: {
+        const int    fmt  = R.get_u8();
+        const uint32 addr = R.get_varint();
+        if (fmt >= NUM_T_FORMATS) { return false; }
+        trace_fmt_load_store(fmt, addr, R.get_varint());
+        break;
+      }
+      case BinaryTrace::kRecLr:
+      case BinaryTrace::kRecSr: {
+        const uint32 addr = R.get_varint();
+        const uint32 data = R.get_varint();
+        trace_fmt_aux(kind == BinaryTrace::kRecSr, addr, data, R.get_u8());
+        break;
+      }
+      case BinaryTrace::kRecRtie: {
+        const uint32 pc       = R.get_varint();
+        const uint32 status32 = R.get_varint();
+        trace_fmt_rtie(pc, status32, R.get_varint());
+        break;
+      }
+      case BinaryTrace::kRecString: {
+        R.get_string(str);
+        IS.write(str.data(), str.size());
+        break;
+      }
+      default: return false;
+    }
+  }
+  return !R.has_error();
 }
 
 // -----------------------------------------------------------------------------
@@ -2385,7 +3094,45 @@ Processor::print_stats ()
   fprintf (stderr, " Total instructions:       %12lld%10.2f\n",
            instructions(),    100.0);
   fprintf (stderr, "-------------------------------------------------\n\n");
-    
+
+  // Print out sampled simulation estimates
+  //
+  sampler_.print_stats(sim_opts.cycle_sim);
+
+  // Print out region formation and execution statistics
+  //
+  if (sim_opts.fast && sim_opts.fast_trans_mode == kCompilationModeRegion) {
+    const uint64 regions   = phys_profile_.get_region_count();
+    const uint64 transfers = cnt_ctx.region_transfer_count.get_value();
+    const uint64 failures  = cnt_ctx.region_guard_fail_count.get_value();
+    const uint64 interp    = cnt_ctx.interp_inst_count.get_value();
+    fprintf (stderr, "Region Statistics\n");
+    fprintf (stderr, "-------------------------------------------------\n");
+    fprintf (stderr, " Regions spanning pages:   %12llu\n", regions);
+    fprintf (stderr, " Off-page blocks/region:     %10.2f\n",
+             regions ? (double)phys_profile_.get_region_off_page_blocks() / regions : 0.0);
+    fprintf (stderr, " Pages/region:               %10.2f\n",
+             regions ? (double)phys_profile_.get_region_pages() / regions : 0.0);
+    fprintf (stderr, " Off-page transfers:       %12llu\n", transfers);
+    fprintf (stderr, " Guard failures:           %12llu\n", failures);
+    fprintf (stderr, " Native/interpreted ratio:   %10.2f\n",
+             interp ? (double)cnt_ctx.native_inst_count.get_value() / interp : 0.0);
+    fprintf (stderr, "-------------------------------------------------\n\n");
+  }
+
+  // Print out invalidations caused by writes to pages containing code
+  //
+  if (sim_opts.fast && cnt_ctx.smc_invalidation_count.get_value()) {
+    const uint64 invalidations = cnt_ctx.smc_invalidation_count.get_value();
+    const uint64 discarded     = cnt_ctx.smc_discarded_translation_count.get_value();
+    fprintf (stderr, "Code Invalidation Statistics\n");
+    fprintf (stderr, "-------------------------------------------------\n");
+    fprintf (stderr, " Invalidations:            %12llu\n", invalidations);
+    fprintf (stderr, " Discarded translations:   %12llu\n", discarded);
+    fprintf (stderr, " Discarded per invalidation: %10.2f\n", (double)discarded / invalidations);
+    fprintf (stderr, "-------------------------------------------------\n\n");
+  }
+
   // Print overall simulation times and simulated instructions
   //  
   double sim_total  = exec_time.get_elapsed_seconds();
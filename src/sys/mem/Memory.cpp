@@ -20,8 +20,11 @@
 //
 // =====================================================================
 
+#include <sys/mman.h>
+
 #include <algorithm>
 #include <iomanip>
+#include <cerrno>
 #include <cstring>
 
 #include "Assertion.h"
@@ -36,6 +39,7 @@
 #include "concurrent/ScopedLock.h"
 
 #include "util/Allocate.h"
+#include "util/Checkpoint.h"
 #include "util/CodeBuffer.h"
 #include "util/Log.h"
 
@@ -44,35 +48,185 @@
 namespace arcsim {
   namespace sys  {
     namespace mem {
+      // -----------------------------------------------------------------------
+      // Proxy serialising all calls into a MemoryDevice shared by processors
+      // that are simulated on their own host threads (@see System::run_parallel())
+      //
+      class SynchronisedMemoryDevice : public arcsim::mem::MemoryDeviceInterface
+      {
+      private:
+        arcsim::mem::MemoryDeviceInterface& dev_;
+        arcsim::concurrent::Mutex&          mtx_;
+        
+      public:
+        SynchronisedMemoryDevice(arcsim::mem::MemoryDeviceInterface& dev,
+                                 arcsim::concurrent::Mutex&          mtx)
+        : dev_(dev), mtx_(mtx)
+        { /* EMPTY */ }
+        
+        uint32 get_range_begin() const { return dev_.get_range_begin(); }
+        uint32 get_range_end  () const { return dev_.get_range_end();   }
+        
+        int mem_dev_init (uint32 value)
+        {
+          arcsim::concurrent::ScopedLock lock(mtx_);
+          return dev_.mem_dev_init(value);
+        }
+        int mem_dev_clear (uint32 value)
+        {
+          arcsim::concurrent::ScopedLock lock(mtx_);
+          return dev_.mem_dev_clear(value);
+        }
+        int mem_dev_read (uint32 addr, unsigned char* dest, int size)
+        {
+          arcsim::concurrent::ScopedLock lock(mtx_);
+          return dev_.mem_dev_read(addr, dest, size);
+        }
+        int mem_dev_write (uint32 addr, const unsigned char* data, int size)
+        {
+          arcsim::concurrent::ScopedLock lock(mtx_);
+          return dev_.mem_dev_write(addr, data, size);
+        }
+        int mem_dev_read (uint32 addr, unsigned char* dest, int size, int agent_id)
+        {
+          arcsim::concurrent::ScopedLock lock(mtx_);
+          return dev_.mem_dev_read(addr, dest, size, agent_id);
+        }
+        int mem_dev_write (uint32 addr, const unsigned char* data, int size, int agent_id)
+        {
+          arcsim::concurrent::ScopedLock lock(mtx_);
+          return dev_.mem_dev_write(addr, data, size, agent_id);
+        }
+      };
+      
       // -----------------------------------------------------------------------
       // Constructor
       //
       Memory::Memory (SystemArch& _sys_arch, PageArch& _page_arch)
-      : sys_arch(_sys_arch),
+      : page_dir_(0),
+        page_dir_size_(1U << (32 - _page_arch.byte_index_shift - kLogTwoPageTableSize)),
+        sys_arch(_sys_arch),
         page_arch(_page_arch),
         block_pool_end_(0),
-        block_pool_ptr_(0)
+        block_pool_ptr_(0),
+        sparse_base_(0),
+        direct_perm_(0)
       {
-        refill_block_pool();
+        page_dir_ = new BlockData**[page_dir_size_];
+        for (uint32 i = 0; i < page_dir_size_; ++i) { page_dir_[i] = 0; }
+        
+        if (!sys_arch.sim_opts.mem_sparse || !reserve_sparse_memory()) {
+          refill_block_pool();
+        }
       }
       // -----------------------------------------------------------------------
       // Destructor
       //      
       Memory::~Memory()
-      { // Free dynamically allocated BlockData Metadata objects
+      { // Free dynamically allocated BlockData Metadata objects and page tables
         //
-        for (std::map<uint32,BlockData*>::iterator
-               I = mem_blocks_.begin(),
-               E = mem_blocks_.end();
-               I != E; ++I)
-        {
-          delete I->second; I->second = 0;
+        for (uint32 i = 0; i < page_dir_size_; ++i) {
+          if (BlockData** const table = page_dir_[i]) {
+            for (uint32 j = 0; j < (1U << kLogTwoPageTableSize); ++j) { delete table[j]; }
+            delete [] table;
+          }
         }
-        // Free dynamically allocated BlockData memory
+        delete [] page_dir_;
+        // Free dynamically allocated BlockData memory and snapshot pages
         //
-        while (!block_pool_stack_.empty()) {
-          arcsim::util::Malloced::DeleteAligned(block_pool_stack_.top());
-          block_pool_stack_.pop();
+        release_block_pool();
+        // Release sparse reservation
+        //
+        if (sparse_base_) { munmap(sparse_base_, static_cast<size_t>(1) << 32); }
+        delete [] direct_perm_;
+        // Free memory device proxies, devices are owned by their simContext
+        //
+        for (uint32 i = 0; i < mem_devices_array_.size(); ++i) { delete mem_devices_array_[i]; }
+      }
+      
+      // -----------------------------------------------------------------------
+      // Reserve the complete physical address space. Nothing is committed until
+      // a page is touched, and transparent huge pages reduce host TLB misses
+      // for large simulated memories.
+      //
+      bool
+      Memory::reserve_sparse_memory()
+      {
+        if (sizeof(void*) < 8) {
+          LOG(LOG_WARNING) << "[MEMORY] Sparse memory requires a 64-bit host, using memory pool.";
+          return false;
+        }
+        const size_t size = static_cast<size_t>(1) << 32;
+        void* p = mmap(0, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (p == MAP_FAILED) {
+          LOG(LOG_WARNING) << "[MEMORY] Failed to reserve sparse memory: '"
+                           << strerror(errno) << "', using memory pool.";
+          return false;
+        }
+#if defined(MADV_HUGEPAGE)
+        madvise(p, size, MADV_HUGEPAGE);
+#endif
+        sparse_base_ = static_cast<uint8*>(p);
+        
+        const uint32 frames = 1U << (32 - page_arch.byte_index_shift);
+        direct_perm_ = new uint8[frames];
+        std::memset(direct_perm_, 0, frames);
+        
+        LOG(LOG_DEBUG) << "[MEMORY] Reserved sparse memory at " << p << ".";
+        return true;
+      }
+      
+      bool
+      Memory::is_direct_access_enabled(const CoreArch& arch) const
+      {
+        if (!direct_perm_
+            || arch.mmu_arch.is_configured
+            || arch.iccm.is_configured
+            || arch.dccm.is_configured
+            || sys_arch.isa_opts.num_actionpoints
+            || sys_arch.isa_opts.addr_size != 32
+            || sys_arch.isa_opts.code_protect_bits
+            || sys_arch.sim_opts.big_endian) {
+          return false;
+        }
+        for (uint32 i = 0; i < sizeof(arch.iccms)/sizeof(arch.iccms[0]); ++i) {
+          if (arch.iccms[i].is_configured) { return false; }
+        }
+        return true;
+      }
+      
+      // -----------------------------------------------------------------------
+      // Page table management
+      //
+      BlockData*
+      Memory::set_page (uint32 frame_num, BlockData* block)
+      {
+        BlockData** table = page_dir_[frame_num >> kLogTwoPageTableSize];
+        if (table == 0) {
+          table = new BlockData*[1U << kLogTwoPageTableSize];
+          for (uint32 j = 0; j < (1U << kLogTwoPageTableSize); ++j) { table[j] = 0; }
+          // Publish table only once it is initialised
+          __sync_synchronize();
+          page_dir_[frame_num >> kLogTwoPageTableSize] = table;
+        }
+        BlockData*& entry = table[frame_num & ((1U << kLogTwoPageTableSize) - 1)];
+        BlockData*  prev  = entry;
+        // Publish block only once it is constructed
+        __sync_synchronize();
+        entry = block;
+        return prev;
+      }
+      
+      void
+      Memory::get_pages (std::vector<BlockData*>& pages) const
+      {
+        for (uint32 i = 0; i < page_dir_size_; ++i) {
+          if (BlockData** const table = page_dir_[i]) {
+            for (uint32 j = 0; j < (1U << kLogTwoPageTableSize); ++j) {
+              if (table[j]) { pages.push_back(table[j]); }
+            }
+          }
         }
       }
       
@@ -83,12 +237,11 @@ namespace arcsim {
         if (sys_arch.sim_opts.init_mem_custom)
         { // Clear managed RAM memory
           //
-          for (std::map<uint32,BlockData*>::const_iterator
-                I = mem_blocks_.begin(),
-                E = mem_blocks_.end();
-               I != E; ++I)
+          std::vector<BlockData*> pages;
+          get_pages(pages);
+          for (uint32 i = 0; i < pages.size(); ++i)
           {
-            const BlockData& block_data = *I->second;
+            const BlockData& block_data = *pages[i];
             if (block_data.is_mem_ram()) {
               uint32 * p = block_data.get_mem_ram();
               std::memset(p, sys_arch.sim_opts.init_mem_value, sizeof(p[0]) * page_arch.page_words);              
@@ -97,18 +250,146 @@ namespace arcsim {
         }
         // Clear all registered memory devices
         //
-        for (std::set<arcsim::mem::MemoryDeviceInterface*>::iterator
-              I = mem_devices_set_.begin(),
-              E = mem_devices_set_.end();
+        for (std::vector<arcsim::mem::MemoryDeviceInterface*>::iterator
+              I = mem_devices_array_.begin(),
+              E = mem_devices_array_.end();
              I != E; ++I)
         {
           (*I)->mem_dev_clear(sys_arch.sim_opts.init_mem_value);          
         }
       }
       
+      // -------------------------------------------------------------------
+      // Checkpointing
+      //
+      bool
+      Memory::save_checkpoint(arcsim::util::CheckpointWriter& writer)
+      {
+        arcsim::concurrent::ScopedLock lock(mem_blocks_mtx_);
+        
+        std::vector<BlockData*> pages;
+        get_pages(pages);
+        
+        uint32 count = 0;
+        for (uint32 i = 0; i < pages.size(); ++i) {
+          if (pages[i]->is_mem_ram()) { ++count; }
+        }
+        
+        writer.begin_section(arcsim::util::Checkpoint::kSectionMemory);
+        writer.write_value(count);
+        for (uint32 i = 0; i < pages.size(); ++i)
+        {
+          const BlockData& block_data = *pages[i];
+          if (block_data.is_mem_ram()) {
+            writer.write_value(block_data.page_frame);
+            writer.write_value(writer.write_page(block_data.get_mem_ram()));
+          }
+        }
+        return true;
+      }
+      
+      bool
+      Memory::restore_checkpoint(arcsim::util::CheckpointReader& reader)
+      {
+        if (reader.get_page_bytes() != page_arch.page_bytes) {
+          LOG(LOG_ERROR) << "[MEMORY] Checkpoint page size '" << reader.get_page_bytes()
+                         << "' does not match memory block size '" << page_arch.page_bytes << "'.";
+          return false;
+        }
+        
+        uint32 count = 0;
+        if (!reader.expect_section(arcsim::util::Checkpoint::kSectionMemory)
+            || !reader.read_value(count)) {
+          return false;
+        }
+        
+        // Read and check complete page table before any page is replaced
+        //
+        std::vector<std::pair<uint32,uint32*> > pages;
+        pages.reserve(count);
+        for (uint32 i = 0; i < count; ++i) {
+          uint32 frame = 0, idx = 0;
+          if (!reader.read_value(frame) || !reader.read_value(idx) || !reader.get_page(idx)) {
+            return false;
+          }
+          pages.push_back(std::make_pair(frame, reinterpret_cast<uint32*>(reader.get_page(idx))));
+        }
+        
+        // -----------------------------------------------------------------
+        // SCOPED LOCK START
+        //
+        arcsim::concurrent::ScopedLock lock(mem_blocks_mtx_);
+        
+        // Drop all RAM pages. Callers MUST flush all page caches holding
+        // pointers to these pages.
+        //
+        std::vector<BlockData*> blocks;
+        get_pages(blocks);
+        for (uint32 i = 0; i < blocks.size(); ++i) {
+          if (blocks[i]->is_mem_ram()) {
+            set_page(blocks[i]->page_frame >> page_arch.byte_index_shift, 0);
+            delete blocks[i];
+          }
+        }
+        
+        // Sparse memory must keep RAM pages at their physical address, hence
+        // snapshot pages are copied into the (discarded) sparse reservation.
+        // Otherwise no page refers to the block pool or to the snapshot of a
+        // previous restore any more, so both are released.
+        //
+        if (sparse_base_) {
+          madvise(sparse_base_, static_cast<size_t>(1) << 32, MADV_DONTNEED);
+          std::memset(direct_perm_, 0, 1U << (32 - page_arch.byte_index_shift));
+        } else {
+          release_block_pool();
+          refill_block_pool();
+        }
+        
+        // Install pages backed by the snapshot file, pages that are already
+        // claimed by a memory device keep the device
+        //
+        for (uint32 i = 0; i < pages.size(); ++i) {
+          const uint32 frame_num = pages[i].first >> page_arch.byte_index_shift;
+          if (lookup_page(frame_num) == 0) {
+            uint32* block = pages[i].second;
+            if (sparse_base_) {
+              block = reinterpret_cast<uint32*>(sparse_base_ + pages[i].first);
+              std::memcpy(block, pages[i].second, page_arch.page_bytes);
+              direct_perm_[frame_num] = kDirectRead | kDirectWrite;
+            }
+            set_page(frame_num, new BlockData(pages[i].first, block));
+          }
+        }
+        
+        if (!sparse_base_) {
+          void*  base = 0;
+          size_t size = 0;
+          reader.release_pages(&base, &size);
+          if (base) { snapshot_mappings_.push_back(std::make_pair(base, size)); }
+        }
+        
+        LOG(LOG_DEBUG) << "[MEMORY] Restored " << pages.size() << " pages from checkpoint.";
+        return true;
+      }
+      
       // -------------------------------------------------------------------
       // BlockData memory pool management methods
       //
+      void
+      Memory::release_block_pool()
+      {
+        while (!block_pool_stack_.empty()) {
+          arcsim::util::Malloced::DeleteAligned(block_pool_stack_.top());
+          block_pool_stack_.pop();
+        }
+        block_pool_ptr_ = block_pool_end_ = 0;
+        
+        for (uint32 i = 0; i < snapshot_mappings_.size(); ++i) {
+          munmap(snapshot_mappings_[i].first, snapshot_mappings_[i].second);
+        }
+        snapshot_mappings_.clear();
+      }
+      
       uint32
       Memory::refill_block_pool()
       {
@@ -145,10 +426,11 @@ namespace arcsim {
       // Get pointer to new block data memory
       //
       uint32 *
-      Memory::new_block() {
+      Memory::new_block(uint32 page_frame) {
         // Pointer to block data memory to be used
         //
-        uint32 * p = block_pool_ptr_;
+        uint32 * p = sparse_base_ ? reinterpret_cast<uint32*>(sparse_base_ + page_frame)
+                                  : block_pool_ptr_;
         
         // Initialise memory when requested
         //
@@ -156,6 +438,8 @@ namespace arcsim {
           std::memset(p, sys_arch.sim_opts.init_mem_value, sizeof(p[0]) * page_arch.page_words);
         }
         
+        if (sparse_base_) { return p; }
+        
         // Increment 'block_data_mem_pool_ptr_'
         //
         block_pool_ptr_ += page_arch.page_words;
@@ -194,15 +478,17 @@ namespace arcsim {
           //
           mem_devices_set_.insert(mem_dev);
           
-          // Add memory device to mem_devices_array and sort mem_devices_array
-          // so we can perform efficient binary search.
+          // Add proxy for memory device to mem_devices_array and sort
+          // mem_devices_array so we can perform efficient binary search.
           //
-          mem_devices_array_.push_back(mem_dev);
+          arcsim::mem::MemoryDeviceInterface* const proxy
+            = new SynchronisedMemoryDevice(*mem_dev, mem_devices_mtx_);
+          mem_devices_array_.push_back(proxy);
           std::sort(mem_devices_array_.begin(), mem_devices_array_.end(), compare_range);
           
           // Call initialisation method on memory device
           //
-          mem_dev->mem_dev_init(sys_arch.sim_opts.init_mem_value);
+          proxy->mem_dev_init(sys_arch.sim_opts.init_mem_value);
         } else {
           LOG(LOG_ERROR) << "[MEMORY] MemoryDevice already registered for range: 0x"
                          << HEX(mem_dev->get_range_begin()) << "  - 0x"
@@ -245,25 +531,29 @@ namespace arcsim {
       //
       BlockData*
       Memory::get_host_page (uint32 phys_byte_addr)
-      { // -----------------------------------------------------------------
+      {
+        const uint32 frame_num  = phys_byte_addr >> page_arch.byte_index_shift;
+        const uint32 page_frame = page_arch.page_byte_frame(phys_byte_addr);
+        
+        // -----------------------------------------------------------------
+        // If BlockData has already been allocated we return a pointer to it
+        //
+        BlockData* block_data = lookup_page(frame_num);
+        if (block_data) { return block_data; }
+        
+        // -----------------------------------------------------------------
         // SCOPED LOCK START
         //
         arcsim::concurrent::ScopedLock lock(mem_blocks_mtx_);
         
-        uint32 page_frame = page_arch.page_byte_frame(phys_byte_addr);
-        
-        // -----------------------------------------------------------------
-        // If BlockData has already been allocated we return a pointer to it
+        // Another thread may have allocated the page in the meantime
         //
-        if (mem_blocks_.find(page_frame) != mem_blocks_.end())
-          return mem_blocks_[page_frame];
+        if ( (block_data = lookup_page(frame_num)) ) { return block_data; }
         
         // -----------------------------------------------------------------
         // BlockData has not been allocated yet, check which type of BlockData
         // object we need to instantiate
         //        
-        BlockData* block_data  = 0;
-        
         // -----------------------------------------------------------------
         // If a MemoryDevice is registered for this BlockData instance we will
         // allocate a special BlockData instance that performs the right call-backs
@@ -293,11 +583,13 @@ namespace arcsim {
         // If no MemoryDevices are registered for this BlockData instance
         // we will allocate a RAM memory BlockData instance.
         //
-        if (block_data == 0)
-          block_data = new BlockData(page_frame, new_block());
+        if (block_data == 0) {
+          block_data = new BlockData(page_frame, new_block(page_frame));
+          if (direct_perm_) { direct_perm_[frame_num] = kDirectRead | kDirectWrite; }
+        }
         
-        // Insert newly allocated BlockData object into memory block map
-        mem_blocks_.insert(std::pair<uint32,BlockData*>(page_frame, block_data));    
+        // Insert newly allocated BlockData object into page table
+        set_page(frame_num, block_data);
 
         return block_data;
       }
@@ -600,11 +892,17 @@ namespace arcsim {
       //
       static bool jit_emit_memory_read_access_function (CoreArch&,
                                                         arcsim::util::CodeBuffer&,
-                                                        MemoryAccessFunctionVariant);
+                                                        MemoryAccessFunctionVariant,
+                                                        bool);
       
       static bool jit_emit_memory_write_access_function(CoreArch&,
                                                         arcsim::util::CodeBuffer&,
-                                                        MemoryAccessFunctionVariant);
+                                                        MemoryAccessFunctionVariant,
+                                                        bool);
+      
+      static void jit_emit_direct_memory_access(CoreArch&,
+                                                arcsim::util::CodeBuffer&,
+                                                MemoryAccessFunctionVariant);
 
       // ---------------------------------------------------------------------------
       // Method emitting code to access memory
@@ -613,29 +911,69 @@ namespace arcsim {
       Memory::jit_emit_memory_access_functions(arcsim::util::CodeBuffer& buf,
                                                CoreArch&                 arch)
       {
+        // Access RAM pages by host address if permitted
+        const bool direct = is_direct_access_enabled(arch);
+        
         // Memory WRITE functions
-        jit_emit_memory_write_access_function(arch, buf, WRITE_WORD_UNSIGNED);
-        jit_emit_memory_write_access_function(arch, buf, WRITE_HALF_UNSIGNED);
-        jit_emit_memory_write_access_function(arch, buf, WRITE_BYTE_UNSIGNED);
+        jit_emit_memory_write_access_function(arch, buf, WRITE_WORD_UNSIGNED, direct);
+        jit_emit_memory_write_access_function(arch, buf, WRITE_HALF_UNSIGNED, direct);
+        jit_emit_memory_write_access_function(arch, buf, WRITE_BYTE_UNSIGNED, direct);
         
         // Memory READ functions
-        jit_emit_memory_read_access_function(arch, buf, READ_WORD);
-        jit_emit_memory_read_access_function(arch, buf, READ_HALF_SIGNED);
-        jit_emit_memory_read_access_function(arch, buf, READ_HALF_UNSIGNED);
-        jit_emit_memory_read_access_function(arch, buf, READ_BYTE_SIGNED);
-        jit_emit_memory_read_access_function(arch, buf, READ_BYTE_UNSIGNED);
+        jit_emit_memory_read_access_function(arch, buf, READ_WORD,          direct);
+        jit_emit_memory_read_access_function(arch, buf, READ_HALF_SIGNED,   direct);
+        jit_emit_memory_read_access_function(arch, buf, READ_HALF_UNSIGNED, direct);
+        jit_emit_memory_read_access_function(arch, buf, READ_BYTE_SIGNED,   direct);
+        jit_emit_memory_read_access_function(arch, buf, READ_BYTE_UNSIGNED, direct);
         
         return buf.is_valid();
       }
       
       
+      // ---------------------------------------------------------------------------
+      // Local code emission helper function emitting direct access to RAM pages
+      // by host address. Page frames without permission (i.e. memory devices,
+      // pages not allocated yet, and pages cached for execution when writing)
+      // fall through to the page cache based access.
+      //
+      static void
+      jit_emit_direct_memory_access(CoreArch&                    core_arch,
+                                    arcsim::util::CodeBuffer&    buf,
+                                    MemoryAccessFunctionVariant  variant)
+      {
+        const PageArch& p = core_arch.page_arch; // short-cut to page archictecture
+        
+        const char* type = 0;
+        uint32      mask = 0;   // alignment mask
+        switch (variant) {
+          case WRITE_BYTE_UNSIGNED:
+          case READ_BYTE_UNSIGNED:  type = "uint8";  mask = ~0U; break;
+          case READ_BYTE_SIGNED:    type = "sint8";  mask = ~0U; break;
+          case WRITE_HALF_UNSIGNED:
+          case READ_HALF_UNSIGNED:  type = "uint16"; mask = ~1U; break;
+          case READ_HALF_SIGNED:    type = "sint16"; mask = ~1U; break;
+          default:                  type = "uint32"; mask = ~3U; break;
+        }
+        
+        if (variant <= WRITE_WORD_UNSIGNED) {
+          buf.append("if (s->mem_direct_perm[addr >> %d] & %d) {\n", p.byte_index_shift, Memory::kDirectWrite)
+             .append("  *(%s*)(s->mem_direct_base + (addr & 0x%08x)) = (%s)data;\n", type, mask, type)
+             .append("  return 1;\n}\n");
+        } else {
+          buf.append("if (s->mem_direct_perm[addr >> %d] & %d) {\n", p.byte_index_shift, Memory::kDirectRead)
+             .append("  s->gprs[dst] = *(%s*)(s->mem_direct_base + (addr & 0x%08x));\n", type, mask)
+             .append("  return 1;\n}\n");
+        }
+      }
+      
       // ---------------------------------------------------------------------------
       // Local code emission helper function emitting memory reads
       //
       static bool
       jit_emit_memory_read_access_function(CoreArch&                    core_arch,
                                            arcsim::util::CodeBuffer&    buf,
-                                           MemoryAccessFunctionVariant  variant)
+                                           MemoryAccessFunctionVariant  variant,
+                                           bool                         direct)
       {
         bool success      = true;        
         const PageArch& p = core_arch.page_arch; // short-cut to page archictecture
@@ -643,6 +981,8 @@ namespace arcsim {
         // Function definition is always the same
         buf.append("\nstatic inline int %s(cpuState * const s,const uint32 pc,const uint32 addr,const uint16 dst) {\n",
                    memory_function_name_map[variant]);
+        
+        if (direct) { jit_emit_direct_memory_access(core_arch, buf, variant); }
                 
         switch (variant) {
           case READ_BYTE_UNSIGNED: {
@@ -720,7 +1060,8 @@ namespace arcsim {
       static bool
       jit_emit_memory_write_access_function(CoreArch&                   core_arch,
                                             arcsim::util::CodeBuffer&   buf,
-                                            MemoryAccessFunctionVariant variant)
+                                            MemoryAccessFunctionVariant variant,
+                                            bool                        direct)
       {
         bool success      = true;
         const PageArch& p = core_arch.page_arch; // short-cut to page archictecture
@@ -729,6 +1070,8 @@ namespace arcsim {
         buf.append("\nstatic inline int %s(cpuState * const s,const uint32 pc,const uint32 addr,const uint32 data) {\n",
                    memory_function_name_map[variant]);
         
+        if (direct) { jit_emit_direct_memory_access(core_arch, buf, variant); }
+        
         switch (variant) {
           case WRITE_BYTE_UNSIGNED: {
             buf.append("EntryPageCache_ * const p = s->cache_page_write_ + ((addr >> %d) & 0x%08x);\n",
@@ -15,6 +15,7 @@
 #include "sys/cpu/processor.h"
 #include "sys/cpu/state.h"
 
+#include "util/Checkpoint.h"
 #include "util/Log.h"
 
 #define HEX(_addr_) std::hex << std::setw(8) << std::setfill('0') << _addr_
@@ -168,6 +169,7 @@ namespace arcsim {
             for (uint32 i = 0; i < kuDTLB_size; ++i) {
               udtlb_[i].virt_pd0 = udtlb_[i].phys_pd1 = 0;
             }
+            soft_tlb_clear();
           }break;
           
           case MmuArch::kMpu:
@@ -191,6 +193,56 @@ namespace arcsim {
         }
       }
       
+      // -----------------------------------------------------------------------------
+      // Checkpointing - the JTLB geometry is part of the configuration and must
+      // match, the software TLB is a cache and is simply cleared on restore.
+      //
+      void
+      Mmu::save_checkpoint(arcsim::util::CheckpointWriter& writer) const
+      {
+        const uint32 jtlb_entries = (jtlb_ != 0) ? (jtlb_sets_ * jtlb_ways_) : 0;
+        
+        writer.write(uitlb_, sizeof(uitlb_));
+        writer.write(udtlb_, sizeof(udtlb_));
+        writer.write_value(jtlb_entries);
+        for (uint32 set = 0; jtlb_entries && set < jtlb_sets_; ++set) {
+          writer.write(jtlb_[set], sizeof(EntryTLB) * jtlb_ways_);
+        }
+        writer.write_value(is_global_tlb_enabled_);
+        writer.write_value(is_shared_library_asid_enabled_);
+        writer.write_value(unmapped_base_address_);
+        writer.write_value(valid_asid_);
+        writer.write_value(rnd_jtlb_way_);
+        writer.write_value(rnd_uitlb_idx_);
+        writer.write_value(rnd_udtlb_idx_);
+      }
+      
+      bool
+      Mmu::restore_checkpoint(arcsim::util::CheckpointReader& reader)
+      {
+        const uint32 jtlb_entries = (jtlb_ != 0) ? (jtlb_sets_ * jtlb_ways_) : 0;
+        uint32       saved_entries;
+        
+        reader.read(uitlb_, sizeof(uitlb_));
+        reader.read(udtlb_, sizeof(udtlb_));
+        if (!reader.read_value(saved_entries) || saved_entries != jtlb_entries) {
+          LOG(LOG_ERROR) << "[MMU] Checkpoint JTLB size does not match MMU configuration.";
+          return false;
+        }
+        for (uint32 set = 0; jtlb_entries && set < jtlb_sets_; ++set) {
+          reader.read(jtlb_[set], sizeof(EntryTLB) * jtlb_ways_);
+        }
+        reader.read_value(is_global_tlb_enabled_);
+        reader.read_value(is_shared_library_asid_enabled_);
+        reader.read_value(unmapped_base_address_);
+        reader.read_value(valid_asid_);
+        reader.read_value(rnd_jtlb_way_);
+        reader.read_value(rnd_uitlb_idx_);
+        reader.read_value(rnd_udtlb_idx_);
+        soft_tlb_clear();
+        return !reader.has_error();
+      }
+      
       // -----------------------------------------------------------------------------
       // Write process identity register or MPU_EN register
       //
@@ -198,6 +250,9 @@ namespace arcsim {
       Mmu::write_pid (uint32 pid)
       {
         if(kind_ == MmuArch::kMmu){
+          const bool   was_enabled = is_global_tlb_enabled_;
+          const uint32 old_asid    = valid_asid_;
+          
           is_global_tlb_enabled_          = pid & kGlobalTlbEnableMask;
           // TODO(iboehm): Enable SASID matching
           //is_shared_library_asid_enabled_ = pid & kSharedLibraryAsidEnableMask;
@@ -210,6 +265,22 @@ namespace arcsim {
           unmapped_base_address_  = pid & kGlobalTlbEnableMask;
           valid_asid_             = (1 << pd_fmt_->v_bit_) | (pid & pd_fmt_->asid_mask_);
 
+          if (was_enabled == is_global_tlb_enabled_) {
+            if (old_asid == valid_asid_)
+              return; // nothing changed, all cached translations remain valid
+            
+            // ASID switch: the software TLB is ASID tagged and cached entries
+            // for the unmapped region do not depend on the ASID, hence only
+            // entries for translated addresses must go. Decode, translation and
+            // page caches are tagged by virtual address only, so entries for
+            // translated addresses are still dropped on every switch rather
+            // than kept per ASID.
+            LOG(LOG_DEBUG2) << "[MMU] ASID SWITCH: 0x" << HEX(old_asid) << " -> 0x" << HEX(valid_asid_);
+            cpu_->purge_dcode_cache_below(unmapped_base_address_);
+            cpu_->purge_translation_cache_below(unmapped_base_address_);
+            cpu_->purge_page_cache_below(arcsim::sys::cpu::PageCache::ALL, unmapped_base_address_);
+            return;
+          }
         }else{
           ASSERT(kind_ == MmuArch::kMpu);
           if((pid & (1<<30)) == 0) return; //Disabling the MPU does not necessitate flushing the caches
@@ -330,6 +401,15 @@ namespace arcsim {
         const uint32 pda = get_valid_asid_or_sasid_search_key(vpn, virt_addr, cpu_->state.auxs[AUX_SASID]);
         const uint32 pdg = get_valid_global_search_key(vpn);      
         
+        // ---------------------------------------------------------------------------
+        // 0. Check software TLB
+        //
+        const EntryTLB& stlb = soft_tlb_[soft_tlb_index(virt_addr)];
+        if ( (stlb.virt_pd0 != 0) && ((pda == stlb.virt_pd0) || (pdg == stlb.virt_pd0)) ) {
+          phys_addr = get_phys_addr(stlb.phys_pd1,virt_addr);
+          perms     = get_phys_addr_perm(stlb.phys_pd1);
+          return true;
+        }
         // ---------------------------------------------------------------------------
         // 1. Check udtlb_
         //
@@ -504,6 +584,15 @@ namespace arcsim {
         const uint32 pda = get_valid_asid_or_sasid_search_key(vpn, virt_addr, cpu_->state.auxs[AUX_SASID]);
         const uint32 pdg = get_valid_global_search_key(vpn);
         
+        // ---------------------------------------------------------------------------
+        // 0. Check software TLB
+        //
+        const EntryTLB& stlb = soft_tlb_[soft_tlb_index(virt_addr)];
+        if ( (stlb.virt_pd0 != 0) && ((pda == stlb.virt_pd0) || (pdg == stlb.virt_pd0)) ) {
+          phys_addr = get_phys_addr(stlb.phys_pd1,virt_addr);
+          perms     = get_phys_addr_perm(stlb.phys_pd1);
+          return true;
+        }
         // ---------------------------------------------------------------------------
         // 1. Check udtlb_
         //
@@ -527,6 +616,8 @@ namespace arcsim {
             perms     = get_phys_addr_perm(jtlb_[set][way].phys_pd1);
             // Compute next victim
             rnd_udtlb_idx_ = (rnd_udtlb_idx_ + 1) % kuDTLB_size;
+            // Remember translation in software TLB
+            soft_tlb_[soft_tlb_index(virt_addr)] = jtlb_[set][way];
             return true;
           }
         }
@@ -821,6 +912,7 @@ namespace arcsim {
         for (uint32 i = 0; i < kuDTLB_size; ++i) {
           udtlb_[i].virt_pd0 = udtlb_[i].phys_pd1 = 0;
         }
+        soft_tlb_clear();
         cpu_->purge_dcode_cache();
         cpu_->purge_translation_cache();
         cpu_->purge_page_cache(arcsim::sys::cpu::PageCache::ALL);
@@ -865,6 +957,10 @@ namespace arcsim {
         // Write the new TLB entry to way 0
         jtlb_[set][way].virt_pd0 = aux_tlb_virt_pd0;
         jtlb_[set][way].phys_pd1 = aux_tlb_phys_pd1;
+        // Drop software TLB copies of the old entry and any entry the new one
+        // might shadow
+        soft_tlb_purge(old_pd0);
+        soft_tlb_purge(aux_tlb_virt_pd0);
 
         // ---------------------------------------------------------------------------
         // If kCmdTlbWrite command is used we need to keep u(I|D)TLBs in sync
@@ -948,6 +1044,24 @@ namespace arcsim {
         return;
       }
       
+      // -----------------------------------------------------------------------------
+      // Software TLB maintenance
+      //
+      void
+      Mmu::soft_tlb_clear()
+      {
+        for (uint32 i = 0; i < kSoftTLB_size; ++i) {
+          soft_tlb_[i].virt_pd0 = soft_tlb_[i].phys_pd1 = 0;
+        }
+      }
+      
+      void
+      Mmu::soft_tlb_purge(uint32 pd0)
+      {
+        EntryTLB& e = soft_tlb_[soft_tlb_index(get_virt_page_num(pd0))];
+        e.virt_pd0 = e.phys_pd1 = 0;
+      }
+      
       // -----------------------------------------------------------------------------
       // Read TLB entry into TLBPD0 and TLBPD1 from the location specified in 
       // TLBIndex 
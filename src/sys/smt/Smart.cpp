@@ -18,6 +18,7 @@
 #include "sys/cpu/processor.h"
 #include "sys/cpu/aux-registers.h"
 
+#include "util/Checkpoint.h"
 #include "util/Log.h"
 
 namespace arcsim {
@@ -126,6 +127,45 @@ namespace arcsim {
         return (stack_depth > 0);
       }
 
+      // -----------------------------------------------------------------------
+      // Save/restore SmaRT registers and stack, the stack depth is part of the
+      // configuration and must match
+      //
+      void
+      Smart::save_checkpoint(arcsim::util::CheckpointWriter& writer) const
+      {
+        writer.write_value(stack_depth);
+        writer.write_value(is_enabled);
+        writer.write_value(head);
+        writer.write_value(aux_smt_control);
+        writer.write_value(aux_smt_data);
+        if (stack_depth) {
+          writer.write(src_addr, sizeof(src_addr[0]) * stack_depth);
+          writer.write(dst_addr, sizeof(dst_addr[0]) * stack_depth);
+          writer.write(flags,    sizeof(flags[0])    * stack_depth);
+        }
+      }
+      
+      bool
+      Smart::restore_checkpoint(arcsim::util::CheckpointReader& reader)
+      {
+        uint32 depth = 0;
+        if (!reader.read_value(depth) || depth != stack_depth) {
+          LOG(LOG_ERROR) << "[SmaRT] Checkpoint stack depth does not match configuration.";
+          return false;
+        }
+        reader.read_value(is_enabled);
+        reader.read_value(head);
+        reader.read_value(aux_smt_control);
+        reader.read_value(aux_smt_data);
+        if (stack_depth) {
+          reader.read(src_addr, sizeof(src_addr[0]) * stack_depth);
+          reader.read(dst_addr, sizeof(dst_addr[0]) * stack_depth);
+          reader.read(flags,    sizeof(flags[0])    * stack_depth);
+        }
+        return !reader.has_error();
+      }
+
       // -----------------------------------------------------------------------
       // Read a SmaRT auxiliary register
       //
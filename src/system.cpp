@@ -25,6 +25,8 @@
 #include <cstdlib>
 #include <cstring>
 #include <iomanip>
+#include <sstream>
+#include <vector>
 
 #include <dlfcn.h>
 #include <sys/stat.h>
@@ -50,6 +52,9 @@
 
 #include "concurrent/Mutex.h"
 #include "concurrent/ScopedLock.h"
+#include "concurrent/ConditionVariable.h"
+#include "concurrent/Barrier.h"
+#include "concurrent/Thread.h"
 
 #include "util/system/SharedLibrary.h"
 
@@ -59,6 +64,8 @@
 #include "util/Allocate.h"
 
 #include "util/SymbolTable.h"
+#include "util/BinaryTrace.h"
+#include "util/Checkpoint.h"
 
 #include <ELFIO.h>
 
@@ -156,6 +163,149 @@ get_next_system_id()
   return systems_in_use_++;
 }
 
+// -----------------------------------------------------------------------------
+// Parallel multi-core simulation support
+//
+
+class ProcessorThread;
+
+// State shared by all ProcessorThreads participating in a parallel run
+//
+struct ParallelRunContext
+{
+  arcsim::concurrent::Barrier           barrier;    // quantum synchronisation barrier
+  arcsim::concurrent::Mutex             turn_mtx;   // protects 'turn'
+  arcsim::concurrent::ConditionVariable turn_cond;  // signalled when 'turn' changes
+  
+  SimOptions&                   sim_opts;
+  std::vector<ProcessorThread*> threads;
+  
+  const System::RunMode mode;           // how processors should be driven
+  const bool            deterministic;  // execute cores in core order within a quantum
+  uint32                turn;           // thread allowed to execute in deterministic mode
+  uint32                quantum;        // length of the current quantum
+  uint64                period_left;    // remaining user specified simulation period
+  bool                  done;           // set by the serial thread to end the run
+  
+  ParallelRunContext(SimOptions& opts, uint32 cores, System::RunMode m)
+  : barrier(cores),
+    sim_opts(opts),
+    mode(m),
+    deterministic(opts.mc_deterministic),
+    turn(0),
+    quantum(0),
+    period_left(opts.sim_period),
+    done(false)
+  { /* EMPTY */ }
+};
+
+static void end_of_quantum(ParallelRunContext& ctx);
+
+// A ProcessorThread drives exactly one Processor. After each quantum all
+// ProcessorThreads meet at the barrier and the last thread to arrive decides
+// whether simulation continues, so every core observes the same decision.
+//
+class ProcessorThread : public arcsim::concurrent::Thread
+{
+public:
+  arcsim::sys::cpu::Processor&  cpu;
+  ParallelRunContext&           ctx;
+  const uint32                  turn;  // position in deterministic execution order
+  
+  bool          step_ok;    // result of last Processor run method
+  volatile int  halt_flag;  // processor local halt flag
+  
+  ProcessorThread(arcsim::sys::cpu::Processor& c, ParallelRunContext& x, uint32 t)
+  : cpu(c), ctx(x), turn(t), step_ok(!c.state.H), halt_flag(0)
+  { /* EMPTY */ }
+  
+  // A core is live as long as it has neither halted nor requested a stop
+  //
+  bool is_live() const { return step_ok && !halt_flag; }
+  
+  void run()
+  {
+    while (!ctx.done) {
+      if (ctx.deterministic) { wait_for_turn(); }
+      
+      if (is_live()) {
+        switch (ctx.mode) {
+          case System::kRunModeFast:    { step_ok = cpu.run         (ctx.quantum); break; }
+          case System::kRunModeNoTrace: { step_ok = cpu.run_notrace (ctx.quantum); break; }
+          case System::kRunModeTrace:   { step_ok = cpu.run_trace   (ctx.quantum); break; }
+        }
+      }
+      
+      if (ctx.deterministic) { pass_turn(); }
+      
+      // Last thread to arrive at the barrier evaluates the termination
+      // condition, the second barrier publishes its decision to all threads.
+      //
+      if (ctx.barrier.wait()) { end_of_quantum(ctx); }
+      ctx.barrier.wait();
+    }
+  }
+  
+private:
+  void wait_for_turn()
+  {
+    arcsim::concurrent::ScopedLock lock(ctx.turn_mtx);
+    while (ctx.turn != turn) { ctx.turn_cond.wait(ctx.turn_mtx); }
+  }
+  
+  void pass_turn()
+  {
+    arcsim::concurrent::ScopedLock lock(ctx.turn_mtx);
+    ++ctx.turn;
+    ctx.turn_cond.broadcast();
+  }
+};
+
+// Compute the length of the next quantum, honouring a user specified
+// simulation period.
+//
+static uint32
+next_quantum(ParallelRunContext& ctx)
+{
+  if (ctx.sim_opts.sim_period && ctx.period_left < ctx.sim_opts.mc_quantum)
+    return (uint32)ctx.period_left;
+  return ctx.sim_opts.mc_quantum;
+}
+
+// Called by exactly one thread between the two barriers separating
+// consecutive quanta, hence no locking is required.
+//
+static void
+end_of_quantum(ParallelRunContext& ctx)
+{
+  bool any_live = false;
+  
+  for (std::vector<ProcessorThread*>::const_iterator
+       I = ctx.threads.begin(), E = ctx.threads.end();
+       I != E; ++I)
+  {
+    const ProcessorThread& t = **I;
+    
+    // A processor that stopped without halting requested control for an
+    // external agent (e.g. IPT, SLEEP with exit-on-sleep), which stops the
+    // whole system just like it does during single-core simulation.
+    //
+    if (t.halt_flag && !t.cpu.state.H) { ctx.sim_opts.set_halt_simulation(true); }
+    
+    any_live |= t.is_live();
+  }
+  
+  if (ctx.sim_opts.sim_period) {
+    ctx.period_left -= ctx.quantum;
+    // After user specified simulation period elapsed we halt the simulation
+    if (!ctx.period_left) { ctx.sim_opts.set_halt_simulation(true); }
+  }
+  
+  ctx.done    = !any_live || ctx.sim_opts.is_halt_simulation();
+  ctx.quantum = next_quantum(ctx);
+  ctx.turn    = 0;
+}
+
 // -----------------------------------------------------------------------------
 // System Constructor
 //
@@ -217,6 +367,131 @@ System::reset_to_initial_state(bool purge_translations)
   if (ext_mem)   { ext_mem->clear();   }
 }
 
+// -----------------------------------------------------------------------------
+// Checkpointing
+//
+bool
+System::save_state (arcsim::util::CheckpointWriter& writer)
+{
+  writer.begin_section(arcsim::util::Checkpoint::kSectionSystem);
+  writer.write_value(total_cores);
+  writer.write_value(static_cast<uint32>(sizeof(cpuState)));
+  
+  for (uint32 i = 0; i < total_cores; ++i) { cpu[i]->save_checkpoint(writer); }
+  
+  if (!ext_mem->save_checkpoint(writer)) { return false; }
+  io_iom_device_manager.save_checkpoint(writer);
+  return true;
+}
+
+bool
+System::restore_state (arcsim::util::CheckpointReader& reader)
+{
+  // Validate system section before any state is modified
+  //
+  uint32 cores      = 0;
+  uint32 state_size = 0;
+  if (   !reader.expect_section(arcsim::util::Checkpoint::kSectionSystem)
+      || !reader.read_value(cores)
+      || !reader.read_value(state_size)
+      || cores      != total_cores
+      || state_size != sizeof(cpuState)) {
+    LOG(LOG_ERROR) << "Checkpoint does not match system configuration.";
+    return false;
+  }
+  
+  bool success = true;
+  for (uint32 i = 0; success && i < total_cores; ++i) {
+    success = cpu[i]->restore_checkpoint(reader);
+  }
+  success = success
+         && ext_mem->restore_checkpoint(reader)
+         && io_iom_device_manager.restore_checkpoint(reader);
+  
+  // Clear main memory model as it refers to previous memory contents
+  //
+  if (ext_mem_c) { ext_mem_c->clear(); }
+  
+  return success;
+}
+
+bool
+System::save_checkpoint (const char* path)
+{
+  arcsim::util::CheckpointWriter writer(cpu[0]->core_arch.page_arch.page_bytes);
+  
+  if (!save_state(writer)) {
+    LOG(LOG_ERROR) << "Failed to save checkpoint '" << path << "'.";
+    return false;
+  }
+  return writer.commit(path);
+}
+
+bool
+System::restore_checkpoint (const char* path)
+{
+  arcsim::util::CheckpointReader reader;
+  if (!reader.open(path)) { return false; }
+  
+  const bool success = restore_state(reader);
+  if (!success) {
+    LOG(LOG_ERROR) << "Failed to restore checkpoint '" << path << "'.";
+  } else {
+    LOG(LOG_INFO) << "Restored checkpoint '" << path << "'.";
+  }
+  return success;
+}
+
+// -----------------------------------------------------------------------------
+// Fork this system into 'count' children. The state is written once to an
+// anonymous temporary snapshot file which every child maps copy-on-write, so
+// memory pages that children only read are shared by all of them (i.e. they
+// are backed by the same host page cache pages) and a child only pays for the
+// pages it writes.
+//
+// Compiled translations are shared through the persistent translation archive
+// ('--fast-cache'), which children open separately and look up by page contents
+// (@see TranslationArchive). Each child gets a private '--fast-tmp-dir' so that
+// the sources and libraries it generates do not clash with those of its
+// siblings when they run in parallel. Without an archive translations are not
+// shared, every child compiles its hot code again.
+//
+bool
+System::fork_state (System* const children[], uint32 count)
+{
+  FILE* fd = tmpfile();
+  if (fd == 0) {
+    LOG(LOG_ERROR) << "[SYSTEM] Failed to create snapshot file for fork: '"
+                   << strerror(errno) << "'";
+    return false;
+  }
+  
+  arcsim::util::CheckpointWriter writer(cpu[0]->core_arch.page_arch.page_bytes);
+  bool success = save_state(writer) && writer.commit(fileno(fd));
+  
+  for (uint32 i = 0; success && i < count; ++i) {
+    arcsim::util::CheckpointReader reader;
+    success = (children[i] != this)
+           && reader.open(fileno(fd))
+           && children[i]->restore_state(reader);
+    if (success) {
+      std::ostringstream tmp_dir;
+      tmp_dir << sim_opts.fast_tmp_dir << "-" << children[i]->id;
+      children[i]->sim_opts.fast_tmp_dir = tmp_dir.str();
+    }
+  }
+  if (!success) {
+    LOG(LOG_ERROR) << "[SYSTEM] Failed to fork system state.";
+  } else {
+    LOG(LOG_DEBUG) << "[SYSTEM] Forked system state into '" << count << "' children.";
+  }
+  
+  // Mappings of children remain valid after the (already unlinked) file is closed
+  //
+  fclose(fd);
+  return success;
+}
+
 // Create System
 //
 void
@@ -1157,11 +1432,15 @@ bool System::run ()
     return false; 
   }
 
+  if (total_cores > 1) {
+    return run_parallel(kRunModeFast);
+  }
+
   LOG(LOG_DEBUG3) << "[SYSTEM] FAST simulation mode enabled.";
   
   cpu[0]->simulation_start();
   
-  while (stepOK && !sim_opts.halt_simulation) {
+  while (stepOK && !sim_opts.is_halt_simulation()) {
 
     if (!sim_opts.sim_period) {
       // Run for one time-slice, defined as a reasonably
@@ -1174,7 +1453,7 @@ bool System::run ()
       stepOK = cpu[0]->run (sim_opts.sim_period);
       // After user specified simulation period elapsed we halt the simulation
       //
-      sim_opts.halt_simulation = true;
+      sim_opts.set_halt_simulation(true);
     }
   }
   
@@ -1184,7 +1463,7 @@ bool System::run ()
     // CPU has halted, and therefore simulation is complete
     // temporarily we print out some statistics.
     //
-    sim_opts.halt_simulation = true;
+    sim_opts.set_halt_simulation(true);
     stepOK                   = false;
   }
 
@@ -1203,12 +1482,16 @@ bool System::run_notrace ()
     LOG(LOG_ERROR) << "[SYSTEM] No processor configured.";
     return false; 
   }
+
+  if (total_cores > 1) {
+    return run_parallel(kRunModeNoTrace);
+  }
   
   LOG(LOG_DEBUG3) << "[SYSTEM] INTERPRETIVE simulation mode enabled.";
   
   cpu[0]->simulation_start();
   
-  while (stepOK && !sim_opts.halt_simulation) {
+  while (stepOK && !sim_opts.is_halt_simulation()) {
     
     if (!sim_opts.sim_period) {
       // Run for one time-slice, defined as a reasonably large number of instructions.
@@ -1219,7 +1502,7 @@ bool System::run_notrace ()
       stepOK = cpu[0]->run_notrace (sim_opts.sim_period);
       
       // After user specified simulation period elapsed we halt the simulation
-      sim_opts.halt_simulation = true;
+      sim_opts.set_halt_simulation(true);
     }
     
   }
@@ -1230,7 +1513,7 @@ bool System::run_notrace ()
     // CPU has halted, and therefore simulation is complete
     // temporarily we print out some statistics..
     //
-    sim_opts.halt_simulation = true;
+    sim_opts.set_halt_simulation(true);
     stepOK          = false;
   }
   
@@ -1249,12 +1532,16 @@ bool System::run_trace ()
     LOG(LOG_ERROR) << "[SYSTEM] No processor configured.";
     return false; 
   }
+
+  if (total_cores > 1) {
+    return run_parallel(kRunModeTrace);
+  }
   
   LOG(LOG_DEBUG3) << "[SYSTEM] INTERPRETIVE TRACING simulation mode enabled.";
   
   cpu[0]->simulation_start();
   
-  while (stepOK && !sim_opts.halt_simulation) {
+  while (stepOK && !sim_opts.is_halt_simulation()) {
 
     if (!sim_opts.sim_period) {
       // Run for one time-slice, defined as a reasonably large number of instructions.
@@ -1266,7 +1553,7 @@ bool System::run_trace ()
       stepOK = cpu[0]->run_trace (sim_opts.sim_period);
       
       // After user specified simulation period elapsed we halt the simulation
-      sim_opts.halt_simulation = true;
+      sim_opts.set_halt_simulation(true);
     }
 
   }
@@ -1277,7 +1564,65 @@ bool System::run_trace ()
     // CPU has halted, and therefore simulation is complete
     // temporarily we print out some statistics..
     //
-    sim_opts.halt_simulation = true;
+    sim_opts.set_halt_simulation(true);
+    stepOK                   = false;
+  }
+  
+  return stepOK;
+}
+
+// Parallel multi-core simulation mode -----------------------------------------
+//
+// Every Processor executes on its own host thread. Processors share Memory and
+// the memory mapped devices, calls into devices are serialised by Memory (@see
+// Memory::register_memory_device()). Processors synchronise at a barrier after
+// each quantum, halt requests raised by other host threads (e.g. API callers)
+// take effect at the end of the current quantum. With
+// '--mc-deterministic' cores execute one after another in core order within a
+// quantum so that runs with a fixed quantum are exactly reproducible.
+//
+bool System::run_parallel (RunMode mode)
+{
+  bool stepOK = false;
+  
+  LOG(LOG_DEBUG3) << "[SYSTEM] PARALLEL simulation mode enabled for '"
+                  << total_cores << "' cores with quantum '"
+                  << sim_opts.mc_quantum << "'.";
+  
+  ParallelRunContext ctx(sim_opts, total_cores, mode);
+  ctx.quantum = next_quantum(ctx);
+  
+  // Create one host thread per processor and redirect halt requests of each
+  // processor to its thread local flag. In deterministic mode threads execute
+  // in the order of cpu[] rather than by the configured core ids, which need
+  // not be contiguous.
+  //
+  for (uint32 i = 0; i < total_cores; ++i) {
+    ProcessorThread* thread = new ProcessorThread(*cpu[i], ctx, i);
+    cpu[i]->set_halt_flag(&thread->halt_flag);
+    cpu[i]->simulation_start();
+    ctx.threads.push_back(thread);
+  }
+  
+  for (uint32 i = 0; i < total_cores; ++i) { ctx.threads[i]->start(); }
+  for (uint32 i = 0; i < total_cores; ++i) { ctx.threads[i]->join();  }
+  
+  // Restore default halt behaviour and determine overall simulation status
+  //
+  bool all_halted = true;
+  for (uint32 i = 0; i < total_cores; ++i) {
+    cpu[i]->set_halt_flag(NULL);
+    stepOK     |= ctx.threads[i]->step_ok;
+    all_halted &= (bool)cpu[i]->state.H;
+    delete ctx.threads[i];
+  }
+  
+  if (all_halted) {
+    for (uint32 i = 0; i < total_cores; ++i) { cpu[i]->simulation_end(); }
+    
+    // All CPUs have halted, and therefore simulation is complete
+    //
+    sim_opts.set_halt_simulation(true);
     stepOK                   = false;
   }
   
@@ -1357,7 +1702,7 @@ bool System::trace (UpdatePacket* deltas)
   
   // Single step simulation until it is halted/interrupted
   //
-  while (stepOK && !sim_opts.halt_simulation) {
+  while (stepOK && !sim_opts.is_halt_simulation()) {
     stepOK = cpu[0]->run_trace(1, deltas);
   }
   
@@ -1385,6 +1730,12 @@ void System::print_stats ()
              << "-----------------------------------------------------\n\n";
     cpu[id]->print_stats();
   }  
+  
+  // Print JIT translation work queue statistics
+  //
+  if (sim_opts.fast) {
+    trans_mgr.print_stats();
+  }
 }
 
 // Dump processor state to stdout
@@ -1514,19 +1865,32 @@ System::start_simulation(int argc, char *argv[])
   //FIXME: We should probably actually simulate a psuedo jump instruction on exception/interrupt entry
   if(!sim_opts.emulate_traps && cpu[0]->sys_arch.isa_opts.new_interrupts) cpu[0]->reset();
   
+  // Restore checkpoint on top of loaded target
+  if (success && !sim_opts.checkpoint_restore_file.empty()) {
+    success = restore_checkpoint(sim_opts.checkpoint_restore_file.c_str());
+  }
+  
   // We know if the target is loaded successfully at this point
   if (success) {        
-    if (sim_opts.interactive) { // Run interactive command line simulation
+    if (!sim_opts.trace_render_file.empty()) { // Render binary trace
+      success = render_binary_trace(sim_opts.trace_render_file.c_str());
+      
+    } else if (sim_opts.interactive) { // Run interactive command line simulation
       for (bool active = true; active; )
         active = interact();
       
     } else {                    // Run standard simulation
-      for (bool active = true; active && !sim_opts.halt_simulation ; )
+      for (bool active = true; active && !sim_opts.is_halt_simulation() ; )
         active = simulate();
       
     }    
   }
   
+  // Save checkpoint of state the simulation stopped in
+  if (success && !sim_opts.checkpoint_save_file.empty()) {
+    save_checkpoint(sim_opts.checkpoint_save_file.c_str());
+  }
+  
   if (sim_opts.dump_state) dump_state();
   
   return success;
@@ -1538,9 +1902,9 @@ System::start_simulation(int argc, char *argv[])
 bool System::simulate ()
 {
   bool status              = false;
-  sim_opts.halt_simulation = false;
+  sim_opts.set_halt_simulation(false);
   
-  cpu[0]->simulation_continued();
+  for (uint32 i = 0; i < total_cores; ++i) { cpu[i]->simulation_continued(); }
   
   if (sim_opts.fast) {             // Fast simulation using JIT DBT
     status = run ();  
@@ -1550,18 +1914,50 @@ bool System::simulate ()
     status = run_notrace ();
   }
   
-  cpu[0]->simulation_stopped();
+  for (uint32 i = 0; i < total_cores; ++i) { cpu[i]->simulation_stopped(); }
   
   return status;
 }
 
+// -----------------------------------------------------------------------------
+// Render binary trace file. The target must be loaded so that symbols can be
+// looked up, and the ISA options must match the traced simulation so that
+// instructions are disassembled the same way.
+//
+bool System::render_binary_trace (const char* trace_file)
+{
+  FILE* fd = fopen(trace_file, "rb");
+  if (fd == 0) {
+    LOG(LOG_ERROR) << "Could not open binary trace file '" << trace_file << "'.";
+    return false;
+  }
+  
+  bool success = true;
+  arcsim::util::BinaryTraceReader reader(fd);
+  while (success && reader.next_chunk()) {
+    if (reader.get_core_id() >= total_cores) {
+      LOG(LOG_ERROR) << "Binary trace refers to unknown core '" << reader.get_core_id() << "'.";
+      success = false;
+    } else {
+      success = cpu[reader.get_core_id()]->trace_render(reader);
+    }
+  }
+  if (reader.has_error()) { success = false; }
+  if (!success) {
+    LOG(LOG_ERROR) << "Binary trace file '" << trace_file << "' is corrupt.";
+  }
+  
+  fclose(fd);
+  return success;
+}
+
 // -----------------------------------------------------------------------------
 // Interactive Simulation
 //
 bool System::interact ()
 {
   bool ret                 = true;
-  sim_opts.halt_simulation = false;
+  sim_opts.set_halt_simulation(false);
   
   fflush (stderr);
   fflush (stdout);
@@ -1577,9 +1973,9 @@ bool System::interact ()
     
     if (!strncmp (lbuf, "cont", 4) ) {
       bool simOk                             = true;
-      sim_opts.halt_simulation = false;
+      sim_opts.set_halt_simulation(false);
 
-      while (simOk && !sim_opts.halt_simulation) {
+      while (simOk && !sim_opts.is_halt_simulation()) {
         simOk = simulate();
       }
     }
@@ -1751,7 +2147,7 @@ bool System::interact ()
     
     if (!strncmp(lbuf, "quit", 4)) {
       cpu[0]->simulation_end();
-      sim_opts.halt_simulation = true;
+      sim_opts.set_halt_simulation(true);
       sim_opts.interactive = false;
       ret = false;
     }
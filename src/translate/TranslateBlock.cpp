@@ -32,6 +32,7 @@
 //
 // =====================================================================
 
+#include <cstddef>
 #include <cstdlib>
 #include <iomanip>
 #include <cstdio>
@@ -59,6 +60,7 @@
 #include "translate/TranslationRuntimeApi.h"
 #include "translate/TranslationEmit.h"
 #include "translate/TranslationWorkUnit.h"
+#include "translate/TranslationModule.h"
 #include "translate/TranslationWorker.h"
 
 #include "util/CodeBuffer.h"
@@ -180,7 +182,7 @@ namespace arcsim {
     E("\ts->D = 1;\n");                                                         \
     if (sim_opts.show_profile) {                                                \
       E_COMMENT("\t// -- DSLOT COUNTER UPDATE\n");                              \
-      E("\t++(*((uint64 * const)(%#p)));\n", work_unit.cpu->cnt_ctx.dslot_inst_count.get_ptr());\
+      E("\t++(*(s->dslot_inst_count));\n");                                     \
     }                                                                           \
     is_in_dslot = true;                                                         \
   }                                                                             \
@@ -243,8 +245,8 @@ namespace arcsim {
 // Macro updating memory models
 //
 #define E_MEMORY_MODEL_ACCESS(_inst_,_addr_str_)                                \
-  { if (sim_opts.memory_sim) {                                                  \
-      if (sim_opts.cycle_sim) {  E("\tmc = ");  }                               \
+  { if (sim_opts.is_jit_memory_sim()) {                                         \
+      if (sim_opts.is_jit_cycle_sim()) {  E("\tmc = ");  }                      \
       work_unit.cpu->mem_model->jit_emit_instr_memory_access(buf,_inst_, _addr_str_);\
     }\
   }
@@ -262,14 +264,14 @@ namespace arcsim {
 // At the end of each block we commit the full pipeline state
 //
 #define E_PIPELINE_COMMIT                                                       \
-  if (sim_opts.cycle_sim) {                                                     \
+  if (sim_opts.is_jit_cycle_sim()) {                                            \
     pipeline.jit_emit_block_end(buf, work_unit.cpu->cnt_ctx, sim_opts, work_unit.cpu->sys_arch.isa_opts);\
   }
 
 // Emitted after each translated instruction
 //
 #define E_PIPELINE_UPDATE                                                 \
-  if (sim_opts.cycle_sim) {                                               \
+  if (sim_opts.is_jit_cycle_sim()) {                                      \
     pipeline.jit_emit_instr_pipeline_update(buf, inst,                    \
                                             SRC1_EXPR, SRC2_EXPR,         \
                                             DST1_EXPR, DST2_EXPR);        \
@@ -279,14 +281,14 @@ namespace arcsim {
 // Emitted after cycle-approximate update, when a branch has been taken
 //
 #define E_TAKEN_BRANCH(_pc)                                               \
-  if (sim_opts.cycle_sim) {                                               \
+  if (sim_opts.is_jit_cycle_sim()) {                                      \
     pipeline.jit_emit_instr_branch_taken(buf, inst, _pc);                 \
   }
 
 // Emitted after cycle-approximate update, when a branch has been not-taken
 //
 #define E_NON_TAKEN_BRANCH(_pc)                                           \
-  if (sim_opts.cycle_sim) {                                               \
+  if (sim_opts.is_jit_cycle_sim()) {                                      \
     pipeline.jit_emit_instr_branch_not_taken(buf,inst, _pc);              \
   }
 
@@ -426,11 +428,60 @@ namespace arcsim {
       
 #define E_TRANS_INSNS_UPDATE(_count)                                            \
   { if (_count) {                                                               \
-      E("\t*((uint64 * const)(%#p)) += %u;\n",                                  \
-                  work_unit.cpu->cnt_ctx.native_inst_count.get_ptr() , _count); \
+      E("\t*(s->native_inst_count) += %u;\n", _count);                          \
     }                                                                           \
   }
 
+// Jump to block '_unit_' of this translation unit if it is the next block.
+// Off-page blocks of a region are only entered while their page has not been
+// written since the region was formed and, with an MMU, while the translation
+// cache has not been purged (i.e. the virtual to physical mapping may differ).
+//
+#define E_GOTO_BLOCK(_unit_)                                                    \
+  { const TranslationBlockUnit& u = (_unit_);                                   \
+    if (!u.is_off_page()) {                                                     \
+      E("\tif (%s == 0x%08x) { goto BLK_0x%08x; }\n",                           \
+        kSymPc, u.entry_.virt_addr, u.entry_.virt_addr);                        \
+    } else {                                                                    \
+      E("\tif (%s == 0x%08x) {\n", kSymPc, u.entry_.virt_addr);                 \
+      E("\t\tif ((*((const uint32 * const)(%#p)) == %#x)",                      \
+        u.region_guard_, u.region_generation_);                                 \
+      if (work_unit.cpu->core_arch.mmu_arch.is_configured) {                    \
+        E(" && (s->trans_cache_epoch == %#x)", work_unit.region_epoch);         \
+      }                                                                         \
+      E(") {\n");                                                               \
+      E("\t\t\t++(*(s->region_transfer_count)); goto BLK_0x%08x;\n",           \
+        u.entry_.virt_addr);                                                    \
+      E("\t\t}\n");                                                             \
+      E("\t\t++(*(s->region_guard_fail_count));\n");                            \
+      E("\t}\n");                                                               \
+    }                                                                           \
+  }
+
+// Chain to the translations of the following blocks as long as the processor's
+// TranslationCache holds them, instead of returning to the main simulation loop.
+// Only the outermost translation runs the chain loop, translations it calls
+// see 'trans_chain_active' set and return, so the native call depth stays
+// constant. PCL is updated before each chained block as Processor::run_jit()
+// does, trace sequences are reset once by the processor when the outermost
+// translation returns (no blocks are traced while the chain runs).
+//
+#define E_CHAIN_NEXT_BLOCK                                                      \
+  { E("\tif (!s->trans_chain_active) {\n");                                      \
+    E("\t\ts->trans_chain_active = 1;\n");                                      \
+    E("\t\twhile ((s->iterations & %#x) && (s->pending_actions == kPendingAction_NONE)) {\n",\
+      TranslationCache::kChainIterationMask);                                   \
+    E("\t\t\tconst char * const e = s->trans_cache_entries + ((s->pc >> 1) & s->trans_cache_mask) * %u;\n",\
+      (uint32)sizeof(TranslationCache::Entry));                                 \
+    E("\t\t\tif (*((const uint32 *)e) != s->pc) { break; }\n");                \
+    E("\t\t\ts->gprs[%d] = s->pc & 0xfffffffc;\n", PCL_REG);                     \
+    E("\t\t\t(*((void (* const *)(cpuState * const))(e + %u)))(s);\n",         \
+      (uint32)offsetof(TranslationCache::Entry, code_));                        \
+    E("\t\t}\n");                                                               \
+    E("\t\ts->trans_chain_active = 0;\n");                                      \
+    E("\t}\n");                                                                 \
+  }
+
 // =====================================================================
 // Prototypes
 // =====================================================================
@@ -495,25 +546,28 @@ TranslationWorker::translate_work_unit_to_c (const TranslationWorkUnit& work_uni
   // blocks contained in this translation work unit
   const std::list<TranslationBlockUnit*>& blocks = work_unit.blocks;
   
-  // OPEN SCOPE - kCompilationModePageControlFlowGraph
+  // OPEN SCOPE - kCompilationModePageControlFlowGraph, kCompilationModeRegion
   //
-  if (sim_opts.fast_trans_mode == kCompilationModePageControlFlowGraph) {
+  if (   sim_opts.fast_trans_mode == kCompilationModePageControlFlowGraph
+      || sim_opts.fast_trans_mode == kCompilationModeRegion) {
     // Emit header for translation function
     TranslationEmit::block_signature(buf, blocks.front()->entry_.virt_addr);
     // Emit local variables in translation function
     E("\tuint32 t1, t2, reg1, maddr, wdata0, wdata1, pc_t, mask, commit; char shift;\n");
 #ifdef CYCLE_ACC_SIM
-    if (sim_opts.cycle_sim) {
+    if (sim_opts.is_jit_cycle_sim()) {
       pipeline.jit_emit_block_begin(buf,work_unit.cpu->cnt_ctx, sim_opts, work_unit.cpu->sys_arch.isa_opts);      
     }
 #endif /* CYCLE_ACC_SIM */
 
     // JUMP TABLE: @see: http://blog.llvm.org/2010/01/address-of-label-and-indirect-branches.html#more
+    // NOTE: Off-page blocks of a region are never entry points of the translation
     //
     if (blocks.size() > 1) {
       E("\tswitch (s->pc) {\n");
         for (std::list<TranslationBlockUnit*>::const_iterator I = blocks.begin(), E = blocks.end();
              I != E; ++I) {
+          if ((*I)->is_off_page()) continue;
           E("\t\tcase 0x%08x: goto BLK_0x%08x;\n", (*I)->entry_.virt_addr, (*I)->entry_.virt_addr);
         }
       E("\t}\n");
@@ -536,7 +590,7 @@ TranslationWorker::translate_work_unit_to_c (const TranslationWorkUnit& work_uni
       // Emit local variables in translation function
       E("\tuint32 t1, t2, reg1, maddr, wdata0, wdata1, pc_t, mask, commit; char shift;\n");
 #ifdef CYCLE_ACC_SIM
-      if (sim_opts.cycle_sim) {
+      if (sim_opts.is_jit_cycle_sim()) {
         pipeline.jit_emit_block_begin(buf, work_unit.cpu->cnt_ctx, sim_opts, work_unit.cpu->sys_arch.isa_opts);
       }
 #endif /* CYCLE_ACC_SIM */
@@ -577,6 +631,13 @@ TranslationWorker::translate_work_unit_to_c (const TranslationWorkUnit& work_uni
     E_COMMENT("\t// -- BEGIN BLOCK BLK_0x%08x\n", block.entry_.virt_addr);
     E("BLK_0x%08x:\n", block.entry_.virt_addr);
     
+    // Count executions of baseline code so hot modules can be recompiled
+    //
+    if (work_unit.module->is_baseline()) {
+      E("\tif (++*((uint32 * const)(%#p)) == %u) { __sync_fetch_and_or(&s->pending_actions, kPendingAction_TIER_UP); }\n",
+        &block.entry_.native_count, sim_opts.fast_tier_up_threshold);
+    }
+    
     // Assign PC to be start of block
     //
     pc_cur = block.entry_.virt_addr;
@@ -785,17 +846,17 @@ TranslationWorker::translate_work_unit_to_c (const TranslationWorkUnit& work_uni
         is_conditional_result_stored = true;
       }
       
-      if (sim_opts.memory_sim){
+      if (sim_opts.is_jit_memory_sim()){
         
         // Variable to store fetch latency when cycle accurate simulation is enabled
         //
-        if (sim_opts.cycle_sim) { E("\tfc = "); }
+        if (sim_opts.is_jit_cycle_sim()) { E("\tfc = "); }
 
         // Emit code that fetches instruction
         work_unit.cpu->mem_model->jit_emit_instr_memory_fetch(buf,inst,pc_cur);
         
 #ifdef CYCLE_ACC_SIM
-        if (sim_opts.cycle_sim) {
+        if (sim_opts.is_jit_cycle_sim()) {
           // Emit code at the beginning of an instruction
           pipeline.jit_emit_instr_begin(buf, inst, pc_cur, work_unit.cpu->cnt_ctx, sim_opts);      
         }
@@ -965,7 +1026,7 @@ TranslationWorker::translate_work_unit_to_c (const TranslationWorkUnit& work_uni
               E("\ts->D = 1;\n");
               if (sim_opts.show_profile) {
                 E_COMMENT("\t// -- DSLOT COUNTER UPDATE\n")
-                E("\t++(*((uint64 * const)(%#p)));\n", work_unit.cpu->cnt_ctx.dslot_inst_count.get_ptr());
+                E("\t++(*(s->dslot_inst_count));\n");
               }
             } else {
               if (target_reg != kSymPc)
@@ -998,7 +1059,7 @@ TranslationWorker::translate_work_unit_to_c (const TranslationWorkUnit& work_uni
               E("\ts->D = 1;\n");
               if (sim_opts.show_profile) {
                 E_COMMENT("\t// -- DSLOT COUNTER UPDATE\n")
-                E("\t++(*((uint64 * const)(%#p)));\n", work_unit.cpu->cnt_ctx.dslot_inst_count.get_ptr());
+                E("\t++(*(s->dslot_inst_count));\n");
               }
             } else {
               if (target_reg != kSymPc)
@@ -3097,7 +3158,7 @@ TranslationWorker::translate_work_unit_to_c (const TranslationWorkUnit& work_uni
             }
             
                 E("\t\ts->auxs[%d] &= 0x9fffffff;\n", AUX_DEBUG);
-                E("\t\ts->pending_actions |= kPendingAction_CPU;\n");
+                E("\t\t__sync_fetch_and_or(&s->pending_actions, kPendingAction_CPU);\n");
               E("\t} else {\n");
                 E("\t\tcpuHalt(%s);\n", kSymCpuContext);
                 E_TRANS_INSNS_UPDATE(block_insns)
@@ -3877,7 +3938,7 @@ TranslationWorker::translate_work_unit_to_c (const TranslationWorkUnit& work_uni
 #ifdef CYCLE_ACC_SIM
       // Cycle Approx Pipeline
       //
-      if (sim_opts.cycle_sim) {
+      if (sim_opts.is_jit_cycle_sim()) {
         if (!pipeline_updated) {
           E_PIPELINE_UPDATE
         }
@@ -4073,9 +4134,7 @@ TranslationWorker::translate_work_unit_to_c (const TranslationWorkUnit& work_uni
     // Timer expiry check, used only when cycle-accurate mode is disabled.
     //
     if (check_inst_timer) {
-      E("\tif (((*((uint64 * const)(%#p))) + (*((uint64 * const)(%#p)))) >= s->timer_expiry) cpuTimerSync(%s);\n",
-        work_unit.cpu->cnt_ctx.native_inst_count.get_ptr(),
-        work_unit.cpu->cnt_ctx.interp_inst_count.get_ptr(),
+      E("\tif ((*(s->native_inst_count) + *(s->interp_inst_count)) >= s->timer_expiry) cpuTimerSync(%s);\n",
         kSymCpuContext);
     }
     
@@ -4085,13 +4144,14 @@ TranslationWorker::translate_work_unit_to_c (const TranslationWorkUnit& work_uni
     //
     switch (sim_opts.fast_trans_mode) {
         
-      // kCompilationModePageControlFlowGraph
+      // kCompilationModePageControlFlowGraph, kCompilationModeRegion
       //    We need to determine where to go after this block. This means
       //    we need to emit code that performs the necessary jumps to target
       //    blocks for direct and indirect control transfers if the jumps
       //    are within this translation unit.
       //
       case kCompilationModePageControlFlowGraph:
+      case kCompilationModeRegion:
       { 
         // Emit dynamic check that determines if we should leave native mode
         // and return to the interpreter by conducting the following checks: 
@@ -4117,8 +4177,7 @@ TranslationWorker::translate_work_unit_to_c (const TranslationWorkUnit& work_uni
             if (   b.virt_addr == direct_block_control_transfer_target_addr
                 || b.virt_addr == direct_block_control_transfer_fall_through_addr)
             {
-              E("\tif (%s == 0x%08x) { goto BLK_0x%08x; }\n",
-                kSymPc, b.virt_addr, b.virt_addr);
+              E_GOTO_BLOCK(**I)
             }
           }            
         }
@@ -4133,8 +4192,11 @@ TranslationWorker::translate_work_unit_to_c (const TranslationWorkUnit& work_uni
             for (std::list<arcsim::profile::BlockEntry*>::const_iterator I = block.edges_.begin(),
                   E = block.edges_.end(); I != E; ++I)
             {
-              E("\tif (%s == 0x%08x) { goto BLK_0x%08x; }\n",
-                kSymPc, (*I)->virt_addr, (*I)->virt_addr);
+              for (std::list<TranslationBlockUnit*>::const_iterator U = blocks.begin(), UE = blocks.end();
+                   U != UE; ++U)
+              {
+                if (&(*U)->entry_ == *I) { E_GOTO_BLOCK(**U) break; }
+              }
             } 
           }
         }
@@ -4154,8 +4216,7 @@ TranslationWorker::translate_work_unit_to_c (const TranslationWorkUnit& work_uni
               if (b.virt_addr == ZOL->second) {
                 E_COMMENT("\t// == ZOL LOOPBACK CHECK\n");
                 // emit direct jump if ZOL loop back PC is within translation work unit
-                E("\tif (%s == 0x%08x) { goto BLK_0x%08x; }\n",
-                  kSymPc, b.virt_addr, b.virt_addr);
+                E_GOTO_BLOCK(**I)
                 // return early if loop back pc has been found
                 break;  
               }
@@ -4167,6 +4228,10 @@ TranslationWorker::translate_work_unit_to_c (const TranslationWorkUnit& work_uni
         //
         E_PIPELINE_COMMIT
         
+        // Chain to translation of next block outside of this translation unit
+        //
+        E_CHAIN_NEXT_BLOCK
+        
         // End of block return - if the previously emitted code didn't figure out where
         // to jump to, then return to main simulation loop.
         //
@@ -4186,6 +4251,10 @@ TranslationWorker::translate_work_unit_to_c (const TranslationWorkUnit& work_uni
         // Update Pipeline
         //
         E_PIPELINE_COMMIT
+        
+        // Chain to translation of next block
+        //
+        E_CHAIN_NEXT_BLOCK
         break;
       }
     }
@@ -4198,16 +4267,18 @@ TranslationWorker::translate_work_unit_to_c (const TranslationWorkUnit& work_uni
 
   } /* END ITERATE OVER ALL BLOCKS IN PATH */
 
-  // CLOSE SCOPE - kCompilationModePageControlFlowGraph
+  // CLOSE SCOPE - kCompilationModePageControlFlowGraph, kCompilationModeRegion
   //
-  if (sim_opts.fast_trans_mode == kCompilationModePageControlFlowGraph) {
+  if (   sim_opts.fast_trans_mode == kCompilationModePageControlFlowGraph
+      || sim_opts.fast_trans_mode == kCompilationModeRegion) {
     E("}\n");
   }      
   
   // Check for code buffer overflow
   if (buf.is_full()) {
+    ++size_reject_count_;
     LOG(LOG_ERROR) << "[TW" << worker_id << "] Maximum tranlsation unit size of '"
-                   << buf.get_size() << "' bytes exceeded, skipping translation of trace.'";
+                   << buf.get_max_size() << "' bytes exceeded, skipping translation of trace.'";
     return false;
   }
   
@@ -0,0 +1,324 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2010 The University of Edinburgh
+//                        All Rights Reserved
+// =====================================================================
+//
+// Description:
+//
+// TranslationArchive Impl.
+//
+// =====================================================================
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include "Assertion.h"
+
+#include "concurrent/ScopedLock.h"
+
+#include "translate/TranslationArchive.h"
+
+#include "util/Log.h"
+
+namespace arcsim {
+  namespace internal {
+    namespace translate {
+
+      // Archive format identification, bump kArchiveVersion whenever the
+      // layout of the archive or the generated code changes incompatibly
+      //
+      static const char   kArchiveMagic[8] = { 'A','R','C','S','I','M','T','A' };
+      static const uint32 kArchiveVersion  = 4;
+
+      struct ArchiveHeader {
+        char    magic[8];
+        uint32  version;
+        uint32  reserved;
+      };
+
+      struct EntryHeader {
+        uint64  key;
+        uint64  size;
+      };
+
+      // Entries are aligned to 8 bytes
+      //
+      static inline uint64 align_entry(uint64 size) { return (size + 7) & ~7ULL; }
+
+      // Write 'len' bytes, retrying on partial writes
+      //
+      static bool write_fully(int fd, const void* buf, size_t len, off_t off)
+      {
+        const char* p = static_cast<const char*>(buf);
+        while (len > 0) {
+          ssize_t n = (off < 0) ? ::write(fd, p, len) : ::pwrite(fd, p, len, off);
+          if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+          }
+          p   += n;
+          len -= n;
+          if (off >= 0) off += n;
+        }
+        return true;
+      }
+
+
+      // Constructor
+      //
+      TranslationArchive::TranslationArchive()
+      : fd_(-1),
+        base_(0),
+        map_size_(0),
+        end_(sizeof(ArchiveHeader)),
+        hit_count_(0),
+        miss_count_(0),
+        insert_count_(0)
+      { /* EMPTY */ }
+
+      // Destructor
+      //
+      TranslationArchive::~TranslationArchive()
+      {
+        close();
+      }
+
+      uint64
+      TranslationArchive::compute_key(const char* buf, size_t len, uint64 seed)
+      {
+        uint64 key = seed;
+        for (size_t i = 0; i < len; ++i) {
+          key ^= static_cast<uint8>(buf[i]);
+          key *= 0x100000001b3ULL;  // FNV-1a prime
+        }
+        return key;
+      }
+
+      bool
+      TranslationArchive::open(const std::string& path)
+      {
+        arcsim::concurrent::ScopedLock lock(mtx_);
+        struct stat status;
+
+        if (fd_ >= 0) { return false; }
+
+        if ((fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644)) < 0) {
+          LOG(LOG_ERROR) << "[TA] Failed to open translation archive '"
+                         << path << "': '" << strerror(errno) << "'";
+          return false;
+        }
+        path_ = path;
+
+        // ----------------------- FILE LOCK START -------------------------------
+        flock(fd_, LOCK_EX);
+
+        bool success = (fstat(fd_, &status) == 0);
+
+        if (success && status.st_size == 0) {            // NEW ARCHIVE
+          ArchiveHeader header;
+          memcpy(header.magic, kArchiveMagic, sizeof(header.magic));
+          header.version  = kArchiveVersion;
+          header.reserved = 0;
+          success = write_fully(fd_, &header, sizeof(header), 0);
+        } else if (success) {                            // EXISTING ARCHIVE
+          ArchiveHeader header;
+          success = (status.st_size >= (off_t)sizeof(header))
+                 && (pread(fd_, &header, sizeof(header), 0) == (ssize_t)sizeof(header))
+                 && (memcmp(header.magic, kArchiveMagic, sizeof(header.magic)) == 0)
+                 && (header.version == kArchiveVersion);
+          if (!success) {
+            LOG(LOG_WARNING) << "[TA] '" << path << "' is not a compatible translation archive.";
+          }
+        }
+
+        if (success) { success = remap(); }
+
+        flock(fd_, LOCK_UN);
+        // ----------------------- FILE LOCK END ---------------------------------
+
+        if (!success) {
+          ::close(fd_);
+          fd_ = -1;
+          return false;
+        }
+
+        LOG(LOG_DEBUG) << "[TA] Opened translation archive '" << path << "' with "
+                       << index_.size() << " entries.";
+        return true;
+      }
+
+      void
+      TranslationArchive::close()
+      {
+        arcsim::concurrent::ScopedLock lock(mtx_);
+        if (base_ != 0) {
+          munmap(base_, map_size_);
+          base_     = 0;
+          map_size_ = 0;
+        }
+        if (fd_ >= 0) {
+          ::close(fd_);
+          fd_ = -1;
+        }
+        index_.clear();
+        end_ = sizeof(ArchiveHeader);
+      }
+
+      // NOTE: Must be called with mtx_ held
+      //
+      bool
+      TranslationArchive::remap()
+      {
+        struct stat status;
+        if (fstat(fd_, &status) != 0) { return false; }
+
+        const uint64 file_size = status.st_size;
+        if (file_size <= map_size_) { return true; }
+
+        if (base_ != 0) { munmap(base_, map_size_); }
+        void* p = mmap(0, file_size, PROT_READ, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) {
+          LOG(LOG_ERROR) << "[TA] Failed to map translation archive '" << path_ << "'.";
+          base_     = 0;
+          map_size_ = 0;
+          return false;
+        }
+        base_     = static_cast<uint8*>(p);
+        map_size_ = file_size;
+
+        // Index entries that have not been seen yet. A truncated entry at the
+        // end of the archive (e.g. from a crashed process) terminates the scan
+        // and is overwritten by the next insert().
+        //
+        while (end_ + sizeof(EntryHeader) <= map_size_) {
+          EntryHeader header;
+          memcpy(&header, base_ + end_, sizeof(header));
+          const uint64 offset = end_ + sizeof(header);
+          if (offset + header.size > map_size_) { break; }
+          Location loc = { offset, header.size };
+          index_[header.key] = loc;
+          end_ = offset + align_entry(header.size);
+        }
+        return true;
+      }
+
+      bool
+      TranslationArchive::lookup(uint64 key, const std::string& path)
+      {
+        std::string object;
+        if (!lookup(key, object)) { return false; }
+
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0755);
+        if (fd < 0) {
+          LOG(LOG_ERROR) << "[TA] Failed to create '" << path << "': '" << strerror(errno) << "'";
+          return false;
+        }
+        const bool success = write_fully(fd, object.data(), object.size(), -1);
+        ::close(fd);
+        return success;
+      }
+
+      bool
+      TranslationArchive::lookup(uint64 key, std::string& object)
+      {
+        arcsim::concurrent::ScopedLock lock(mtx_);
+        if (fd_ < 0) { return false; }
+
+        std::map<uint64,Location>::const_iterator it = index_.find(key);
+        if (it == index_.end()) {
+          // Another process might have added this object in the meantime
+          //
+          remap();
+          it = index_.find(key);
+        }
+        if (it == index_.end()) {
+          ++miss_count_;
+          return false;
+        }
+
+        object.assign(reinterpret_cast<const char*>(base_ + it->second.offset), it->second.size);
+        ++hit_count_;
+        return true;
+      }
+
+      bool
+      TranslationArchive::insert(uint64 key, const std::string& path)
+      {
+        struct stat status;
+
+        // Read object into memory before touching the archive
+        //
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) { return false; }
+        if (fstat(fd, &status) != 0 || status.st_size == 0) { ::close(fd); return false; }
+
+        const uint64       size = status.st_size;
+        std::vector<char>  object(size);
+
+        bool success = true;
+        for (uint64 done = 0; success && done < size; ) {
+          ssize_t n = ::read(fd, &object[done], size - done);
+          if (n < 0 && errno == EINTR) continue;
+          success = (n > 0);
+          if (success) { done += n; }
+        }
+        ::close(fd);
+
+        return success && insert(key, &object[0], size);
+      }
+
+      bool
+      TranslationArchive::insert(uint64 key, const char* object, size_t size)
+      {
+        if (size == 0) { return false; }
+
+        std::vector<char>  entry(sizeof(EntryHeader) + align_entry(size), 0);
+        EntryHeader        header = { key, size };
+        memcpy(&entry[0], &header, sizeof(header));
+        memcpy(&entry[sizeof(header)], object, size);
+
+        arcsim::concurrent::ScopedLock lock(mtx_);
+        if (fd_ < 0) { return false; }
+
+        // ----------------------- FILE LOCK START -------------------------------
+        flock(fd_, LOCK_EX);
+
+        // Pick up entries appended by other processes, another process might
+        // even have added this very object
+        //
+        bool success = remap();
+        if (success && index_.find(key) == index_.end()) {
+          // Discard any truncated entry before appending
+          //
+          if (map_size_ > end_) { success = (ftruncate(fd_, end_) == 0); }
+          if (success) { success = write_fully(fd_, &entry[0], entry.size(), end_); }
+          if (success) {
+            // Archive shrank if we truncated it, so force a fresh mapping
+            //
+            munmap(base_, map_size_);
+            base_     = 0;
+            map_size_ = 0;
+            success   = remap();
+            ++insert_count_;
+          }
+        }
+
+        flock(fd_, LOCK_UN);
+        // ----------------------- FILE LOCK END ---------------------------------
+
+        if (!success) {
+          LOG(LOG_WARNING) << "[TA] Failed to add object to translation archive '" << path_ << "'.";
+        }
+        return success;
+      }
+
+} } } // namespace arcsim::internal::translate
@@ -103,14 +103,14 @@ TranslationEmit::emit(arcsim::util::CodeBuffer&     buf,
   
   // Emit memory model access functions
   if (success
-      && (sim_opts.memory_sim || sim_opts.cycle_sim)
+      && (sim_opts.is_jit_memory_sim() || sim_opts.is_jit_cycle_sim())
       && mem_model) {
     success = mem_model->jit_emit_memory_model_access_functions(buf, core_arch);
   }
   
   // In cycle accurate mode we need to emit pipeline update/accessor functions
   if (success
-      && sim_opts.cycle_sim
+      && sim_opts.is_jit_cycle_sim()
       && pipeline) {
     pipeline->jit_emit_translation_unit_begin(buf,cnt_ctx,sim_opts,isa_opts);
   }
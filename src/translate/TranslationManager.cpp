@@ -12,6 +12,7 @@
 // =====================================================================
 
 #include <limits.h>
+#include <stdio.h>
 
 #include "translate/TranslationManager.h"
 #include "translate/TranslationWorker.h"
@@ -120,6 +121,20 @@ namespace arcsim {
         
         worker_thread_count = _num_workers;
         
+        // Use one work queue shard per worker so workers mostly pop from
+        // their own shard
+        //
+        trans_work_unit_queue.set_shard_count(worker_thread_count);
+        
+        // Open persistent translation archive if requested. It holds LLVM
+        // bitcode or shared libraries produced by an external JIT compiler.
+        //
+        if (!sim_opts->fast_cache_file.empty() && !trans_archive.is_open()) {
+          if (!trans_archive.open(sim_opts->fast_cache_file)) {
+            LOG(LOG_WARNING) << "[TM] Persistent translation cache disabled.";
+          }
+        }
+        
         return true;
       }
       
@@ -160,50 +175,40 @@ namespace arcsim {
         //
         if (work_size == 0) { return success; }
         
-        // ---------------------------------------------------------------------------
-        // MUTEX LOCK
-        // ---------------------------------------------------------------------------
-        mutx_work_queue.acquire();
-        
         // Upon each call to this method we increment our dispatch_counter which
         // is used to indicate 'recency' of TranslationWorkUnit (i.e. largest
-        // dispatch_counter means most recent TranslationWorkUnit)
+        // dispatch_counter means most recent TranslationWorkUnit). Several
+        // processors may dispatch work concurrently so increment atomically.
         //
-        ++dispatch_counter;
+        const uint64 timestamp = __sync_add_and_fetch(&dispatch_counter, 1);
         
-        // Copy work into local priority queue, the insertion puts the hottest things
-        // to the front of the queue.
+        // Set recency of TranslationWorkUnits accordingly
         //
         for (size_t i = 0; i < work_size; ++i) {          
-          TranslationWorkUnit *twu = w[i];
-          
-          // Set recency of TranslationWorkUnit accordingly
-          //
-          twu->timestamp = dispatch_counter;
-
-          // Insert this work unit into the priority queue
-          //
-          trans_work_unit_queue.push(twu);
-
+          w[i]->timestamp = timestamp;
         }
         
+        // Copy work into shared priority queue, the insertion puts the hottest
+        // things to the front of the queue.
+        //
+        trans_work_unit_queue.push(work_size, &w[0]);
+        
         // Output how much work is being generated
         //
         LOG(LOG_DEBUG) << "[TM] Disp Traces: "
                        << work_size
                        << " Disp Inter: "
-                       << dispatch_counter
+                       << timestamp
                        << " Cur Queue Length: "
                        << trans_work_unit_queue.size();
         
-        // ---------------------------------------------------------------------------
-        // MUTEX UNLOCK
-        // ---------------------------------------------------------------------------
-        mutx_work_queue.release();
-        
-        //  Signal that there is work to-do
+        //  Signal that there is work to-do. Acquiring the MUTEX guarantees that
+        //  a worker that has just seen an empty queue is already waiting and
+        //  does not miss the signal.
         //
+        mutx_work_queue.acquire();
         cond_work_queue.broadcast();
+        mutx_work_queue.release();
 
         
 #ifdef BLOCKING_DISPATCH_TRANSLATION_WORK_UNITS
@@ -247,29 +252,17 @@ namespace arcsim {
         
         if (!keep_mode) {
           
-          // FIRST we empty the work queue, we need to acquire the MUTEX as we are
-          // modifying a shared resource
+          // FIRST we empty the work queue
           //
-          // ---------------------------------------------------------------------------
-          // MUTEX LOCK
-          // ---------------------------------------------------------------------------
-          mutx_work_queue.acquire();
-          
-          while (!trans_work_unit_queue.empty()) {
-            trans_work_unit_queue.pop();
-          }
-          // ---------------------------------------------------------------------------
-          // MUTEX UNLOCK
-          // ---------------------------------------------------------------------------
-          mutx_work_queue.release();
+          trans_work_unit_queue.clear();
           
         } else { 
           // We are in keep_mode so we need to wait for workers to finish
           //
           
           // We are in keep_mode and wait until the queue is empty so all translations
-          // get written out. We do NOT need to acquire a MUTEX as we are only reading
-          // and not modifying a shared resources.
+          // get written out. Querying the size of the queue does not require
+          // any locking.
           //
           while (!trans_work_unit_queue.empty()) {
             arcsim::util::Os::sleep_micros(1000);
@@ -328,5 +321,76 @@ namespace arcsim {
         return success;
       }
 
+      // Print translation work queue statistics
+      //
+      void
+      TranslationManager::print_stats() const
+      {
+        TranslationWorkQueue::Stats stats;
+        trans_work_unit_queue.get_stats(stats);
+        const uint64 enq_count = stats.enqueue_count;
+        const uint64 deq_count = stats.dequeue_count;
+        
+        fprintf(stderr, "\nJIT Translation Work Queue Statistics\n");
+        fprintf(stderr, "-----------------------------------------------------\n");
+        fprintf(stderr, " Queue shards:                  %llu\n", (uint64)trans_work_unit_queue.get_shard_count());
+        fprintf(stderr, " Dispatch intervals:            %llu\n", dispatch_counter);
+        fprintf(stderr, " Enqueued work units:           %llu\n", enq_count);
+        fprintf(stderr, " Dequeued work units:           %llu\n", deq_count);
+        fprintf(stderr, " Stolen work units:             %llu\n", stats.steal_count);
+        fprintf(stderr, " Contended shard accesses:      %llu\n", stats.contention_count);
+        fprintf(stderr, " Enqueue latency [us] (total):  %llu\n", stats.enqueue_micros);
+        fprintf(stderr, " Enqueue latency [us] (avg):    %.2f\n",
+                enq_count ? (double)stats.enqueue_micros / enq_count : 0.0);
+        fprintf(stderr, " Dequeue latency [us] (avg):    %.2f\n",
+                deq_count ? (double)stats.dequeue_micros / deq_count : 0.0);
+        fprintf(stderr, " Dequeue latency [us] (max):    %llu\n", stats.dequeue_max_micros);
+        fprintf(stderr, "-----------------------------------------------------\n");
+        
+        if (trans_archive.is_open()) {
+          fprintf(stderr, "\nPersistent Translation Cache Statistics\n");
+          fprintf(stderr, "-----------------------------------------------------\n");
+          fprintf(stderr, " Archive file:                  %s\n", sim_opts->fast_cache_file.c_str());
+          fprintf(stderr, " Archive entries:               %llu\n", (uint64)trans_archive.get_entry_count());
+          fprintf(stderr, " Hits:                          %llu\n", trans_archive.get_hit_count());
+          fprintf(stderr, " Misses:                        %llu\n", trans_archive.get_miss_count());
+          fprintf(stderr, " Inserted objects:              %llu\n", trans_archive.get_insert_count());
+          fprintf(stderr, "-----------------------------------------------------\n");
+        }
+        
+        // Translation latency of the C/Clang code generator
+        //
+        if (has_started && use_llvm_jit) {
+          uint64 c_micros = 0, c_insns = 0, c_modules = 0, tier_ups = 0;
+          uint64 preludes = 0, prelude_micros = 0, size_rejects = 0;
+          for (size_t i = 0; i < worker_list.size(); ++i) {
+            tier_ups  += worker_list[i]->get_tier_up_count();
+            c_micros  += worker_list[i]->get_c_trans_micros();
+            c_insns   += worker_list[i]->get_c_trans_insns();
+            c_modules += worker_list[i]->get_c_trans_modules();
+            preludes       += worker_list[i]->get_prelude_count();
+            prelude_micros += worker_list[i]->get_prelude_micros();
+            size_rejects   += worker_list[i]->get_size_reject_count();
+          }
+          fprintf(stderr, "\nJIT Translation Latency Statistics\n");
+          fprintf(stderr, "-----------------------------------------------------\n");
+          fprintf(stderr, " C/Clang instructions:          %llu\n", c_insns);
+          fprintf(stderr, " C/Clang latency [us] (total):  %llu\n", c_micros);
+          fprintf(stderr, " C/Clang latency [us/inst]:     %.2f\n",
+                  c_insns ? (double)c_micros / c_insns : 0.0);
+          fprintf(stderr, " C/Clang modules:               %llu\n", c_modules);
+          fprintf(stderr, " C/Clang latency [us/module]:   %.2f\n",
+                  c_modules ? (double)c_micros / c_modules : 0.0);
+          if (sim_opts->fast_prelude_pch) {
+            fprintf(stderr, " Precompiled preludes:          %llu\n", preludes);
+            fprintf(stderr, " Prelude latency [us] (total):  %llu\n", prelude_micros);
+          }
+          fprintf(stderr, " Rejected for size:             %llu\n", size_rejects);
+          if (sim_opts->fast_tier_up_threshold) {
+            fprintf(stderr, " Tier-up recompilations:        %llu\n", tier_ups);
+          }
+          fprintf(stderr, "-----------------------------------------------------\n");
+        }
+      }
       
 } } } // namespace arcsim::internal::translate
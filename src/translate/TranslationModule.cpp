@@ -49,7 +49,10 @@ TranslationModule::TranslationModule (uint32 key, SimOptions& sim_opts)
   module_state_(0),
   module_(0),
   engine_(0),
-  ref_count_(0)
+  ref_count_(0),
+  tier_(kTranslationTierOptimised),
+  baseline_(0),
+  tier_up_pending_(false)
 { /* EMPTY */ }
 
 TranslationModule::~TranslationModule ()
@@ -132,6 +135,67 @@ TranslationModule::add_block_entry(arcsim::profile::BlockEntry& block,
   }
 }
 
+// -----------------------------------------------------------------------------
+// Tiered compilation support
+//
+bool
+TranslationModule::is_hot(uint32 threshold) const
+{
+  for (std::map<uint32,arcsim::profile::BlockEntry*>::const_iterator
+       I = block_map_.begin(), E = block_map_.end(); I != E; ++I)
+  {
+    if (I->second->native_count >= threshold)
+      return true;
+  }
+  return false;
+}
+
+void
+TranslationModule::reset_exec_counts()
+{
+  for (std::map<uint32,arcsim::profile::BlockEntry*>::const_iterator
+       I = block_map_.begin(), E = block_map_.end(); I != E; ++I)
+  {
+    I->second->native_count = 0;
+  }
+}
+
+void
+TranslationModule::get_block_entries(std::list<arcsim::profile::BlockEntry*>& blocks) const
+{
+  for (std::map<uint32,arcsim::profile::BlockEntry*>::const_iterator
+       I = block_map_.begin(), E = block_map_.end(); I != E; ++I)
+  {
+    blocks.push_back(I->second);
+  }
+}
+
+void
+TranslationModule::stage_block_entry(arcsim::profile::BlockEntry& block,
+                                     TranslationBlock             native)
+{
+  staged_blocks_.push_back(std::make_pair(&block, native));
+}
+
+// Register staged native code. The BlockEntries must have been released by the
+// baseline module before.
+//
+int
+TranslationModule::install_staged_block_entries()
+{
+  int num_installed = 0;
+  while (!staged_blocks_.empty()) {
+    arcsim::profile::BlockEntry& b = *staged_blocks_.front().first;
+    if (b.is_not_translated()) {
+      b.mark_as_in_translation();
+      add_block_entry(b, staged_blocks_.front().second);
+      ++num_installed;
+    }
+    staged_blocks_.pop_front();
+  }
+  return num_installed;
+}
+
 // -----------------------------------------------------------------------------
 // Removes all BlockEntries and returns true if one of them was 'in translation'
 //
@@ -172,14 +236,20 @@ TranslationModule::close_shared_library ()
   return arcsim::util::system::SharedLibrary::close(module_);
 }
 
-bool
-TranslationModule::load_shared_library ()
+std::string
+TranslationModule::get_shared_library_path () const
 {
   std::string path(name_);
   
   if (!sim_opts_.keep_files)
     path.append(".tmp");
   path.append(".dll");
+  
+  return path;
+}
 
-  return arcsim::util::system::SharedLibrary::open(&module_, path);
+bool
+TranslationModule::load_shared_library ()
+{
+  return arcsim::util::system::SharedLibrary::open(&module_, get_shared_library_path());
 }
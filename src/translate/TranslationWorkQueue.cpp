@@ -0,0 +1,181 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2010 The University of Edinburgh
+//                        All Rights Reserved
+// =====================================================================
+//
+// Description:
+//
+// TranslationWorkQueue Impl.
+//
+// =====================================================================
+
+#include <cstddef>
+#include <cstring>
+
+#include "Assertion.h"
+
+#include "translate/TranslationWorkQueue.h"
+
+#include "concurrent/ScopedLock.h"
+
+#include "util/Os.h"
+
+namespace arcsim {
+  namespace internal {
+    namespace translate {
+
+      // Constructor
+      //
+      TranslationWorkQueue::TranslationWorkQueue(size_t shard_count)
+      : size_(0),
+        next_shard_(0)
+      {
+        std::memset(&stats_, 0, sizeof(stats_));
+        create_shards(shard_count);
+      }
+
+      // Destructor
+      //
+      TranslationWorkQueue::~TranslationWorkQueue()
+      {
+        destroy_shards();
+      }
+
+      void
+      TranslationWorkQueue::create_shards(size_t shard_count)
+      {
+        if (shard_count < 1) { shard_count = 1; }
+        shard_list_.resize(shard_count);
+        for (size_t i = 0; i < shard_count; ++i) {
+          shard_list_[i] = new Shard();
+        }
+      }
+
+      void
+      TranslationWorkQueue::destroy_shards()
+      {
+        for (size_t i = 0; i < shard_list_.size(); ++i) {
+          delete shard_list_[i];
+        }
+        shard_list_.clear();
+      }
+
+      void
+      TranslationWorkQueue::set_shard_count(size_t shard_count)
+      {
+        ASSERT(empty() && "Changing shard count of non-empty work queue.");
+        if (shard_count == shard_list_.size()) { return; }
+        destroy_shards();
+        create_shards(shard_count);
+      }
+
+      // Add work to the queue. Each work unit goes to the next shard in
+      // round-robin order so consecutive units can be picked up by different
+      // workers without contending for the same lock.
+      //
+      void
+      TranslationWorkQueue::push(size_t work_size, TranslationWorkUnit* const * w)
+      {
+        if (work_size == 0) { return; }
+
+        const uint64 start_time  = arcsim::util::Os::get_current_time_micros();
+        const size_t shard_count = shard_list_.size();
+        const uint32 first_shard = __sync_fetch_and_add(&next_shard_, static_cast<uint32>(work_size));
+
+        for (size_t i = 0; i < work_size; ++i) {
+          Shard& shard = *shard_list_[(first_shard + i) % shard_count];
+          Entry  entry = { w[i], start_time };
+
+          // Account for work unit before a consumer can remove it
+          //
+          shard.mtx.acquire();
+          shard.queue.push(entry);
+          __sync_fetch_and_add(&size_, 1);
+          shard.mtx.release();
+        }
+
+        const uint64 latency = arcsim::util::Os::get_current_time_micros() - start_time;
+        arcsim::concurrent::ScopedLock lock(stats_mtx_);
+        stats_.enqueue_count  += work_size;
+        stats_.enqueue_micros += latency;
+      }
+
+      // Pop work starting with our 'home' shard. The first sweep over all shards
+      // skips contended shards, the second sweep waits for shard locks.
+      //
+      TranslationWorkUnit*
+      TranslationWorkQueue::pop(size_t home)
+      {
+        const size_t shard_count = shard_list_.size();
+        const size_t first_shard = home % shard_count;
+
+        for (int sweep = 0; sweep < 2 && !empty(); ++sweep) {
+          for (size_t i = 0; i < shard_count; ++i) {
+            Shard& shard = *shard_list_[(first_shard + i) % shard_count];
+            Entry  entry;
+            if (pop_shard(shard, sweep != 0, entry)) {
+              // Record how long work unit was waiting in the queue
+              //
+              const uint64 latency = arcsim::util::Os::get_current_time_micros() - entry.enqueue_time;
+              arcsim::concurrent::ScopedLock lock(stats_mtx_);
+              ++stats_.dequeue_count;
+              stats_.dequeue_micros += latency;
+              if (latency > stats_.dequeue_max_micros) { stats_.dequeue_max_micros = latency; }
+              if (i != 0)                              { ++stats_.steal_count; }
+              return entry.unit;
+            }
+          }
+        }
+        return NULL;
+      }
+
+      bool
+      TranslationWorkQueue::pop_shard(Shard& shard, bool block, Entry& entry)
+      {
+        if (block) {
+          shard.mtx.acquire();
+        } else if (!shard.mtx.tryacquire()) {
+          arcsim::concurrent::ScopedLock lock(stats_mtx_);
+          ++stats_.contention_count;
+          return false;
+        }
+
+        if (shard.queue.empty()) {
+          shard.mtx.release();
+          return false;
+        }
+
+        // Only account for work unit once it has been removed
+        //
+        entry = shard.queue.top();
+        shard.queue.pop();
+        __sync_fetch_and_sub(&size_, 1);
+        shard.mtx.release();
+        return true;
+      }
+
+      void
+      TranslationWorkQueue::get_stats(Stats& stats) const
+      {
+        arcsim::concurrent::ScopedLock lock(stats_mtx_);
+        stats = stats_;
+      }
+
+      // Remove all work from all shards
+      //
+      void
+      TranslationWorkQueue::clear()
+      {
+        for (size_t i = 0; i < shard_list_.size(); ++i) {
+          Shard& shard = *shard_list_[i];
+          shard.mtx.acquire();
+          while (!shard.queue.empty()) {
+            shard.queue.pop();
+            __sync_fetch_and_sub(&size_, 1);
+          }
+          shard.mtx.release();
+        }
+      }
+
+} } } // namespace arcsim::internal::translate
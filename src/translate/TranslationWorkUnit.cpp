@@ -20,7 +20,9 @@
 // Explicit TranslationBlockUnit constructor
 //
 TranslationBlockUnit::TranslationBlockUnit(arcsim::profile::BlockEntry*  entry)
-  : entry_(*entry)
+  : entry_(*entry),
+    region_guard_(0),
+    region_generation_(0)
 { /* EMPTY */ }
 
 // Default TranslationBlockUnit destructor
@@ -40,17 +42,28 @@ TranslationWorkUnit::TranslationWorkUnit(arcsim::sys::cpu::Processor* _cpu,
   : cpu(_cpu),
     timestamp(_timestamp),
     exec_freq(0),
-    module(0)
+    module(0),
+    region_epoch(0)
 { /* EMPTY */ }
 
 // Default TranslationWorkUnit destructor
 //
 TranslationWorkUnit::~TranslationWorkUnit()
 { 
+  clear();
+}
+
+void
+TranslationWorkUnit::clear()
+{
   while (!blocks.empty()) {
     delete *blocks.begin();
     blocks.erase(blocks.begin());
   }
+  lp_end_to_lp_start_map.clear();
+  module       = 0;
+  exec_freq    = 0;
+  region_epoch = 0;
 }
 
 
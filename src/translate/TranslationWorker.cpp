@@ -15,10 +15,15 @@
 // =====================================================================
 
 #include <dlfcn.h>
+#include <errno.h>
 #include <limits.h>
 #include <unistd.h>
 #include <signal.h>
+#include <sys/stat.h>
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iomanip>
 #include <string>
 #include <list>
@@ -45,13 +50,16 @@
 #include "llvm/PassManager.h"
 
 #include "llvm/Module.h"
+#include "llvm/Bitcode/ReaderWriter.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
 
 #include "llvm/ADT/StringRef.h"
 
 #include "clang/Basic/TargetInfo.h"
 
 #include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendActions.h"
 #include "clang/Frontend/TextDiagnosticBuffer.h"
 
 #include "clang/Lex/Preprocessor.h"
@@ -93,6 +101,7 @@
 #include "util/system/SharedLibrary.h"
 
 #include "util/CodeBuffer.h"
+#include "util/Os.h"
 
 #include "util/Log.h"
 
@@ -109,6 +118,18 @@ namespace arcsim {
       // Static variable indicating if LLVM NativeTarget has been initiliased
       //
       static bool isNativeLlvmTargetInitialised = false;
+      
+      // Configure clang compiler instance for compiling generated C code. Module
+      // compilation and prelude precompilation MUST use the same configuration,
+      // otherwise the precompiled prelude is rejected.
+      //
+      static void configure_compiler_instance(clang::CompilerInstance& CI)
+      {
+        CI.createDiagnostics(0, 0);
+        CI.getDiagnostics().setClient(new clang::TextDiagnosticBuffer());
+        clang::CompilerInvocation::CreateFromArgs(CI.getInvocation(), 0, 0, CI.getDiagnostics());
+        CI.getInvocation().getLangOpts().C99 = 1; // set C99 standard
+      }
 
       
 // Constructor
@@ -121,10 +142,17 @@ TranslationWorker::TranslationWorker(uint32 _id, TranslationManager& _m, SimOpti
         keep_mode(_m.keep_mode),
         use_llvm_jit(_m.use_llvm_jit),
         run_state(TW_STATE_RUN),
-        work_state(TW_WORK_STATE_WAITING)
+        work_state(TW_WORK_STATE_WAITING),
+        ENG_BASELINE_(0),
+        c_trans_micros_(0),
+        c_trans_insns_(0),
+        c_trans_modules_(0),
+        tier_up_count_(0),
+        size_reject_count_(0),
+        prelude_micros_(0)
   { 
     // FIXME: @igor - make this configurable
-    code_buf_ = new arcsim::util::CodeBuffer((sim_opts.cycle_sim) ? 1024*KB : 512*KB);
+    code_buf_ = new arcsim::util::CodeBuffer((sim_opts.is_jit_cycle_sim()) ? 1024*KB : 512*KB);
 
     if (use_llvm_jit) {
       if (!llvm::llvm_is_multithreaded()) { llvm::llvm_start_multithreaded(); }
@@ -154,10 +182,7 @@ TranslationWorker::TranslationWorker(uint32 _id, TranslationManager& _m, SimOpti
       //
             
       CI_ = new clang::CompilerInstance(); // create new clang compiler instance
-      CI_->createDiagnostics(0, 0);
-      CI_->getDiagnostics().setClient(new clang::TextDiagnosticBuffer());
-      clang::CompilerInvocation::CreateFromArgs(CI_->getInvocation(), 0, 0, CI_->getDiagnostics());
-      CI_->getInvocation().getLangOpts().C99 = 1; // set C99 standard
+      configure_compiler_instance(*CI_);
       CI_->createFileManager(); // create file manager
       CI_->setTarget(clang::TargetInfo::CreateTargetInfo(CI_->getDiagnostics(),
                                                          CI_->getTargetOpts()));      
@@ -171,10 +196,23 @@ TranslationWorker::TranslationWorker(uint32 _id, TranslationManager& _m, SimOpti
                 .setJITMemoryManager(NULL)
                 .create();
       
+      // Baseline modules of tiered compilation are code generated by a separate
+      // engine that trades code quality for compilation speed
+      //
+      if (sim_opts.fast_tier_up_threshold) {
+        ENG_BASELINE_ = llvm::EngineBuilder(new llvm::Module("baseline", *CTX_))
+                          .setEngineKind(llvm::EngineKind::JIT)
+                          .setOptLevel(llvm::CodeGenOpt::None)  // -O0
+                          .setAllocateGVsWithCode(false)
+                          .setCodeModel(llvm::CodeModel::Default)
+                          .setJITMemoryManager(NULL)
+                          .create();
+      }
+      
       // Initialise the TranslationOptManager
       // FIXME: What is magic number 3, use typedefed ENUM instead
       //
-      TranslationVariant variant = (sim_opts.cycle_sim || sim_opts.memory_sim)
+      TranslationVariant variant = (sim_opts.is_jit_cycle_sim() || sim_opts.is_jit_memory_sim())
                                     ? VARIANT_CYCLE_ACCURATE
                                     : VARIANT_FUNCTIONAL;
       opt_manager.configure(3, ENG_, variant);
@@ -187,6 +225,16 @@ TranslationWorker::~TranslationWorker()
 {
   delete code_buf_; // free code generation buffer
   delete CI_; // free compiler instance
+  
+  // Remove precompiled preludes
+  //
+  for (std::map<uint64, std::string>::const_iterator I = prelude_pch_.begin(), E = prelude_pch_.end();
+       !keep_mode && I != E; ++I) {
+    if (!I->second.empty()) {
+      unlink(I->second.c_str());
+      unlink((I->second + ".pch").c_str());
+    }
+  }
   if (use_llvm_jit) {
     // Sweep release pools
     sweep_translation_work_unit_release_pool();   // GC translation work unit
@@ -195,6 +243,7 @@ TranslationWorker::~TranslationWorker()
     opt_manager.destroy();                        // destroy opt pass managers
 
     // deleting an ExecutionEngine automatically deletes all owned modules
+    delete ENG_BASELINE_;
     delete ENG_;      
     delete CTX_;
   }
@@ -221,45 +270,54 @@ TranslationWorker::run()
   for (; /* ever */ ;)
   {
     bool    success = true;
-    // Wait until there is work in the queue
+    
+    // Set our work state to busy BEFORE grabbing work so a unit that has
+    // just been removed from the queue is never mistaken for finished work
+    // (@see TranslationManager::stop_workers())
     //
-    mgr.mutx_work_queue.acquire();
-
-    while (mgr.trans_work_unit_queue.empty()) {
-      // Check if we should stop
-      // NOTE: This only breaks out of the 'while' loop. That is why we need to
-      //       check after the 'while' loop again to break out of outer 'for' loop.
+    work_state = TW_WORK_STATE_BUSY;
+    __sync_synchronize();
+    
+    // Pop off next work item, this does not require the global MUTEX
+    //
+    TranslationWorkUnit* work_unit = mgr.trans_work_unit_queue.pop(worker_id);
+    
+    if (work_unit == NULL) {
+      work_state = TW_WORK_STATE_WAITING;
+      
+      // Wait until there is work in the queue
       //
-      if (run_state == TW_STATE_STOP)
-        break;
+      mgr.mutx_work_queue.acquire();
       
-      // If queue is empty go to sleep and wait for signal
+      while (mgr.trans_work_unit_queue.empty()) {
+        // Check if we should stop
+        // NOTE: This only breaks out of the 'while' loop. That is why we need to
+        //       check after the 'while' loop again to break out of outer 'for' loop.
+        //
+        if (run_state == TW_STATE_STOP)
+          break;
+        
+        // If queue is empty go to sleep and wait for signal
+        //
+        mgr.cond_work_queue.wait(mgr.mutx_work_queue);
+      }
+      
+      mgr.mutx_work_queue.release();
+      
+      // Check if we should stop, otherwise try to grab work again
       //
-      mgr.cond_work_queue.wait(mgr.mutx_work_queue);
-
+      if (run_state == TW_STATE_STOP)
+        break;
+      continue;
     }
+    
     // Check if we should stop
-    // NOTE: If state was changed to STOP we need to release the MUTEX and break
-    //       out of the 'for' loop.
     //
     if (run_state == TW_STATE_STOP) {
-      mgr.mutx_work_queue.release();
+      mark_translation_work_unit_for_gc(work_unit); // mark work unit for GC  
       break;
     }
         
-    // Pop off next work item
-    //
-    TranslationWorkUnit* work_unit = mgr.trans_work_unit_queue.top();
-    mgr.trans_work_unit_queue.pop();
-    
-    // Once we have grabbed some work set our work state to busy
-    //
-    work_state = TW_WORK_STATE_BUSY;
-    
-    // Release mutex as quickly as possible
-    //
-    mgr.mutx_work_queue.release();
-        
     // Perform translations
     //
     code_buf_->clear(); // clear code buffer for code generation
@@ -290,6 +348,15 @@ TranslationWorker::run()
       }
     }
     
+    // A failed optimised replacement module is dropped by the processor owning
+    // it, which then allows its baseline module to be recompiled
+    //
+    if (!success && work_unit->module->get_baseline() != 0) {
+      work_unit->module->lock();
+      work_unit->module->mark_as_failed();
+      work_unit->module->unlock();
+    }
+    
     mark_translation_work_unit_for_gc(work_unit); // mark work unit for GC  
     sweep_translation_work_unit_release_pool();   // GC translation work unit
     sweep_module_release_pool();                  // GC machine code
@@ -338,12 +405,13 @@ TranslationWorker::sweep_module_release_pool()
     // GC generated machine code for Module functions and remove llvm::Module
     //
     llvm::Module* m = reinterpret_cast<llvm::Module*>(*mod_release_pool_.begin());
+    llvm::ExecutionEngine* engine = baseline_modules_.erase(m) ? ENG_BASELINE_ : ENG_;
     
     for (llvm::Module::iterator I = m->getFunctionList().begin(), E = m->getFunctionList().end();
          I != E; ++I) {
-      ENG_->freeMachineCodeForFunction(I);
+      engine->freeMachineCodeForFunction(I);
     }
-    ENG_->removeModule(m);
+    engine->removeModule(m);
     LOG(LOG_DEBUG1) << "[TW" << worker_id << "] GC Module '" << m->getModuleIdentifier() << "'.";
     delete m;
     mod_release_pool_.erase(mod_release_pool_.begin());
@@ -380,44 +448,347 @@ TranslationWorker::sweep_translation_work_unit_release_pool()
 bool
 TranslationWorker::translate_module(const TranslationWorkUnit& wu)
 {
-  bool success          = true;
-  
-  // Emit the header and local functions for this translation unit
-  success = TranslationEmit::emit(*code_buf_,
-                                  sim_opts,
-                                  wu.cpu->sys_arch.isa_opts,
-                                  wu.cpu->core_arch,
-                                  wu.cpu->mem,
-                                  wu.cpu->mem_model,
-                                  wu.cpu->pipeline,
-                                  wu.cpu->cnt_ctx);
-  if (!success) return false;
+  bool         success    = true;
+  const uint64 start_time = arcsim::util::Os::get_current_time_micros();
   
-  // Emit translated blocks for this translation unit
-  success = translate_work_unit_to_c(wu);
+  // Modules found in the persistent translation archive need no code
+  // generation at all, so probe the archive first
+  //
+  TranslationArchive& archive  = mgr.trans_archive;
+  const bool          archived = archive.is_open() && is_archivable(wu);
+  uint64              key      = 0;
+  
+  if (archived) {
+    key = archive_key(wu);
+    if (load_archived_module(wu, key)) {
+      LOG(LOG_DEBUG) << "[TW" << worker_id << "] JIT: archive HIT for '" << wu.module->get_id() << "'";
+      return true;
+    }
+  }
+  
+  // Count instructions so translation latency can be reported per instruction
+  //
+  uint64 insns = 0;
+  for (std::list<TranslationBlockUnit*>::const_iterator I = wu.blocks.begin(), E = wu.blocks.end();
+       I != E; ++I) {
+    insns += (*I)->get_instruction_count();
+  }
+  
+  // Emit C code for this translation unit
+  std::string pch;
+  success = emit_module_source(wu, pch);
   if (!success) return false;            
   
   // Compile translation unit
-  if (use_llvm_jit)   { success = compile_module_llvm  (*wu.module); }
-  else if (debug_mode){ success = compile_module_system(*wu.module); }
-  else                { success = compile_module_popen (*wu.module); }
+  if (use_llvm_jit) {
+    bool pch_failed = false;
+    success = compile_module_llvm(*wu.module, pch, pch_failed);
+    if (pch_failed) {
+      // The precompiled prelude has been dropped, hence emit the prelude again
+      // and retry once
+      code_buf_->clear();
+      success = emit_module_source(wu, pch)
+             && compile_module_llvm(*wu.module, pch, pch_failed);
+    }
+    c_trans_micros_ += arcsim::util::Os::get_current_time_micros() - start_time;
+    c_trans_insns_  += insns;
+    ++c_trans_modules_;
+  } else if (debug_mode) {
+    success = compile_module_system(*wu.module);
+  } else {
+    success = compile_module_popen (*wu.module);
+  }
+  
+  if (success && archived) { archive_module(wu, key); }
   
   return success;
 }
 
+// Emit the header and local functions, followed by the translated blocks of a
+// translation unit
+//
+bool
+TranslationWorker::emit_module_source(const TranslationWorkUnit& wu, std::string& pch)
+{
+  pch.clear();
+  bool success = TranslationEmit::emit(*code_buf_,
+                                       sim_opts,
+                                       wu.cpu->sys_arch.isa_opts,
+                                       wu.cpu->core_arch,
+                                       wu.cpu->mem,
+                                       wu.cpu->mem_model,
+                                       wu.cpu->pipeline,
+                                       wu.cpu->cnt_ctx);
+  if (!success) return false;
+  
+  // With a precompiled prelude only the translated blocks need to be parsed
+  if (use_llvm_jit && sim_opts.fast_prelude_pch && get_prelude_pch(pch)) {
+    code_buf_->clear();
+  }
+  
+  // Emit translated blocks for this translation unit
+  return translate_work_unit_to_c(wu);
+}
+
+// Translated code reaches counters and caches through cpuState (@see state.def),
+// the remaining features listed here still embed host addresses (i.e. histogram
+// bins, EIA extension objects, pipeline counters, tier-up counters and region
+// guards) or depend on run-time state (i.e. IPT hooks) that is not part of the
+// archive key.
+//
+bool
+TranslationWorker::is_archivable(const TranslationWorkUnit& wu) const
+{
+  return !wu.module->is_baseline()
+      && (sim_opts.fast_trans_mode != kCompilationModeRegion)
+      && !sim_opts.show_profile
+      && !sim_opts.is_pc_freq_recording_enabled
+      && !sim_opts.is_limm_freq_recording_enabled
+      && !sim_opts.is_killed_recording_enabled
+      && !sim_opts.is_dkilled_recording_enabled
+      && !sim_opts.is_call_freq_recording_enabled
+      && !sim_opts.is_call_graph_recording_enabled
+      && !sim_opts.is_jit_cycle_sim()
+      && !wu.cpu->eia_mgr.any_eia_extensions_defined
+      && !wu.cpu->ipt_mgr.is_enabled();
+}
+
+// Compute persistent translation archive key for a TranslationWorkUnit. The key
+// covers the configuration of its processor, the instructions and control-flow
+// of its blocks, and all options passed to the code generator and compiler.
+//
+uint64
+TranslationWorker::archive_key(const TranslationWorkUnit& wu)
+{
+  arcsim::sys::cpu::Processor& cpu = *wu.cpu;
+  
+  // The runtime prelude is derived from the processor configuration, it is
+  // emitted once per processor to compute its key
+  //
+  std::map<const void*, uint64>::const_iterator C = config_key_.find(&cpu);
+  if (C == config_key_.end()) {
+    code_buf_->clear();
+    TranslationEmit::emit(*code_buf_, sim_opts, cpu.sys_arch.isa_opts, cpu.core_arch,
+                          cpu.mem, cpu.mem_model, cpu.pipeline, cpu.cnt_ctx);
+    const char* src = code_buf_->get_buffer();
+    C = config_key_.insert(std::make_pair(&cpu, TranslationArchive::compute_key(src, strlen(src)))).first;
+    code_buf_->clear();
+  }
+  uint64 key = C->second;
+  
+  // Options affecting code generation
+  //
+  const uint32 opts[] = {
+    sim_opts.fast_trans_mode,
+    static_cast<uint32>(wu.module->get_opt_level()),
+    sim_opts.trace_on,
+    sim_opts.fast_enable_debug,
+    sim_opts.fast_use_inline_asm,
+    sim_opts.emulate_traps,
+    sim_opts.track_regs,
+    sim_opts.is_jit_memory_sim(),
+    cpu.inst_timer_enabled && !sim_opts.cycle_sim,
+    cpu.core_arch.mmu_arch.is_configured,
+    cpu.aps.has_ld_aps(),
+    cpu.aps.has_st_aps(),
+    cpu.aps.has_lr_aps(),
+    cpu.aps.has_sr_aps(),
+    cpu.aps.has_extparam_aps(),
+    cpu.state.pc_mask
+  };
+  key = TranslationArchive::compute_key(reinterpret_cast<const char*>(opts), sizeof(opts), key);
+  
+  // Options affecting compilation
+  //
+  if (use_llvm_jit) {
+    key = TranslationArchive::compute_key("llvm-bitcode", 12, key);
+  } else {
+    key = TranslationArchive::compute_key(sim_opts.fast_cc.c_str(), sim_opts.fast_cc.size(), key);
+    key = TranslationArchive::compute_key(JIT_CCOPT, strlen(JIT_CCOPT), key);
+    key = TranslationArchive::compute_key(sim_opts.fast_mode_cc_opts.c_str(),
+                                          sim_opts.fast_mode_cc_opts.size(), key);
+    if (debug_mode) { key = TranslationArchive::compute_key("-g", 2, key); }
+  }
+  
+  // Contents of blocks, and edges between them
+  //
+  for (std::list<TranslationBlockUnit*>::const_iterator BI = wu.blocks.begin(), BE = wu.blocks.end();
+       BI != BE; ++BI) {
+    const TranslationBlockUnit& block = **BI;
+    const uint32 head[] = {
+      block.entry_.virt_addr,
+      static_cast<uint32>(block.entry_.mode),
+      static_cast<uint32>(block.get_instruction_count()),
+      static_cast<uint32>(block.edges_.size())
+    };
+    key = TranslationArchive::compute_key(reinterpret_cast<const char*>(head), sizeof(head), key);
+    
+    for (std::list<TranslationInstructionUnit*>::const_iterator I = block.begin(), E = block.end();
+         I != E; ++I) {
+      const arcsim::isa::arc::Dcode& inst = (*I)->inst;
+      const uint32 words[] = { inst.info.ir, inst.limm, inst.size };
+      key = TranslationArchive::compute_key(reinterpret_cast<const char*>(words), sizeof(words), key);
+    }
+    for (std::list<arcsim::profile::BlockEntry*>::const_iterator E = block.edges_.begin(),
+         EE = block.edges_.end(); E != EE; ++E) {
+      key = TranslationArchive::compute_key(reinterpret_cast<const char*>(&(*E)->virt_addr),
+                                            sizeof((*E)->virt_addr), key);
+    }
+  }
+  for (std::map<uint32,uint32>::const_iterator I = wu.lp_end_to_lp_start_map.begin(),
+       E = wu.lp_end_to_lp_start_map.end(); I != E; ++I) {
+    const uint32 zol[] = { I->first, I->second };
+    key = TranslationArchive::compute_key(reinterpret_cast<const char*>(zol), sizeof(zol), key);
+  }
+  return key;
+}
+
+// Modules compiled with Clang are archived as LLVM bitcode, modules compiled by
+// an external compiler as shared libraries
+//
+bool
+TranslationWorker::load_archived_module(const TranslationWorkUnit& wu, uint64 key)
+{
+  TranslationArchive& archive = mgr.trans_archive;
+  
+  if (!use_llvm_jit) {
+    return archive.lookup(key, wu.module->get_shared_library_path());
+  }
+  
+  std::string bitcode;
+  if (!archive.lookup(key, bitcode)) { return false; }
+  
+  llvm::MemoryBuffer* buf = llvm::MemoryBuffer::getMemBufferCopy(llvm::StringRef(bitcode),
+                                                                 wu.module->get_id());
+  std::string         err;
+  llvm::Module* const llvm_module = llvm::ParseBitcodeFile(buf, MOD_->getContext(), &err);
+  delete buf;
+  
+  if (llvm_module == 0) {
+    LOG(LOG_WARNING) << "[TW" << worker_id << "] Failed to read archived module '"
+                     << wu.module->get_id() << "': " << err;
+    return false;
+  }
+  wu.module->set_llvm_module(llvm_module);
+  return true;
+}
+
+void
+TranslationWorker::archive_module(const TranslationWorkUnit& wu, uint64 key)
+{
+  TranslationArchive& archive = mgr.trans_archive;
+  
+  if (!use_llvm_jit) {
+    archive.insert(key, wu.module->get_shared_library_path());
+    return;
+  }
+  
+  std::string              bitcode;
+  llvm::raw_string_ostream os(bitcode);
+  llvm::WriteBitcodeToFile(wu.module->get_llvm_module(), os);
+  os.flush();
+  archive.insert(key, bitcode.data(), bitcode.size());
+}
+
+// Precompile the runtime prelude (i.e. types, JIT API declarations, memory and
+// pipeline helper functions) emitted by TranslationEmit::emit(). It only depends
+// on the configuration of the processor a module is translated for, so each
+// worker precompiles it once per processor configuration instead of parsing it
+// again for every module.
+//
+bool
+TranslationWorker::get_prelude_pch(std::string& pch)
+{
+  const char*  src = code_buf_->get_buffer();
+  const uint64 key = TranslationArchive::compute_key(src, strlen(src));
+  
+  std::map<uint64, std::string>::const_iterator I = prelude_pch_.find(key);
+  if (I != prelude_pch_.end()) {
+    pch = I->second.empty() ? "" : I->second + ".pch";
+    return !I->second.empty();
+  }
+  
+  const uint64 start_time = arcsim::util::Os::get_current_time_micros();
+  
+  // Write prelude to a header file in the JIT's temporary directory, the include
+  // guard makes sure the header is skipped when the precompiled header is
+  // implicitly included
+  //
+  char hdr[BUFSIZ];
+  snprintf(hdr, sizeof(hdr), "%s/prelude-%d-%u-%u.h",
+           sim_opts.fast_tmp_dir.c_str(), getpid(), worker_id, (uint32)prelude_pch_.size());
+  
+  if (mkdir(sim_opts.fast_tmp_dir.c_str(), 0755) && errno != EEXIST) {
+    LOG(LOG_WARNING) << "[TW" << worker_id << "] Failed to create directory '"
+                     << sim_opts.fast_tmp_dir << "' for JIT prelude.";
+  }
+  std::ofstream hfile(hdr, std::ofstream::out);
+  hfile << "#ifndef ARCSIM_JIT_PRELUDE\n#define ARCSIM_JIT_PRELUDE\n"
+        << src
+        << "\n#endif /* ARCSIM_JIT_PRELUDE */\n";
+  hfile.close();
+  
+  // Precompile header with a separate compiler instance configured exactly
+  // like the one used for module compilation
+  //
+  bool success = !hfile.fail();
+  if (success) {
+    clang::CompilerInstance   CI;
+    clang::GeneratePCHAction  action;
+    configure_compiler_instance(CI);
+    CI.getFrontendOpts().Inputs.push_back(std::make_pair(clang::IK_C, std::string(hdr)));
+    CI.getFrontendOpts().OutputFile = std::string(hdr) + ".pch";
+    success = CI.ExecuteAction(action) && !CI.getDiagnostics().hasErrorOccurred();
+  }
+  
+  prelude_micros_ += arcsim::util::Os::get_current_time_micros() - start_time;
+  
+  if (!success) {
+    LOG(LOG_WARNING) << "[TW" << worker_id << "] Failed to precompile JIT prelude '"
+                     << hdr << "', parsing it for each module.";
+    unlink(hdr);
+    prelude_pch_[key] = "";
+    return false;
+  }
+  
+  LOG(LOG_DEBUG) << "[TW" << worker_id << "] Precompiled JIT prelude '" << hdr << ".pch'.";
+  prelude_pch_[key] = hdr;
+  pch = std::string(hdr) + ".pch";
+  return true;
+}
+
 // CLANG/LLVM based JIT compilation
 //
 bool
-TranslationWorker::compile_module_llvm(TranslationModule& m)
+TranslationWorker::compile_module_llvm(TranslationModule& m, const std::string& pch, bool& pch_failed)
 {
   // Create llvm::MemoryBuffer from arcsim::util::CodeBuffer
   CI_->createSourceManager(CI_->getFileManager());
   llvm::MemoryBuffer* buf  = llvm::MemoryBuffer::getMemBuffer(llvm::StringRef(code_buf_->get_buffer()), m.get_id());
   CI_->getSourceManager().createMainFileIDForMemBuffer(buf);
 
-  // Create pre-processor and AST context
+  // Create pre-processor and AST context, the precompiled prelude is included
+  // implicitly and deserialised lazily from the AST file
+  CI_->getPreprocessorOpts().ImplicitPCHInclude = pch;
   CI_->createPreprocessor();
   CI_->createASTContext();
+  if (!pch.empty()) {
+    CI_->createPCHExternalASTSource(pch,     /* Path                    */
+                                    false,   /* DisablePCHValidation    */
+                                    false,   /* DisableStatCache        */
+                                    0);      /* DeserializationListener */
+    if (!CI_->hasASTContext() || !CI_->getASTContext().getExternalSource()) {
+      LOG(LOG_ERROR) << "[TW" << worker_id << "] Failed to load precompiled JIT prelude '"
+                     << pch << "'.";
+      // Parse this prelude for each module from now on
+      for (std::map<uint64, std::string>::iterator I = prelude_pch_.begin(), E = prelude_pch_.end();
+           I != E; ++I) {
+        if (!I->second.empty() && pch == I->second + ".pch") { I->second.clear(); }
+      }
+      pch_failed = true;
+      return false;
+    }
+  }
 
   // Create HEAP allocated CodeGenerator instance
   clang::CodeGenOptions  CG_opts;
@@ -443,8 +814,8 @@ TranslationWorker::compile_module_llvm(TranslationModule& m)
     return false;
   }
   
-  // Optimise LLVM::Module (i.e. -O3)
-  opt_manager.get_pass_manager(0,3)->run(*llvm_module);
+  // Optimise LLVM::Module (i.e. -O3, or -O1 for baseline modules)
+  opt_manager.get_pass_manager(0,m.get_opt_level())->run(*llvm_module);
   // Register LLVM::Module
   m.set_llvm_module(llvm_module);
   return true;
@@ -611,6 +982,12 @@ TranslationWorker::load_module(const TranslationWorkUnit& work_unit)
   bool success               = true;
   TranslationModule& m = *work_unit.module;
   
+  // Optimised modules replacing a baseline module only stage their native
+  // code, the owning processor installs it once it is safe to free the
+  // baseline code (@see arcsim::profile::PageProfile::install_optimised_modules())
+  //
+  const bool is_replacement  = (m.get_baseline() != 0);
+  
   // -----------------------------------------------------------------------
   // BEGIN SYNCHRONISED registration of native code
   //
@@ -620,12 +997,15 @@ TranslationWorker::load_module(const TranslationWorkUnit& work_unit)
     // If a module is dirty, no translations can be present
     ASSERT((m.get_ref_count() == 0)
            && "[TranslationWorker] Module is dirty but contains references to translations.");
-    // re-set translation state for BlockEntries
+    // re-set translation state for BlockEntries, unless they still belong to
+    // the baseline module this module was meant to replace or are off-page
+    // blocks of a region that this module never registered
     
     for (std::list<TranslationBlockUnit*>::const_iterator
          BI = work_unit.blocks.begin(), E = work_unit.blocks.end();
-         BI != E; ++BI)
+         !is_replacement && BI != E; ++BI)
     {
+      if ((*BI)->is_off_page()) continue;
       LOG(LOG_DEBUG) << "[TW" << worker_id << "] reset QUEUED BlockEntry @ 0x"
                      << HEX((*BI)->entry_.phys_addr);
       (*BI)->entry_.mark_as_not_translated();
@@ -636,7 +1016,8 @@ TranslationWorker::load_module(const TranslationWorkUnit& work_unit)
     
     if (use_llvm_jit) {       // link Module and Engine with each other
       m.set_worker_engine(this);
-      ENG_->addModule(m.get_llvm_module());
+      if (get_engine(m) == ENG_BASELINE_) { baseline_modules_.insert(m.get_llvm_module()); }
+      get_engine(m)->addModule(m.get_llvm_module());
     } else {                  // load module so we can resolve symbols
       success = m.load_shared_library(); 
     }
@@ -646,7 +1027,8 @@ TranslationWorker::load_module(const TranslationWorkUnit& work_unit)
     if (success) {
       switch (sim_opts.fast_trans_mode)
       {    
-        case kCompilationModePageControlFlowGraph: {
+        case kCompilationModePageControlFlowGraph:
+        case kCompilationModeRegion: {
           TranslationBlock       native   = 0;
           llvm::Function*        function = 0;
           
@@ -659,7 +1041,7 @@ TranslationWorker::load_module(const TranslationWorkUnit& work_unit)
             // Retrieve function pointer from the module that was just compiled
             if ((function = m.get_llvm_module()->getFunction(sym.get_buffer()))) {
               // JIT compile function, returning a function pointer.
-              native = (TranslationBlock)ENG_->getPointerToFunction(function);
+              native = (TranslationBlock)get_engine(m)->getPointerToFunction(function);
               // Free up IR for function once machine code has been generated
               function->deleteBody();
             } 
@@ -672,19 +1054,23 @@ TranslationWorker::load_module(const TranslationWorkUnit& work_unit)
                            << sym.get_buffer() << "'";
             success = false;
           } else {        
-            // All Blocks have equal entry point for mode 'kCompilationModePageControlFlowGraph'
+            // All Blocks have equal entry point for mode 'kCompilationModePageControlFlowGraph'.
+            // Off-page blocks of a region are only reached from within the translation,
+            // their own page registers its translations for them.
             //
             for (std::list<TranslationBlockUnit*>::const_iterator
                  BI = work_unit.blocks.begin(), E = work_unit.blocks.end();
                  BI != E; ++BI)
             {
-              m.add_block_entry((*BI)->entry_, native);
+              if ((*BI)->is_off_page()) continue;
+              if (is_replacement) { m.stage_block_entry((*BI)->entry_, native); }
+              else                { m.add_block_entry((*BI)->entry_, native);   }
             }
             m.mark_as_translated(); // mark module as successfully translated
           }
           
           break;
-        } // END case kCompilationModePageControlFlowGraph
+        } // END case kCompilationModePageControlFlowGraph, kCompilationModeRegion
           
         case kCompilationModeBasicBlock: {
           
@@ -703,7 +1089,7 @@ TranslationWorker::load_module(const TranslationWorkUnit& work_unit)
               // Retrieve function pointer from the module that was just compiled
               if ((function = m.get_llvm_module()->getFunction(sym.get_buffer()))) {
                 // JIT compile function, returning a function pointer.
-                native = (TranslationBlock)ENG_->getPointerToFunction(function);
+                native = (TranslationBlock)get_engine(m)->getPointerToFunction(function);
                 // Free up IR for function once machine code has been generated
                 function->deleteBody();
               } 
@@ -716,7 +1102,8 @@ TranslationWorker::load_module(const TranslationWorkUnit& work_unit)
                              << sym.get_buffer() << "'";
               success = false;
             } else {
-              m.add_block_entry((*BI)->entry_, native);
+              if (is_replacement) { m.stage_block_entry((*BI)->entry_, native); }
+              else                { m.add_block_entry((*BI)->entry_, native);   }
             }
           }
           
@@ -733,9 +1120,23 @@ TranslationWorker::load_module(const TranslationWorkUnit& work_unit)
   //
   // END SYNCHRONISED
   // -----------------------------------------------------------------------
+  
+  // Optimised code is installed by the processor the next time it dispatches
+  // hot traces (@see Processor::dispatch_hot_traces()), workers never modify
+  // processor state such as pending actions
+  //
+  if (success && is_replacement) { ++tier_up_count_; }
 
   return  success;
 }
 
+// Baseline modules are code generated by the baseline engine if there is one
+//
+llvm::ExecutionEngine*
+TranslationWorker::get_engine(const TranslationModule& m) const
+{
+  return (m.is_baseline() && ENG_BASELINE_) ? ENG_BASELINE_ : ENG_;
+}
+
 } } } // namespace arcsim::internal::translate
 
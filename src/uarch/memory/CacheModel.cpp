@@ -85,21 +85,19 @@ CacheModel::CacheModel (int lev,
        s > 0;
        s = s >> 1, ++index_bits);
   
-  // Create ways/sets
+  // Create ways/sets - tags are stored set-major with each set padded to a
+  // multiple of kTagVectorWidth ways. Padding entries stay 0 (i.e. invalid)
+  // and therefore never match.
   //
-  tags = new uint32* [ways];
-  for (uint32 w = 0; w < ways; ++w) {
-    tags[w] = new uint32 [sets];
-    for (uint32 s = 0; s < sets; ++s) {
-      tags[w][s] = 0;
-    }
+  way_stride = (ways + kTagVectorWidth - 1) & ~(kTagVectorWidth - 1);
+  tags       = new uint32 [sets * way_stride];
+  for (uint32 i = 0; i < sets * way_stride; ++i) {
+    tags[i] = 0;
   }
 }
 
 CacheModel::~CacheModel ()
 {
-  for (uint32 w = 0; w < ways; ++w)
-    delete [] tags[w];
   delete [] tags;
 }
 
@@ -108,10 +106,8 @@ CacheModel::clear()
 {
   // Clear out ways/sets
   //
-  for (uint32 w = 0; w < ways; ++w) {
-    for (uint32 s = 0; s < sets; ++s) {
-      tags[w][s] = 0;
-    }
+  for (uint32 i = 0; i < sets * way_stride; ++i) {
+    tags[i] = 0;
   }
   read_hits   = 0;
   read_misses = 0;
@@ -133,7 +129,7 @@ CacheModel::clear()
 uint32
 CacheModel::line_copy_back (uint32 way, uint32 set)
 {
-  uint32 victim_addr = tags[way][set] & tagmask;
+  uint32 victim_addr = tag_at(way,set) & tagmask;
 
   if (next_level)
     return next_level->write (victim_addr, block_bits, kInvalidProgramCount);
@@ -147,7 +143,7 @@ CacheModel::line_copy_back (uint32 way, uint32 set)
 uint32
 CacheModel::line_reload (uint32 way, uint32 set)
 {
-  uint32 victim_addr = tags[way][set] & tagmask;
+  uint32 victim_addr = tag_at(way,set) & tagmask;
 
   if (next_level)
     return next_level->read (victim_addr, block_bits, kInvalidProgramCount);
@@ -170,7 +166,7 @@ CacheModel::get_victim_way (uint32 vset)
   //    if so assign it to victim_way.
   //
   for (uint32 w = 0; w < this->ways ; ++w) {
-    if ( !(tags[w][vset] & (VALID_BIT | LOCK_BIT)) ) {
+    if ( !(tag_at(w,vset) & (VALID_BIT | LOCK_BIT)) ) {
       victim_way = w;
       return true;
     }
@@ -186,7 +182,7 @@ CacheModel::get_victim_way (uint32 vset)
   uint32 v = victim_rotate;
 
   for (uint32 w = 0; w < this->ways ; ++w) {
-    if (!(tags[v][vset] & LOCK_BIT)) {
+    if (!(tag_at(v,vset) & LOCK_BIT)) {
       victim_way = v;
       return true;
     }
@@ -248,14 +244,14 @@ CacheModel::replace_block (uint32 addr, uint8 blk_bits, uint32 pc, bool write_op
     
   // Is victim dirty?
   //
-  if (tags[victim_way][hit_set] & DIRTY_BIT) {
+  if (tag_at(victim_way,hit_set) & DIRTY_BIT) {
     dirty = true;
     ++dirty_misses;
   }
   
   // Calculate victim address
   //
-  victim_addr = tags[victim_way][hit_set] & tagmask;
+  victim_addr = tag_at(victim_way,hit_set) & tagmask;
   
   // Go to next memory hierarchy level
   //
@@ -276,9 +272,9 @@ CacheModel::replace_block (uint32 addr, uint8 blk_bits, uint32 pc, bool write_op
   purge_victim (victim_addr);
   
   if (write_op) {
-    tags[victim_way][hit_set] = (addr & tagmask) | (VALID_BIT | DIRTY_BIT);
+    tag_at(victim_way,hit_set) = (addr & tagmask) | (VALID_BIT | DIRTY_BIT);
   } else {
-    tags[victim_way][hit_set] = (addr & tagmask) | VALID_BIT;
+    tag_at(victim_way,hit_set) = (addr & tagmask) | VALID_BIT;
   }
   return miss_time;
 }
@@ -293,11 +289,11 @@ CacheModel::invalidate (bool flush_dirty_entries)
   
   for (w = 0; w < ways; ++w) {
     for (s = 0; s < sets; ++s) {
-      if (flush_dirty_entries && ((tags[w][s] & VALID_DIRTY) == VALID_DIRTY)) {
+      if (flush_dirty_entries && ((tag_at(w,s) & VALID_DIRTY) == VALID_DIRTY)) {
         cost += line_copy_back (w, s);
       }
-      purge_victim (tags[w][s] & tagmask);
-      tags[w][s] &= tagmask; // clear VALID, DIRTY and LOCK bits
+      purge_victim (tag_at(w,s) & tagmask);
+      tag_at(w,s) &= tagmask; // clear VALID, DIRTY and LOCK bits
     }
   }
   
@@ -314,10 +310,10 @@ CacheModel::flush (bool flush_locked_entries)
   
   for (w = 0; w < ways; ++w) {
     for (s = 0; s < sets; ++s) {
-      if (    ((tags[w][s] & VALID_DIRTY) == VALID_DIRTY)
-           && (flush_locked_entries || !(tags[w][s] & LOCK_BIT) )) { 
+      if (    ((tag_at(w,s) & VALID_DIRTY) == VALID_DIRTY)
+           && (flush_locked_entries || !(tag_at(w,s) & LOCK_BIT) )) { 
         cost += line_copy_back (w, s);        
-        tags[w][s] ^= DIRTY_BIT; // toggle the dirty bit to clear it
+        tag_at(w,s) ^= DIRTY_BIT; // toggle the dirty bit to clear it
       }
     }
   }
@@ -337,12 +333,12 @@ CacheModel::flush_line (uint32 addr, bool flush_locked_entries, bool &success)
   success     = false;
   
   for (hit_way = 0; hit_way < ways; ++hit_way)
-    if ((tags[hit_way][hit_set] & (tagmask | VALID_DIRTY)) == valid_match) {
+    if ((tag_at(hit_way,hit_set) & (tagmask | VALID_DIRTY)) == valid_match) {
       // this is a match and the line is dirty
       success = true;
-      if (flush_locked_entries || !(tags[hit_way][hit_set] & LOCK_BIT)) {
+      if (flush_locked_entries || !(tag_at(hit_way,hit_set) & LOCK_BIT)) {
         cost += line_copy_back (hit_way, hit_set);
-        tags[hit_way][hit_set] ^= DIRTY_BIT; // toggle the dirty bit to clear it
+        tag_at(hit_way,hit_set) ^= DIRTY_BIT; // toggle the dirty bit to clear it
       }
       break;
     }
@@ -361,14 +357,14 @@ CacheModel::invalidate_line (uint32 addr, bool flush_dirty_entries, bool &succes
   success     = false;
   
   for (hit_way = 0; hit_way < ways; ++hit_way) {
-    if ((tags[hit_way][hit_set] & (tagmask | VALID_BIT)) == valid_match) {
+    if ((tag_at(hit_way,hit_set) & (tagmask | VALID_BIT)) == valid_match) {
       // this is a match
-      if (flush_dirty_entries && (tags[hit_way][hit_set] & VALID_BIT)) {
+      if (flush_dirty_entries && (tag_at(hit_way,hit_set) & VALID_BIT)) {
         // the line is dirty and a dirty line should be flushed
         cost += line_copy_back (hit_way, hit_set);
       }
-      purge_victim (tags[hit_way][hit_set] & tagmask);
-      tags[hit_way][hit_set] &= tagmask; // clear VALID, DIRTY and LOCK bits
+      purge_victim (tag_at(hit_way,hit_set) & tagmask);
+      tag_at(hit_way,hit_set) &= tagmask; // clear VALID, DIRTY and LOCK bits
       success = true;
       break;
     }
@@ -390,23 +386,23 @@ CacheModel::lock_line (uint32 addr, bool flush_on_lock, bool &success)
   // 1. Check to see if the given address is already present in cache
   //
   for (hit_way = 0; hit_way < ways; ++hit_way)
-    if ((tags[hit_way][hit_set] & (tagmask | VALID_BIT)) == valid_match) 
+    if ((tag_at(hit_way,hit_set) & (tagmask | VALID_BIT)) == valid_match) 
     {
       // The address to be locked is aleady in cache.      
       // If the line is clean, re-read it from memory
       //
-      if (!(tags[hit_way][hit_set] & DIRTY_BIT)) {
+      if (!(tag_at(hit_way,hit_set) & DIRTY_BIT)) {
         cost += line_reload (hit_way, hit_set);
       }
       
       // If flush_on_lock, and the line is dirty, copy it back to memory
       //
-      if (flush_on_lock && (tags[hit_way][hit_set] & DIRTY_BIT)) {
+      if (flush_on_lock && (tag_at(hit_way,hit_set) & DIRTY_BIT)) {
         cost += line_copy_back (hit_way, hit_set);
-        tags[hit_way][hit_set] ^= DIRTY_BIT; // toggle the dirty bit to clear it
+        tag_at(hit_way,hit_set) ^= DIRTY_BIT; // toggle the dirty bit to clear it
       }
       
-      tags[hit_way][hit_set] |= LOCK_BIT; // lock the line
+      tag_at(hit_way,hit_set) |= LOCK_BIT; // lock the line
       success = true;
       return cost;
     }
@@ -419,7 +415,7 @@ CacheModel::lock_line (uint32 addr, bool flush_on_lock, bool &success)
     // A victim line was found, and was loaded with the lock address,
     // so we can now lock that line.
     //
-    tags[victim_way][hit_set] |= LOCK_BIT; // lock the line
+    tag_at(victim_way,hit_set) |= LOCK_BIT; // lock the line
   }
   
   return cost;
@@ -442,7 +438,7 @@ CacheModel::cache_addr_probe (uint32 addr, uint32 &tag_result, bool &success)
   // set number, as required.
   //
   if (success) {
-    tag_result = (tags[hit_way][hit_set] & (tagmask | ALL_STATE))
+    tag_result = (tag_at(hit_way,hit_set) & (tagmask | ALL_STATE))
                | (hit_set << block_bits);
   } else {
     tag_result = 0;
@@ -476,7 +472,7 @@ CacheModel::direct_addr_probe (uint32 addr, uint32 &tag_result, bool &success)
   // mask out any unwanted bits, and merge-in the set index
   // at the appropriate index position.
   //
-  tag_result = (tags[way][set] & (tagmask | ALL_STATE))
+  tag_result = (tag_at(way,set) & (tagmask | ALL_STATE))
              | (set << block_bits);
   
   success = tag_result & VALID_BIT;
@@ -505,7 +501,7 @@ CacheModel::direct_tag_read (uint32 addr, uint32 &tag_result)
   // mask out any unwanted bits, and merge-in the set index
   // at the appropriate index position.
   //
-  tag_result = (tags[way][set] & (tagmask | ALL_STATE))
+  tag_result = (tag_at(way,set) & (tagmask | ALL_STATE))
              | (set << block_bits);
   
   // Return the cycle cost of this operation, which is assumed
@@ -531,7 +527,7 @@ CacheModel::direct_tag_write (uint32 addr, uint32 tag_value)
   // Mask out reserved and unused bits from the supplied tag
   // value, and write the selected way, at the selected set index.
   //
-  tags[way][set] = tag_value & (tagmask | ALL_STATE);
+  tag_at(way,set) = tag_value & (tagmask | ALL_STATE);
   
   // Return the cycle cost of this operation, which is assumed
   // to be 1 cycle.
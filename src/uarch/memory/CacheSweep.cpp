@@ -0,0 +1,157 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2011 The University of Edinburgh
+//                        All Rights Reserved
+//
+// =====================================================================
+//
+// Description:
+//
+// Single pass simulation of many cache geometries for one address stream.
+//
+// =====================================================================
+
+#include <cstdio>
+
+#include "uarch/memory/CacheSweep.h"
+
+namespace arcsim {
+  namespace uarch {
+    namespace memory {
+
+      // -----------------------------------------------------------------------
+      // CONSTANTS
+      //
+
+      // Block addresses are at most 30 bits wide, hence this tag never matches
+      //
+      static const uint32 kInvalidTag = 0xFFFFFFFF;
+
+      static uint32
+      log2_of_pow2(uint32 value)
+      {
+        uint32 bits = 0;
+        while (value > 1) { value >>= 1; ++bits; }
+        return bits;
+      }
+
+      // -----------------------------------------------------------------------
+      // StackGroup
+      //
+      CacheSweep::StackGroup::StackGroup(uint32 _block_bits, uint32 _set_bits, uint32 _depth)
+      : block_bits(_block_bits),
+        set_bits(_set_bits),
+        set_mask((1U << _set_bits) - 1),
+        depth(_depth),
+        stacks(new uint32[(1U << _set_bits) * _depth]),
+        hits(new uint64[_depth])
+      {
+        for (uint32 i = 0; i < depth; ++i) { hits[i] = 0; }
+        invalidate();
+      }
+
+      CacheSweep::StackGroup::~StackGroup()
+      {
+        delete [] stacks;
+        delete [] hits;
+      }
+
+      void
+      CacheSweep::StackGroup::invalidate()
+      {
+        for (uint32 i = 0; i < (1U << set_bits) * depth; ++i) { stacks[i] = kInvalidTag; }
+      }
+
+      uint64
+      CacheSweep::StackGroup::get_hits(uint32 ways) const
+      {
+        uint64 value = 0;
+        for (uint32 d = 0; d < ways && d < depth; ++d) { value += hits[d]; }
+        return value;
+      }
+
+      // -----------------------------------------------------------------------
+      // CacheSweep
+      //
+      CacheSweep::CacheSweep(CacheArch::CacheKind kind, const std::vector<CacheArch>& geometries)
+      : kind_(kind),
+        geometries_(geometries),
+        accesses_(0)
+      {
+        // Group geometries by block size and number of sets, each group is as
+        // deep as its most associative geometry
+        //
+        std::vector<uint32> group_block_bits;
+        std::vector<uint32> group_set_bits;
+        std::vector<uint32> group_depth;
+
+        for (uint32 i = 0; i < geometries_.size(); ++i) {
+          const CacheArch& g = geometries_[i];
+          const uint32 set_bits = log2_of_pow2(g.size >> g.block_bits) - log2_of_pow2(g.ways);
+
+          uint32 j = 0;
+          while (   j < group_depth.size()
+                 && (group_block_bits[j] != g.block_bits || group_set_bits[j] != set_bits)) {
+            ++j;
+          }
+          if (j == group_depth.size()) {
+            group_block_bits.push_back(g.block_bits);
+            group_set_bits.push_back(set_bits);
+            group_depth.push_back(g.ways);
+          } else if (g.ways > group_depth[j]) {
+            group_depth[j] = g.ways;
+          }
+          geometry_group_.push_back(j);
+        }
+
+        for (uint32 j = 0; j < group_depth.size(); ++j) {
+          groups_.push_back(new StackGroup(group_block_bits[j], group_set_bits[j], group_depth[j]));
+        }
+      }
+
+      CacheSweep::~CacheSweep()
+      {
+        for (uint32 j = 0; j < groups_.size(); ++j) { delete groups_[j]; }
+      }
+
+      void
+      CacheSweep::invalidate()
+      {
+        for (uint32 j = 0; j < groups_.size(); ++j) { groups_[j]->invalidate(); }
+      }
+
+      void
+      CacheSweep::print_stats() const
+      {
+        const char * cache_str = CacheArch::kind_tostring(kind_);
+
+        fprintf (stderr, "%s-Cache Sweep Statistics [LRU, %llu accesses]\n", cache_str, accesses_);
+        fprintf (stderr, "-----------------------------------------------------------\n");
+        fprintf (stderr, "      Size   Ways  Block        Misses  Miss ratio\n");
+        fprintf (stderr, "-----------------------------------------------------------\n");
+        for (uint32 i = 0; i < geometries_.size(); ++i) {
+          const CacheArch& g      = geometries_[i];
+          const uint64     misses = accesses_ - groups_[geometry_group_[i]]->get_hits(g.ways);
+          fprintf (stderr, " %9u  %5u  %5u  %12llu  %9.4f%%\n",
+                   g.size, g.ways, 1U << g.block_bits, misses,
+                   accesses_ ? (100.0 * misses / accesses_) : 0.0);
+        }
+        fprintf (stderr, "-----------------------------------------------------------\n");
+
+        // Miss-ratio curve of each group for all power of two associativities
+        //
+        for (uint32 j = 0; j < groups_.size(); ++j) {
+          const StackGroup& grp = *groups_[j];
+          fprintf (stderr, " Miss-ratio curve [%u sets, %u byte blocks]\n",
+                   1U << grp.set_bits, 1U << grp.block_bits);
+          for (uint32 ways = 1; ways <= grp.depth; ways <<= 1) {
+            const uint64 misses = accesses_ - grp.get_hits(ways);
+            fprintf (stderr, " %9u  %5u  %5u  %12llu  %9.4f%%\n",
+                     (ways << grp.set_bits) << grp.block_bits, ways, 1U << grp.block_bits, misses,
+                     accesses_ ? (100.0 * misses / accesses_) : 0.0);
+          }
+        }
+        fprintf (stderr, "-----------------------------------------------------------\n\n");
+      }
+
+} } } // arcsim::uarch::memory
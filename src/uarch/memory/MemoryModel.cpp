@@ -34,7 +34,9 @@ MemoryModel::MemoryModel (SystemArch&       _sys_arch,
   icache_c(_icache),
   dcache_c(_dcache),
   dcache_enabled(_dcache != 0),
-  icache_enabled(_icache != 0)
+  icache_enabled(_icache != 0),
+  icache_sweep(0),
+  dcache_sweep(0)
 {
   // FIXME: improve co-existence of multiple ICCMs
   if (sys_arch.isa_opts.multiple_iccms) {
@@ -54,10 +56,24 @@ MemoryModel::MemoryModel (SystemArch&       _sys_arch,
       latency_cache.d_block_bits = dcache_c->block_bits;
     }
   }
+  
+  // Cache geometry sweeps
+  //
+  if (!sys_arch.sim_opts.icache_sweep.empty()) {
+    icache_sweep = new arcsim::uarch::memory::CacheSweep(CacheArch::kInstCache,
+                                                         sys_arch.sim_opts.icache_sweep);
+  }
+  if (!sys_arch.sim_opts.dcache_sweep.empty()) {
+    dcache_sweep = new arcsim::uarch::memory::CacheSweep(CacheArch::kDataCache,
+                                                         sys_arch.sim_opts.dcache_sweep);
+  }
 }
 
 MemoryModel::~MemoryModel() 
-{ /* EMPTY */ }
+{
+  delete icache_sweep;
+  delete dcache_sweep;
+}
 
 // Memory interface
 //
@@ -87,6 +103,10 @@ MemoryModel::print_stats()
       if (dccm_c) { dccm_c->print_stats(); }
     }
   }
+  // Cache geometry sweeps
+  //
+  if (icache_sweep) { icache_sweep->print_stats(); }
+  if (dcache_sweep) { dcache_sweep->print_stats(); }
 
 }
 
@@ -101,8 +121,39 @@ MemoryModel::clear()
   latency_cache.flush();
   if (icache_c) { icache_c->clear(); }
   if (dcache_c) { dcache_c->clear(); }
+  if (icache_sweep) { icache_sweep->invalidate(); }
+  if (dcache_sweep) { dcache_sweep->invalidate(); }
+}
+
+
+// ---------------------------------------------------------------------------
+// Read/write methods for the accesses of ENTER_S/LEAVE_S
+//
+uint32
+MemoryModel::read_multiple (uint32 const * addrs, uint32 count, uint32 pc, bool uncached)
+{
+  if (dcache_enabled && !uncached) {
+    for (uint32 i = 0; i < count; ++i) { dcache_c->prefetch_set(addrs[i]); }
+  }
+  uint32 cycles = 0;
+  for (uint32 i = 0; i < count; ++i) {
+    cycles += read(addrs[i], pc, uncached);
+  }
+  return cycles;
 }
 
+uint32
+MemoryModel::write_multiple (uint32 const * addrs, uint32 count, uint32 pc, bool uncached)
+{
+  if (dcache_enabled && !uncached) {
+    for (uint32 i = 0; i < count; ++i) { dcache_c->prefetch_set(addrs[i]); }
+  }
+  uint32 cycles = 0;
+  for (uint32 i = 0; i < count; ++i) {
+    cycles += write(addrs[i], pc, uncached);
+  }
+  return cycles;
+}
 
 // ---------------------------------------------------------------------------
 // Method emitting code to access memory
@@ -163,13 +214,16 @@ MemoryModel::jit_emit_instr_memory_fetch(arcsim::util::CodeBuffer&      buf,
 
 // FIXME: Integrate CCM memory model
 //
+// The inlined latency cache checks are omitted if a CacheSweep is attached, as
+// it must observe every access.
+//
 bool
 MemoryModel::jit_emit_memory_model_access_functions(arcsim::util::CodeBuffer& buf,
                                                     CoreArch&                 core_arch)
 {
   // WRITE latency
   buf.append("\nstatic inline uint16 mem_model_write(cpuState * const s, uint32 addr) {");
-  if (core_arch.dcache.is_configured) {
+  if (core_arch.dcache.is_configured && !dcache_sweep) {
     buf.append("uint32 blk_addr = addr >> %d;\n", core_arch.dcache.block_bits)
        .append("uint32 index = blk_addr & 0x%08x;\n", (DEFAULT_HASH_CACHE_SIZE-1))
        .append("if ((blk_addr | 0x80000000) == s->lat_cache_d_tag[index]) {\n")
@@ -183,7 +237,7 @@ MemoryModel::jit_emit_memory_model_access_functions(arcsim::util::CodeBuffer& bu
   
   // READ latency
   buf.append("\nstatic inline uint16 mem_model_read(cpuState * const s, uint32 addr) {");
-  if (core_arch.dcache.is_configured) {
+  if (core_arch.dcache.is_configured && !dcache_sweep) {
     buf.append("uint32 blk_addr = addr >> %d;\n", core_arch.dcache.block_bits)
        .append("uint32 index = blk_addr & 0x%08x;\n", (DEFAULT_HASH_CACHE_SIZE-1))
        .append("if (blk_addr == (s->lat_cache_d_tag[index] & 0x7FFFFFFF)) {\n")
@@ -201,7 +255,7 @@ MemoryModel::jit_emit_memory_model_access_functions(arcsim::util::CodeBuffer& bu
   //  state.ibuff_addr = addr >> 2;
   //
   buf.append("\nstatic inline uint16 mem_model_fetch_1(cpuState * const s, uint32 addr) {\n");
-  if (core_arch.icache.is_configured) {
+  if (core_arch.icache.is_configured && !icache_sweep) {
     buf.append("uint32 blk_addr = addr >> %d;\n", core_arch.icache.block_bits)
        .append("uint32 index = blk_addr & 0x%08x;\n", (DEFAULT_HASH_CACHE_SIZE-1))
        .append("s->ibuff_addr = addr >> 2;\n")
@@ -227,7 +281,7 @@ MemoryModel::jit_emit_memory_model_access_functions(arcsim::util::CodeBuffer& bu
   // state.ibuff_addr  = addr2 >> 2;
   //
   buf.append("\nstatic inline uint32 mem_model_fetch_2 (cpuState * const s, uint32 addr1, uint32 addr2) {\n");
-  if (core_arch.icache.is_configured) {
+  if (core_arch.icache.is_configured && !icache_sweep) {
     buf.append("uint32 lat = 0;\n")
        .append("uint32 word_addr = addr1 >> 2;\n")
        .append("if (word_addr != s->ibuff_addr) {\n")
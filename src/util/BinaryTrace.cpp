@@ -0,0 +1,267 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2011 The University of Edinburgh
+//                        All Rights Reserved
+// =====================================================================
+//
+// Description:
+//
+// Compact binary instruction trace writer and reader.
+//
+// =====================================================================
+
+#include "util/BinaryTrace.h"
+
+#include "util/Os.h"
+#include "util/Log.h"
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/uio.h>
+
+namespace arcsim {
+  namespace util {
+
+    // -------------------------------------------------------------------------
+    // BinaryTraceWriter
+    //
+    BinaryTraceWriter::BinaryTraceWriter(int fd, uint32 core_id)
+    : fd_(fd),
+      core_id_(core_id),
+      chunks_(new uint8[kChunkCount * kChunkSize]),
+      head_(0),
+      tail_(0),
+      done_(false),
+      failed_(false),
+      running_(false),
+      cur_(0),
+      end_(0),
+      last_pc_(0),
+      chunk_count_(0),
+      stall_count_(0),
+      lost_count_(0)
+    {
+      for (uint32 i = 0; i < kChunkCount; ++i) { chunk_len_[i] = 0; }
+      begin_chunk();
+    }
+
+    BinaryTraceWriter::~BinaryTraceWriter()
+    {
+      close();
+      delete [] chunks_;
+    }
+
+    void
+    BinaryTraceWriter::open()
+    {
+      if (running_) { return; }
+      done_    = false;
+      running_ = true;
+      start();
+    }
+
+    void
+    BinaryTraceWriter::close()
+    {
+      if (!running_) { return; }
+      flush();
+      done_ = true;
+      join();
+      running_ = false;
+      if (failed_) {
+        LOG(LOG_ERROR) << "[BinaryTrace] Trace of core '" << core_id_ << "' is incomplete, '"
+                       << lost_count_ << "' of '" << chunk_count_ << "' chunks were not written.";
+      }
+    }
+
+    void
+    BinaryTraceWriter::flush()
+    {
+      if (cur_ != chunks_ + (head_ & (kChunkCount - 1)) * kChunkSize) { publish_chunk(); }
+    }
+
+    void
+    BinaryTraceWriter::put_string(const char* str, uint32 len)
+    {
+      if (len > BinaryTrace::kMaxStringLength) { len = BinaryTrace::kMaxStringLength; }
+      put_varint(len);
+      memcpy(cur_, str, len);
+      cur_ += len;
+    }
+
+    // Position producer at the start of the chunk at 'head_'
+    //
+    void
+    BinaryTraceWriter::begin_chunk()
+    {
+      cur_     = chunks_ + (head_ & (kChunkCount - 1)) * kChunkSize;
+      end_     = cur_ + kChunkSize;
+      last_pc_ = 0; // chunks are decoded independently
+    }
+
+    // Hand current chunk over to writer thread. If all chunks are in flight we
+    // have to wait for the writer thread to catch up.
+    //
+    void
+    BinaryTraceWriter::publish_chunk()
+    {
+      const uint32 idx = head_ & (kChunkCount - 1);
+      chunk_len_[idx]  = cur_ - (chunks_ + idx * kChunkSize);
+
+      // Make chunk contents visible before advancing 'head_'
+      //
+      __sync_synchronize();
+      ++head_;
+      ++chunk_count_;
+
+      if (head_ - tail_ == kChunkCount) {
+        ++stall_count_;
+        while (head_ - tail_ == kChunkCount) {
+          if (!running_) { (void)write_chunk(tail_ & (kChunkCount - 1)); ++tail_; }
+          else           { arcsim::util::Os::sleep_micros(50); }
+        }
+      }
+      __sync_synchronize();
+      begin_chunk();
+    }
+
+    // Write chunk 'idx' to the trace file. Once a write failed the trace is
+    // marked incomplete and no further chunks are written, so that the file
+    // never has a gap in the middle.
+    //
+    bool
+    BinaryTraceWriter::write_chunk(uint32 idx)
+    {
+      if (failed_) { ++lost_count_; return false; }
+      
+      const uint32 header[3] = { BinaryTrace::kChunkMagic, core_id_, chunk_len_[idx] };
+      uint8 const * const buf = chunks_ + idx * kChunkSize;
+
+      // A single writev() per chunk keeps chunks of different processors sharing
+      // the same file descriptor from interleaving
+      //
+      struct iovec iov[2];
+      iov[0].iov_base = const_cast<uint32*>(header);
+      iov[0].iov_len  = sizeof(header);
+      iov[1].iov_base = const_cast<uint8*>(buf);
+      iov[1].iov_len  = chunk_len_[idx];
+      const ssize_t len = sizeof(header) + chunk_len_[idx];
+      const ssize_t ret = ::writev(fd_, iov, 2);
+      if (ret != len) {
+        LOG(LOG_ERROR) << "[BinaryTrace] Failed to write chunk of core '" << core_id_ << "': '"
+                       << ((ret < 0) ? strerror(errno) : "short write") << "'";
+        failed_ = true;
+        ++lost_count_;
+        return false;
+      }
+      return true;
+    }
+
+    // Writer thread - drains chunks between 'tail_' and 'head_'
+    //
+    void
+    BinaryTraceWriter::run()
+    {
+      for (;;) {
+        const bool done = done_;
+        __sync_synchronize();
+        if (tail_ != head_) {
+          // A failed write marks the trace incomplete, the chunk is still
+          // consumed so that the producer never waits for a dead file
+          (void)write_chunk(tail_ & (kChunkCount - 1));
+          __sync_synchronize();
+          ++tail_;
+        } else if (done) {
+          break;
+        } else {
+          arcsim::util::Os::sleep_micros(100);
+        }
+      }
+    }
+
+    // -------------------------------------------------------------------------
+    // BinaryTraceReader
+    //
+    BinaryTraceReader::BinaryTraceReader(FILE* fd)
+    : fd_(fd),
+      buf_(new uint8[BinaryTraceWriter::kChunkSize]),
+      buf_size_(BinaryTraceWriter::kChunkSize),
+      cur_(0),
+      end_(0),
+      core_id_(0),
+      last_pc_(0),
+      error_(false)
+    { /* EMPTY */ }
+
+    BinaryTraceReader::~BinaryTraceReader()
+    {
+      delete [] buf_;
+    }
+
+    bool
+    BinaryTraceReader::next_chunk()
+    {
+      uint32 header[3];
+      if (error_ || fread(header, sizeof(header), 1, fd_) != 1) { return false; }
+      if (header[0] != BinaryTrace::kChunkMagic || header[2] > buf_size_) {
+        error_ = true;
+        return false;
+      }
+      if (header[2] && fread(buf_, header[2], 1, fd_) != 1) {
+        error_ = true;
+        return false;
+      }
+      core_id_ = header[1];
+      cur_     = buf_;
+      end_     = buf_ + header[2];
+      last_pc_ = 0;
+      return true;
+    }
+
+    uint8
+    BinaryTraceReader::get_u8()
+    {
+      if (cur_ >= end_) { error_ = true; return 0; }
+      return *cur_++;
+    }
+
+    uint64
+    BinaryTraceReader::get_varint()
+    {
+      uint64 val   = 0;
+      uint32 shift = 0;
+      for (;;) {
+        if (cur_ >= end_ || shift > 63) { error_ = true; return 0; }
+        const uint8 b = *cur_++;
+        val |= static_cast<uint64>(b & 0x7F) << shift;
+        if (!(b & 0x80)) { break; }
+        shift += 7;
+      }
+      return val;
+    }
+
+    sint32
+    BinaryTraceReader::get_svarint()
+    {
+      const uint32 v = static_cast<uint32>(get_varint());
+      return static_cast<sint32>((v >> 1) ^ (0U - (v & 1)));
+    }
+
+    uint32
+    BinaryTraceReader::get_pc()
+    {
+      last_pc_ += static_cast<uint32>(get_svarint());
+      return last_pc_;
+    }
+
+    void
+    BinaryTraceReader::get_string(std::string& str)
+    {
+      const uint32 len = static_cast<uint32>(get_varint());
+      if (len > static_cast<uint32>(end_ - cur_)) { error_ = true; str.clear(); return; }
+      str.assign(reinterpret_cast<const char*>(cur_), len);
+      cur_ += len;
+    }
+
+} } // arcsim::util
@@ -0,0 +1,294 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2011 The University of Edinburgh
+//                        All Rights Reserved
+// =====================================================================
+//
+// Description:
+//
+// Snapshot file writer and reader.
+//
+// =====================================================================
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "util/Checkpoint.h"
+#include "util/Log.h"
+
+namespace arcsim {
+  namespace util {
+
+    // Snapshot file header
+    //
+    struct CheckpointHeader {
+      uint32  magic;
+      uint32  version;
+      uint32  page_bytes;
+      uint32  page_count;
+      uint64  meta_size;
+      uint64  page_offset;  // offset of page data area, host page aligned
+    };
+
+    // Write 'len' bytes at 'off', retrying on partial writes
+    //
+    static bool write_fully(int fd, const void* buf, size_t len, off_t off)
+    {
+      const char* p = static_cast<const char*>(buf);
+      while (len > 0) {
+        ssize_t n = ::pwrite(fd, p, len, off);
+        if (n < 0) {
+          if (errno == EINTR) continue;
+          return false;
+        }
+        p   += n;
+        len -= n;
+        off += n;
+      }
+      return true;
+    }
+
+    static bool read_fully(int fd, void* buf, size_t len, off_t off)
+    {
+      char* p = static_cast<char*>(buf);
+      while (len > 0) {
+        ssize_t n = ::pread(fd, p, len, off);
+        if (n < 0) {
+          if (errno == EINTR) continue;
+          return false;
+        }
+        if (n == 0) { return false; } // unexpected end of file
+        p   += n;
+        len -= n;
+        off += n;
+      }
+      return true;
+    }
+
+    // -------------------------------------------------------------------------
+    // CheckpointWriter
+    //
+    CheckpointWriter::CheckpointWriter(uint32 page_bytes)
+    : page_bytes_(page_bytes)
+    { /* EMPTY */ }
+
+    CheckpointWriter::~CheckpointWriter()
+    { /* EMPTY */ }
+
+    void
+    CheckpointWriter::begin_section(uint32 tag)
+    {
+      write_value(tag);
+    }
+
+    void
+    CheckpointWriter::write(const void* data, size_t size)
+    {
+      const uint8* p = static_cast<const uint8*>(data);
+      meta_.insert(meta_.end(), p, p + size);
+    }
+
+    void
+    CheckpointWriter::write_string(const std::string& str)
+    {
+      write_value(static_cast<uint32>(str.size()));
+      write(str.data(), str.size());
+    }
+
+    uint32
+    CheckpointWriter::write_page(const void* page)
+    {
+      pages_.push_back(page);
+      return pages_.size() - 1;
+    }
+
+    bool
+    CheckpointWriter::commit(const std::string& path)
+    {
+      int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0) {
+        LOG(LOG_ERROR) << "[CHECKPOINT] Failed to create '" << path << "': '"
+                       << strerror(errno) << "'";
+        return false;
+      }
+
+      bool success = commit(fd);
+      if (::close(fd) != 0) { success = false; }
+
+      if (!success) {
+        LOG(LOG_ERROR) << "[CHECKPOINT] Failed to write '" << path << "': '"
+                       << strerror(errno) << "'";
+      } else {
+        LOG(LOG_INFO) << "[CHECKPOINT] Saved '" << path << "' ("
+                      << pages_.size() << " pages, "
+                      << meta_.size() << " bytes of state).";
+      }
+      return success;
+    }
+
+    bool
+    CheckpointWriter::commit(int fd)
+    {
+      const uint64 host_page = sysconf(_SC_PAGESIZE);
+
+      CheckpointHeader header;
+      header.magic       = Checkpoint::kMagic;
+      header.version     = Checkpoint::kVersion;
+      header.page_bytes  = page_bytes_;
+      header.page_count  = pages_.size();
+      header.meta_size   = meta_.size();
+      header.page_offset = ((sizeof(header) + meta_.size() + host_page - 1) / host_page) * host_page;
+
+      bool success = write_fully(fd, &header, sizeof(header), 0)
+                  && (meta_.empty() || write_fully(fd, &meta_[0], meta_.size(), sizeof(header)));
+
+      off_t off = header.page_offset;
+      for (uint32 i = 0; success && i < pages_.size(); ++i, off += page_bytes_) {
+        success = write_fully(fd, pages_[i], page_bytes_, off);
+      }
+
+      // Make sure the page data area is present even if the last pages are
+      // sparse so that it can be mapped in full
+      //
+      return success && (ftruncate(fd, off) == 0);
+    }
+
+    // -------------------------------------------------------------------------
+    // CheckpointReader
+    //
+    CheckpointReader::CheckpointReader()
+    : pos_(0),
+      error_(false),
+      page_bytes_(0),
+      page_count_(0),
+      pages_(0),
+      pages_size_(0)
+    { /* EMPTY */ }
+
+    CheckpointReader::~CheckpointReader()
+    {
+      if (pages_) { munmap(pages_, pages_size_); }
+    }
+
+    bool
+    CheckpointReader::open(const std::string& path)
+    {
+      int fd = ::open(path.c_str(), O_RDONLY);
+      if (fd < 0) {
+        LOG(LOG_ERROR) << "[CHECKPOINT] Failed to open '" << path << "': '"
+                       << strerror(errno) << "'";
+        return false;
+      }
+      const bool success = open(fd);
+      ::close(fd);
+
+      if (!success) {
+        LOG(LOG_ERROR) << "[CHECKPOINT] Failed to read '" << path << "'.";
+      }
+      return success;
+    }
+
+    bool
+    CheckpointReader::open(int fd)
+    {
+      if (pages_) { munmap(pages_, pages_size_); pages_ = 0; pages_size_ = 0; }
+
+      CheckpointHeader header;
+      bool success = read_fully(fd, &header, sizeof(header), 0)
+                  && (header.magic   == Checkpoint::kMagic)
+                  && (header.version == Checkpoint::kVersion);
+      if (!success) {
+        LOG(LOG_ERROR) << "[CHECKPOINT] Not a compatible checkpoint.";
+        error_ = true;
+        return false;
+      }
+
+      meta_.resize(header.meta_size);
+      success = meta_.empty() || read_fully(fd, &meta_[0], meta_.size(), sizeof(header));
+
+      page_bytes_ = header.page_bytes;
+      page_count_ = header.page_count;
+
+      if (success && page_count_) {
+        // Private mapping: simulated writes to restored pages are copied on
+        // write and never reach the snapshot file
+        //
+        const size_t size = static_cast<size_t>(page_count_) * page_bytes_;
+        void* p = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                       fd, header.page_offset);
+        if (p == MAP_FAILED) {
+          success = false;
+        } else {
+          pages_      = static_cast<uint8*>(p);
+          pages_size_ = size;
+        }
+      }
+
+      if (!success) {
+        LOG(LOG_ERROR) << "[CHECKPOINT] Failed to read checkpoint: '" << strerror(errno) << "'";
+      }
+      pos_   = 0;
+      error_ = !success;
+      return success;
+    }
+
+    bool
+    CheckpointReader::expect_section(uint32 tag)
+    {
+      uint32 val = 0;
+      if (!read_value(val) || val != tag) {
+        error_ = true;
+        return false;
+      }
+      return true;
+    }
+
+    bool
+    CheckpointReader::read(void* data, size_t size)
+    {
+      if (error_ || size > meta_.size() - pos_) {
+        error_ = true;
+        return false;
+      }
+      if (size) {
+        std::memcpy(data, &meta_[pos_], size);
+        pos_ += size;
+      }
+      return true;
+    }
+
+    bool
+    CheckpointReader::read_string(std::string& str)
+    {
+      uint32 len = 0;
+      if (!read_value(len) || len > meta_.size() - pos_) {
+        error_ = true;
+        return false;
+      }
+      str.assign(reinterpret_cast<const char*>(&meta_[0]) + pos_, len);
+      pos_ += len;
+      return true;
+    }
+
+    uint8*
+    CheckpointReader::get_page(uint32 idx) const
+    {
+      return (idx < page_count_) ? (pages_ + static_cast<size_t>(idx) * page_bytes_) : 0;
+    }
+
+    void
+    CheckpointReader::release_pages(void** base, size_t* size)
+    {
+      *base       = pages_;
+      *size       = pages_size_;
+      pages_      = 0;
+      pages_size_ = 0;
+    }
+
+} } // namespace arcsim::util
@@ -9,6 +9,10 @@
 // and snprintf(buf,...). It provides all the luxury of snprintf(buf,...) and
 // snprintf(buf,...) but is much easier to use and SAFER.
 //
+// The buffer starts out with the given size and grows by doubling whenever an
+// append does not fit, up to a maximum size. Only if that maximum size is
+// exceeded the buffer becomes full.
+//
 // NOTE: This buffer implemenation is NOT thread-safe, so do not try to append
 //       to a CodeBuffer instance from multiple threads!
 //
@@ -16,6 +20,7 @@
 
 #include <cstdarg>
 #include <cstdio>
+#include <cstring>
 
 #include "util/CodeBuffer.h"
 
@@ -25,10 +30,11 @@ namespace arcsim {
     // -------------------------------------------------------------------------
     // Constructor
     //
-    CodeBuffer::CodeBuffer(uint32 size)
+    CodeBuffer::CodeBuffer(uint32 size, uint32 max_size)
     // NOTE: Declaration and initialisation order matters!
     //
     : size_(size),            // store size of buffer
+      max_size_((max_size > size) ? max_size : size),
       buf_(new char[size]),   // HEAP allocate buffer
       end_(&buf_[size-1]),    // store end_ of buffer
       pos_(buf_),             // point current pos_ to beginning
@@ -52,24 +58,32 @@ namespace arcsim {
     CodeBuffer::append(const char *fmt, ...)
     {
       va_list ap;
-      int     size;
       
       va_start(ap, fmt);
       
-      // Is there enough room left?
-      //
-      if (state_ && (size = end_ - pos_) > 0) {
+      while (state_) {
+        const int size = end_ - pos_;
         
-        // Write to internal buffer
+        // Write to internal buffer, 'ap' is copied as we may need to write
+        // again after growing the buffer
         //
-        int ret = vsnprintf(pos_, size, fmt, ap);
+        va_list aq;
+        va_copy(aq, ap);
+        int ret = vsnprintf(pos_, size, fmt, aq);
+        va_end(aq);
         
         // If write was successful we modify internal buffer pointer
         // NOTE: 'ret' may be zero in which case nothing was written
         //
         if (ret >= 0 && ret < size) {
           pos_ += ret;
-        } else {
+          break;
+        }
+        
+        // Discard truncated output and retry with a larger buffer
+        //
+        *pos_ = '\0';
+        if (ret < 0 || !grow(ret + 1)) {
           state_ = kFull;
         }
       }
@@ -79,5 +93,30 @@ namespace arcsim {
       return *this;
     }
     
+    // -------------------------------------------------------------------------
+    // Grow buffer by doubling its size
+    //
+    bool
+    CodeBuffer::grow(uint32 bytes)
+    {
+      const uint32 used = pos_ - buf_;
+      uint32       size = size_;
+      
+      while ((size - used - 1) < bytes) {
+        if (size >= max_size_) { return false; }
+        size = (size > (max_size_ >> 1)) ? max_size_ : (size << 1);
+      }
+      
+      char * const buf = new char[size];
+      std::memcpy(buf, buf_, used + 1);
+      delete [] buf_;
+      
+      size_ = size;
+      buf_  = buf;
+      end_  = &buf_[size-1];
+      pos_  = buf_ + used;
+      return true;
+    }
+    
 } } // arcsim::util
 
@@ -56,56 +56,85 @@ namespace arcsim {
     }
     
     // -------------------------------------------------------------------------
-    // Histogram
+    // Histogram radix tree nodes
     //
+    Histogram::HistogramLeaf::HistogramLeaf(uint32 base_idx)
+    {
+      for (uint32 i = 0; i < kLeafSize; ++i)      { entry[i].set_index(base_idx | i); }
+      for (uint32 i = 0; i < kLeafSize / 32; ++i) { present[i] = 0;                   }
+    }
     
-    // Re-fill HistogramEntry allocation pool
-    //
-    uint32
-    Histogram::refill_historgram_allocation_pool()
+    Histogram::HistogramNode::HistogramNode()
     {
-      // Register pointer to HistogramEntry chunk
-      //
-      HistogramEntry* entries = new HistogramEntry [alloc_size_];
-      hist_entries_alloc_chunks_.push(entries);
-      
-      // Fill up hist_alloc_pool_
-      //
-      for (uint32 i = 0; i < alloc_size_; ++i) {
-        hist_entries_alloc_pool_.push(&entries[i]);
+      for (uint32 i = 0; i < kNodeSize; ++i) { child[i] = 0; }
+    }
+    
+    void
+    Histogram::delete_node(HistogramNode* n, uint32 shift)
+    {
+      for (uint32 i = 0; i < kNodeSize; ++i) {
+        if (n->child[i] == 0) { continue; }
+        if (shift > kLeafBits) {
+          delete_node(static_cast<HistogramNode*>(n->child[i]), shift - kNodeBits);
+        } else {
+          delete static_cast<HistogramLeaf*>(n->child[i]);
+        }
       }
-      
-      return hist_entries_alloc_pool_.size();
+      delete n;
     }
     
-    // Returns pointer to new HistogramEntry while maintaining all lookup
-    // structures
+    // -------------------------------------------------------------------------
+    // Histogram
+    //
+    
+    // Returns pointer to HistogramEntry for index while maintaining all lookup
+    // structures. Readers walk the radix tree without holding the lock, hence
+    // a new node is fully initialised before a memory barrier and only then
+    // made visible by storing its pointer.
     //
     HistogramEntry*
     Histogram::new_histogram_entry(uint32 idx)
     {
       arcsim::concurrent::ScopedLock lock(hist_entries_mutex_);
       
-      // Re-fill allocation pool if it is empty
-      //
-      if (hist_entries_alloc_pool_.empty()) { refill_historgram_allocation_pool(); }
-      
-      // Pop entry from allocation pool stack
-      //
-      HistogramEntry* entry = hist_entries_alloc_pool_.top();
-      hist_entries_alloc_pool_.pop();
-      
-      // Set desired index
+      // Another thread might have created the entry while we were waiting
       //
-      entry->set_index(idx);
+      HistogramEntry* entry = lookup_entry(idx);
+      if (entry) { return entry; }
       
-      // Add entry to histogram entries
+      // Create missing radix tree nodes
       //
-      hist_entries_.insert(entry);
+      HistogramNode* n = hist_root_[idx >> kRootShift];
+      if (n == 0) {
+        n = new HistogramNode();
+        __sync_synchronize();
+        hist_root_[idx >> kRootShift] = n;
+      }
+      uint32 s = kRootShift - kNodeBits;
+      for (; s > kLeafBits; s -= kNodeBits) {
+        void*& c = n->child[(idx >> s) & kNodeMask];
+        if (c == 0) {
+          HistogramNode* const node = new HistogramNode();
+          __sync_synchronize();
+          c = node;
+        }
+        n = static_cast<HistogramNode*>(c);
+      }
+      void*& c = n->child[(idx >> s) & kNodeMask];
+      if (c == 0) {
+        HistogramLeaf* const leaf = new HistogramLeaf(idx & ~kLeafMask);
+        __sync_synchronize();
+        c = leaf;
+      }
+      HistogramLeaf* const l = static_cast<HistogramLeaf*>(c);
       
-      // Install mapping into fast lookup map
+      // Mark entry as present and add it to histogram entries
       //
-      hist_map_index_value_[idx] = entry->get_value_ptr();
+      const uint32 i = idx & kLeafMask;
+      entry = &l->entry[i];
+      __sync_synchronize();
+      l->present[i >> 5] |= (1U << (i & 31));
+      hist_entries_.push_back(entry);
       
       return entry;
     }
@@ -115,128 +144,33 @@ namespace arcsim {
     void
     Histogram::set_value_at_index(uint32 idx, uint32 val)
     {
-      std::map<uint32,uint32*>::const_iterator I;
-      if ((I = hist_map_index_value_.find(idx)) != hist_map_index_value_.end()) {
-        // FAST PATH ------------------------------------------------------------
-        //
-        
-        // Hit in fast lookup map
-        //
-        (*I->second) = val;        
-      } else {      
-        // SLOW PATH ------------------------------------------------------------
-        //
-        
-        // HistogramEntry is not in fast look-up map so we have to create and install
-        // a new one via the following method call.
-        //
-        HistogramEntry* entry = new_histogram_entry(idx);
-        entry->set_value(val);
-      }
+      HistogramEntry* entry = lookup_entry(idx);
+      if (entry == 0) { entry = new_histogram_entry(idx); }
+      entry->set_value(val);
     }
     
     // Get value at index
     //
     uint32
     Histogram::get_value_at_index(uint32 idx)
-    {      
-      std::map<uint32,uint32*>::const_iterator I;
-      if ((I = hist_map_index_value_.find(idx)) != hist_map_index_value_.end()) {
-        // FAST PATH ------------------------------------------------------------
-        //
-        
-        // Hit in fast lookup map
-        //
-        return (*I->second);        
-      } else {        
-        // SLOW PATH ------------------------------------------------------------
-        //
-        
-        // HistogramEntry is not in fast look-up map so we have to create and install
-        // a new one via the following method call.
-        //
-        HistogramEntry* entry = new_histogram_entry(idx);
-        return entry->get_value();
-      }
+    {
+      HistogramEntry* entry = lookup_entry(idx);
+      if (entry == 0) { entry = new_histogram_entry(idx); }
+      return entry->get_value();
     }
     
     uint32* 
     Histogram::get_value_ptr_at_index(uint32 idx)
     {
-      // FAST PATH ------------------------------------------------------------
-      //
-      
-      // First we query fast lookup map
-      //
-      std::map<uint32,uint32*>::const_iterator I;
-      if ((I = hist_map_index_value_.find(idx)) != hist_map_index_value_.end()) {
-        // Hit in fast lookup map
-        //
-        return I->second;
-      }
-      
-      // SLOW PATH ------------------------------------------------------------
-      //
-      
-      // HistogramEntry is not in fast look-up map so we have to create and install
-      // a new one via the following method call.
-      //
-      HistogramEntry* entry = new_histogram_entry(idx);
+      HistogramEntry* entry = lookup_entry(idx);
+      if (entry == 0) { entry = new_histogram_entry(idx); }
       return entry->get_value_ptr();
     }
     
     bool
     Histogram::index_exists(uint32 idx) const
     {
-      return hist_map_index_value_.find(idx) != hist_map_index_value_.end();
-    }
-    
-    // Increment
-    //
-    void
-    Histogram::inc(uint32 idx)
-    {
-      std::map<uint32,uint32*>::const_iterator I;
-      if ((I = hist_map_index_value_.find(idx)) != hist_map_index_value_.end()) {
-        // FAST PATH ------------------------------------------------------------
-        //
-        
-        // Hit in fast lookup map
-        //
-        ++(*I->second);
-      } else {      
-        // SLOW PATH ------------------------------------------------------------
-        //
-        
-        // HistogramEntry is not in fast look-up map so we have to create and install
-        // a new one via the following method call.
-        //
-        HistogramEntry* entry = new_histogram_entry(idx);
-        entry->inc();
-      }
-    }
-    
-    void
-    Histogram::inc(uint32 idx, uint32 val)
-    {      
-      std::map<uint32,uint32*>::const_iterator I;
-      if ((I = hist_map_index_value_.find(idx)) != hist_map_index_value_.end()) {
-        // FAST PATH ------------------------------------------------------------
-        //
-        
-        // Hit in fast lookup map
-        //
-        (*I->second) += val;
-      } else {
-        // SLOW PATH ------------------------------------------------------------
-        //
-        
-        // HistogramEntry is not in fast look-up map so we have to create and install
-        // a new one via the following method call.
-        //
-        HistogramEntry* entry = new_histogram_entry(idx);
-        entry->inc(val);      
-      }
+      return lookup_entry(idx) != 0;
     }
     
     // Reset everything to 0
@@ -244,7 +178,7 @@ namespace arcsim {
     void
     Histogram::clear()
     {
-      for (std::set<HistogramEntry*>::const_iterator I = hist_entries_.begin(),
+      for (std::vector<HistogramEntry*>::const_iterator I = hist_entries_.begin(),
            E = hist_entries_.end();
            I != E; ++I)
       {
@@ -258,7 +192,7 @@ namespace arcsim {
     Histogram::get_total(void) const
     {
       uint64 total = 0;
-      for (std::set<HistogramEntry*>::iterator
+      for (std::vector<HistogramEntry*>::const_iterator
            I = hist_entries_.begin(),
            E = hist_entries_.end();
            I != E; ++I)
@@ -304,17 +238,16 @@ namespace arcsim {
     // Protected no args Histogram constructor
     //
     Histogram::Histogram()
-    : id_(kInitialHistogramId),
-      alloc_size_(kHistogramEntryDefaultAllocSize)
+    : id_(kInitialHistogramId)
     {
       name_[0] = '\0';
+      for (uint32 i = 0; i < kRootSize; ++i) { hist_root_[i] = 0; }
     }
 
     // Public Histogram constructor using automatic unique ID injection
     //
-    Histogram::Histogram(const char* name, uint32 alloc_size)
-    : id_(kInitialHistogramId),
-      alloc_size_(alloc_size)
+    Histogram::Histogram(const char* name)
+    : id_(kInitialHistogramId)
     { 
       uint32 i;
       // init name
@@ -322,16 +255,17 @@ namespace arcsim {
       for (i = 0; i < kHistogramMaxNameSize - 1 && name[i]; ++i)
         name_[i] = static_cast<uint8>(name[i]);
       name_[i] = '\0';      
+      for (i = 0; i < kRootSize; ++i) { hist_root_[i] = 0; }
     }
     
     Histogram::~Histogram()
     {
-      // Remove all dynamically allocated histogram chunks
+      // Remove all dynamically allocated radix tree nodes
       //
-      while (!hist_entries_alloc_chunks_.empty()) {
-        HistogramEntry* entries = hist_entries_alloc_chunks_.top();
-        delete [] entries;
-        hist_entries_alloc_chunks_.pop();
+      for (uint32 i = 0; i < kRootSize; ++i) {
+        if (hist_root_[i] == 0) { continue; }
+        delete_node(hist_root_[i], kRootShift - kNodeBits);
+        hist_root_[i] = 0;
       }
     }
     
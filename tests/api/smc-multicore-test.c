@@ -0,0 +1,167 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <dlfcn.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include "api/api_funs.h"
+#include "api/mem/api_mem.h"
+
+// -----------------------------------------------------------------------------
+// Self-modifying code test for a system with two cores.
+//
+// Core 0 executes a loop storing a LIMM value to kResultAddr. Core 1 then
+// overwrites the LIMM, first with a store (i.e. a page cache write miss) and
+// then with a block write. Every core keeps its own decode, page and translation
+// caches, so core 0 must be told to decode the 'mov' instruction again after
+// each write, or it keeps storing the previous value.
+//
+//   0x00000000: b      kCodeAddr
+//   0x00001000: mov    r0,kOldValue          ; LIMM at kLimmAddr
+//   0x00001008: st     r0,[kResultAddr]
+//   0x00001010: b      kCodeAddr
+//
+enum Addresses {
+  kCodeAddr   = 0x00001000,
+  kLimmAddr   = 0x00001004,
+  kResultAddr = 0x00020000
+};
+
+static const uint32 kOldValue   = 0x11111111;
+static const uint32 kStoreValue = 0x22222222;
+static const uint32 kBlockValue = 0x33333333;
+
+// Two cores sharing memory
+//
+static const char kArchFile[] =
+  "CORE         smc_core 1 32 EC5 316\n"
+  "MODULE       smc_module\n"
+  "ADD_CORE     smc_core 2\n"
+  "SYSTEM       smc_system 533 0 4294967292 32 16 2\n"
+  "ADD_MODULE   smc_module 1\n";
+
+// Instructions and LIMMs are stored as two 16-bit half-words, the most
+// significant half-word first
+//
+static void
+put_word(uint8* buf, uint32 word)
+{
+  buf[0] = (word >> 16) & 0xff;
+  buf[1] = (word >> 24) & 0xff;
+  buf[2] = (word      ) & 0xff;
+  buf[3] = (word >>  8) & 0xff;
+}
+
+static int
+write_word(cpuContext cpu, uint32 addr, uint32 word)
+{
+  uint8 buf[4];
+  put_word(buf, word);
+  return simCpuWriteBlock(cpu, addr, sizeof(buf), buf);
+}
+
+// Write 'word' with a store of 'cpu', swapping half-words so that memory holds
+// the same bytes as after write_word()
+//
+static int
+store_word(cpuContext cpu, uint32 addr, uint32 word)
+{
+  return simCpuWriteWord(cpu, addr, (word << 16) | (word >> 16));
+}
+
+static int
+check_result(cpuContext cpu, uint32 expected, const char* when)
+{
+  uint32 result = 0;
+  simCpuReadWord(cpu, kResultAddr, &result);
+  if (result != expected) {
+    printf("=== FAILED: [SMC-MULTICORE-TEST] expected:'0x%08x' actual:'0x%08x' %s\n",
+           expected, result, when);
+    return 1;
+  }
+  return 0;
+}
+
+void usage(void)
+{
+  printf(
+      "smc-multicore-test: Test harness for self-modifying code on two cores.\n"
+      "Usage: smc-multicore-test [OPTIONS]\n"
+      " OPTIONS: \n"
+      "   -h          Print this usage message and exit\n"
+      "\n"
+      );
+}
+
+int
+main(int argc, char **argv)
+{
+  char        img_path[]  = "smc-multicore-test.img";
+  char        arch_path[] = "smc-multicore-test.arc";
+  char*       sargv[]     = { "smc-multicore-test", "-a", arch_path };
+  uint8       img[4];
+  int         i;
+  int         failed;
+  FILE*       f;
+
+  simContext  sys;
+  cpuContext  cpu0;
+  cpuContext  cpu1;
+
+  if (argc > 1) {
+    usage();
+    return 0;
+  }
+
+  // Load simulator shared library
+  dlopen("libsim.so", RTLD_NOW+RTLD_GLOBAL);
+  printf ("Shared simulator library 'libsim.so' loaded...\n");
+
+  // Create system with two cores
+  f = fopen(arch_path, "w");
+  assert(f != 0 && "Failed to create system architecture file.");
+  fputs(kArchFile, f);
+  fclose(f);
+  sys  = simCreateContext (sizeof(sargv)/sizeof(sargv[0]), sargv);
+  remove(arch_path);
+  cpu0 = simGetCPUcontext (sys, 0);
+  cpu1 = simGetCPUcontext (sys, 1);
+
+  // Binary image holding the branch at address 0, loading it resets the PC
+  put_word(img, 0x00010080);                              /* b  kCodeAddr      */
+  f = fopen(img_path, "wb");
+  assert(f != 0 && "Failed to create binary image.");
+  fwrite(img, sizeof(img), 1, f);
+  fclose(f);
+  if (simLoadBinaryImage(sys, img_path) != 0) {
+    fprintf(stderr, "Fatal: Cannot load binary image '%s'.\n", img_path);
+    return -1;
+  }
+  remove(img_path);
+
+  write_word(cpu0, kCodeAddr,        0x200a0f80);        /* mov r0,limm       */
+  write_word(cpu0, kLimmAddr,        kOldValue);
+  write_word(cpu0, kCodeAddr + 8,    0x1e007000);        /* st  r0,[limm]     */
+  write_word(cpu0, kCodeAddr + 12,   kResultAddr);
+  write_word(cpu0, kCodeAddr + 16,   0x07f1ffcf);        /* b   kCodeAddr     */
+
+  // Core 0 executes b, mov, st, b
+  for (i = 0; i < 4; ++i) { simStep(sys); }
+  failed = check_result(cpu0, kOldValue, "before writes");
+
+  // Core 1 stores to the executed page, then core 0 executes mov, st
+  store_word(cpu1, kLimmAddr, kStoreValue);
+  for (i = 0; i < 2; ++i) { simStep(sys); }
+  failed = failed || check_result(cpu0, kStoreValue, "after store by other core");
+
+  // Core 1 writes a block to the executed page, then core 0 executes b, mov, st
+  write_word(cpu1, kLimmAddr, kBlockValue);
+  for (i = 0; i < 3; ++i) { simStep(sys); }
+  failed = failed || check_result(cpu0, kBlockValue, "after block write by other core");
+
+  if (failed) { return 1; }
+
+  printf("=== PASSED: [SMC-MULTICORE-TEST]\n");
+  return 0;
+}
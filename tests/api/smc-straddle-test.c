@@ -0,0 +1,143 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <dlfcn.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include "api/api_funs.h"
+#include "api/mem/api_mem.h"
+
+// -----------------------------------------------------------------------------
+// Self-modifying code test for instructions straddling a page boundary.
+//
+// The 'mov' instruction at kStraddleAddr starts on one page and its LIMM lies
+// on the next page. After executing it once, the LIMM (i.e. the tail of the
+// instruction) is overwritten with a block write, and the instruction must be
+// decoded again when it executes next. Page sizes are at most 16K so the
+// boundary at 0x10000 is a page boundary for all configurations.
+//
+//   0x00000000: b      kStraddleAddr
+//   0x0000fffc: mov    r0,kOldValue          ; LIMM at 0x00010000
+//   0x00010004: st     r0,[kResultAddr]
+//   0x0001000c: b      kStraddleAddr
+//
+enum Addresses {
+  kStraddleAddr = 0x0000fffc,
+  kLimmAddr     = 0x00010000,
+  kResultAddr   = 0x00020000
+};
+
+static const uint32 kOldValue = 0x11111111;
+static const uint32 kNewValue = 0x22222222;
+
+// Instructions and LIMMs are stored as two 16-bit half-words, the most
+// significant half-word first
+//
+static void
+put_word(uint8* buf, uint32 word)
+{
+  buf[0] = (word >> 16) & 0xff;
+  buf[1] = (word >> 24) & 0xff;
+  buf[2] = (word      ) & 0xff;
+  buf[3] = (word >>  8) & 0xff;
+}
+
+static int
+write_word(cpuContext cpu, uint32 addr, uint32 word)
+{
+  uint8 buf[4];
+  put_word(buf, word);
+  return simCpuWriteBlock(cpu, addr, sizeof(buf), buf);
+}
+
+void usage(void)
+{
+  printf(
+      "smc-straddle-test: Test harness for self-modifying code spanning pages.\n"
+      "Usage: smc-straddle-test [OPTIONS]\n"
+      " OPTIONS: \n"
+      "   -h          Print this usage message and exit\n"
+      "   --          Pass the rest of the command line options to Arcsim\n"
+      "\n"
+      );
+}
+
+int
+main(int argc, char **argv)
+{
+  char        img_path[] = "smc-straddle-test.img";
+  int         sargc = 0;
+  char*       sargv[128];
+  int         argp;
+  uint8       img[4];
+  uint32      result;
+  int         i;
+  FILE*       f;
+
+  simContext  sys;
+  cpuContext  cpu;
+
+  // Process command line arguments
+  for (argp = 1; argp < argc; argp ++) {
+    // Pass the rest of command line args to simulator
+    if (!strcmp(argv[argp], "--")) {
+      do {
+        sargv[sargc++] = argv[argp++];
+      } while (argp < argc);
+      break;
+    }
+    if (*argv[argp] == '-') {
+      usage();
+      return 0;
+    }
+  }
+
+  // Load simulator shared library
+  dlopen("libsim.so", RTLD_NOW+RTLD_GLOBAL);
+  printf ("Shared simulator library 'libsim.so' loaded...\n");
+
+  // Create system
+  sys = simCreateContext (sargc, sargv);
+  cpu = simGetCPUcontext (sys, 0);
+
+  // Binary image holding the branch at address 0, loading it resets the PC
+  put_word(img, 0x07fd07c0);                              /* b  kStraddleAddr */
+  f = fopen(img_path, "wb");
+  assert(f != 0 && "Failed to create binary image.");
+  fwrite(img, sizeof(img), 1, f);
+  fclose(f);
+  if (simLoadBinaryImage(sys, img_path) != 0) {
+    fprintf(stderr, "Fatal: Cannot load binary image '%s'.\n", img_path);
+    return -1;
+  }
+  remove(img_path);
+
+  write_word(cpu, kStraddleAddr,     0x200a0f80);        /* mov r0,limm      */
+  write_word(cpu, kLimmAddr,         kOldValue);
+  write_word(cpu, kLimmAddr + 4,     0x1e007000);        /* st  r0,[limm]    */
+  write_word(cpu, kLimmAddr + 8,     kResultAddr);
+  write_word(cpu, kLimmAddr + 12,    0x07f1ffcf);        /* b   kStraddleAddr */
+
+  // Execute b, mov, st, b
+  for (i = 0; i < 4; ++i) { simStep(sys); }
+  simCpuReadWord(cpu, kResultAddr, &result);
+  if (result != kOldValue) {
+    printf("=== FAILED: [SMC-STRADDLE-TEST] expected:'0x%08x' actual:'0x%08x' before write\n",
+           kOldValue, result);
+    return 1;
+  }
+
+  // Overwrite tail of the straddling instruction, then execute mov, st
+  write_word(cpu, kLimmAddr, kNewValue);
+  for (i = 0; i < 2; ++i) { simStep(sys); }
+  simCpuReadWord(cpu, kResultAddr, &result);
+  if (result != kNewValue) {
+    printf("=== FAILED: [SMC-STRADDLE-TEST] expected:'0x%08x' actual:'0x%08x' after write\n",
+           kNewValue, result);
+    return 1;
+  }
+
+  printf("=== PASSED: [SMC-STRADDLE-TEST]\n");
+  return 0;
+}
@@ -0,0 +1,188 @@
+//                      Confidential Information
+//           Limited Distribution to Authorized Persons Only
+//         Copyright (C) 2011 The University of Edinburgh
+//                        All Rights Reserved
+// =====================================================================
+//
+// Description:
+//
+// Micro-benchmark comparing std::map<>/std::multimap<> with OpenHashMap<> for
+// the lookup pattern of Processor::step_block() during tracing, i.e.
+// PhysicalProfile::get_page_profile() on a page cache miss,
+// PageProfile::get_block_entry(), and PhysicalProfile/PageProfile
+// trace_block(). PhysicalProfile and PageProfile can not be instantiated
+// outside of a Processor (their Zone is owned by Processor/System), so the
+// benchmark mirrors their map operations on minimal page and block types. It
+// measures the map data structures only, not the profiling classes.
+//
+// Usage: profile-map-bench [pages] [blocks-per-page] [iterations]
+//
+// =====================================================================
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+#include <sys/time.h>
+
+#include "api/types.h"
+#include "util/OpenHashMap.h"
+
+using arcsim::util::OpenHashMap;
+
+struct Block { uint32 phys_addr; uint32 virt_addr; uint32 interp_count; };
+
+static uint64
+now_micros()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return (uint64)tv.tv_sec * 1000000ULL + tv.tv_usec;
+}
+
+// -----------------------------------------------------------------------------
+// Previous implementation
+//
+struct MapPage {
+  std::map<uint32,Block*>       block_map;
+  std::map<uint32,Block*>       nodes;
+  std::multimap<uint32,Block*>  edges;
+  uint32                        prev;
+  MapPage() : prev(1) { }
+};
+
+static uint64
+run_map(const std::vector<uint32>& stream, uint32 page_mask, std::vector<Block>& pool)
+{
+  std::map<uint32,MapPage*> page_map;
+  std::map<uint32,MapPage*> touched_pages;
+  size_t                    next = 0;
+  uint64                    sum  = 0;
+
+  for (size_t i = 0; i < stream.size(); ++i) {
+    const uint32 addr  = stream[i];
+    const uint32 frame = addr & page_mask;
+    // get_page_profile()
+    MapPage* p;
+    std::map<uint32,MapPage*>::const_iterator P = page_map.find(frame);
+    if (P != page_map.end()) { p = P->second; }
+    else { p = new MapPage(); page_map.insert(std::make_pair(frame, p)); }
+    // get_block_entry()
+    Block* b;
+    if (p->block_map.find(addr) != p->block_map.end()) { b = p->block_map[addr]; }
+    else { b = &pool[next++]; b->phys_addr = b->virt_addr = addr; p->block_map.insert(std::make_pair(addr, b)); }
+    ++b->interp_count;
+    // trace_block()
+    if (touched_pages.find(frame) == touched_pages.end()) { touched_pages.insert(std::make_pair(frame, p)); }
+    if (p->nodes.find(addr) == p->nodes.end()) { p->nodes[addr] = b; }
+    if (p->prev != 1) {
+      bool found = false;
+      std::pair<std::multimap<uint32,Block*>::const_iterator,
+                std::multimap<uint32,Block*>::const_iterator> r = p->edges.equal_range(p->prev);
+      for (std::multimap<uint32,Block*>::const_iterator I = r.first; I != r.second; ++I) {
+        if (I->second->virt_addr == addr) { found = true; break; }
+      }
+      if (!found) { p->edges.insert(std::make_pair(p->prev, b)); }
+    }
+    p->prev = addr;
+    sum += b->interp_count;
+  }
+  for (std::map<uint32,MapPage*>::iterator I = page_map.begin(); I != page_map.end(); ++I) { delete I->second; }
+  return sum;
+}
+
+// -----------------------------------------------------------------------------
+// OpenHashMap implementation
+//
+struct HashPage {
+  OpenHashMap<uint32,Block*>  block_map;
+  OpenHashMap<uint32,Block*>  nodes;
+  OpenHashMap<uint64,Block*>  edges;
+  uint32                      prev;
+  HashPage() : prev(1) { }
+};
+
+static uint64
+run_hash(const std::vector<uint32>& stream, uint32 page_mask, std::vector<Block>& pool)
+{
+  OpenHashMap<uint32,HashPage*> page_map;
+  OpenHashMap<uint32,HashPage*> touched_pages;
+  size_t                        next = 0;
+  uint64                        sum  = 0;
+
+  for (size_t i = 0; i < stream.size(); ++i) {
+    const uint32 addr  = stream[i];
+    const uint32 frame = addr & page_mask;
+    // get_page_profile()
+    HashPage* p;
+    if (HashPage** const e = page_map.find(frame)) { p = *e; }
+    else { p = new HashPage(); page_map.insert(frame, p); }
+    // get_block_entry()
+    Block* b;
+    if (Block** const e = p->block_map.find(addr)) { b = *e; }
+    else { b = &pool[next++]; b->phys_addr = b->virt_addr = addr; p->block_map.insert(addr, b); }
+    ++b->interp_count;
+    // trace_block()
+    touched_pages.insert(frame, p);
+    p->nodes.insert(addr, b);
+    if (p->prev != 1) { p->edges.insert(((uint64)p->prev << 32) | addr, b); }
+    p->prev = addr;
+    sum += b->interp_count;
+  }
+  for (OpenHashMap<uint32,HashPage*>::Iter I(page_map); !I.is_end(); ++I) { delete I.value(); }
+  return sum;
+}
+
+int
+main(int argc, char* argv[])
+{
+  const uint32 pages      = (argc > 1) ? atoi(argv[1]) : 256;
+  const uint32 blocks     = (argc > 2) ? atoi(argv[2]) : 128;
+  const uint32 iterations = (argc > 3) ? atoi(argv[3]) : 4000000;
+  const uint32 page_bytes = 8192;
+  const uint32 page_mask  = ~(page_bytes - 1);
+
+  // Synthesise a block address stream with page locality. Each block either
+  // falls through to its successor or branches to a fixed target, so every
+  // block has at most two outgoing edges. Occasionally we jump to another page.
+  //
+  std::vector<uint32> stream;
+  std::vector<uint32> target(blocks);
+  stream.reserve(iterations);
+  srand(42);
+  for (uint32 b = 0; b < blocks; ++b) { target[b] = rand() % blocks; }
+  uint32 page  = 0;
+  uint32 block = 0;
+  for (uint32 i = 0; i < iterations; ++i) {
+    if ((rand() & 0x3f) == 0) { page = rand() % pages; block = rand() % blocks; }
+    else                      { block = (rand() & 1) ? target[block] : (block + 1) % blocks; }
+    stream.push_back(0x10000000 + page * page_bytes + ((block * (page_bytes / blocks)) & ~1U));
+  }
+
+  std::vector<Block> pool_map((size_t)pages * blocks);
+  std::vector<Block> pool_hash((size_t)pages * blocks);
+
+  uint64 t0 = now_micros();
+  const uint64 s0 = run_map(stream, page_mask, pool_map);
+  uint64 t1 = now_micros();
+  const uint64 s1 = run_hash(stream, page_mask, pool_hash);
+  uint64 t2 = now_micros();
+
+  if (s0 != s1) {
+    fprintf(stderr, "profile-map-bench: result mismatch (%llu != %llu)\n", s0, s1);
+    return EXIT_FAILURE;
+  }
+
+  fprintf(stdout, "\nProfile Lookup Micro-Benchmark\n");
+  fprintf(stdout, "-----------------------------------------------------\n");
+  fprintf(stdout, " Pages/Blocks per page:         %u/%u\n", pages, blocks);
+  fprintf(stdout, " Traced blocks:                 %u\n", iterations);
+  fprintf(stdout, " std::map<>   [us] (total):     %llu\n", t1 - t0);
+  fprintf(stdout, " std::map<>   [M blocks/s]:     %.2f\n", (double)iterations / (t1 - t0));
+  fprintf(stdout, " OpenHashMap<>[us] (total):     %llu\n", t2 - t1);
+  fprintf(stdout, " OpenHashMap<>[M blocks/s]:     %.2f\n", (double)iterations / (t2 - t1));
+  fprintf(stdout, "-----------------------------------------------------\n");
+  return EXIT_SUCCESS;
+}
@@ -20,7 +20,7 @@ test-default: setup
 	$(Verb) _EEMBC_TESTS="$(EEMBC_DEFAULT_ITER)"     make _test-default-eembc
 	$(Verb) _BIOPERF_TESTS="$(BIOPERF_DEFAULT_ITER)" make _test-default-bioperf
 	$(Verb) _SPEC_TESTS="$(SPEC_DEFAULT_ITER)"       make _test-default-spec
-	$(Verb)                                          make -C $(TOP)/../api clean test-default-api test-default-ipt-api
+	$(Verb)                                          make -C $(TOP)/../api clean test-default-api test-default-ipt-api test-default-smc-api
 	$(Verb)                                          make _test-default-misc
 
 
@@ -33,7 +33,7 @@ test-regression: setup
 	$(Verb) _EEMBC_TESTS="${EEMBC_REGRESSION}"     make _test-default-eembc    | tee    ${LOG}/$@.log
 	$(Verb) _BIOPERF_TESTS="$(BIOPERF_REGRESSION)" make _test-default-bioperf  | tee -a ${LOG}/$@.log
 	$(Verb) _SPEC_TESTS="$(SPEC_REGRESSION)"       make _test-default-spec     | tee -a ${LOG}/$@.log
-	$(Verb)                                        make -C $(TOP)/../api clean test-default-api test-default-ipt-api | tee -a ${LOG}/$@.log
+	$(Verb)                                        make -C $(TOP)/../api clean test-default-api test-default-ipt-api test-default-smc-api | tee -a ${LOG}/$@.log
 	$(Verb)                                        make _test-default-misc     | tee -a ${LOG}/$@.log
 	$(Verb)                                        make _test-default-hex      | tee -a ${LOG}/$@.log
 	$(Verb) awk 'BEGIN {F=0;} /FAILED/ {F++;}\
@@ -79,7 +79,7 @@ test-regression-vendor-drop: setup
 	$(Verb) _SPEC_TESTS="$(SPEC_REGRESSION)"       SIMOPT="--fast-num-threads=3" make _test-default-spec     | tee -a ${LOG}/$@.log
 	$(Verb)                                                                      make _test-default-hex      | tee -a ${LOG}/$@.log
 	$(Verb) DRIVER_MDB=1            SIMOPT="-prop=arcsim_fast-num-threads=3"     make _test-default-arcompactv2 | tee ${LOG}/$@.log
-	$(Verb)                                                                      make -C $(TOP)/../api clean test-default-api test-default-ipt-api | tee -a ${LOG}/$@.log
+	$(Verb)                                                                      make -C $(TOP)/../api clean test-default-api test-default-ipt-api test-default-smc-api | tee -a ${LOG}/$@.log
 	$(Verb)                                                                      make _test-default-misc     | tee -a ${LOG}/$@.log
 	$(Verb) awk 'BEGIN {F=0;} /FAILED/ {F++;}\
 					END\